@@ -24,4 +24,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     $$PWD/camera/qcctv-camera.pro \
-    $$PWD/station/qcctv-station.pro
+    $$PWD/station/qcctv-station.pro \
+    $$PWD/tests/tests.pro
@@ -1,171 +1,327 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-import QtQuick 2.0
-import QtQuick.Layouts 1.0
-import QtQuick.Controls 2.0
-import Qt.labs.settings 1.0
-import QtQuick.Controls.Material 2.0
-
-Popup {
-    id: settings
-
-    //
-    // Settings
-    //
-    Settings {
-        property alias fps: fps.value
-        property alias name: name.text
-        property alias group: group.text
-        property alias resolution: resolutions.currentIndex
-        property alias autoRegulateResolution: autoRegulateResolution.checked
-    }
-
-    //
-    // Geometry options
-    //
-    modal: true
-    contentWidth: col.width
-    contentHeight: col.height
-    x: (app.width - width) / 2
-    y: (app.height - height * 1.2) / 2
-
-    //
-    // Styling options
-    //
-    Material.theme: Material.Light
-
-    //
-    // Central widget
-    //
-    ColumnLayout {
-        id: col
-        spacing: app.spacing
-        anchors.centerIn: parent
-
-        //
-        // Camera name label
-        //
-        Label {
-            text: qsTr ("Camera Name") + ":"
-        }
-
-        //
-        // Camera name text input
-        //
-        TextField {
-            id: name
-            text: QCCTVCamera.name
-            Layout.fillWidth: true
-            Layout.minimumWidth: 280
-            onTextChanged: {
-                if (text.length > 0)
-                    QCCTVCamera.name = text
-            }
-        }
-
-        //
-        // Camera group label
-        //
-        Label {
-            text: qsTr ("Camera Group") + ":"
-        }
-
-        //
-        // Camera group text input
-        //
-        TextField {
-            id: group
-            Layout.fillWidth: true
-            text: QCCTVCamera.group
-            Layout.minimumWidth: 280
-            onTextChanged: {
-                if (text.length > 0)
-                    QCCTVCamera.group = text
-            }
-        }
-
-        //
-        // FPS label
-        //
-        Label {
-            text: qsTr ("Camera FPS") + ":"
-        }
-
-        //
-        // FPS spinbox
-        //
-        SpinBox {
-            id: fps
-            value: QCCTVCamera.fps
-            Layout.fillWidth: true
-            to: QCCTVCamera.maximumFps
-            from: QCCTVCamera.minimumFps
-            onValueChanged: QCCTVCamera.fps = value
-        }
-
-        //
-        // Resolution label
-        //
-        Label {
-            text: qsTr ("Target Resolution") + ":"
-        }
-
-        //
-        // Resolution selector
-        //
-        ComboBox {
-            id: resolutions
-            Layout.fillWidth: true
-            model: QCCTVCamera.resolutions
-            currentIndex: QCCTVCamera.resolution
-            onCurrentIndexChanged: QCCTVCamera.resolution = currentIndex
-        }
-
-        //
-        // Auto-regulate switch
-        //
-        Switch {
-            id: autoRegulateResolution
-            checked: QCCTVCamera.autoRegulateResolution
-            text: qsTr ("Auto-regulate video resolution")
-            onCheckedChanged: QCCTVCamera.autoRegulateResolution = checked
-        }
-
-        //
-        // Spacer
-        //
-        Item {
-            Layout.fillWidth: true
-            Layout.minimumWidth: app.spacing
-        }
-
-        //
-        // Close button
-        //
-        Button {
-            text: qsTr ("Close")
-            Layout.fillWidth: true
-            onClicked: settings.close()
-        }
-    }
-}
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+import QtQuick 2.0
+import QtQuick.Layouts 1.0
+import QtQuick.Controls 2.0
+import Qt.labs.settings 1.0
+import QtQuick.Controls.Material 2.0
+
+Popup {
+    id: settings
+
+    //
+    // Settings
+    //
+    Settings {
+        property alias fps: fps.value
+        property alias idleFps: idleFps.value
+        property alias bitrate: bitrate.value
+        property alias name: name.text
+        property alias group: group.text
+        property alias resolution: resolutions.currentIndex
+        property alias autoRegulateResolution: autoRegulateResolution.checked
+        property alias motionDetection: motionDetection.checked
+        property alias deltaFrames: deltaFrames.checked
+        property alias noiseReduction: noiseReduction.checked
+        property alias autoGrayscale: autoGrayscale.checked
+        property alias highFps: highFps.checked
+        property alias pacing: pacing.checked
+        property alias pacingBurst: pacingBurst.value
+        property alias rtpDestination: rtpDestination.text
+    }
+
+    //
+    // Geometry options
+    //
+    modal: true
+    contentWidth: col.width
+    contentHeight: col.height
+    x: (app.width - width) / 2
+    y: (app.height - height * 1.2) / 2
+
+    //
+    // Styling options
+    //
+    Material.theme: Material.Light
+
+    //
+    // Central widget
+    //
+    ColumnLayout {
+        id: col
+        spacing: app.spacing
+        anchors.centerIn: parent
+
+        //
+        // Camera name label
+        //
+        Label {
+            text: qsTr ("Camera Name") + ":"
+        }
+
+        //
+        // Camera name text input
+        //
+        TextField {
+            id: name
+            text: QCCTVCamera.name
+            Layout.fillWidth: true
+            Layout.minimumWidth: 280
+            onTextChanged: {
+                if (text.length > 0)
+                    QCCTVCamera.name = text
+            }
+        }
+
+        //
+        // Camera group label
+        //
+        Label {
+            text: qsTr ("Camera Group") + ":"
+        }
+
+        //
+        // Camera group text input
+        //
+        TextField {
+            id: group
+            Layout.fillWidth: true
+            text: QCCTVCamera.group
+            Layout.minimumWidth: 280
+            onTextChanged: {
+                if (text.length > 0)
+                    QCCTVCamera.group = text
+            }
+        }
+
+        //
+        // FPS label
+        //
+        Label {
+            text: qsTr ("Camera FPS") + ":"
+        }
+
+        //
+        // FPS spinbox
+        //
+        SpinBox {
+            id: fps
+            value: QCCTVCamera.fps
+            Layout.fillWidth: true
+            to: QCCTVCamera.maximumFps
+            from: QCCTVCamera.minimumFps
+            onValueChanged: QCCTVCamera.fps = value
+        }
+
+        //
+        // Bitrate label
+        //
+        Label {
+            text: qsTr ("Target Bitrate (kbit/s, 0 = best quality)") + ":"
+        }
+
+        //
+        // Bitrate spinbox
+        //
+        SpinBox {
+            id: bitrate
+            from: 0
+            to: 20000
+            stepSize: 250
+            editable: true
+            Layout.fillWidth: true
+            value: QCCTVCamera.bitrate
+            onValueChanged: QCCTVCamera.bitrate = value
+        }
+
+        //
+        // Pacing burst label
+        //
+        Label {
+            text: qsTr ("Pacing Burst (KB)") + ":"
+        }
+
+        //
+        // Pacing burst spinbox
+        //
+        SpinBox {
+            id: pacingBurst
+            from: 2
+            to: 256
+            editable: true
+            Layout.fillWidth: true
+            enabled: pacing.checked
+            value: QCCTVCamera.pacingBurst / 1024
+            onValueChanged: QCCTVCamera.pacingBurst = value * 1024
+        }
+
+        //
+        // Resolution label
+        //
+        Label {
+            text: qsTr ("Target Resolution") + ":"
+        }
+
+        //
+        // Resolution selector
+        //
+        ComboBox {
+            id: resolutions
+            Layout.fillWidth: true
+            model: QCCTVCamera.resolutions
+            currentIndex: QCCTVCamera.resolution
+            onCurrentIndexChanged: QCCTVCamera.resolution = currentIndex
+        }
+
+        //
+        // Auto-regulate switch
+        //
+        Switch {
+            id: autoRegulateResolution
+            checked: QCCTVCamera.autoRegulateResolution
+            text: qsTr ("Auto-regulate video resolution")
+            onCheckedChanged: QCCTVCamera.autoRegulateResolution = checked
+        }
+
+        //
+        // Delta frames switch
+        //
+        Switch {
+            id: deltaFrames
+            checked: QCCTVCamera.deltaFramesEnabled
+            text: qsTr ("Only send changed image blocks")
+            onCheckedChanged: QCCTVCamera.deltaFramesEnabled = checked
+        }
+
+        //
+        // Noise reduction switch
+        //
+        Switch {
+            id: noiseReduction
+            checked: QCCTVCamera.noiseReductionEnabled
+            text: qsTr ("Reduce image noise")
+            onCheckedChanged: QCCTVCamera.noiseReductionEnabled = checked
+        }
+
+        //
+        // High frame rate switch
+        //
+        Switch {
+            id: highFps
+            checked: QCCTVCamera.highFpsEnabled
+            text: qsTr ("Allow high frame rates (up to 120 FPS)")
+            onCheckedChanged: QCCTVCamera.highFpsEnabled = checked
+        }
+
+        //
+        // Pacing switch
+        //
+        Switch {
+            id: pacing
+            checked: QCCTVCamera.pacingEnabled
+            text: qsTr ("Spread frames over the frame interval")
+            onCheckedChanged: QCCTVCamera.pacingEnabled = checked
+        }
+
+        //
+        // Automatic grayscale switch
+        //
+        Switch {
+            id: autoGrayscale
+            checked: QCCTVCamera.autoGrayscaleEnabled
+            text: qsTr ("Send grayscale images when there is no color")
+            onCheckedChanged: QCCTVCamera.autoGrayscaleEnabled = checked
+        }
+
+        //
+        // Motion detection switch
+        //
+        Switch {
+            id: motionDetection
+            checked: QCCTVCamera.motionDetectionEnabled
+            text: qsTr ("Lower FPS when there is no motion")
+            onCheckedChanged: QCCTVCamera.motionDetectionEnabled = checked
+        }
+
+        //
+        // Idle FPS label
+        //
+        Label {
+            enabled: motionDetection.checked
+            text: qsTr ("Idle FPS") + ":"
+        }
+
+        //
+        // Idle FPS spinbox
+        //
+        SpinBox {
+            id: idleFps
+            from: 1
+            to: fps.value
+            Layout.fillWidth: true
+            value: QCCTVCamera.idleFps
+            enabled: motionDetection.checked
+            onValueChanged: QCCTVCamera.idleFps = value
+        }
+
+        //
+        // RTP destination label
+        //
+        Label {
+            text: qsTr ("RTP/JPEG Destination") + ":"
+        }
+
+        //
+        // RTP destination text input (empty disables the RTP output)
+        //
+        TextField {
+            id: rtpDestination
+            Layout.fillWidth: true
+            Layout.minimumWidth: 280
+            text: QCCTVCamera.rtpDestination
+            placeholderText: qsTr ("Address:Port")
+            onEditingFinished: QCCTVCamera.rtpDestination = text
+            onTextChanged: {
+                if (!activeFocus)
+                    QCCTVCamera.rtpDestination = text
+            }
+        }
+
+        //
+        // Spacer
+        //
+        Item {
+            Layout.fillWidth: true
+            Layout.minimumWidth: app.spacing
+        }
+
+        //
+        // Close button
+        //
+        Button {
+            text: qsTr ("Close")
+            Layout.fillWidth: true
+            onClicked: settings.close()
+        }
+    }
+}
@@ -1,41 +1,41 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#ifndef _QCCTV_CAMERA_IMAGE_PROVIDER_H
-#define _QCCTV_CAMERA_IMAGE_PROVIDER_H
-
-#include <QQuickImageProvider>
-
-class QCCTV_LocalCamera;
-class QCCTV_ImageProvider : public QQuickImageProvider
-{
-public:
-    QCCTV_ImageProvider (QCCTV_LocalCamera* parent);
-    QImage requestImage (const QString& id, QSize* size,
-                         const QSize& requestedSize);
-
-private:
-    QImage m_cameraError;
-    QCCTV_LocalCamera* m_localCamera;
-};
-
-#endif
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_CAMERA_IMAGE_PROVIDER_H
+#define _QCCTV_CAMERA_IMAGE_PROVIDER_H
+
+#include <QQuickImageProvider>
+
+class QCCTV_LocalCamera;
+class QCCTV_ImageProvider : public QQuickImageProvider
+{
+public:
+    QCCTV_ImageProvider (QCCTV_LocalCamera* parent);
+    QImage requestImage (const QString& id, QSize* size,
+                         const QSize& requestedSize);
+
+private:
+    QImage m_cameraError;
+    QCCTV_LocalCamera* m_localCamera;
+};
+
+#endif
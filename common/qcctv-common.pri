@@ -37,11 +37,23 @@ include ($$PWD/lib/yuv2rgb/yuv2rgb.pri)
 HEADERS += \
     $$PWD/src/QCCTV_Communications.h \
     $$PWD/src/QCCTV_CRC32.h \
+    $$PWD/src/QCCTV_DatagramStream.h \
+    $$PWD/src/QCCTV_DeltaFrame.h \
+    $$PWD/src/QCCTV_Denoiser.h \
     $$PWD/src/QCCTV_Discovery.h \
     $$PWD/src/QCCTV_ImageCapture.h \
     $$PWD/src/QCCTV_ImageSaver.h \
+    $$PWD/src/QCCTV_JpegTables.h \
     $$PWD/src/QCCTV_LocalCamera.h \
+    $$PWD/src/QCCTV_MotionAnalyzer.h \
+    $$PWD/src/QCCTV_MotionDetector.h \
+    $$PWD/src/QCCTV_Pacer.h \
+    $$PWD/src/QCCTV_Relay.h \
     $$PWD/src/QCCTV_RemoteCamera.h \
+    $$PWD/src/QCCTV_RtpStream.h \
+    $$PWD/src/QCCTV_Scaler.h \
+    $$PWD/src/QCCTV_Session.h \
+    $$PWD/src/QCCTV_SharedFrames.h \
     $$PWD/src/QCCTV_Station.h \
     $$PWD/src/QCCTV_Watchdog.h \
     $$PWD/src/QCCTV.h
@@ -49,11 +61,23 @@ HEADERS += \
 SOURCES += \
     $$PWD/src/QCCTV_Communications.cpp \
     $$PWD/src/QCCTV_CRC32.cpp \
+    $$PWD/src/QCCTV_DatagramStream.cpp \
+    $$PWD/src/QCCTV_DeltaFrame.cpp \
+    $$PWD/src/QCCTV_Denoiser.cpp \
     $$PWD/src/QCCTV_Discovery.cpp \
     $$PWD/src/QCCTV_ImageCapture.cpp \
     $$PWD/src/QCCTV_ImageSaver.cpp \
+    $$PWD/src/QCCTV_JpegTables.cpp \
     $$PWD/src/QCCTV_LocalCamera.cpp \
+    $$PWD/src/QCCTV_MotionAnalyzer.cpp \
+    $$PWD/src/QCCTV_MotionDetector.cpp \
+    $$PWD/src/QCCTV_Pacer.cpp \
+    $$PWD/src/QCCTV_Relay.cpp \
     $$PWD/src/QCCTV_RemoteCamera.cpp \
+    $$PWD/src/QCCTV_RtpStream.cpp \
+    $$PWD/src/QCCTV_Scaler.cpp \
+    $$PWD/src/QCCTV_Session.cpp \
+    $$PWD/src/QCCTV_SharedFrames.cpp \
     $$PWD/src/QCCTV_Station.cpp \
     $$PWD/src/QCCTV_Watchdog.cpp \
     $$PWD/src/QCCTV.cpp
@@ -1,212 +1,580 @@
-﻿/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#include "QCCTV.h"
-
-#include <QBuffer>
-#include <QObject>
-#include <QPixmap>
-#include <QPainter>
-#include <QFontMetrics>
-
-/**
- * If a is not empty, the function appends \a b to \a a and adds a separator.
- * Otherwise, this function shall return \a b
- */
-static QString append_str (const QString a, QString b)
-{
-    if (a.isEmpty())
-        return b;
-
-    else
-        return a + " | " + b;
-}
-
-/**
- * Returns a valid FPS value
- */
-int QCCTV_ValidFps (const int fps)
-{
-    return qMax (qMin (fps, QCCTV_MAX_FPS), QCCTV_MIN_FPS);
-}
-
-/**
- * Returns a valid watchdog timeout value
- */
-int QCCTV_GetWatchdogTime (const int fps)
-{
-    return qMax (QCCTV_MIN_WATCHDOG_TIME,
-                 qMin (fps * 50, QCCTV_MAX_WATCHDOG_TIME));
-}
-
-/**
- * Parses the given status flags as a string
- */
-QString QCCTV_GetStatusString (const int status)
-{
-    QString str;
-
-    if (status & QCCTV_CAMSTATUS_LIGHT_FAILURE)
-        str = append_str (str, QObject::tr ("Flashlight Failure"));
-
-    if (status & QCCTV_CAMSTATUS_VIDEO_FAILURE)
-        str = append_str (str, QObject::tr ("Video Failure"));
-
-    if (status == QCCTV_CAMSTATUS_DEFAULT)
-        str = QObject::tr ("Camera OK");
-
-    return str;
-}
-
-/**
- * Returns the available image resolutions
- */
-extern QStringList QCCTV_Resolutions()
-{
-    QStringList list;
-
-    list.append (QObject::tr ("QCIF (176x120)"));
-    list.append (QObject::tr ("CIF (352x240)"));
-    list.append (QObject::tr ("2CIF (704x240)"));
-    list.append (QObject::tr ("4CIF (704x480)"));
-    list.append (QObject::tr ("D1 (720x480)"));
-    list.append (QObject::tr ("720p (1280x720)"));
-    list.append (QObject::tr ("960p (1280x960)"));
-    list.append (QObject::tr ("Original Resolution"));
-
-    return list;
-}
-
-/**
- * Gets the frame size for the given \a resolution
- */
-QSize QCCTV_GetResolution (const int resolution)
-{
-    int width = 0;
-    int height = 0;
-
-    switch ((QCCTV_Resolution) resolution) {
-    case QCCTV_QCIF:
-        width = 176;
-        height = 144;
-        break;
-    case QCCTV_CIF:
-        width = 352;
-        height = 240;
-        break;
-    case QCCTV_2CIF:
-        width = 704;
-        height = 240;
-        break;
-    case QCCTV_4CIF:
-        width = 704;
-        height = 480;
-        break;
-    case QCCTV_D1:
-        width = 720;
-        height = 480;
-        break;
-    case QCCTV_720p:
-        width = 1280;
-        height = 720;
-        break;
-    case QCCTV_960p:
-        width = 1280;
-        height = 960;
-        break;
-    default:
-        width = -1;
-        height = -1;
-        break;
-    }
-
-    return QSize (width, height);
-}
-
-/**
- * Returns the raw bytes of the encoded \a image
- */
-QByteArray QCCTV_EncodeImage (const QImage& image, const int res)
-{
-    /* Get resolution */
-    QSize size = QCCTV_GetResolution (res);
-    if (res == QCCTV_Original)
-        size = image.size();
-
-    /* Scale the image */
-    QImage final = image.scaled (size,
-                                 Qt::KeepAspectRatio,
-                                 Qt::FastTransformation);
-
-    /* Save image to byte array */
-    QByteArray raw_bytes;
-    QBuffer buffer (&raw_bytes);
-    final.save (&buffer, "jpg", 100);
-    buffer.close();
-
-    /* Return image bytes */
-    return raw_bytes;
-}
-
-/**
- * Generates a image from the given \a data
- */
-QImage QCCTV_DecodeImage (const QByteArray& data)
-{
-    if (!data.isEmpty())
-        return QImage::fromData (data);
-
-    return QCCTV_CreateStatusImage (QSize (640, 480), "IMAGE ERROR");
-}
-
-/**
- * Generates an image with the given \a size and \a text
- */
-QImage QCCTV_CreateStatusImage (const QSize& size, const QString& text)
-{
-    /* Get initial SMPTE image */
-    QPixmap pixmap (":/qcctv/smpte.jpg");
-    pixmap = pixmap.scaled (size);
-    QPainter painter (&pixmap);
-
-    /* Get font information */
-    QFont font ("Arial", size.height() / 18, QFont::Bold);
-    QFontMetrics metrics (font);
-
-    /* Set painter font */
-    painter.setFont (font);
-    painter.setPen (Qt::white);
-
-    /* Draw text background */
-    int h = metrics.height() * 1.2;
-    int w = metrics.width (text) * 1.2;
-    int x = (size.width() - w) / 2;
-    int y = (size.height() - h) / 2;
-    painter.fillRect (QRectF (x, y, w, h), Qt::black);
-
-    /* Draw the text */
-    painter.drawText (QRectF (0, 0, size.width(), size.height()),
-                      Qt::AlignCenter, text);
-
-    /* Convert the pixmap to an image */
-    return pixmap.toImage();
-}
+﻿/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_Scaler.h"
+
+#include <QBuffer>
+#include <QObject>
+#include <QPixmap>
+#include <QPainter>
+#include <QtMath>
+#include <string.h>
+#include <QAtomicInt>
+#include <QTcpSocket>
+#include <QFontMetrics>
+#include <QNetworkInterface>
+
+#ifdef Q_OS_LINUX
+    #include <sys/uio.h>
+    #include <sys/socket.h>
+#endif
+
+/* SIMD instruction sets used by the image kernels (-1 until detected) */
+static QAtomicInt ENABLED_SIMD (-1);
+
+/**
+ * If a is not empty, the function appends \a b to \a a and adds a separator.
+ * Otherwise, this function shall return \a b
+ */
+static QString append_str (const QString a, QString b)
+{
+    if (a.isEmpty())
+        return b;
+
+    else
+        return a + " | " + b;
+}
+
+/**
+ * Returns a valid FPS value, \a maxFps is the highest rate allowed by the
+ * camera (see \c QCCTV_MAX_HIGH_FPS) and \a minFps is the lowest rate
+ * allowed (see \c QCCTV_MIN_STATION_FPS)
+ */
+int QCCTV_ValidFps (const int fps, const int maxFps, const int minFps)
+{
+    int limit = qMax (qMin (maxFps, QCCTV_MAX_HIGH_FPS), QCCTV_MAX_FPS);
+    return qMax (qMin (fps, limit), minFps);
+}
+
+/**
+ * Returns a valid bitrate value (zero is valid, it disables rate control)
+ */
+int QCCTV_ValidBitrate (const int bitrate)
+{
+    if (bitrate <= 0)
+        return 0;
+
+    return qMax (qMin (bitrate, QCCTV_MAX_BITRATE), QCCTV_MIN_BITRATE);
+}
+
+/**
+ * Returns a valid watchdog timeout value, the timeout is a fixed number of
+ * frame intervals (so it gets shorter as the FPS goes up)
+ */
+int QCCTV_GetWatchdogTime (const int fps)
+{
+    int time = QCCTV_WATCHDOG_FRAMES * 1000 / qMax (fps, 1);
+    return qMax (QCCTV_MIN_WATCHDOG_TIME,
+                 qMin (time, QCCTV_MAX_WATCHDOG_TIME));
+}
+
+/**
+ * Parses the given status flags as a string
+ */
+QString QCCTV_GetStatusString (const int status)
+{
+    QString str;
+
+    if (status & QCCTV_CAMSTATUS_LIGHT_FAILURE)
+        str = append_str (str, QObject::tr ("Flashlight Failure"));
+
+    if (status & QCCTV_CAMSTATUS_VIDEO_FAILURE)
+        str = append_str (str, QObject::tr ("Video Failure"));
+
+    if (status == QCCTV_CAMSTATUS_DEFAULT)
+        str = QObject::tr ("Camera OK");
+
+    return str;
+}
+
+/**
+ * Returns the available image resolutions
+ */
+extern QStringList QCCTV_Resolutions()
+{
+    QStringList list;
+
+    list.append (QObject::tr ("QCIF (176x120)"));
+    list.append (QObject::tr ("CIF (352x240)"));
+    list.append (QObject::tr ("2CIF (704x240)"));
+    list.append (QObject::tr ("4CIF (704x480)"));
+    list.append (QObject::tr ("D1 (720x480)"));
+    list.append (QObject::tr ("720p (1280x720)"));
+    list.append (QObject::tr ("960p (1280x960)"));
+    list.append (QObject::tr ("Original Resolution"));
+
+    return list;
+}
+
+/**
+ * Gets the frame size for the given \a resolution
+ */
+QSize QCCTV_GetResolution (const int resolution)
+{
+    int width = 0;
+    int height = 0;
+
+    switch ((QCCTV_Resolution) resolution) {
+    case QCCTV_QCIF:
+        width = 176;
+        height = 144;
+        break;
+    case QCCTV_CIF:
+        width = 352;
+        height = 240;
+        break;
+    case QCCTV_2CIF:
+        width = 704;
+        height = 240;
+        break;
+    case QCCTV_4CIF:
+        width = 704;
+        height = 480;
+        break;
+    case QCCTV_D1:
+        width = 720;
+        height = 480;
+        break;
+    case QCCTV_720p:
+        width = 1280;
+        height = 720;
+        break;
+    case QCCTV_960p:
+        width = 1280;
+        height = 960;
+        break;
+    default:
+        width = -1;
+        height = -1;
+        break;
+    }
+
+    return QSize (width, height);
+}
+
+/**
+ * Scales the given \a image to fit in the given \a res (resolution)
+ */
+QImage QCCTV_ScaleImage (const QImage& image, const int res)
+{
+    /* Get resolution */
+    QSize size = QCCTV_GetResolution (res);
+    if (res == QCCTV_Original)
+        size = image.size();
+
+    /* Image is already scaled */
+    if (image.size() == size)
+        return image;
+
+    /* Downscale the image with area averaging (avoids aliasing) */
+    QSize scaled = image.size().scaled (size, Qt::KeepAspectRatio);
+    if (scaled.width() <= image.width() && scaled.height() <= image.height())
+        return QCCTV_DownscaleImage (image, scaled, QCCTV_SCALE_AREA);
+
+    /* Upscale the image */
+    return image.scaled (size, Qt::KeepAspectRatio, Qt::FastTransformation);
+}
+
+/**
+ * Returns the raw bytes of the encoded \a image
+ */
+QByteArray QCCTV_EncodeImage (const QImage& image, const int res,
+                              const int quality)
+{
+    /* Scale the image */
+    QImage final = QCCTV_ScaleImage (image, res);
+
+    /* Save image to byte array */
+    QByteArray raw_bytes;
+    QBuffer buffer (&raw_bytes);
+    final.save (&buffer, "jpg", quality);
+    buffer.close();
+
+    /* Return image bytes */
+    return raw_bytes;
+}
+
+/**
+ * Returns the JPEG quality that should produce \a target bytes, given that
+ * the last frame was encoded at \a quality and produced \a size bytes.
+ *
+ * The size of a JPEG image is roughly inversely proportional to the scale
+ * factor that libjpeg applies to the quantization tables, so we scale that
+ * factor by the size error and convert it back to a quality value. Small
+ * errors are ignored to avoid oscillating between two quality values
+ */
+int QCCTV_EstimateQuality (const int quality, const qreal size,
+                           const qreal target)
+{
+    /* Invalid input */
+    if (size <= 0 || target <= 0)
+        return quality;
+
+    /* Size is close enough to the target */
+    qreal error = size / target;
+    if (error > 0.9 && error < 1.1)
+        return quality;
+
+    /* Get quantization scale factor (in percent) */
+    qreal scale;
+    int q = qMax (qMin (quality, QCCTV_MAX_QUALITY), 1);
+    if (q < 50)
+        scale = 5000.0 / q;
+    else
+        scale = qMax (200.0 - q * 2, 1.0);
+
+    /* Scale the factor by the size error (limit the step) */
+    scale *= qMax (qMin (error, 2.0), 0.5);
+
+    /* Get the quality for the new scale factor */
+    if (scale > 100)
+        q = qRound (5000 / scale);
+    else
+        q = qRound ((200 - scale) / 2);
+
+    /* Make sure that we move towards the target */
+    if (q == quality)
+        q += (error > 1) ? -1 : 1;
+
+    return qMax (qMin (q, QCCTV_MAX_QUALITY), QCCTV_MIN_QUALITY);
+}
+
+/**
+ * Generates a image from the given \a data
+ */
+QImage QCCTV_DecodeImage (const QByteArray& data)
+{
+    if (!data.isEmpty())
+        return QImage::fromData (data);
+
+    return QCCTV_CreateStatusImage (QSize (640, 480), "IMAGE ERROR");
+}
+
+/**
+ * Generates a \c QCCTV_MOTION_WIDTH x \c QCCTV_MOTION_HEIGHT luma plane from
+ * the given \a image, which can be used for motion detection.
+ *
+ * Each value is the average of the pixels that it covers, so that the noise
+ * of single pixels (e.g. in low light) is not detected as motion
+ */
+QByteArray QCCTV_CreateLumaPlane (const QImage& image)
+{
+    const QSize size (QCCTV_MOTION_WIDTH, QCCTV_MOTION_HEIGHT);
+    QImage gray = QCCTV_DownscaleImage (image, size, QCCTV_SCALE_AREA);
+    gray = gray.convertToFormat (QImage::Format_Grayscale8);
+
+    QByteArray luma;
+    for (int y = 0; y < gray.height(); ++y)
+        luma.append ((const char*) gray.constScanLine (y), gray.width());
+
+    return luma;
+}
+
+/**
+ * Returns the mean color saturation (0-255) of the given \a image, which is
+ * close to zero for monochrome (e.g. infrared) images.
+ *
+ * The saturation is measured on an area-averaged version of the image, so
+ * that the color noise of single pixels (e.g. in low light) is not taken as
+ * color
+ */
+int QCCTV_ChromaLevel (const QImage& image)
+{
+    if (image.isNull() || image.format() == QImage::Format_Grayscale8)
+        return 0;
+
+    const QSize size (QCCTV_MOTION_WIDTH, QCCTV_MOTION_HEIGHT);
+    QImage small = QCCTV_DownscaleImage (image, size, QCCTV_SCALE_AREA);
+    small = small.convertToFormat (QImage::Format_RGB32);
+
+    qint64 sum = 0;
+    for (int y = 0; y < small.height(); ++y) {
+        const QRgb* row = (const QRgb*) small.constScanLine (y);
+        for (int x = 0; x < small.width(); ++x) {
+            const int r = qRed (row [x]);
+            const int g = qGreen (row [x]);
+            const int b = qBlue (row [x]);
+            sum += qMax (r, qMax (g, b)) - qMin (r, qMin (g, b));
+        }
+    }
+
+    return sum / (small.width() * small.height());
+}
+
+/**
+ * Generates an image with the given \a size and \a text
+ */
+QImage QCCTV_CreateStatusImage (const QSize& size, const QString& text)
+{
+    /* Get initial SMPTE image */
+    QPixmap pixmap (":/qcctv/smpte.jpg");
+    pixmap = pixmap.scaled (size);
+    QPainter painter (&pixmap);
+
+    /* Get font information */
+    QFont font ("Arial", size.height() / 18, QFont::Bold);
+    QFontMetrics metrics (font);
+
+    /* Set painter font */
+    painter.setFont (font);
+    painter.setPen (Qt::white);
+
+    /* Draw text background */
+    int h = metrics.height() * 1.2;
+    int w = metrics.width (text) * 1.2;
+    int x = (size.width() - w) / 2;
+    int y = (size.height() - h) / 2;
+    painter.fillRect (QRectF (x, y, w, h), Qt::black);
+
+    /* Draw the text */
+    painter.drawText (QRectF (0, 0, size.width(), size.height()),
+                      Qt::AlignCenter, text);
+
+    /* Convert the pixmap to an image */
+    return pixmap.toImage();
+}
+
+/**
+ * Returns a valid region of interest (given in normalized coordinates).
+ * An empty rectangle means that the whole image is of interest
+ */
+QRectF QCCTV_ValidRegionOfInterest (const QRectF& roi)
+{
+    QRectF frame (0, 0, 1, 1);
+    QRectF valid = roi.normalized().intersected (frame);
+    if (valid.isEmpty() || valid == frame)
+        return QRectF();
+
+    return valid;
+}
+
+/**
+ * Flattens the areas of the \a image that are outside of the given \a roi
+ * (normalized coordinates) so that the encoder spends (almost) no bits on
+ * them. The ROI is aligned to the JPEG blocks, so its contents are encoded
+ * exactly as before
+ */
+QImage QCCTV_ApplyRegionOfInterest (const QImage& image, const QRectF& roi)
+{
+    /* Whole image is of interest */
+    QRectF valid = QCCTV_ValidRegionOfInterest (roi);
+    if (valid.isEmpty() || image.isNull())
+        return image;
+
+    /* Get the ROI in pixels, aligned to the JPEG blocks */
+    const int b = QCCTV_ROI_BLOCK_SIZE;
+    const int w = image.width();
+    const int h = image.height();
+    int x0 = qFloor (valid.left() * w / b) * b;
+    int y0 = qFloor (valid.top() * h / b) * b;
+    int x1 = qMin (qCeil (valid.right() * w / b) * b, w);
+    int y1 = qMin (qCeil (valid.bottom() * h / b) * b, h);
+    QRect rect (x0, y0, x1 - x0, y1 - y0);
+
+    /* Keep luma-only images in grayscale */
+    QImage::Format format = QImage::Format_RGB32;
+    if (image.format() == QImage::Format_Grayscale8)
+        format = QImage::Format_Grayscale8;
+
+    /* Flatten the whole image */
+    QImage source = image.convertToFormat (format);
+    QSize size = (image.size() / QCCTV_ROI_FLATTEN_FACTOR).expandedTo (QSize (1, 1));
+    QImage flat = QCCTV_DownscaleImage (source, size, QCCTV_SCALE_AREA);
+    flat = flat.scaled (image.size(),
+                        Qt::IgnoreAspectRatio,
+                        Qt::SmoothTransformation);
+    flat = flat.convertToFormat (format);
+
+    /* Copy the region of interest */
+    const int bpp = source.depth() / 8;
+    for (int y = rect.top(); y <= rect.bottom(); ++y)
+        memcpy (flat.scanLine (y) + rect.left() * bpp,
+                source.constScanLine (y) + rect.left() * bpp,
+                rect.width() * bpp);
+
+    return flat;
+}
+
+/**
+ * Returns a valid crop rectangle (given in normalized coordinates). The crop
+ * is enlarged around its center to \c QCCTV_MIN_CROP_SIZE if needed and
+ * moved inside the frame. An empty rectangle means that the whole image is
+ * streamed
+ */
+QRectF QCCTV_ValidCrop (const QRectF& crop)
+{
+    /* Crop is empty or contains the whole frame */
+    QRectF valid = QCCTV_ValidRegionOfInterest (crop);
+    if (valid.isEmpty())
+        return QRectF();
+
+    /* Limit the zoom factor */
+    QPointF center = valid.center();
+    valid.setWidth (qMax (valid.width(), (qreal) QCCTV_MIN_CROP_SIZE));
+    valid.setHeight (qMax (valid.height(), (qreal) QCCTV_MIN_CROP_SIZE));
+    valid.moveCenter (center);
+
+    /* Keep the crop inside the frame */
+    valid.moveLeft (qMax ((qreal) 0, qMin (valid.left(), 1 - valid.width())));
+    valid.moveTop (qMax ((qreal) 0, qMin (valid.top(), 1 - valid.height())));
+    return valid;
+}
+
+/**
+ * Returns the region of the (full-resolution) \a image given by the \a crop
+ * rectangle (in normalized coordinates)
+ */
+QImage QCCTV_CropImage (const QImage& image, const QRectF& crop)
+{
+    if (crop.isEmpty() || image.isNull())
+        return image;
+
+    QRect rect (qFloor (crop.x() * image.width()),
+                qFloor (crop.y() * image.height()),
+                qMax (qRound (crop.width() * image.width()), 1),
+                qMax (qRound (crop.height() * image.height()), 1));
+
+    return image.copy (rect.intersected (image.rect()));
+}
+
+/**
+ * Returns \c true if the given \a address belongs to this host
+ */
+bool QCCTV_IsLocalAddress (const QHostAddress& address)
+{
+    if (address.isLoopback())
+        return true;
+
+    /* Compare IPv4-mapped addresses as IPv4 addresses */
+    bool ipv4 = false;
+    QHostAddress mapped (address.toIPv4Address (&ipv4));
+    foreach (QHostAddress local, QNetworkInterface::allAddresses()) {
+        if (local == address || (ipv4 && local == mapped))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Writes the given \a header followed by \a length bytes of \a data to the
+ * given TCP \a socket.
+ *
+ * On Linux, if nothing is waiting in the write buffer of the socket, both
+ * parts are handed to the kernel with a single vectored write. The data is
+ * not copied to the write buffer of the socket first, which matters when
+ * the same frame is sent to many stations. Whatever the kernel does not
+ * accept (or everything, on other systems) is written through the socket.
+ *
+ * Returns the number of bytes handed to the kernel directly, the socket
+ * does not report them with its \c bytesWritten() signal
+ */
+qint64 QCCTV_WriteSocket (QTcpSocket* socket, const QByteArray& header,
+                          const char* data, const qint64 length)
+{
+    qint64 written = 0;
+
+#ifdef Q_OS_LINUX
+    if (socket->bytesToWrite() == 0 &&
+        socket->state() == QAbstractSocket::ConnectedState &&
+        socket->socketDescriptor() != -1) {
+        struct iovec iov[2];
+        iov[0].iov_base = (void*) header.constData();
+        iov[0].iov_len = header.size();
+        iov[1].iov_base = (void*) data;
+        iov[1].iov_len = length;
+
+        struct msghdr msg;
+        memset (&msg, 0, sizeof (msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 2;
+
+        ssize_t bytes = ::sendmsg (socket->socketDescriptor(), &msg,
+                                   MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (bytes > 0)
+            written = bytes;
+    }
+#endif
+
+    /* Write the rest of the header */
+    qint64 direct = written;
+    if (written < header.size()) {
+        socket->write (header.constData() + written, header.size() - written);
+        written = header.size();
+    }
+
+    /* Write the rest of the data */
+    qint64 offset = written - header.size();
+    if (offset < length)
+        socket->write (data + offset, length - offset);
+
+    return direct;
+}
+
+/**
+ * Returns the SIMD instruction sets (see \c QCCTV_SimdFlags) supported by
+ * the build and by the CPU
+ */
+int QCCTV_SupportedSimd()
+{
+    int flags = QCCTV_SIMD_NONE;
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    flags |= QCCTV_SIMD_SSE2;
+#endif
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports ("avx2"))
+        flags |= QCCTV_SIMD_AVX2;
+#endif
+#if defined (ARM_NEON_ENABLE) || defined (__ARM_NEON) || defined (__ARM_NEON__)
+    flags |= QCCTV_SIMD_NEON;
+#endif
+
+    return flags;
+}
+
+/**
+ * Returns the SIMD instruction sets used by the image kernels, which are
+ * all the supported sets unless \c QCCTV_SetEnabledSimd() was called
+ */
+int QCCTV_EnabledSimd()
+{
+    int flags = ENABLED_SIMD.loadAcquire();
+    if (flags < 0) {
+        flags = QCCTV_SupportedSimd();
+        ENABLED_SIMD.storeRelease (flags);
+    }
+
+    return flags;
+}
+
+/**
+ * Restricts the image kernels to the given SIMD instruction set \a flags
+ * (unsupported sets are ignored). This is used by the tests and benchmarks
+ * to compare each set with the plain C++ code
+ */
+void QCCTV_SetEnabledSimd (const int flags)
+{
+    ENABLED_SIMD.storeRelease (flags & QCCTV_SupportedSimd());
+}
@@ -1,100 +1,344 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#ifndef _QCCTV_GLOBAL_H
-#define _QCCTV_GLOBAL_H
-
-#include <QImage>
-#include <QString>
-#include <QHostAddress>
-
-/*
- * Set network ports
- */
-#define QCCTV_INFO_PORT      1050
-#define QCCTV_STREAM_PORT    1100
-#define QCCTV_COMMAND_PORT   1150
-#define QCCTV_REQUEST_PORT   1200
-#define QCCTV_DISCOVERY_PORT 1250
-
-/*
- * Image encoding
- */
-#define QCCTV_MIN_FPS         5
-#define QCCTV_MAX_FPS         30
-#define QCCTV_MAX_BUFFER_SIZE 250 * 1024
-#define QCCTV_RECORDINGS_PATH QDir::homePath() + "/Documents/QCCTV/"
-
-/*
- * Watchdog timings
- */
-#define QCCTV_MIN_WATCHDOG_TIME 500
-#define QCCTV_MAX_WATCHDOG_TIME 3000
-
-/*
- * Ugly OS fixes
- */
-#if defined (Q_OS_LINUX) || defined (Q_OS_ANDROID)
-    #define QCCTV_USE_FALLBACK_INTERFACE
-#else
-    #ifdef QCCTV_USE_FALLBACK_INTERFACE
-        #undef QCCTV_USE_FALLBACK_INTERFACE
-    #endif
-#endif
-
-/*
- * Camera status flags
- */
-enum QCCTV_CameraStatus {
-    QCCTV_CAMSTATUS_DEFAULT       = 0b0,
-    QCCTV_CAMSTATUS_VIDEO_FAILURE = 0b10,
-    QCCTV_CAMSTATUS_LIGHT_FAILURE = 0b100,
-};
-
-/*
- * Image resolutions
- */
-enum QCCTV_Resolution {
-    QCCTV_QCIF     = 0x00,
-    QCCTV_CIF      = 0x01,
-    QCCTV_2CIF     = 0x02,
-    QCCTV_4CIF     = 0x03,
-    QCCTV_D1       = 0x04,
-    QCCTV_720p     = 0x05,
-    QCCTV_960p     = 0x06,
-    QCCTV_Original = 0x07
-};
-
-/*
- * Misc functions
- */
-extern QStringList QCCTV_Resolutions();
-extern int QCCTV_ValidFps (const int fps);
-extern int QCCTV_GetWatchdogTime (const int fps);
-extern QSize QCCTV_GetResolution (const int resolution);
-extern QString QCCTV_GetStatusString (const int status);
-extern QImage QCCTV_DecodeImage (const QByteArray& data);
-extern QByteArray QCCTV_EncodeImage (const QImage& image, const int res);
-extern QImage QCCTV_CreateStatusImage (const QSize& size, const QString& text);
-
-#endif
-
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_GLOBAL_H
+#define _QCCTV_GLOBAL_H
+
+#include <QImage>
+#include <QRectF>
+#include <QString>
+#include <QHostAddress>
+
+class QTcpSocket;
+
+/*
+ * Set network ports
+ */
+#define QCCTV_INFO_PORT      1050
+#define QCCTV_STREAM_PORT    1100
+#define QCCTV_COMMAND_PORT   1150
+#define QCCTV_REQUEST_PORT   1200
+#define QCCTV_DISCOVERY_PORT 1250
+#define QCCTV_SESSION_PORT   1300
+
+/*
+ * Image encoding
+ */
+#define QCCTV_MIN_FPS         5
+#define QCCTV_MAX_FPS         30
+#define QCCTV_MAX_BUFFER_SIZE 250 * 1024
+#define QCCTV_RECORDINGS_PATH QDir::homePath() + "/Documents/QCCTV/"
+
+/*
+ * High frame rate mode, the FPS can go above QCCTV_MAX_FPS (up to the
+ * given value) if the capture device and all the stations support it
+ */
+#define QCCTV_MAX_HIGH_FPS 120
+
+/*
+ * Stations that receive the images at their own rate can ask for rates
+ * below QCCTV_MIN_FPS, down to the idle FPS floor (the camera still
+ * captures at QCCTV_MIN_FPS or more to detect motion)
+ */
+#define QCCTV_MIN_STATION_FPS QCCTV_MIN_IDLE_FPS
+
+/*
+ * JPEG rate control (bitrates are given in kbit/s, zero disables the rate
+ * control and images are encoded at the maximum quality)
+ */
+#define QCCTV_MIN_QUALITY     10
+#define QCCTV_MAX_QUALITY     100
+#define QCCTV_DEFAULT_QUALITY 85
+#define QCCTV_MIN_BITRATE     64
+#define QCCTV_MAX_BITRATE     20000
+#define QCCTV_DEFAULT_BITRATE 2000
+
+/*
+ * Frame types (first byte of the image data, full JPEG images start with
+ * the 0xFF 0xD8 marker and are sent without a frame type)
+ */
+#define QCCTV_FRAME_DELTA    0x01
+#define QCCTV_FRAME_TABLES   0x02
+#define QCCTV_FRAME_SNAPSHOT 0x03
+
+/*
+ * On-demand snapshots (full-resolution images sent out-of-band), the quality
+ * is lowered in steps until the snapshot fits in the snapshot buffer
+ */
+#define QCCTV_SNAPSHOT_QUALITY      95
+#define QCCTV_SNAPSHOT_QUALITY_STEP 10
+#define QCCTV_MAX_SNAPSHOT_SIZE     4 * 1024 * 1024
+#define QCCTV_SNAPSHOT_TIMEOUT      10000
+
+/*
+ * Delta frames (conditional replenishment), the threshold is the mean
+ * absolute difference of a block and the max. change is given in percent
+ */
+#define QCCTV_DELTA_BLOCK_SIZE  16
+#define QCCTV_DELTA_THRESHOLD   6
+#define QCCTV_DELTA_MAX_CHANGE  60
+#define QCCTV_KEYFRAME_INTERVAL 50
+
+/*
+ * Motion detection
+ */
+#define QCCTV_MOTION_WIDTH     64
+#define QCCTV_MOTION_HEIGHT    48
+#define QCCTV_MOTION_HOLD_TIME 3000
+#define QCCTV_MIN_IDLE_FPS     1
+#define QCCTV_DEFAULT_IDLE_FPS 1
+
+/*
+ * Station-side motion analysis (CPU budget is given in percent of a core)
+ */
+#define QCCTV_DEFAULT_ANALYSIS_BUDGET 10
+
+/*
+ * Temporal noise reduction (time budget is given in milliseconds per frame)
+ */
+#define QCCTV_DEFAULT_DENOISE_BUDGET 8
+
+/*
+ * Region of interest, the image outside of the ROI is downscaled by the
+ * flatten factor (and upscaled again) before encoding
+ */
+#define QCCTV_ROI_BLOCK_SIZE     16
+#define QCCTV_ROI_FLATTEN_FACTOR 8
+
+/*
+ * Digital PTZ, the crop size is given relative to the frame size (which
+ * limits the digital zoom factor)
+ */
+#define QCCTV_MIN_CROP_SIZE 0.1
+
+/*
+ * Luma-only streaming, the automatic mode switches to grayscale when the
+ * chroma level (mean color saturation, 0-255) of the image goes below the
+ * first value and back to color when it goes above the second value
+ */
+#define QCCTV_GRAYSCALE_ENTER_CHROMA 3
+#define QCCTV_GRAYSCALE_LEAVE_CHROMA 6
+
+/*
+ * Change-only info and command packets, a full packet (which is the base of
+ * the following packets) is sent at least once in the given interval (ms)
+ */
+#define QCCTV_FULL_STATE_INTERVAL 1000
+
+/*
+ * Flow control, number of frames that a station in a multiplexed session
+ * accepts before it acknowledges them (reduced while the frames wait to be
+ * displayed, but never below one frame)
+ */
+#define QCCTV_CREDIT_WINDOW 2
+
+/*
+ * Capability handshake, the camera and the station exchange their protocol
+ * version, capabilities and max. frame size when a multiplexed session
+ * starts and use the best common configuration. Peers that do not send a
+ * hello packet are assumed to use the first protocol version
+ */
+#define QCCTV_PROTOCOL_VERSION     1
+#define QCCTV_MIN_PROTOCOL_VERSION 1
+
+/*
+ * Multiplexed sessions, image frames are split in fragments so that control
+ * frames (info, commands and acks) can be sent between them. Data is only
+ * handed to the TCP socket while its write buffer is below the watermark
+ */
+#define QCCTV_SESSION_FRAGMENT_SIZE 16 * 1024
+#define QCCTV_SESSION_WATERMARK     64 * 1024
+
+/*
+ * Send pacing, each frame is spread over the given percentage of the frame
+ * interval (or sent at the bitrate target if that is faster). The burst is
+ * the number of bytes (tokens) that can be sent at once
+ */
+#define QCCTV_PACING_SPREAD         80
+#define QCCTV_DEFAULT_PACING_BURST  16 * 1024
+#define QCCTV_MIN_PACING_BURST      2 * 1024
+#define QCCTV_MAX_PACING_BURST      256 * 1024
+
+/*
+ * UDP image transport, frames are split in datagrams that fit in the usual
+ * MTU and an XOR parity datagram is sent for each group of fragments (zero
+ * disables the parity). Incomplete frames are dropped when a newer frame is
+ * complete, the number of incomplete frames kept is also limited
+ */
+#define QCCTV_UDP_FRAGMENT_SIZE  1200
+#define QCCTV_UDP_PARITY_GROUP   4
+#define QCCTV_UDP_PENDING_FRAMES 4
+
+/*
+ * Multicast delivery, the camera sends the shared stream once to a random
+ * group in the given range. Stations ask for lost frames through their
+ * session, the camera keeps the given number of sent frames for that and
+ * the station waits for them for the given time (ms) before giving up
+ */
+#define QCCTV_MULTICAST_PREFIX     "239.255.43."
+#define QCCTV_MULTICAST_PORT       1400
+#define QCCTV_UDP_HISTORY_FRAMES   8
+#define QCCTV_UDP_RETRANSMIT_TIME  200
+
+/*
+ * RTP/JPEG output (RFC 2435), default destination port and max. size of the
+ * JPEG data in each RTP packet
+ */
+#define QCCTV_RTP_PORT         5004
+#define QCCTV_RTP_PAYLOAD_SIZE 1400
+
+/*
+ * Shared-memory transport (camera and station in the same host), number of
+ * frame slots in the ring. Each slot holds one image packet
+ */
+#define QCCTV_SHARED_FRAME_SLOTS 4
+
+/*
+ * Station relay, each relayed camera is served on its own port (starting
+ * with the given port) and announced with the discovery packet
+ */
+#define QCCTV_RELAY_PORT           1450
+#define QCCTV_MAX_RELAYED_CAMERAS  32
+
+/*
+ * Watchdog timings
+ */
+#define QCCTV_MIN_WATCHDOG_TIME 500
+#define QCCTV_MAX_WATCHDOG_TIME 3000
+#define QCCTV_WATCHDOG_FRAMES   45
+
+/*
+ * Ugly OS fixes
+ */
+#if defined (Q_OS_LINUX) || defined (Q_OS_ANDROID)
+    #define QCCTV_USE_FALLBACK_INTERFACE
+#else
+    #ifdef QCCTV_USE_FALLBACK_INTERFACE
+        #undef QCCTV_USE_FALLBACK_INTERFACE
+    #endif
+#endif
+
+/*
+ * Camera status flags
+ */
+enum QCCTV_CameraStatus {
+    QCCTV_CAMSTATUS_DEFAULT       = 0b0,
+    QCCTV_CAMSTATUS_VIDEO_FAILURE = 0b10,
+    QCCTV_CAMSTATUS_LIGHT_FAILURE = 0b100,
+};
+
+/*
+ * Stream options
+ */
+enum QCCTV_StreamFlags {
+    QCCTV_STREAM_DEFAULT         = 0b0,
+    QCCTV_STREAM_DELTA_FRAMES    = 0b1,
+    QCCTV_STREAM_ABBREVIATED     = 0b10,
+    QCCTV_STREAM_NOISE_REDUCTION = 0b100,
+    QCCTV_STREAM_GRAYSCALE       = 0b1000,
+    QCCTV_STREAM_AUTO_GRAYSCALE  = 0b10000,
+};
+
+/*
+ * Protocol capabilities (frame formats and packet features)
+ */
+enum QCCTV_Capabilities {
+    QCCTV_CAP_NONE          = 0b0,
+    QCCTV_CAP_DELTA_FRAMES  = 0b1,
+    QCCTV_CAP_JPEG_TABLES   = 0b10,
+    QCCTV_CAP_SNAPSHOTS     = 0b100,
+    QCCTV_CAP_PARTIAL_STATE = 0b1000,
+    QCCTV_CAP_CREDITS       = 0b10000,
+    QCCTV_CAP_UDP_TRANSPORT = 0b100000,
+    QCCTV_CAP_MULTICAST     = 0b1000000,
+    QCCTV_CAP_SHARED_MEMORY = 0b10000000,
+    QCCTV_CAP_HIGH_FPS      = 0b100000000,
+    QCCTV_CAP_STATION_FPS   = 0b1000000000,
+    QCCTV_CAP_ALL           = 0b1111111111,
+};
+
+/*
+ * Image scaling modes
+ */
+enum QCCTV_ScaleMode {
+    QCCTV_SCALE_AREA     = 0x00,
+    QCCTV_SCALE_BILINEAR = 0x01,
+};
+
+/*
+ * SIMD instruction sets used by the image kernels (scaler and denoiser)
+ */
+enum QCCTV_SimdFlags {
+    QCCTV_SIMD_NONE = 0b0,
+    QCCTV_SIMD_SSE2 = 0b1,
+    QCCTV_SIMD_AVX2 = 0b10,
+    QCCTV_SIMD_NEON = 0b100,
+};
+
+/*
+ * Image resolutions
+ */
+enum QCCTV_Resolution {
+    QCCTV_QCIF     = 0x00,
+    QCCTV_CIF      = 0x01,
+    QCCTV_2CIF     = 0x02,
+    QCCTV_4CIF     = 0x03,
+    QCCTV_D1       = 0x04,
+    QCCTV_720p     = 0x05,
+    QCCTV_960p     = 0x06,
+    QCCTV_Original = 0x07
+};
+
+/*
+ * Misc functions
+ */
+extern QStringList QCCTV_Resolutions();
+extern int QCCTV_ValidFps (const int fps,
+                           const int maxFps = QCCTV_MAX_FPS,
+                           const int minFps = QCCTV_MIN_FPS);
+extern int QCCTV_ValidBitrate (const int bitrate);
+extern int QCCTV_GetWatchdogTime (const int fps);
+extern QSize QCCTV_GetResolution (const int resolution);
+extern QString QCCTV_GetStatusString (const int status);
+extern QImage QCCTV_DecodeImage (const QByteArray& data);
+extern QImage QCCTV_ScaleImage (const QImage& image, const int res);
+extern QByteArray QCCTV_CreateLumaPlane (const QImage& image);
+extern int QCCTV_ChromaLevel (const QImage& image);
+extern QByteArray QCCTV_EncodeImage (const QImage& image, const int res,
+                                     const int quality = QCCTV_MAX_QUALITY);
+extern int QCCTV_EstimateQuality (const int quality, const qreal size,
+                                  const qreal target);
+extern QImage QCCTV_CreateStatusImage (const QSize& size, const QString& text);
+extern QRectF QCCTV_ValidRegionOfInterest (const QRectF& roi);
+extern QImage QCCTV_ApplyRegionOfInterest (const QImage& image,
+                                           const QRectF& roi);
+extern QRectF QCCTV_ValidCrop (const QRectF& crop);
+extern QImage QCCTV_CropImage (const QImage& image, const QRectF& crop);
+extern bool QCCTV_IsLocalAddress (const QHostAddress& address);
+extern qint64 QCCTV_WriteSocket (QTcpSocket* socket, const QByteArray& header,
+                                 const char* data, const qint64 length);
+extern int QCCTV_SupportedSimd();
+extern int QCCTV_EnabledSimd();
+extern void QCCTV_SetEnabledSimd (const int flags);
+
+#endif
+
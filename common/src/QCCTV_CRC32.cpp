@@ -1,66 +1,66 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#include "QCCTV_CRC32.h"
-
-/**
- * Generates the CRC table during initialization
- */
-QCCTV_CRC32::QCCTV_CRC32()
-{
-    quint32 crc;
-
-    for (int i = 0; i < 256; i++) {
-        crc = i;
-        for (int j = 0; j < 8; j++)
-            crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320UL : crc >> 1;
-
-        crc_table[i] = crc;
-    }
-}
-
-/**
- * Overloaded function, calculates the CRC of the given byte array as a whole
- *
- * @param buf the data buffer
- */
-quint32 QCCTV_CRC32::compute (QByteArray buf)
-{
-    return compute (buf, buf.length());
-}
-
-/**
- * Adds the byte array to the data checksum.
- *
- * @param buf the data buffer
- * @param off the offset in the buffer where the data starts
- * @param len the length of the data
- */
-quint32 QCCTV_CRC32::compute (QByteArray buf, int len)
-{
-    quint32 crc = 0xFFFFFFFFUL;
-
-    for (int i = 0; i < len; ++i)
-        crc = crc_table [ (crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
-
-    return crc ^ 0xFFFFFFFFUL;
-}
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV_CRC32.h"
+
+/**
+ * Generates the CRC table during initialization
+ */
+QCCTV_CRC32::QCCTV_CRC32()
+{
+    quint32 crc;
+
+    for (int i = 0; i < 256; i++) {
+        crc = i;
+        for (int j = 0; j < 8; j++)
+            crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320UL : crc >> 1;
+
+        crc_table[i] = crc;
+    }
+}
+
+/**
+ * Overloaded function, calculates the CRC of the given byte array as a whole
+ *
+ * @param buf the data buffer
+ */
+quint32 QCCTV_CRC32::compute (QByteArray buf)
+{
+    return compute (buf, buf.length());
+}
+
+/**
+ * Adds the byte array to the data checksum.
+ *
+ * @param buf the data buffer
+ * @param off the offset in the buffer where the data starts
+ * @param len the length of the data
+ */
+quint32 QCCTV_CRC32::compute (QByteArray buf, int len)
+{
+    quint32 crc = 0xFFFFFFFFUL;
+
+    for (int i = 0; i < len; ++i)
+        crc = crc_table [ (crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+
+    return crc ^ 0xFFFFFFFFUL;
+}
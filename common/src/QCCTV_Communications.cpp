@@ -1,287 +1,1003 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#include "QCCTV_CRC32.h"
-#include "QCCTV_Communications.h"
-
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QJsonDocument>
-
-static QCCTV_CRC32 crc32;
-
-/* Stream packet keys */
-static const QString KEY_FPS        = "fps";
-static const QString KEY_ZOOM       = "zoom";
-static const QString KEY_NAME       = "name";
-static const QString KEY_GROUP      = "group";
-static const QString KEY_STATUS     = "status";
-static const QString KEY_RESOLUTION = "resolution";
-static const QString KEY_FLASHLIGHT = "flashlight";
-static const QString KEY_ZOOM_AVAIL = "zoomSupported";
-static const QString KEY_AUTOREGRES = "autoRegulateResolution";
-
-/* Command packet keys */
-static const QString KEY_HOST = "host";
-static const QString KEY_OLD_FPS = "o_fps";
-static const QString KEY_NEW_FPS = "n_fps";
-static const QString KEY_OLD_ZOOM = "o_zoom";
-static const QString KEY_NEW_ZOOM = "n_zoom";
-static const QString KEY_FOCUS_REQUEST  = "focus";
-static const QString KEY_OLD_RESOLUTION = "o_res";
-static const QString KEY_NEW_RESOLUTION = "n_res";
-static const QString KEY_OLD_FLASHLIGHT = "o_flashlight";
-static const QString KEY_NEW_FLASHLIGHT = "n_flashlight";
-static const QString KEY_OLD_AUTOREGRES = "o_autoRegulateResolution";
-static const QString KEY_NEW_AUTOREGRES = "n_autoRegulateResolution";
-
-/**
- * Initializes the default values for the given stream \a packet
- */
-void QCCTV_InitInfo (QCCTV_InfoPacket* packet)
-{
-    if (packet) {
-        packet->fps = 10;
-        packet->zoom = 0;
-        packet->cameraName = "";
-        packet->supportsZoom = false;
-        packet->cameraGroup = "Default";
-        packet->flashlightEnabled = false;
-        packet->resolution = QCCTV_Original;
-        packet->autoRegulateResolution = true;
-        packet->cameraStatus = QCCTV_CAMSTATUS_DEFAULT;
-    }
-}
-
-/**
- * Initializes the default values for the given image \a packet
- */
-void QCCTV_InitImage (QCCTV_ImagePacket* packet)
-{
-    if (packet) {
-        packet->crc32 = 0;
-        packet->image = QCCTV_CreateStatusImage (QSize (640, 480),
-                                                 "NO CAMERA IMAGE");
-    }
-}
-
-/**
- * Initializes the variables of the given \a command packet with the
- * values in the given \a stream packet
- */
-void QCCTV_InitCommand (QCCTV_CommandPacket* command,
-                        QCCTV_InfoPacket* stream)
-{
-    if (command && stream) {
-        command->focusRequest = false;
-        command->newFps = stream->fps;
-        command->oldFps = stream->fps;
-        command->oldZoom = stream->zoom;
-        command->newZoom = stream->zoom;
-        command->oldResolution = stream->resolution;
-        command->newResolution = stream->resolution;
-        command->oldFlashlightEnabled = stream->flashlightEnabled;
-        command->newFlashlightEnabled = stream->flashlightEnabled;
-        command->oldAutoRegulateResolution = stream->autoRegulateResolution;
-        command->newAutoRegulateResolution = stream->autoRegulateResolution;
-    }
-}
-
-/**
- * Generates an image packet using \c QCCTV_CreateImagePacket and writes it
- * on the given \a output byte array
- */
-void QCCTV_WriteImagePacket (QByteArray* output,
-                             const QCCTV_ImagePacket* image,
-                             const QCCTV_InfoPacket* info)
-{
-    output->clear();
-    *output = QCCTV_CreateImagePacket (image, info);
-}
-
-/**
- * Reads the given stream \a packet and generates the binary data that can be
- * sent through a network socket to a connected QCCTV Station
- */
-QByteArray QCCTV_CreateInfoPacket (const QCCTV_InfoPacket* packet)
-{
-    QJsonObject json;
-    json.insert (KEY_FPS, packet->fps);
-    json.insert (KEY_ZOOM, packet->zoom);
-    json.insert (KEY_NAME, packet->cameraName);
-    json.insert (KEY_GROUP, packet->cameraGroup);
-    json.insert (KEY_STATUS, packet->cameraStatus);
-    json.insert (KEY_RESOLUTION, packet->resolution);
-    json.insert (KEY_ZOOM_AVAIL, packet->supportsZoom);
-    json.insert (KEY_FLASHLIGHT, packet->flashlightEnabled);
-    json.insert (KEY_AUTOREGRES, packet->autoRegulateResolution);
-    return QJsonDocument (json).toBinaryData();
-}
-
-/**
- * Reads the given command \a packet and generates the binary data that can be
- * sent through a network socket to a connected QCCTV Camera
- */
-QByteArray QCCTV_CreateCommandPacket (const QCCTV_CommandPacket* packet)
-{
-    QJsonObject json;
-    json.insert (KEY_HOST, packet->host);
-    json.insert (KEY_OLD_FPS, packet->oldFps);
-    json.insert (KEY_NEW_FPS, packet->newFps);
-    json.insert (KEY_OLD_ZOOM, packet->oldZoom);
-    json.insert (KEY_NEW_ZOOM, packet->newZoom);
-    json.insert (KEY_FOCUS_REQUEST, packet->focusRequest);
-    json.insert (KEY_OLD_RESOLUTION, packet->oldResolution);
-    json.insert (KEY_NEW_RESOLUTION, packet->newResolution);
-    json.insert (KEY_OLD_FLASHLIGHT, packet->oldFlashlightEnabled);
-    json.insert (KEY_NEW_FLASHLIGHT, packet->newFlashlightEnabled);
-    json.insert (KEY_OLD_AUTOREGRES, packet->oldAutoRegulateResolution);
-    json.insert (KEY_NEW_AUTOREGRES, packet->newAutoRegulateResolution);
-    return QJsonDocument (json).toBinaryData();
-}
-
-/**
- * Reads the given image \a packet and \a info packet and generates a
- * binary image and its respective CRC32 bits
- */
-QByteArray QCCTV_CreateImagePacket (const QCCTV_ImagePacket* packet,
-                                    const QCCTV_InfoPacket* info)
-{
-    /* Add image data */
-    QByteArray data = QCCTV_EncodeImage (packet->image, info->resolution);
-    QByteArray comp = qCompress (data, 9);
-
-    /* Add the cheksum at the start of the data */
-    quint32 crc = crc32.compute (comp);
-    comp.prepend ((crc & 0xff));
-    comp.prepend ((crc & 0xff00) >> 8);
-    comp.prepend ((crc & 0xff0000) >> 16);
-    comp.prepend ((crc & 0xff000000) >> 24);
-
-    /* Return obtained data */
-    return comp;
-}
-
-/**
- * Reads the given \a binary data and updates the values of the given stream
- * \a packet structure
- *
- * This function shall return \c true on success, \c false on failure
- */
-bool QCCTV_ReadInfoPacket (QCCTV_InfoPacket* packet, const QByteArray& data)
-{
-    /* Packet pointer is invalid and/or data incomplete */
-    if (!packet || data.isEmpty())
-        return false;
-
-    /* Get JSON object from data */
-    QJsonObject json = QJsonDocument::fromBinaryData (data).object();
-    if (json.isEmpty())
-        return false;
-
-    /* Get information from JSON object */
-    packet->fps = json.value (KEY_FPS).toInt();
-    packet->zoom = json.value (KEY_ZOOM).toInt();
-    packet->cameraName = json.value (KEY_NAME).toString();
-    packet->cameraStatus = json.value (KEY_STATUS).toInt();
-    packet->cameraGroup = json.value (KEY_GROUP).toString();
-    packet->resolution = json.value (KEY_RESOLUTION).toInt();
-    packet->supportsZoom = json.value (KEY_ZOOM_AVAIL).toBool();
-    packet->flashlightEnabled = json.value (KEY_FLASHLIGHT).toBool();
-    packet->autoRegulateResolution = json.value (KEY_AUTOREGRES).toBool();
-
-    /* Packet read successfully */
-    return true;
-}
-
-/**
- * Obtains the image from the given \a data (only if CRC32 codes match)
- */
-bool QCCTV_ReadImagePacket (QCCTV_ImagePacket* packet, const QByteArray& data)
-{
-    if (!packet || data.length() < 4)
-        return false;
-
-    /* Get the checksum */
-    quint8 a = data.at (0);
-    quint8 b = data.at (1);
-    quint8 c = data.at (2);
-    quint8 d = data.at (3);
-    packet->crc32 = (a << 24) | (b << 16) | (c << 8) | (d & 0xff);
-
-    /* Create byte array without checksum header */
-    QByteArray stream = data;
-    stream.remove (0, 4);
-
-    /* Compare checksums (abort if they are different) */
-    quint32 crc = crc32.compute (stream);
-    if (packet->crc32 != crc)
-        return false;
-
-    /* Read image */
-    packet->image = QCCTV_DecodeImage (qUncompress (stream));
-    return !packet->image.isNull();
-}
-
-/**
- * Reads the given \a binary data and updates the values of the given command
- * \a packet structure
- *
- * This function shall return \c true on success, \c false on failure
- */
-bool QCCTV_ReadCommandPacket (QCCTV_CommandPacket* packet,
-                              const QByteArray& data)
-{
-    /* Packet pointer is invalid and/or data incomplete */
-    if (!packet || data.isEmpty())
-        return false;
-
-    /* Get JSON object from data */
-    QJsonObject json = QJsonDocument::fromBinaryData (data).object();
-    if (json.isEmpty())
-        return false;
-
-    /* Get information from JSON object */
-    packet->host = json.value (KEY_HOST).toString();
-    packet->oldFps = json.value (KEY_OLD_FPS).toInt();
-    packet->newFps = json.value (KEY_NEW_FPS).toInt();
-    packet->oldZoom = json.value (KEY_OLD_ZOOM).toInt();
-    packet->newZoom = json.value (KEY_NEW_ZOOM).toInt();
-    packet->focusRequest = json.value (KEY_FOCUS_REQUEST).toBool();
-    packet->oldResolution = json.value (KEY_OLD_RESOLUTION).toInt();
-    packet->newResolution = json.value (KEY_NEW_RESOLUTION).toInt();
-    packet->oldFlashlightEnabled = json.value (KEY_OLD_FLASHLIGHT).toBool();
-    packet->newFlashlightEnabled = json.value (KEY_NEW_FLASHLIGHT).toBool();
-    packet->oldAutoRegulateResolution = json.value (KEY_OLD_AUTOREGRES).toBool();
-    packet->newAutoRegulateResolution = json.value (KEY_NEW_AUTOREGRES).toBool();
-
-    /* Check command flags have changed since last packet */
-    packet->fpsChanged = (packet->oldFps != packet->newFps);
-    packet->zoomChanged = (packet->oldZoom != packet->newZoom);
-    packet->resolutionChanged = (packet->oldResolution != packet->newResolution);
-    packet->flashlightEnabledChanged = (packet->oldFlashlightEnabled != packet->newFlashlightEnabled);
-    packet->autoRegulateResolutionChanged = (packet->oldAutoRegulateResolution !=
-                                             packet->newAutoRegulateResolution);
-
-    /* Packet read successfully */
-    return true;
-}
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV_CRC32.h"
+#include "QCCTV_DeltaFrame.h"
+#include "QCCTV_JpegTables.h"
+#include "QCCTV_Communications.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+static QCCTV_CRC32 crc32;
+
+/**
+ * Returns the offset of the JPEG data in the given frame \a data
+ */
+static int jpeg_offset (const QByteArray& data)
+{
+    if (QCCTV_IsDeltaFrame (data))
+        return QCCTV_DeltaFrameHeaderLength (data);
+
+    return 0;
+}
+
+/**
+ * Compresses the given frame \a data with the given zlib compression
+ * \a level and prepends the CRC32 checksum of the compressed data
+ */
+static QByteArray pack_frame (const QByteArray& data, const int level)
+{
+    /* Compress the data */
+    QByteArray comp = qCompress (data, level);
+
+    /* Add the cheksum at the start of the data */
+    quint32 crc = crc32.compute (comp);
+    comp.prepend ((crc & 0xff));
+    comp.prepend ((crc & 0xff00) >> 8);
+    comp.prepend ((crc & 0xff0000) >> 16);
+    comp.prepend ((crc & 0xff000000) >> 24);
+
+    /* Return obtained data */
+    return comp;
+}
+
+/**
+ * Removes the quantization and Huffman tables from the JPEG data of the given
+ * frame \a data. The tables are prepended to the frame (as a tables frame)
+ * only if they changed since the last frame or if \a sendTables is \c true.
+ *
+ * \a complete is set to \c false if the frame does not carry the tables
+ */
+static QByteArray abbreviate_frame (QCCTV_ImagePacket* packet,
+                                    const QByteArray& data,
+                                    const bool sendTables,
+                                    bool* complete)
+{
+    /* Split the tables from the JPEG data */
+    *complete = true;
+    int offset = jpeg_offset (data);
+    QByteArray jpeg = data.mid (offset);
+    QByteArray tables = QCCTV_ExtractJpegTables (&jpeg);
+    if (tables.isEmpty() || tables.size() > 0xffff)
+        return data;
+
+    /* Get abbreviated frame */
+    QByteArray frame = data.left (offset);
+    frame.append (jpeg);
+
+    /* The stations already know the tables */
+    if (!sendTables && packet->tables == tables) {
+        *complete = false;
+        return frame;
+    }
+
+    /* Prepend the tables to the frame */
+    packet->tables = tables;
+    frame.prepend (tables);
+    frame.prepend ((char) (tables.size() & 0xff));
+    frame.prepend ((char) ((tables.size() & 0xff00) >> 8));
+    frame.prepend ((char) QCCTV_FRAME_TABLES);
+    return frame;
+}
+
+/**
+ * Reads the tables frame at the start of the given \a data (if any) and
+ * restores the abbreviated JPEG data of the frame with the tables of the
+ * \a packet.
+ *
+ * \a complete is set to \c true if the frame carried its own tables.
+ *
+ * This function shall return \c false if the JPEG data is abbreviated and
+ * we did not receive the tables yet
+ */
+static bool restore_frame (QCCTV_ImagePacket* packet, QByteArray* data,
+                           bool* complete)
+{
+    /* Read the tables */
+    *complete = false;
+    if (!data->isEmpty() && (quint8) data->at (0) == QCCTV_FRAME_TABLES) {
+        if (data->size() < 3)
+            return false;
+
+        int length = ((quint8) data->at (1) << 8) | (quint8) data->at (2);
+        packet->tables = data->mid (3, length);
+        data->remove (0, 3 + length);
+        *complete = true;
+    }
+
+    /* Frame has no JPEG data (e.g. empty delta frame) */
+    int offset = jpeg_offset (*data);
+    if (offset >= data->size())
+        return true;
+
+    /* JPEG data is complete */
+    QByteArray jpeg = data->mid (offset);
+    if (QCCTV_HasJpegTables (jpeg)) {
+        *complete = true;
+        return true;
+    }
+
+    /* We do not know the tables yet */
+    if (packet->tables.isEmpty())
+        return false;
+
+    /* Restore the JPEG data */
+    *data = data->left (offset);
+    data->append (QCCTV_RestoreJpegTables (jpeg, packet->tables));
+    return true;
+}
+
+/**
+ * Converts the given \a rect to a JSON array
+ */
+static QJsonArray rect_to_json (const QRectF& rect)
+{
+    QJsonArray array;
+    array.append (rect.x());
+    array.append (rect.y());
+    array.append (rect.width());
+    array.append (rect.height());
+    return array;
+}
+
+/**
+ * Obtains a rectangle from the given JSON \a value, an empty rectangle is
+ * returned if the value is not valid
+ */
+static QRectF json_to_rect (const QJsonValue& value)
+{
+    QJsonArray array = value.toArray();
+    if (array.count() != 4)
+        return QRectF();
+
+    return QRectF (array.at (0).toDouble(),
+                   array.at (1).toDouble(),
+                   array.at (2).toDouble(),
+                   array.at (3).toDouble());
+}
+
+/**
+ * Updates the quality estimate of the image \a packet after encoding
+ * \a pixels (out of \a area pixels) in \a bytes.
+ *
+ * The frame budget is obtained from the bitrate of the \a info packet and
+ * the rate at which the stream of the \a packet is delivered, and it is
+ * scaled by the number of encoded pixels, so that delta frames are encoded
+ * with the same quality as full frames
+ */
+static void update_quality (QCCTV_ImagePacket* packet,
+                            const QCCTV_InfoPacket* info,
+                            const int bytes,
+                            const int pixels,
+                            const int area)
+{
+    /* Rate control is disabled */
+    if (info->bitrate <= 0) {
+        packet->quality = QCCTV_MAX_QUALITY;
+        return;
+    }
+
+    /* Nothing was encoded */
+    if (pixels <= 0 || area <= 0)
+        return;
+
+    /* Get the target frame size (bytes) */
+    qreal target = info->bitrate * 125.0 / qMax (packet->fps, 1);
+    target = qMin (target, QCCTV_MAX_BUFFER_SIZE / 2.0);
+
+    /* Get quality for the next frame */
+    packet->quality = QCCTV_EstimateQuality (packet->quality, bytes,
+                                             target * pixels / area);
+}
+
+/* Stream packet keys */
+static const QString KEY_FPS        = "fps";
+static const QString KEY_MAX_FPS    = "maxFps";
+static const QString KEY_ZOOM       = "zoom";
+static const QString KEY_NAME       = "name";
+static const QString KEY_GROUP      = "group";
+static const QString KEY_STATUS     = "status";
+static const QString KEY_RESOLUTION = "resolution";
+static const QString KEY_FLASHLIGHT = "flashlight";
+static const QString KEY_ZOOM_AVAIL = "zoomSupported";
+static const QString KEY_AUTOREGRES = "autoRegulateResolution";
+static const QString KEY_MOTION_DET = "motionDetection";
+static const QString KEY_MOTION     = "motion";
+static const QString KEY_STREAM     = "stream";
+static const QString KEY_BITRATE    = "bitrate";
+static const QString KEY_QUALITY    = "quality";
+static const QString KEY_ROI        = "roi";
+static const QString KEY_GRAYSCALE  = "gray";
+static const QString KEY_MCAST_ADDR = "mcast";
+static const QString KEY_MCAST_PORT = "mport";
+static const QString KEY_SHM_KEY    = "shm";
+
+/* Packet state keys */
+static const QString KEY_GENERATION = "gen";
+static const QString KEY_FULL       = "full";
+
+/* Hello packet keys */
+static const QString KEY_VERSION        = "version";
+static const QString KEY_CAPABILITIES   = "caps";
+static const QString KEY_MAX_FRAME_SIZE = "maxFrame";
+
+/* Command packet keys */
+static const QString KEY_HOST = "host";
+static const QString KEY_OLD_FPS = "o_fps";
+static const QString KEY_NEW_FPS = "n_fps";
+static const QString KEY_REQUESTED_FPS = "r_fps";
+static const QString KEY_OLD_ZOOM = "o_zoom";
+static const QString KEY_NEW_ZOOM = "n_zoom";
+static const QString KEY_FOCUS_REQUEST  = "focus";
+static const QString KEY_KEYFRAME_REQUEST = "keyframe";
+static const QString KEY_SNAPSHOT_REQUEST = "snapshot";
+static const QString KEY_INFO_REQUEST = "info";
+static const QString KEY_CREDITS = "credits";
+static const QString KEY_UDP_PORT = "udp";
+static const QString KEY_UDP_PARITY = "parity";
+static const QString KEY_MULTICAST = "multicast";
+static const QString KEY_SHARED_MEMORY = "shm";
+static const QString KEY_OLD_RESOLUTION = "o_res";
+static const QString KEY_NEW_RESOLUTION = "n_res";
+static const QString KEY_OLD_FLASHLIGHT = "o_flashlight";
+static const QString KEY_NEW_FLASHLIGHT = "n_flashlight";
+static const QString KEY_OLD_AUTOREGRES = "o_autoRegulateResolution";
+static const QString KEY_NEW_AUTOREGRES = "n_autoRegulateResolution";
+static const QString KEY_OLD_STREAM = "o_stream";
+static const QString KEY_NEW_STREAM = "n_stream";
+static const QString KEY_OLD_BITRATE = "o_bitrate";
+static const QString KEY_NEW_BITRATE = "n_bitrate";
+static const QString KEY_OLD_ROI = "o_roi";
+static const QString KEY_NEW_ROI = "n_roi";
+static const QString KEY_CROP = "crop";
+
+/**
+ * Generates the binary data of the given \a json packet. If a full packet is
+ * not due (or forced with \a forceFull), only the fields that differ from
+ * the last full packet sent with the given \a state are written, and an
+ * empty byte array is returned if no field changed.
+ *
+ * Each full packet starts a new generation, the packets that follow it only
+ * make sense to receivers that got that full packet
+ */
+static QByteArray write_state (const QJsonObject& json,
+                               QCCTV_PacketState* state,
+                               const bool forceFull)
+{
+    /* Check if we need to send a full packet */
+    bool full = forceFull || !state->synchronized ||
+                state->clock.elapsed() >= QCCTV_FULL_STATE_INTERVAL;
+
+    /* Send all fields and make them the new base */
+    QJsonObject packet;
+    if (full) {
+        packet = json;
+        packet.insert (KEY_FULL, true);
+
+        state->base = json;
+        state->generation++;
+        state->synchronized = true;
+        state->clock.restart();
+    }
+
+    /* Only send the fields that changed since the last full packet */
+    else {
+        foreach (QString key, json.keys())
+            if (json.value (key) != state->base.value (key))
+                packet.insert (key, json.value (key));
+
+        if (packet.isEmpty())
+            return QByteArray();
+    }
+
+    /* Add generation and get binary data */
+    packet.insert (KEY_GENERATION, state->generation);
+    return QJsonDocument (packet).toBinaryData();
+}
+
+/**
+ * Reads the given binary \a data and obtains the complete packet (the last
+ * full packet of the given \a state with the received changes applied).
+ *
+ * This function shall return an empty object if the data is invalid or if
+ * we missed the full packet on which the data is based. Packets without a
+ * generation (sent by older versions) are treated as full packets
+ */
+static QJsonObject read_state (const QByteArray& data, QCCTV_PacketState* state)
+{
+    /* Get JSON object from data */
+    QJsonObject json = QJsonDocument::fromBinaryData (data).object();
+    if (json.isEmpty())
+        return QJsonObject();
+
+    /* Get generation and packet type */
+    int generation = json.value (KEY_GENERATION).toInt();
+    bool full = !json.contains (KEY_GENERATION) || json.value (KEY_FULL).toBool();
+    json.remove (KEY_GENERATION);
+    json.remove (KEY_FULL);
+
+    /* Full packet, use it as the new base */
+    if (full) {
+        state->base = json;
+        state->generation = generation;
+        state->synchronized = true;
+        return json;
+    }
+
+    /* We missed an update, wait for the next full packet */
+    if (!state->synchronized || state->generation != generation) {
+        state->synchronized = false;
+        return QJsonObject();
+    }
+
+    /* Apply the changes to the base */
+    QJsonObject packet = state->base;
+    foreach (QString key, json.keys())
+        packet.insert (key, json.value (key));
+
+    return packet;
+}
+
+/**
+ * Initializes the default values for the given stream \a packet
+ */
+void QCCTV_InitInfo (QCCTV_InfoPacket* packet)
+{
+    if (packet) {
+        packet->fps = 10;
+        packet->maxFps = QCCTV_MAX_FPS;
+        packet->zoom = 0;
+        packet->cameraName = "";
+        packet->supportsZoom = false;
+        packet->cameraGroup = "Default";
+        packet->flashlightEnabled = false;
+        packet->resolution = QCCTV_Original;
+        packet->autoRegulateResolution = true;
+        packet->motionDetectionEnabled = false;
+        packet->motionDetected = false;
+        packet->streamFlags = QCCTV_STREAM_DEFAULT;
+        packet->bitrate = QCCTV_DEFAULT_BITRATE;
+        packet->quality = QCCTV_DEFAULT_QUALITY;
+        packet->grayscale = false;
+        packet->regionOfInterest = QRectF();
+        packet->multicastGroup = "";
+        packet->multicastPort = 0;
+        packet->sharedMemoryKey = "";
+        packet->cameraStatus = QCCTV_CAMSTATUS_DEFAULT;
+    }
+}
+
+/**
+ * Initializes the default values for the given image \a packet
+ */
+void QCCTV_InitImage (QCCTV_ImagePacket* packet)
+{
+    if (packet) {
+        packet->crc32 = 0;
+        packet->jpeg.clear();
+        packet->tables.clear();
+        packet->keyframe = false;
+        packet->selfContained = false;
+        packet->snapshot = false;
+        packet->quality = QCCTV_DEFAULT_QUALITY;
+        packet->fps = 10;
+        packet->frameCount = 0;
+        packet->reference = QImage();
+        packet->keyframeRequested = true;
+        packet->crop = QRectF();
+        packet->capabilities = QCCTV_CAP_ALL;
+        packet->denoiser.reset();
+        packet->image = QCCTV_CreateStatusImage (QSize (640, 480),
+                                                 "NO CAMERA IMAGE");
+    }
+}
+
+/**
+ * Initializes the variables of the given \a command packet with the
+ * values in the given \a stream packet
+ */
+void QCCTV_InitCommand (QCCTV_CommandPacket* command,
+                        QCCTV_InfoPacket* stream)
+{
+    if (command && stream) {
+        command->focusRequest = false;
+        command->keyframeRequest = false;
+        command->infoRequest = false;
+        command->snapshotRequest = 0;
+        command->credits = -1;
+        command->udpPort = 0;
+        command->udpParity = QCCTV_UDP_PARITY_GROUP;
+        command->multicast = false;
+        command->sharedMemory = false;
+        command->newFps = stream->fps;
+        command->oldFps = stream->fps;
+        command->requestedFps = 0;
+        command->oldZoom = stream->zoom;
+        command->newZoom = stream->zoom;
+        command->oldResolution = stream->resolution;
+        command->newResolution = stream->resolution;
+        command->oldFlashlightEnabled = stream->flashlightEnabled;
+        command->newFlashlightEnabled = stream->flashlightEnabled;
+        command->oldAutoRegulateResolution = stream->autoRegulateResolution;
+        command->newAutoRegulateResolution = stream->autoRegulateResolution;
+        command->oldStreamFlags = stream->streamFlags;
+        command->newStreamFlags = stream->streamFlags;
+        command->oldBitrate = stream->bitrate;
+        command->newBitrate = stream->bitrate;
+        command->oldRegionOfInterest = stream->regionOfInterest;
+        command->newRegionOfInterest = stream->regionOfInterest;
+        command->crop = QRectF();
+    }
+}
+
+/**
+ * Initializes the given packet \a state, the first packet written or read
+ * with the state must be a full packet
+ */
+void QCCTV_InitState (QCCTV_PacketState* state)
+{
+    if (state) {
+        state->generation = 0;
+        state->synchronized = false;
+        state->base = QJsonObject();
+        state->clock.invalidate();
+    }
+}
+
+/**
+ * Initializes the given hello \a packet with the protocol version and the
+ * capabilities of this build
+ */
+void QCCTV_InitHello (QCCTV_HelloPacket* packet)
+{
+    if (packet) {
+        packet->version = QCCTV_PROTOCOL_VERSION;
+        packet->capabilities = QCCTV_CAP_ALL;
+        packet->maxFrameSize = QCCTV_MAX_SNAPSHOT_SIZE;
+    }
+}
+
+/**
+ * Initializes the given hello \a packet with the configuration of a peer
+ * that did not send us a hello packet (yet), which does not support any
+ * capability and only accepts frames that fit in the legacy stream buffer
+ */
+void QCCTV_InitLegacyHello (QCCTV_HelloPacket* packet)
+{
+    if (packet) {
+        packet->version = QCCTV_MIN_PROTOCOL_VERSION;
+        packet->capabilities = QCCTV_CAP_NONE;
+        packet->maxFrameSize = QCCTV_MAX_BUFFER_SIZE;
+    }
+}
+
+/**
+ * Obtains the best configuration supported by the \a local and \a remote
+ * peers (the lowest protocol version and frame size and the capabilities
+ * supported by both peers) and writes it to the given \a packet.
+ *
+ * This function shall return \c false if the remote peer uses a protocol
+ * version that we do not support anymore
+ */
+bool QCCTV_NegotiateHello (QCCTV_HelloPacket* packet,
+                           const QCCTV_HelloPacket* local,
+                           const QCCTV_HelloPacket* remote)
+{
+    if (!packet || !local || !remote)
+        return false;
+
+    if (remote->version < QCCTV_MIN_PROTOCOL_VERSION)
+        return false;
+
+    packet->version = qMin (local->version, remote->version);
+    packet->capabilities = local->capabilities & remote->capabilities;
+    packet->maxFrameSize = qMin (local->maxFrameSize, remote->maxFrameSize);
+    return true;
+}
+
+/**
+ * Returns the stream \a flags without the frame formats that are not
+ * supported by the given \a capabilities
+ */
+int QCCTV_SupportedStreamFlags (const int flags, const int capabilities)
+{
+    int supported = flags;
+
+    if (!(capabilities & QCCTV_CAP_DELTA_FRAMES))
+        supported &= ~QCCTV_STREAM_DELTA_FRAMES;
+    if (!(capabilities & QCCTV_CAP_JPEG_TABLES))
+        supported &= ~QCCTV_STREAM_ABBREVIATED;
+
+    return supported;
+}
+
+/**
+ * Generates an image packet using \c QCCTV_CreateImagePacket and writes it
+ * on the given \a output byte array
+ */
+void QCCTV_WriteImagePacket (QByteArray* output,
+                             QCCTV_ImagePacket* image,
+                             const QCCTV_InfoPacket* info)
+{
+    output->clear();
+    *output = QCCTV_CreateImagePacket (image, info);
+}
+
+/**
+ * Reads the given stream \a packet and generates the binary data that can be
+ * sent through a network socket to a connected QCCTV Station.
+ *
+ * Only the fields that changed since the last full packet of the \a state
+ * are sent (see \c write_state()), an empty byte array means that there is
+ * nothing to send
+ */
+QByteArray QCCTV_CreateInfoPacket (const QCCTV_InfoPacket* packet,
+                                   QCCTV_PacketState* state,
+                                   const bool forceFull)
+{
+    QJsonObject json;
+    json.insert (KEY_FPS, packet->fps);
+    json.insert (KEY_MAX_FPS, packet->maxFps);
+    json.insert (KEY_ZOOM, packet->zoom);
+    json.insert (KEY_NAME, packet->cameraName);
+    json.insert (KEY_GROUP, packet->cameraGroup);
+    json.insert (KEY_STATUS, packet->cameraStatus);
+    json.insert (KEY_RESOLUTION, packet->resolution);
+    json.insert (KEY_ZOOM_AVAIL, packet->supportsZoom);
+    json.insert (KEY_FLASHLIGHT, packet->flashlightEnabled);
+    json.insert (KEY_AUTOREGRES, packet->autoRegulateResolution);
+    json.insert (KEY_MOTION_DET, packet->motionDetectionEnabled);
+    json.insert (KEY_MOTION, packet->motionDetected);
+    json.insert (KEY_STREAM, packet->streamFlags);
+    json.insert (KEY_BITRATE, packet->bitrate);
+    json.insert (KEY_QUALITY, packet->quality);
+    json.insert (KEY_GRAYSCALE, packet->grayscale);
+    json.insert (KEY_ROI, rect_to_json (packet->regionOfInterest));
+    json.insert (KEY_MCAST_ADDR, packet->multicastGroup);
+    json.insert (KEY_MCAST_PORT, packet->multicastPort);
+    json.insert (KEY_SHM_KEY, packet->sharedMemoryKey);
+    return write_state (json, state, forceFull);
+}
+
+/**
+ * Reads the given command \a packet and generates the binary data that can be
+ * sent through a network socket to a connected QCCTV Camera.
+ *
+ * Only the fields that changed since the last full packet of the \a state
+ * are sent (see \c write_state()), an empty byte array means that there is
+ * nothing to send
+ */
+QByteArray QCCTV_CreateCommandPacket (const QCCTV_CommandPacket* packet,
+                                      QCCTV_PacketState* state,
+                                      const bool forceFull)
+{
+    QJsonObject json;
+    json.insert (KEY_HOST, packet->host);
+    json.insert (KEY_OLD_FPS, packet->oldFps);
+    json.insert (KEY_NEW_FPS, packet->newFps);
+    json.insert (KEY_REQUESTED_FPS, packet->requestedFps);
+    json.insert (KEY_OLD_ZOOM, packet->oldZoom);
+    json.insert (KEY_NEW_ZOOM, packet->newZoom);
+    json.insert (KEY_FOCUS_REQUEST, packet->focusRequest);
+    json.insert (KEY_KEYFRAME_REQUEST, packet->keyframeRequest);
+    json.insert (KEY_SNAPSHOT_REQUEST, packet->snapshotRequest);
+    json.insert (KEY_INFO_REQUEST, packet->infoRequest);
+    json.insert (KEY_CREDITS, packet->credits);
+    json.insert (KEY_UDP_PORT, packet->udpPort);
+    json.insert (KEY_UDP_PARITY, packet->udpParity);
+    json.insert (KEY_MULTICAST, packet->multicast);
+    json.insert (KEY_SHARED_MEMORY, packet->sharedMemory);
+    json.insert (KEY_OLD_RESOLUTION, packet->oldResolution);
+    json.insert (KEY_NEW_RESOLUTION, packet->newResolution);
+    json.insert (KEY_OLD_FLASHLIGHT, packet->oldFlashlightEnabled);
+    json.insert (KEY_NEW_FLASHLIGHT, packet->newFlashlightEnabled);
+    json.insert (KEY_OLD_AUTOREGRES, packet->oldAutoRegulateResolution);
+    json.insert (KEY_NEW_AUTOREGRES, packet->newAutoRegulateResolution);
+    json.insert (KEY_OLD_STREAM, packet->oldStreamFlags);
+    json.insert (KEY_NEW_STREAM, packet->newStreamFlags);
+    json.insert (KEY_OLD_BITRATE, packet->oldBitrate);
+    json.insert (KEY_NEW_BITRATE, packet->newBitrate);
+    json.insert (KEY_OLD_ROI, rect_to_json (packet->oldRegionOfInterest));
+    json.insert (KEY_NEW_ROI, rect_to_json (packet->newRegionOfInterest));
+    json.insert (KEY_CROP, rect_to_json (packet->crop));
+    return write_state (json, state, forceFull);
+}
+
+/**
+ * Reads the given image \a packet and \a info packet and generates a
+ * binary image and its respective CRC32 bits.
+ *
+ * If delta frames are enabled in the \a info packet, this function shall
+ * only send the blocks that changed since the last frame, unless a keyframe
+ * is due or was requested. The reference image of the \a packet is updated
+ * accordingly.
+ *
+ * The JPEG quality is chosen by the rate control, which uses the size of the
+ * previous frame to get closer to the bitrate of the \a info packet.
+ *
+ * If the image \a packet has a crop rectangle, only that region of the
+ * full-resolution image is scaled and encoded (digital PTZ), and the region
+ * of interest is ignored.
+ *
+ * Luma-only streams are encoded as single-component (grayscale) JPEG data.
+ *
+ * If the \a info packet defines a region of interest, the rest of the image
+ * is flattened before encoding, so that (almost) all bits are spent in the
+ * region of interest.
+ *
+ * If abbreviated JPEG data is enabled, the quantization and Huffman tables
+ * are only sent when they change and when a keyframe is requested.
+ *
+ * The \c selfContained flag of the \a packet is set if the frame does not
+ * depend on the previous frames (a keyframe with its JPEG tables)
+ */
+QByteArray QCCTV_CreateImagePacket (QCCTV_ImagePacket* packet,
+                                    const QCCTV_InfoPacket* info)
+{
+    /* Crop the full-resolution image (digital PTZ) and scale it */
+    QImage image = QCCTV_CropImage (packet->image, packet->crop);
+    image = QCCTV_ScaleImage (image, info->resolution);
+
+    /* Luma-only stream, encode single-component JPEG data */
+    if (info->grayscale)
+        image = image.convertToFormat (QImage::Format_Grayscale8);
+
+    /* Only use the frame formats supported by the stations */
+    int flags = QCCTV_SupportedStreamFlags (info->streamFlags,
+                                            packet->capabilities);
+
+    /* Reduce the noise before encoding (noise inflates JPEG and delta frames) */
+    if (flags & QCCTV_STREAM_NOISE_REDUCTION)
+        image = packet->denoiser.process (image);
+    else
+        packet->denoiser.reset();
+
+    /* Flatten the image outside of the region of interest */
+    if (packet->crop.isEmpty())
+        image = QCCTV_ApplyRegionOfInterest (image, info->regionOfInterest);
+
+    bool delta = (flags & QCCTV_STREAM_DELTA_FRAMES);
+
+    /* Keyframes are also requested by new stations */
+    bool requested = packet->keyframeRequested;
+
+    /* Get the quality estimated by the rate control */
+    int pixels = 0;
+    int quality = QCCTV_MAX_QUALITY;
+    if (info->bitrate > 0)
+        quality = packet->quality;
+
+    /* Try to generate a delta frame */
+    QByteArray data;
+    if (delta && !packet->keyframeRequested &&
+        packet->frameCount < QCCTV_KEYFRAME_INTERVAL)
+        data = QCCTV_CreateDeltaFrame (image, &packet->reference,
+                                       packet->frameCount + 1,
+                                       quality, &pixels);
+
+    /* Delta frame could not be generated, send a keyframe */
+    packet->keyframe = data.isEmpty();
+    if (packet->keyframe) {
+        data = QCCTV_EncodeImage (image, QCCTV_Original, quality);
+        pixels = image.width() * image.height();
+        packet->frameCount = 0;
+        packet->keyframeRequested = false;
+
+        if (delta)
+            packet->reference = image.convertToFormat (QImage::Format_RGB32);
+        else
+            packet->reference = QImage();
+    }
+
+    /* Update frame counter */
+    else
+        ++packet->frameCount;
+
+    /* Update the quality estimate for the next frame */
+    update_quality (packet, info, data.size(), pixels,
+                    image.width() * image.height());
+
+    /* Only send the JPEG tables when they change */
+    bool complete = true;
+    if (flags & QCCTV_STREAM_ABBREVIATED)
+        data = abbreviate_frame (packet, data, requested, &complete);
+
+    /* Stations can start decoding the stream with this frame */
+    packet->selfContained = packet->keyframe && complete;
+
+    /* Compress the data and add the checksum */
+    return pack_frame (data, 9);
+}
+
+/**
+ * Encodes the given \a image (cropped to the given \a crop rectangle, if
+ * any) at its original resolution and generates a snapshot frame, which is
+ * sent out-of-band and does not affect the state of the live stream.
+ *
+ * The quality is lowered until the snapshot is smaller than \a maxSize (the
+ * receive buffer of the station), an empty byte array is returned if this
+ * is not possible
+ */
+QByteArray QCCTV_CreateSnapshotPacket (const QImage& image,
+                                       const QRectF& crop,
+                                       const int maxSize)
+{
+    /* Get the full-resolution image */
+    QImage snapshot = QCCTV_CropImage (image, crop);
+    if (snapshot.isNull())
+        return QByteArray();
+
+    /* Encode the image with the highest quality that fits */
+    int quality = QCCTV_SNAPSHOT_QUALITY;
+    while (quality >= QCCTV_MIN_QUALITY) {
+        QByteArray data = QCCTV_EncodeImage (snapshot, QCCTV_Original, quality);
+        data.prepend ((char) QCCTV_FRAME_SNAPSHOT);
+
+        /* JPEG data does not compress, do not waste time on it */
+        QByteArray packet = pack_frame (data, 1);
+        if (packet.size() < maxSize)
+            return packet;
+
+        quality -= QCCTV_SNAPSHOT_QUALITY_STEP;
+    }
+
+    return QByteArray();
+}
+
+/**
+ * Generates the binary data of the given hello \a packet, which is sent when
+ * a multiplexed session starts
+ */
+QByteArray QCCTV_CreateHelloPacket (const QCCTV_HelloPacket* packet)
+{
+    QJsonObject json;
+    json.insert (KEY_VERSION, packet->version);
+    json.insert (KEY_CAPABILITIES, packet->capabilities);
+    json.insert (KEY_MAX_FRAME_SIZE, packet->maxFrameSize);
+    return QJsonDocument (json).toBinaryData();
+}
+
+/**
+ * Reads the given \a binary data and updates the values of the given stream
+ * \a packet structure, the changes are applied to the last full packet of
+ * the given \a state
+ *
+ * This function shall return \c true on success, \c false on failure (or if
+ * we need a full packet)
+ */
+bool QCCTV_ReadInfoPacket (QCCTV_InfoPacket* packet,
+                           QCCTV_PacketState* state,
+                           const QByteArray& data)
+{
+    /* Packet pointer is invalid and/or data incomplete */
+    if (!packet || !state || data.isEmpty())
+        return false;
+
+    /* Get complete JSON object from data */
+    QJsonObject json = read_state (data, state);
+    if (json.isEmpty())
+        return false;
+
+    /* Get information from JSON object */
+    packet->fps = json.value (KEY_FPS).toInt();
+    packet->maxFps = json.value (KEY_MAX_FPS).toInt (QCCTV_MAX_FPS);
+    packet->zoom = json.value (KEY_ZOOM).toInt();
+    packet->cameraName = json.value (KEY_NAME).toString();
+    packet->cameraStatus = json.value (KEY_STATUS).toInt();
+    packet->cameraGroup = json.value (KEY_GROUP).toString();
+    packet->resolution = json.value (KEY_RESOLUTION).toInt();
+    packet->supportsZoom = json.value (KEY_ZOOM_AVAIL).toBool();
+    packet->flashlightEnabled = json.value (KEY_FLASHLIGHT).toBool();
+    packet->autoRegulateResolution = json.value (KEY_AUTOREGRES).toBool();
+    packet->motionDetectionEnabled = json.value (KEY_MOTION_DET).toBool();
+    packet->motionDetected = json.value (KEY_MOTION).toBool();
+    packet->streamFlags = json.value (KEY_STREAM).toInt();
+    packet->bitrate = json.value (KEY_BITRATE).toInt();
+    packet->quality = json.value (KEY_QUALITY).toInt();
+    packet->grayscale = json.value (KEY_GRAYSCALE).toBool();
+    packet->regionOfInterest = json_to_rect (json.value (KEY_ROI));
+    packet->multicastGroup = json.value (KEY_MCAST_ADDR).toString();
+    packet->multicastPort = json.value (KEY_MCAST_PORT).toInt();
+    packet->sharedMemoryKey = json.value (KEY_SHM_KEY).toString();
+
+    /* Packet read successfully */
+    return true;
+}
+
+/**
+ * Reads the given hello packet \a data and updates the values of the given
+ * \a packet. Unknown capabilities of newer peers are ignored.
+ *
+ * This function shall return \c true on success, \c false on failure
+ */
+bool QCCTV_ReadHelloPacket (QCCTV_HelloPacket* packet, const QByteArray& data)
+{
+    if (!packet || data.isEmpty())
+        return false;
+
+    /* Get JSON object from data */
+    QJsonObject json = QJsonDocument::fromBinaryData (data).object();
+    if (json.isEmpty() || !json.contains (KEY_VERSION))
+        return false;
+
+    /* Get information from JSON object */
+    packet->version = json.value (KEY_VERSION).toInt();
+    packet->capabilities = json.value (KEY_CAPABILITIES).toInt() & QCCTV_CAP_ALL;
+    packet->maxFrameSize = json.value (KEY_MAX_FRAME_SIZE).toInt();
+
+    /* Packet read successfully */
+    return packet->maxFrameSize > 0;
+}
+
+/**
+ * Obtains the image from the given \a data (only if CRC32 codes match).
+ *
+ * Delta frames are applied to the reference image of the \a packet and
+ * abbreviated JPEG data is restored with the tables of the \a packet. If the
+ * reference image or the tables are not valid (or if the frame counter of the
+ * \a packet shows that we lost a delta frame), the \c keyframeRequested flag
+ * of the \a packet will be set and this function shall return \c false.
+ *
+ * Snapshot frames are decoded without modifying the reference image or the
+ * tables of the \a packet, its \c snapshot flag is set accordingly.
+ *
+ * The \c selfContained flag of the \a packet is set if the frame can be
+ * decoded without the previous frames (a keyframe with its JPEG tables)
+ */
+bool QCCTV_ReadImagePacket (QCCTV_ImagePacket* packet, const QByteArray& data)
+{
+    if (!packet)
+        return false;
+
+    /* Reset the keyframe request flag */
+    packet->keyframeRequested = false;
+    if (data.length() < 4)
+        return false;
+
+    /* Get the checksum */
+    quint8 a = data.at (0);
+    quint8 b = data.at (1);
+    quint8 c = data.at (2);
+    quint8 d = data.at (3);
+    packet->crc32 = (a << 24) | (b << 16) | (c << 8) | (d & 0xff);
+
+    /* Create byte array without checksum header */
+    QByteArray stream = data;
+    stream.remove (0, 4);
+
+    /* Compare checksums (abort if they are different) */
+    quint32 crc = crc32.compute (stream);
+    if (packet->crc32 != crc)
+        return false;
+
+    /* Uncompress the data */
+    QByteArray frame = qUncompress (stream);
+
+    /* Read snapshot (the stream state is not changed) */
+    packet->snapshot = !frame.isEmpty() &&
+                       (quint8) frame.at (0) == QCCTV_FRAME_SNAPSHOT;
+    if (packet->snapshot) {
+        packet->jpeg = frame.mid (1);
+        packet->image = QCCTV_DecodeImage (packet->jpeg);
+        return !packet->image.isNull();
+    }
+
+    /* Restore abbreviated JPEG data */
+    bool complete = false;
+    if (!restore_frame (packet, &frame, &complete)) {
+        packet->keyframeRequested = true;
+        return false;
+    }
+
+    /* Get frame type */
+    packet->keyframe = !QCCTV_IsDeltaFrame (frame);
+    packet->selfContained = packet->keyframe && complete;
+
+    /* Read delta frame */
+    if (!packet->keyframe) {
+        packet->jpeg.clear();
+        if (!QCCTV_ApplyDeltaFrame (frame, &packet->reference,
+                                    packet->frameCount + 1)) {
+            packet->keyframeRequested = true;
+            return false;
+        }
+
+        ++packet->frameCount;
+        packet->image = packet->reference;
+        return true;
+    }
+
+    /* Read full image */
+    packet->jpeg = frame;
+    packet->image = QCCTV_DecodeImage (packet->jpeg);
+    packet->reference = packet->image;
+    packet->frameCount = 0;
+    return !packet->image.isNull();
+}
+
+/**
+ * Reads the given \a binary data and updates the values of the given command
+ * \a packet structure, the changes are applied to the last full packet of
+ * the given \a state
+ *
+ * This function shall return \c true on success, \c false on failure (or if
+ * we need a full packet)
+ */
+bool QCCTV_ReadCommandPacket (QCCTV_CommandPacket* packet,
+                              QCCTV_PacketState* state,
+                              const QByteArray& data)
+{
+    /* Packet pointer is invalid and/or data incomplete */
+    if (!packet || !state || data.isEmpty())
+        return false;
+
+    /* Get complete JSON object from data */
+    QJsonObject json = read_state (data, state);
+    if (json.isEmpty())
+        return false;
+
+    /* Get information from JSON object */
+    packet->host = json.value (KEY_HOST).toString();
+    packet->oldFps = json.value (KEY_OLD_FPS).toInt();
+    packet->newFps = json.value (KEY_NEW_FPS).toInt();
+    packet->requestedFps = json.value (KEY_REQUESTED_FPS).toInt();
+    packet->oldZoom = json.value (KEY_OLD_ZOOM).toInt();
+    packet->newZoom = json.value (KEY_NEW_ZOOM).toInt();
+    packet->focusRequest = json.value (KEY_FOCUS_REQUEST).toBool();
+    packet->oldResolution = json.value (KEY_OLD_RESOLUTION).toInt();
+    packet->newResolution = json.value (KEY_NEW_RESOLUTION).toInt();
+    packet->oldFlashlightEnabled = json.value (KEY_OLD_FLASHLIGHT).toBool();
+    packet->newFlashlightEnabled = json.value (KEY_NEW_FLASHLIGHT).toBool();
+    packet->oldAutoRegulateResolution = json.value (KEY_OLD_AUTOREGRES).toBool();
+    packet->newAutoRegulateResolution = json.value (KEY_NEW_AUTOREGRES).toBool();
+    packet->keyframeRequest = json.value (KEY_KEYFRAME_REQUEST).toBool();
+    packet->snapshotRequest = json.value (KEY_SNAPSHOT_REQUEST).toInt();
+    packet->infoRequest = json.value (KEY_INFO_REQUEST).toBool();
+    packet->credits = json.value (KEY_CREDITS).toInt (-1);
+    packet->udpPort = json.value (KEY_UDP_PORT).toInt();
+    packet->udpParity = json.value (KEY_UDP_PARITY).toInt();
+    packet->multicast = json.value (KEY_MULTICAST).toBool();
+    packet->sharedMemory = json.value (KEY_SHARED_MEMORY).toBool();
+    packet->oldStreamFlags = json.value (KEY_OLD_STREAM).toInt();
+    packet->newStreamFlags = json.value (KEY_NEW_STREAM).toInt();
+    packet->oldBitrate = json.value (KEY_OLD_BITRATE).toInt();
+    packet->newBitrate = json.value (KEY_NEW_BITRATE).toInt();
+    packet->oldRegionOfInterest = json_to_rect (json.value (KEY_OLD_ROI));
+    packet->newRegionOfInterest = json_to_rect (json.value (KEY_NEW_ROI));
+    packet->crop = QCCTV_ValidCrop (json_to_rect (json.value (KEY_CROP)));
+
+    /* Check command flags have changed since last packet */
+    packet->fpsChanged = (packet->oldFps != packet->newFps);
+    packet->zoomChanged = (packet->oldZoom != packet->newZoom);
+    packet->resolutionChanged = (packet->oldResolution != packet->newResolution);
+    packet->flashlightEnabledChanged = (packet->oldFlashlightEnabled != packet->newFlashlightEnabled);
+    packet->autoRegulateResolutionChanged = (packet->oldAutoRegulateResolution !=
+                                             packet->newAutoRegulateResolution);
+    packet->streamFlagsChanged = (packet->oldStreamFlags != packet->newStreamFlags);
+    packet->bitrateChanged = (packet->oldBitrate != packet->newBitrate);
+    packet->regionOfInterestChanged = (packet->oldRegionOfInterest !=
+                                       packet->newRegionOfInterest);
+
+    /* Packet read successfully */
+    return true;
+}
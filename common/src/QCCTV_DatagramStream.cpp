@@ -0,0 +1,667 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_DatagramStream.h"
+
+#include <QTimer>
+#include <QUdpSocket>
+
+/* Fragment types */
+static const quint8 FRAGMENT_DATA   = 0x00;
+static const quint8 FRAGMENT_PARITY = 0x01;
+
+/* Frame ID, fragment index, fragment count, type, parity group and length */
+static const int HEADER_SIZE = 12;
+
+/* Frames that are this close behind the last frame are considered late */
+static const int LATE_WINDOW = 64;
+
+/**
+ * Appends the given 16-bit \a value to the \a data (big-endian)
+ */
+static void write_u16 (QByteArray* data, const quint16 value)
+{
+    data->append ((char) ((value & 0xff00) >> 8));
+    data->append ((char) (value & 0xff));
+}
+
+/**
+ * Appends the given 32-bit \a value to the \a data (big-endian)
+ */
+static void write_u32 (QByteArray* data, const quint32 value)
+{
+    write_u16 (data, (value & 0xffff0000) >> 16);
+    write_u16 (data, value & 0xffff);
+}
+
+/**
+ * Reads a 16-bit value from the given \a data at the given \a offset
+ */
+static quint16 read_u16 (const QByteArray& data, const int offset)
+{
+    return ((quint8) data.at (offset) << 8) | (quint8) data.at (offset + 1);
+}
+
+/**
+ * Reads a 32-bit value from the given \a data at the given \a offset
+ */
+static quint32 read_u32 (const QByteArray& data, const int offset)
+{
+    return ((quint32) read_u16 (data, offset) << 16) |
+           read_u16 (data, offset + 2);
+}
+
+/**
+ * Returns the header of a fragment with the given values
+ */
+static QByteArray fragment_header (const quint16 frame,
+                                   const quint16 index,
+                                   const quint16 count,
+                                   const quint8 type,
+                                   const quint8 group,
+                                   const quint32 length)
+{
+    QByteArray header;
+    write_u16 (&header, frame);
+    write_u16 (&header, index);
+    write_u16 (&header, count);
+    header.append ((char) type);
+    header.append ((char) group);
+    write_u32 (&header, length);
+    return header;
+}
+
+/**
+ * XORs the given \a data into the \a parity buffer (the parity buffer has
+ * the size of a full fragment, shorter fragments are padded with zeros)
+ */
+static void xor_fragment (QByteArray* parity, const QByteArray& data)
+{
+    if (parity->size() < QCCTV_UDP_FRAGMENT_SIZE)
+        parity->append (QByteArray (QCCTV_UDP_FRAGMENT_SIZE - parity->size(), 0));
+
+    char* out = parity->data();
+    for (int i = 0; i < data.size(); ++i)
+        out[i] ^= data.at (i);
+}
+
+/**
+ * Returns \c true if the frame with the given \a id was sent before the
+ * \a last frame that we delivered (frame IDs wrap around, IDs that are far
+ * behind the last frame belong to a restarted stream)
+ */
+static bool is_late (const quint16 id, const quint16 last)
+{
+    qint16 diff = (qint16) (id - last);
+    return diff <= 0 && diff > -LATE_WINDOW;
+}
+
+/**
+ * Creates a datagram stream, call \c listen() to receive frames or
+ * \c setDestination() to send frames
+ */
+QCCTV_DatagramStream::QCCTV_DatagramStream (QObject* parent) : QObject (parent)
+{
+    m_port = 0;
+    m_frameId = 0;
+    m_lastFrame = 0;
+    m_delivered = false;
+    m_parityGroup = QCCTV_UDP_PARITY_GROUP;
+    m_socket = new QUdpSocket (this);
+
+    /* Held frames are delivered when we stop waiting for the lost frames */
+    m_retransmissions = false;
+    m_retransmissionTimer = new QTimer (this);
+    m_retransmissionTimer->setSingleShot (true);
+    m_retransmissionTimer->setInterval (QCCTV_UDP_RETRANSMIT_TIME);
+    connect (m_retransmissionTimer, SIGNAL (timeout()),
+             this,                    SLOT (onRetransmissionTimeout()));
+
+    /* Resumes the datagrams held back by the pacer */
+    m_pacingTimer = new QTimer (this);
+    m_pacingTimer->setSingleShot (true);
+    m_pacingTimer->setTimerType (Qt::PreciseTimer);
+    connect (m_pacingTimer, SIGNAL (timeout()),
+             this,            SLOT (writeDatagrams()));
+}
+
+/**
+ * Returns the local port used to receive frames
+ */
+quint16 QCCTV_DatagramStream::port() const
+{
+    return m_socket->localPort();
+}
+
+/**
+ * Returns the number of fragments protected by each parity fragment
+ */
+int QCCTV_DatagramStream::parityGroup() const
+{
+    return m_parityGroup;
+}
+
+/**
+ * Returns the ID of the last frame that we sent
+ */
+quint16 QCCTV_DatagramStream::lastFrameId() const
+{
+    return m_frameId - 1;
+}
+
+/**
+ * Writes the data of the recently sent frame with the given \a id to the
+ * given \a data array, returns \c false if we do not have the frame anymore
+ */
+bool QCCTV_DatagramStream::sentFrame (const quint16 id, QByteArray* data) const
+{
+    int index = m_sentIds.indexOf (id);
+    if (index < 0 || !data)
+        return false;
+
+    *data = m_sentFrames.at (index);
+    return true;
+}
+
+/**
+ * Returns the pacer used for the outgoing datagrams (disabled by default)
+ */
+QCCTV_Pacer* QCCTV_DatagramStream::pacer()
+{
+    return &m_pacer;
+}
+
+/**
+ * Binds the socket to a random port and starts reading the frames sent to
+ * it, returns \c false if the socket cannot be bound
+ */
+bool QCCTV_DatagramStream::listen()
+{
+    if (!m_socket->bind (QHostAddress::AnyIPv4, 0))
+        return false;
+
+    connect (m_socket, SIGNAL (readyRead()),
+             this,       SLOT (readDatagrams()));
+
+    return true;
+}
+
+/**
+ * Binds the socket to the given \a port (which may be shared with other
+ * streams) and joins the given multicast \a group, returns \c false if
+ * the socket cannot be bound or the group cannot be joined
+ */
+bool QCCTV_DatagramStream::listen (const QHostAddress& group,
+                                   const quint16 port)
+{
+    if (!m_socket->bind (QHostAddress::AnyIPv4, port,
+                         QUdpSocket::ShareAddress |
+                         QUdpSocket::ReuseAddressHint))
+        return false;
+
+    if (!m_socket->joinMulticastGroup (group)) {
+        m_socket->close();
+        return false;
+    }
+
+    connect (m_socket, SIGNAL (readyRead()),
+             this,       SLOT (readDatagrams()));
+
+    return true;
+}
+
+/**
+ * Only accepts datagrams sent from the given \a address (shared multicast
+ * ports receive the datagrams of other senders too)
+ */
+void QCCTV_DatagramStream::setSource (const QHostAddress& address)
+{
+    m_source = address;
+}
+
+/**
+ * If \a enabled is set to \c true, complete frames that follow a lost
+ * frame are held back until the lost frame is inserted with
+ * \c insertFrame() (the \c frameMissing() signal is emitted for each lost
+ * frame)
+ */
+void QCCTV_DatagramStream::setRetransmissionsEnabled (const bool enabled)
+{
+    m_retransmissions = enabled;
+    if (!enabled)
+        flushFrames (true);
+}
+
+/**
+ * Registers the given frame \a data, which was lost and retransmitted
+ * through another channel, and delivers the frames held back by it
+ */
+void QCCTV_DatagramStream::insertFrame (const quint16 id,
+                                        const QByteArray& data)
+{
+    if (!m_retransmissions || data.isEmpty())
+        return;
+
+    if (m_delivered && is_late (id, m_lastFrame))
+        return;
+
+    holdFrame (id, data);
+    flushFrames (false);
+}
+
+/**
+ * Changes the number of fragments protected by each parity fragment, zero
+ * disables the parity fragments
+ */
+void QCCTV_DatagramStream::setParityGroup (const int group)
+{
+    m_parityGroup = qBound (0, group, 255);
+}
+
+/**
+ * Splits the given frame \a data in fragments and sends them to the
+ * destination address, followed by their parity fragments
+ */
+void QCCTV_DatagramStream::sendFrame (const QByteArray& data)
+{
+    /* No destination or invalid frame */
+    if (m_address.isNull() || m_port == 0)
+        return;
+    if (data.isEmpty() || data.size() > QCCTV_MAX_BUFFER_SIZE)
+        return;
+
+    /* Write the datagrams left from the previous frame at once */
+    if (!m_datagrams.isEmpty()) {
+        m_pacingTimer->stop();
+        foreach (const QByteArray& datagram, m_datagrams) {
+            m_pacer.consume (datagram.size());
+            m_socket->writeDatagram (datagram, m_address, m_port);
+        }
+
+        m_datagrams.clear();
+    }
+
+    /* Keep the frame for retransmissions */
+    quint16 id = m_frameId++;
+    m_sentIds.append (id);
+    m_sentFrames.append (data);
+    if (m_sentIds.count() > QCCTV_UDP_HISTORY_FRAMES) {
+        m_sentIds.removeFirst();
+        m_sentFrames.removeFirst();
+    }
+
+    /* Get the number of fragments */
+    int count = (data.size() + QCCTV_UDP_FRAGMENT_SIZE - 1) /
+                QCCTV_UDP_FRAGMENT_SIZE;
+
+    QByteArray parity;
+    for (int i = 0; i < count; ++i) {
+        /* Send the data fragment */
+        QByteArray fragment = data.mid (i * QCCTV_UDP_FRAGMENT_SIZE,
+                                        QCCTV_UDP_FRAGMENT_SIZE);
+        m_datagrams.append (fragment_header (id, i, count,
+                                             FRAGMENT_DATA,
+                                             m_parityGroup,
+                                             data.size()) + fragment);
+
+        /* Send the parity fragment after the last fragment of each group */
+        if (m_parityGroup > 0) {
+            xor_fragment (&parity, fragment);
+            if ((i + 1) % m_parityGroup == 0 || i == count - 1) {
+                m_datagrams.append (fragment_header (id,
+                                                     i / m_parityGroup,
+                                                     count,
+                                                     FRAGMENT_PARITY,
+                                                     m_parityGroup,
+                                                     data.size()) + parity);
+                parity.clear();
+            }
+        }
+    }
+
+    /* Send the datagrams */
+    writeDatagrams();
+}
+
+/**
+ * Changes the \a address and \a port to which we send the frames
+ */
+void QCCTV_DatagramStream::setDestination (const QHostAddress& address,
+                                           const quint16 port)
+{
+    m_port = port;
+    m_address = address;
+
+    /* Keep multicast datagrams in the local network (and this host) */
+    if (address.isMulticast()) {
+        m_socket->setSocketOption (QUdpSocket::MulticastTtlOption, 1);
+        m_socket->setSocketOption (QUdpSocket::MulticastLoopbackOption, 1);
+    }
+}
+
+/**
+ * Writes the queued datagrams, as fast as the pacer allows
+ */
+void QCCTV_DatagramStream::writeDatagrams()
+{
+    while (!m_datagrams.isEmpty()) {
+        int length = m_datagrams.first().size();
+
+        /* Wait until the pacer lets the datagram through */
+        int wait = m_pacer.delay (length);
+        if (wait > 0) {
+            if (!m_pacingTimer->isActive())
+                m_pacingTimer->start (wait);
+
+            return;
+        }
+
+        /* Send the datagram */
+        m_pacer.consume (length);
+        m_socket->writeDatagram (m_datagrams.takeFirst(), m_address, m_port);
+    }
+}
+
+/**
+ * Reads the datagrams received by the socket
+ */
+void QCCTV_DatagramStream::readDatagrams()
+{
+    while (m_socket->hasPendingDatagrams()) {
+        QByteArray datagram;
+        QHostAddress sender;
+        datagram.resize (m_socket->pendingDatagramSize());
+        m_socket->readDatagram (datagram.data(), datagram.size(), &sender);
+
+        /* Ignore the datagrams of other senders */
+        if (!m_source.isNull() &&
+            sender.toIPv4Address() != m_source.toIPv4Address())
+            continue;
+
+        readFragment (datagram);
+    }
+}
+
+/**
+ * Registers the fragment in the given \a datagram and reports its frame
+ * when all its fragments were received (or recovered)
+ */
+void QCCTV_DatagramStream::readFragment (const QByteArray& datagram)
+{
+    if (datagram.size() <= HEADER_SIZE)
+        return;
+
+    /* Read the header */
+    quint16 id = read_u16 (datagram, 0);
+    int index = read_u16 (datagram, 2);
+    int count = read_u16 (datagram, 4);
+    quint8 type = datagram.at (6);
+    int group = (quint8) datagram.at (7);
+    int length = read_u32 (datagram, 8);
+    QByteArray payload = datagram.mid (HEADER_SIZE, QCCTV_UDP_FRAGMENT_SIZE);
+
+    /* Discard invalid fragments */
+    if (length <= 0 || length > QCCTV_MAX_BUFFER_SIZE)
+        return;
+    if (count != (length + QCCTV_UDP_FRAGMENT_SIZE - 1) / QCCTV_UDP_FRAGMENT_SIZE)
+        return;
+    if (type == FRAGMENT_DATA && index >= count)
+        return;
+    if (type == FRAGMENT_PARITY && (group == 0 || index * group >= count))
+        return;
+    if (type != FRAGMENT_DATA && type != FRAGMENT_PARITY)
+        return;
+
+    /* Discard truncated fragments */
+    int size = QCCTV_UDP_FRAGMENT_SIZE;
+    if (type == FRAGMENT_DATA)
+        size = qMin (size, length - index * QCCTV_UDP_FRAGMENT_SIZE);
+    if (payload.size() != size)
+        return;
+
+    /* We already reported a newer frame */
+    if (m_delivered && is_late (id, m_lastFrame))
+        return;
+
+    /* Get the frame of the fragment */
+    int frame = -1;
+    for (int i = 0; i < m_frames.count(); ++i) {
+        if (m_frames.at (i).id == id) {
+            frame = i;
+            break;
+        }
+    }
+
+    /* Register a new frame, forget the oldest one if needed */
+    if (frame < 0) {
+        if (m_frames.count() >= QCCTV_UDP_PENDING_FRAMES)
+            m_frames.removeFirst();
+
+        Frame f;
+        f.id = id;
+        f.count = count;
+        f.group = group;
+        f.length = length;
+        f.received = 0;
+        f.fragments.resize (count);
+        if (group > 0)
+            f.parity.resize ((count + group - 1) / group);
+
+        m_frames.append (f);
+        frame = m_frames.count() - 1;
+    }
+
+    /* Fragment does not belong to the frame that we know */
+    Frame* f = &m_frames[frame];
+    if (f->count != count || f->group != group || f->length != length)
+        return;
+
+    /* Register the fragment */
+    if (type == FRAGMENT_DATA && f->fragments.at (index).isEmpty()) {
+        f->fragments[index] = payload;
+        f->received++;
+    }
+
+    else if (type == FRAGMENT_PARITY)
+        f->parity[index] = payload;
+
+    /* Report the frame once we have all its data */
+    recoverFragments (f);
+    if (f->received == f->count)
+        completeFrame (frame);
+}
+
+/**
+ * Rebuilds the lost fragment of each group of the given \a frame, which is
+ * only possible if we have its parity fragment and the rest of the group
+ */
+void QCCTV_DatagramStream::recoverFragments (Frame* frame)
+{
+    for (int g = 0; g < frame->parity.count(); ++g) {
+        if (frame->parity.at (g).isEmpty())
+            continue;
+
+        /* Find the lost fragment of the group */
+        int lost = -1;
+        int first = g * frame->group;
+        int last = qMin (first + frame->group, frame->count);
+        for (int i = first; i < last; ++i) {
+            if (frame->fragments.at (i).isEmpty()) {
+                if (lost >= 0) {
+                    lost = -1;
+                    break;
+                }
+
+                lost = i;
+            }
+        }
+
+        if (lost < 0)
+            continue;
+
+        /* XOR the parity with the rest of the group */
+        QByteArray data = frame->parity.at (g);
+        for (int i = first; i < last; ++i)
+            if (i != lost)
+                xor_fragment (&data, frame->fragments.at (i));
+
+        /* Remove the padding of the last fragment */
+        int size = qMin (QCCTV_UDP_FRAGMENT_SIZE,
+                         frame->length - lost * QCCTV_UDP_FRAGMENT_SIZE);
+        frame->fragments[lost] = data.left (size);
+        frame->received++;
+    }
+}
+
+/**
+ * Joins the fragments of the frame with the given \a index, drops the
+ * older (incomplete) frames and reports the frame.
+ *
+ * If frames were lost before this frame, we report them and hold this frame
+ * back until they are retransmitted (if retransmissions are enabled)
+ */
+void QCCTV_DatagramStream::completeFrame (const int index)
+{
+    /* Join the fragments */
+    QByteArray data;
+    quint16 id = m_frames.at (index).id;
+    int length = m_frames.at (index).length;
+    data.reserve (length);
+    foreach (QByteArray fragment, m_frames.at (index).fragments)
+        data.append (fragment);
+
+    /* Drop this frame and the frames that were sent before it */
+    for (int i = m_frames.count() - 1; i >= 0; --i)
+        if (is_late (m_frames.at (i).id, id))
+            m_frames.removeAt (i);
+
+    /* Invalid frame */
+    if (data.size() != length)
+        return;
+
+    /* No frames were lost */
+    bool gap = m_delivered && id != (quint16) (m_lastFrame + 1);
+    if (!gap && m_heldIds.isEmpty()) {
+        deliverFrame (id, data);
+        return;
+    }
+
+    /* Frames were lost and cannot be retransmitted */
+    if (!m_retransmissions) {
+        emit framesLost();
+        deliverFrame (id, data);
+        return;
+    }
+
+    /* Hold this frame back */
+    holdFrame (id, data);
+
+    /* Too many frames were lost, the sender does not have them anymore */
+    quint16 missing = id - m_lastFrame - 1;
+    if (!m_delivered || missing > QCCTV_UDP_HISTORY_FRAMES) {
+        flushFrames (true);
+        return;
+    }
+
+    /* Ask for the lost frames */
+    for (quint16 i = m_lastFrame + 1; i != id; ++i) {
+        if (!m_heldIds.contains (i) && !m_requestedIds.contains (i)) {
+            m_requestedIds.append (i);
+            emit frameMissing (i);
+        }
+    }
+
+    if (!m_retransmissionTimer->isActive())
+        m_retransmissionTimer->start();
+
+    /* Do not hold too many frames */
+    flushFrames (m_heldIds.count() > QCCTV_UDP_HISTORY_FRAMES);
+}
+
+/**
+ * Reports the frame with the given \a id and \a data
+ */
+void QCCTV_DatagramStream::deliverFrame (const quint16 id,
+                                         const QByteArray& data)
+{
+    m_delivered = true;
+    m_lastFrame = id;
+    emit frameReceived (data);
+}
+
+/**
+ * Adds the frame with the given \a id and \a data to the held frames,
+ * which are sorted by their ID
+ */
+void QCCTV_DatagramStream::holdFrame (const quint16 id, const QByteArray& data)
+{
+    if (m_heldIds.contains (id))
+        return;
+
+    int index = 0;
+    while (index < m_heldIds.count() &&
+           (qint16) (id - m_heldIds.at (index)) > 0)
+        ++index;
+
+    m_heldIds.insert (index, id);
+    m_heldFrames.insert (index, data);
+}
+
+/**
+ * Delivers the held frames that follow the last delivered frame. If we
+ * stopped waiting for the lost frames (\a timeout), all the held frames are
+ * delivered and the loss is reported
+ */
+void QCCTV_DatagramStream::flushFrames (const bool timeout)
+{
+    bool lost = false;
+    while (!m_heldIds.isEmpty()) {
+        /* Next frame is still missing */
+        quint16 id = m_heldIds.first();
+        if (m_delivered && id != (quint16) (m_lastFrame + 1)) {
+            if (!timeout)
+                break;
+
+            if (!lost)
+                emit framesLost();
+
+            lost = true;
+        }
+
+        deliverFrame (m_heldIds.takeFirst(), m_heldFrames.takeFirst());
+    }
+
+    /* We are not waiting for anything */
+    if (m_heldIds.isEmpty()) {
+        m_requestedIds.clear();
+        m_retransmissionTimer->stop();
+    }
+}
+
+/**
+ * Stops waiting for the lost frames and delivers the held frames
+ */
+void QCCTV_DatagramStream::onRetransmissionTimeout()
+{
+    flushFrames (true);
+}
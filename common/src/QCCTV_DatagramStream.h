@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_DATAGRAM_STREAM_H
+#define _QCCTV_DATAGRAM_STREAM_H
+
+#include <QList>
+#include <QObject>
+#include <QVector>
+#include <QByteArray>
+#include <QHostAddress>
+
+#include "QCCTV_Pacer.h"
+
+class QTimer;
+class QUdpSocket;
+
+/**
+ * \brief Sends and receives image frames through UDP datagrams.
+ *
+ * Each frame is split in fragments that fit in a single datagram. Every
+ * fragment carries the frame ID, its index, the number of fragments and the
+ * length of the frame. An XOR parity fragment is added for every group of
+ * fragments, which allows the receiver to recover one lost fragment per
+ * group.
+ *
+ * The receiver never waits for lost fragments: incomplete frames are
+ * dropped as soon as a newer frame is complete. Frames depend on the frames
+ * before them (delta frames), so the receiver reports the lost frames. If
+ * retransmissions are enabled, complete frames that follow a lost frame
+ * are held back until the lost frame is received through another channel
+ * (see \c insertFrame()) or until the retransmission times out.
+ *
+ * The sender keeps the last frames that it sent, so that they can be
+ * retransmitted through the reliable connection with the receiver. The
+ * datagrams of each frame can be paced (see \c QCCTV_Pacer), datagrams that
+ * are still queued when the next frame is sent are written at once.
+ */
+class QCCTV_DatagramStream : public QObject
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void framesLost();
+    void frameMissing (const quint16 id);
+    void frameReceived (const QByteArray& data);
+
+public:
+    explicit QCCTV_DatagramStream (QObject* parent = Q_NULLPTR);
+
+    quint16 port() const;
+    int parityGroup() const;
+    quint16 lastFrameId() const;
+    bool sentFrame (const quint16 id, QByteArray* data) const;
+    QCCTV_Pacer* pacer();
+
+public Q_SLOTS:
+    bool listen();
+    bool listen (const QHostAddress& group, const quint16 port);
+    void setSource (const QHostAddress& address);
+    void setRetransmissionsEnabled (const bool enabled);
+    void insertFrame (const quint16 id, const QByteArray& data);
+    void setParityGroup (const int group);
+    void sendFrame (const QByteArray& data);
+    void setDestination (const QHostAddress& address, const quint16 port);
+
+private Q_SLOTS:
+    void readDatagrams();
+    void writeDatagrams();
+    void onRetransmissionTimeout();
+
+private:
+    struct Frame {
+        quint16 id;
+        int count;
+        int group;
+        int length;
+        int received;
+        QVector<QByteArray> fragments;
+        QVector<QByteArray> parity;
+    };
+
+    void readFragment (const QByteArray& datagram);
+    void recoverFragments (Frame* frame);
+    void completeFrame (const int index);
+    void deliverFrame (const quint16 id, const QByteArray& data);
+    void holdFrame (const quint16 id, const QByteArray& data);
+    void flushFrames (const bool timeout);
+
+private:
+    QUdpSocket* m_socket;
+
+    quint16 m_port;
+    int m_parityGroup;
+    QHostAddress m_source;
+    QHostAddress m_address;
+
+    quint16 m_frameId;
+    QList<quint16> m_sentIds;
+    QList<QByteArray> m_sentFrames;
+
+    QCCTV_Pacer m_pacer;
+    QTimer* m_pacingTimer;
+    QList<QByteArray> m_datagrams;
+
+    bool m_delivered;
+    quint16 m_lastFrame;
+    QList<Frame> m_frames;
+
+    bool m_retransmissions;
+    QTimer* m_retransmissionTimer;
+    QList<quint16> m_heldIds;
+    QList<quint16> m_requestedIds;
+    QList<QByteArray> m_heldFrames;
+};
+
+#endif
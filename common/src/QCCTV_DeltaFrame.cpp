@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_DeltaFrame.h"
+
+#include <QtMath>
+#include <QVector>
+
+/* Header length (frame type + sequence + width + height) */
+static const int HEADER_LENGTH = 6;
+
+/**
+ * Returns the number of block columns for the given \a width
+ */
+static int block_columns (const int width)
+{
+    return (width + QCCTV_DELTA_BLOCK_SIZE - 1) / QCCTV_DELTA_BLOCK_SIZE;
+}
+
+/**
+ * Returns the number of block rows for the given \a height
+ */
+static int block_rows (const int height)
+{
+    return (height + QCCTV_DELTA_BLOCK_SIZE - 1) / QCCTV_DELTA_BLOCK_SIZE;
+}
+
+/**
+ * Returns the number of mosaic columns used to store \a count blocks
+ */
+static int mosaic_columns (const int count)
+{
+    return qMax (1, qCeil (qSqrt (count)));
+}
+
+/**
+ * Copies the block at (\a sx, \a sy) of the \a source image to (\a dx, \a dy)
+ * in the \a target image, clipping the block to the bounds of both images.
+ *
+ * Both images must use the \c QImage::Format_RGB32 format
+ */
+static void copy_block (const QImage& source, const int sx, const int sy,
+                        QImage* target, const int dx, const int dy)
+{
+    const int w = qMin (QCCTV_DELTA_BLOCK_SIZE,
+                        qMin (source.width() - sx, target->width() - dx));
+    const int h = qMin (QCCTV_DELTA_BLOCK_SIZE,
+                        qMin (source.height() - sy, target->height() - dy));
+
+    for (int y = 0; y < h; ++y) {
+        const uchar* src = source.constScanLine (sy + y) + sx * 4;
+        uchar* dst = target->scanLine (dy + y) + dx * 4;
+        memcpy (dst, src, w * 4);
+    }
+}
+
+/**
+ * Returns \c true if the mean absolute difference of the block at (\a x,
+ * \a y) in both images exceeds \c QCCTV_DELTA_THRESHOLD
+ */
+static bool block_changed (const QImage& a, const QImage& b,
+                           const int x, const int y)
+{
+    const int w = qMin (QCCTV_DELTA_BLOCK_SIZE, a.width() - x);
+    const int h = qMin (QCCTV_DELTA_BLOCK_SIZE, a.height() - y);
+    const int limit = QCCTV_DELTA_THRESHOLD * w * h * 3;
+
+    int sum = 0;
+    for (int row = 0; row < h; ++row) {
+        const uchar* pa = a.constScanLine (y + row) + x * 4;
+        const uchar* pb = b.constScanLine (y + row) + x * 4;
+
+        for (int i = 0; i < w * 4; ++i)
+            sum += qAbs (pa [i] - pb [i]);
+
+        if (sum > limit)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given (uncompressed) image \a data is a delta frame
+ */
+bool QCCTV_IsDeltaFrame (const QByteArray& data)
+{
+    return !data.isEmpty() && (quint8) data.at (0) == QCCTV_FRAME_DELTA;
+}
+
+/**
+ * Returns the length of the header and bitmap of the given delta frame
+ * \a data, which is the offset of the JPEG mosaic.
+ *
+ * If the frame is not valid, this function shall return the length of the
+ * \a data
+ */
+int QCCTV_DeltaFrameHeaderLength (const QByteArray& data)
+{
+    if (!QCCTV_IsDeltaFrame (data) || data.size() < HEADER_LENGTH)
+        return data.size();
+
+    const int width = ((quint8) data.at (2) << 8) | (quint8) data.at (3);
+    const int height = ((quint8) data.at (4) << 8) | (quint8) data.at (5);
+    const int bitmapLength = (block_columns (width) * block_rows (height) + 7) / 8;
+
+    return qMin (HEADER_LENGTH + bitmapLength, data.size());
+}
+
+/**
+ * Compares the given \a image with the \a reference image known by the
+ * stations and generates a delta frame with the blocks that changed. The
+ * changed blocks are copied to the \a reference image and encoded with the
+ * given JPEG \a quality. The number of encoded pixels is written to
+ * \a pixels, which is used by the rate control.
+ *
+ * The \a sequence (the number of frames since the last keyframe) is written
+ * to the header, so that the stations can tell if they lost a frame.
+ *
+ * If the \a reference image is invalid or too many blocks changed, this
+ * function shall return an empty byte array, in which case a full frame
+ * should be sent instead
+ */
+QByteArray QCCTV_CreateDeltaFrame (const QImage& image,
+                                   QImage* reference,
+                                   const int sequence,
+                                   const int quality,
+                                   int* pixels)
+{
+    /* Nothing has been encoded yet */
+    if (pixels)
+        *pixels = 0;
+
+    /* Reference image is not valid */
+    if (!reference || reference->isNull() || reference->size() != image.size())
+        return QByteArray();
+
+    /* Get image in the same format as the reference */
+    const QImage current = image.convertToFormat (QImage::Format_RGB32);
+    const int columns = block_columns (current.width());
+    const int rows = block_rows (current.height());
+
+    /* Get changed blocks */
+    QVector<int> changed;
+    for (int y = 0; y < rows; ++y) {
+        for (int x = 0; x < columns; ++x) {
+            if (block_changed (current, *reference,
+                               x * QCCTV_DELTA_BLOCK_SIZE,
+                               y * QCCTV_DELTA_BLOCK_SIZE))
+                changed.append (y * columns + x);
+        }
+    }
+
+    /* Too many blocks changed, a full frame is cheaper */
+    if (changed.count() * 100 > columns * rows * QCCTV_DELTA_MAX_CHANGE)
+        return QByteArray();
+
+    /* Write header */
+    QByteArray data;
+    data.append ((char) QCCTV_FRAME_DELTA);
+    data.append ((char) (sequence & 0xff));
+    data.append ((char) ((current.width() & 0xff00) >> 8));
+    data.append ((char) (current.width() & 0xff));
+    data.append ((char) ((current.height() & 0xff00) >> 8));
+    data.append ((char) (current.height() & 0xff));
+
+    /* Write bitmap */
+    QByteArray bitmap ((columns * rows + 7) / 8, 0);
+    foreach (int block, changed)
+        bitmap [block / 8] = (char) (bitmap.at (block / 8) | (1 << (block % 8)));
+
+    data.append (bitmap);
+
+    /* Nothing changed, no need to send a mosaic */
+    if (changed.isEmpty())
+        return data;
+
+    /* Create mosaic with the changed blocks */
+    const int mosaicColumns = mosaic_columns (changed.count());
+    const int mosaicRows = (changed.count() + mosaicColumns - 1) / mosaicColumns;
+    QImage mosaic (mosaicColumns * QCCTV_DELTA_BLOCK_SIZE,
+                   mosaicRows * QCCTV_DELTA_BLOCK_SIZE,
+                   QImage::Format_RGB32);
+    mosaic.fill (Qt::black);
+
+    /* Copy changed blocks to the mosaic and to the reference image */
+    for (int i = 0; i < changed.count(); ++i) {
+        const int x = (changed.at (i) % columns) * QCCTV_DELTA_BLOCK_SIZE;
+        const int y = (changed.at (i) / columns) * QCCTV_DELTA_BLOCK_SIZE;
+        const int mx = (i % mosaicColumns) * QCCTV_DELTA_BLOCK_SIZE;
+        const int my = (i / mosaicColumns) * QCCTV_DELTA_BLOCK_SIZE;
+
+        copy_block (current, x, y, &mosaic, mx, my);
+        copy_block (current, x, y, reference, x, y);
+    }
+
+    /* Keep luma-only streams single-component */
+    if (image.format() == QImage::Format_Grayscale8)
+        mosaic = mosaic.convertToFormat (QImage::Format_Grayscale8);
+
+    /* Append the mosaic as a JPEG image */
+    data.append (QCCTV_EncodeImage (mosaic, QCCTV_Original, quality));
+    if (pixels)
+        *pixels = mosaic.width() * mosaic.height();
+
+    return data;
+}
+
+/**
+ * Copies the blocks of the given delta frame \a data to the \a reference
+ * image.
+ *
+ * This function shall return \c false if the frame is invalid or if it
+ * cannot be applied to the \a reference image (e.g. because we did not
+ * receive a keyframe yet or because the \a sequence of the frame does not
+ * match, which means that we lost the previous frame)
+ */
+bool QCCTV_ApplyDeltaFrame (const QByteArray& data,
+                            QImage* reference,
+                            const int sequence)
+{
+    /* Invalid arguments */
+    if (!reference || !QCCTV_IsDeltaFrame (data) || data.size() < HEADER_LENGTH)
+        return false;
+
+    /* Frame was not generated from our reference image */
+    if ((quint8) data.at (1) != (sequence & 0xff))
+        return false;
+
+    /* Get frame size */
+    const int width = ((quint8) data.at (2) << 8) | (quint8) data.at (3);
+    const int height = ((quint8) data.at (4) << 8) | (quint8) data.at (5);
+
+    /* Reference image does not match frame */
+    if (reference->isNull() || reference->size() != QSize (width, height))
+        return false;
+
+    /* Get the bitmap */
+    const int columns = block_columns (width);
+    const int rows = block_rows (height);
+    const int bitmapLength = (columns * rows + 7) / 8;
+    if (data.size() < HEADER_LENGTH + bitmapLength)
+        return false;
+
+    /* Get the changed blocks */
+    QVector<int> changed;
+    for (int block = 0; block < columns * rows; ++block) {
+        const quint8 byte = data.at (HEADER_LENGTH + block / 8);
+        if (byte & (1 << (block % 8)))
+            changed.append (block);
+    }
+
+    /* Nothing changed */
+    if (changed.isEmpty())
+        return true;
+
+    /* Decode the mosaic */
+    const int mosaicColumns = mosaic_columns (changed.count());
+    const int mosaicRows = (changed.count() + mosaicColumns - 1) / mosaicColumns;
+    QImage mosaic = QImage::fromData (data.mid (HEADER_LENGTH + bitmapLength));
+    if (mosaic.width() < mosaicColumns * QCCTV_DELTA_BLOCK_SIZE ||
+        mosaic.height() < mosaicRows * QCCTV_DELTA_BLOCK_SIZE)
+        return false;
+
+    /* Copy the blocks to the reference image */
+    mosaic = mosaic.convertToFormat (QImage::Format_RGB32);
+    if (reference->format() != QImage::Format_RGB32)
+        *reference = reference->convertToFormat (QImage::Format_RGB32);
+
+    for (int i = 0; i < changed.count(); ++i) {
+        const int x = (changed.at (i) % columns) * QCCTV_DELTA_BLOCK_SIZE;
+        const int y = (changed.at (i) / columns) * QCCTV_DELTA_BLOCK_SIZE;
+        const int mx = (i % mosaicColumns) * QCCTV_DELTA_BLOCK_SIZE;
+        const int my = (i / mosaicColumns) * QCCTV_DELTA_BLOCK_SIZE;
+
+        copy_block (mosaic, mx, my, reference, x, y);
+    }
+
+    return true;
+}
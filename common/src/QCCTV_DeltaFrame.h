@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_DELTA_FRAME_H
+#define _QCCTV_DELTA_FRAME_H
+
+#include <QImage>
+#include <QByteArray>
+
+/*
+ * Delta frames only carry the 16x16 blocks that changed since the previous
+ * frame. They are composed of a header (frame type, sequence, width and
+ * height), a bitmap with one bit per block and a JPEG mosaic with the
+ * changed blocks. The sequence is the number of frames since the keyframe.
+ *
+ * Full frames are sent as plain JPEG data, which always starts with the
+ * 0xFF 0xD8 marker, so the first byte is enough to tell both types apart.
+ */
+extern bool QCCTV_IsDeltaFrame (const QByteArray& data);
+extern int QCCTV_DeltaFrameHeaderLength (const QByteArray& data);
+extern bool QCCTV_ApplyDeltaFrame (const QByteArray& data,
+                                   QImage* reference,
+                                   const int sequence);
+extern QByteArray QCCTV_CreateDeltaFrame (const QImage& image,
+                                          QImage* reference,
+                                          const int sequence,
+                                          const int quality,
+                                          int* pixels);
+
+#endif
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_Scaler.h"
+#include "QCCTV_Denoiser.h"
+
+#include <QVector>
+#include <QElapsedTimer>
+#include <string.h>
+
+/*
+ * Select the available SIMD instruction sets
+ */
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define QCCTV_DENOISER_SSE2
+    #include <emmintrin.h>
+#endif
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+    #define QCCTV_DENOISER_AVX2
+    #include <immintrin.h>
+#endif
+#if defined (ARM_NEON_ENABLE) || defined (__ARM_NEON) || defined (__ARM_NEON__)
+    #define QCCTV_DENOISER_NEON
+    #include <arm_neon.h>
+#endif
+
+/*
+ * Each blending step halves the weight of the current frame, the thresholds
+ * are given in luma/color units (0-255)
+ */
+static const int BLEND_STEPS      = 2;
+static const int PIXEL_THRESHOLD  = 20;
+static const int MOTION_THRESHOLD = 6;
+
+/*
+ * Filter kernels, for each byte:
+ *
+ *   x = cur, repeated BLEND_STEPS times: x = (prev + x + 1) / 2
+ *   dst = |cur - prev| <= PIXEL_THRESHOLD ? x : cur
+ */
+
+#ifdef QCCTV_DENOISER_AVX2
+__attribute__ ((target ("avx2")))
+static int filter_avx2 (uchar* dst, const uchar* cur, const uchar* prev,
+                        const int count)
+{
+    int i = 0;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i threshold = _mm256_set1_epi8 (PIXEL_THRESHOLD);
+    for (; i + 32 <= count; i += 32) {
+        __m256i c = _mm256_loadu_si256 ((const __m256i*) (cur + i));
+        __m256i p = _mm256_loadu_si256 ((const __m256i*) (prev + i));
+
+        __m256i x = c;
+        for (int s = 0; s < BLEND_STEPS; ++s)
+            x = _mm256_avg_epu8 (p, x);
+
+        __m256i diff = _mm256_or_si256 (_mm256_subs_epu8 (c, p),
+                                        _mm256_subs_epu8 (p, c));
+        __m256i still = _mm256_cmpeq_epi8 (_mm256_subs_epu8 (diff, threshold),
+                                           zero);
+
+        x = _mm256_or_si256 (_mm256_and_si256 (still, x),
+                             _mm256_andnot_si256 (still, c));
+        _mm256_storeu_si256 ((__m256i*) (dst + i), x);
+    }
+
+    return i;
+}
+#endif
+
+#ifdef QCCTV_DENOISER_SSE2
+static int filter_sse2 (uchar* dst, const uchar* cur, const uchar* prev,
+                        const int count)
+{
+    int i = 0;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i threshold = _mm_set1_epi8 (PIXEL_THRESHOLD);
+    for (; i + 16 <= count; i += 16) {
+        __m128i c = _mm_loadu_si128 ((const __m128i*) (cur + i));
+        __m128i p = _mm_loadu_si128 ((const __m128i*) (prev + i));
+
+        __m128i x = c;
+        for (int s = 0; s < BLEND_STEPS; ++s)
+            x = _mm_avg_epu8 (p, x);
+
+        __m128i diff = _mm_or_si128 (_mm_subs_epu8 (c, p),
+                                     _mm_subs_epu8 (p, c));
+        __m128i still = _mm_cmpeq_epi8 (_mm_subs_epu8 (diff, threshold), zero);
+
+        x = _mm_or_si128 (_mm_and_si128 (still, x),
+                          _mm_andnot_si128 (still, c));
+        _mm_storeu_si128 ((__m128i*) (dst + i), x);
+    }
+
+    return i;
+}
+#endif
+
+#ifdef QCCTV_DENOISER_NEON
+static int filter_neon (uchar* dst, const uchar* cur, const uchar* prev,
+                        const int count)
+{
+    int i = 0;
+    const uint8x16_t threshold = vdupq_n_u8 (PIXEL_THRESHOLD);
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t c = vld1q_u8 (cur + i);
+        uint8x16_t p = vld1q_u8 (prev + i);
+
+        uint8x16_t x = c;
+        for (int s = 0; s < BLEND_STEPS; ++s)
+            x = vrhaddq_u8 (p, x);
+
+        uint8x16_t still = vcleq_u8 (vabdq_u8 (c, p), threshold);
+        vst1q_u8 (dst + i, vbslq_u8 (still, x, c));
+    }
+
+    return i;
+}
+#endif
+
+/**
+ * Filters \a count bytes of the \a cur row with the \a prev row
+ */
+static void filter_row (uchar* dst, const uchar* cur, const uchar* prev,
+                        const int count)
+{
+    int i = 0;
+    const int simd = QCCTV_EnabledSimd();
+    Q_UNUSED (simd);
+
+#ifdef QCCTV_DENOISER_AVX2
+    if (simd & QCCTV_SIMD_AVX2)
+        i = filter_avx2 (dst, cur, prev, count);
+#endif
+#ifdef QCCTV_DENOISER_SSE2
+    if (simd & QCCTV_SIMD_SSE2)
+        i += filter_sse2 (dst + i, cur + i, prev + i, count - i);
+#endif
+#ifdef QCCTV_DENOISER_NEON
+    if (simd & QCCTV_SIMD_NEON)
+        i += filter_neon (dst + i, cur + i, prev + i, count - i);
+#endif
+
+    for (; i < count; ++i) {
+        int x = cur [i];
+        for (int s = 0; s < BLEND_STEPS; ++s)
+            x = (prev [i] + x + 1) >> 1;
+
+        dst [i] = qAbs (cur [i] - prev [i]) <= PIXEL_THRESHOLD ? x : cur [i];
+    }
+}
+
+/**
+ * Initializes the filter with the default time budget
+ */
+QCCTV_Denoiser::QCCTV_Denoiser()
+{
+    m_budget = QCCTV_DEFAULT_DENOISE_BUDGET;
+}
+
+/**
+ * Returns the maximum time (in milliseconds) spent filtering each frame
+ */
+int QCCTV_Denoiser::timeBudget() const
+{
+    return m_budget;
+}
+
+/**
+ * Discards the previous frame, the next frame shall not be filtered
+ */
+void QCCTV_Denoiser::reset()
+{
+    m_luma.clear();
+    m_previous = QImage();
+}
+
+/**
+ * Changes the maximum time (in milliseconds) spent filtering each frame
+ */
+void QCCTV_Denoiser::setTimeBudget (const int budget)
+{
+    m_budget = qMax (budget, 1);
+}
+
+/**
+ * Filters the given \a image with the previous frame and returns the result
+ * (as a 32-bit RGB image, or as a grayscale image for luma-only streams)
+ */
+QImage QCCTV_Denoiser::process (const QImage& image)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    /* Get the image (keep luma-only images in grayscale) and its luma plane */
+    QImage current = image;
+    if (current.format() != QImage::Format_Grayscale8)
+        current = current.convertToFormat (QImage::Format_RGB32);
+
+    /* Average the luma plane over each cell, so that the noise of single
+     * pixels is not detected as motion in low light */
+    const QSize cells (QCCTV_MOTION_WIDTH, QCCTV_MOTION_HEIGHT);
+    QImage small = QCCTV_DownscaleImage (current, cells, QCCTV_SCALE_AREA);
+    QByteArray luma = QCCTV_CreateLumaPlane (small);
+
+    /* No previous frame to compare with */
+    if (m_previous.size() != current.size() ||
+        m_previous.format() != current.format() ||
+        m_luma.size() != luma.size()) {
+        m_luma = luma;
+        m_previous = current;
+        return current;
+    }
+
+    /* Get the moving cells of the luma plane */
+    QVector<bool> moving (luma.size());
+    for (int i = 0; i < luma.size(); ++i) {
+        int diff = (quint8) luma.at (i) - (quint8) m_luma.at (i);
+        moving [i] = qAbs (diff) > MOTION_THRESHOLD;
+    }
+
+    /* Get the first column of each cell */
+    const int width = current.width();
+    const int height = current.height();
+    QVector<int> columns (QCCTV_MOTION_WIDTH + 1);
+    for (int i = 0; i <= QCCTV_MOTION_WIDTH; ++i)
+        columns [i] = (i * width) / QCCTV_MOTION_WIDTH;
+
+    /* Filter each row */
+    const int bpp = current.depth() / 8;
+    QImage output (current.size(), current.format());
+    for (int y = 0; y < height; ++y) {
+        uchar* dst = output.scanLine (y);
+        const uchar* cur = current.constScanLine (y);
+        const uchar* prev = m_previous.constScanLine (y);
+
+        /* We are over the time budget, copy the remaining rows */
+        if ((y & 7) == 0 && timer.elapsed() >= m_budget) {
+            for (; y < height; ++y)
+                memcpy (output.scanLine (y), current.constScanLine (y),
+                        width * bpp);
+
+            break;
+        }
+
+        /* Filter the static cells, copy the moving cells */
+        const int row = (y * QCCTV_MOTION_HEIGHT / height) * QCCTV_MOTION_WIDTH;
+        for (int cell = 0; cell < QCCTV_MOTION_WIDTH;) {
+            const bool move = moving.at (row + cell);
+
+            /* Get a run of cells with the same state */
+            int end = cell + 1;
+            while (end < QCCTV_MOTION_WIDTH && moving.at (row + end) == move)
+                ++end;
+
+            const int offset = columns.at (cell) * bpp;
+            const int count = (columns.at (end) - columns.at (cell)) * bpp;
+            if (move)
+                memcpy (dst + offset, cur + offset, count);
+            else
+                filter_row (dst + offset, cur + offset, prev + offset, count);
+
+            cell = end;
+        }
+    }
+
+    /* Save the state for the next frame */
+    m_luma = luma;
+    m_previous = output;
+    return output;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_DENOISER_H
+#define _QCCTV_DENOISER_H
+
+#include <QImage>
+#include <QByteArray>
+
+/**
+ * \brief Motion-adaptive temporal noise reduction filter.
+ *
+ * Each frame is blended with the previous (filtered) frame. Regions that
+ * changed in the (area-averaged) low-resolution luma plane, as well as
+ * single pixels that changed more than the expected noise level, are not
+ * blended, which avoids ghosting of moving objects.
+ *
+ * Rows that cannot be processed within the time budget are passed through.
+ */
+class QCCTV_Denoiser
+{
+public:
+    explicit QCCTV_Denoiser();
+
+    int timeBudget() const;
+
+    void reset();
+    void setTimeBudget (const int budget);
+    QImage process (const QImage& image);
+
+private:
+    int m_budget;
+    QImage m_previous;
+    QByteArray m_luma;
+};
+
+#endif
@@ -1,240 +1,420 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#include "yuv2rgb.h"
-#include "QCCTV_ImageCapture.h"
-
-#include "QCCTV.h"
-
-#include <QScreen>
-#include <QCamera>
-#include <QVideoProbe>
-#include <QCameraInfo>
-#include <QGuiApplication>
-
-QCCTV_ImageCapture::QCCTV_ImageCapture (QObject* parent) :
-    QAbstractVideoSurface (parent)
-{
-    m_enabled = false;
-    m_probe = Q_NULLPTR;
-    m_camera = Q_NULLPTR;
-
-    if (!parent) {
-        m_thread.start();
-        moveToThread (&m_thread);
-    }
-}
-
-QCCTV_ImageCapture::~QCCTV_ImageCapture()
-{
-    if (m_probe)
-        delete m_probe;
-}
-
-/**
- * Returns the supported pixel formats of the frame grabber, we just return
- * all available pixel formats to avoid issues...
- */
-QList<QVideoFrame::PixelFormat> QCCTV_ImageCapture::supportedPixelFormats
-(QAbstractVideoBuffer::HandleType handleType) const
-{
-    Q_UNUSED (handleType);
-
-    return QList<QVideoFrame::PixelFormat>()
-           << QVideoFrame::Format_ARGB32
-           << QVideoFrame::Format_ARGB32_Premultiplied
-           << QVideoFrame::Format_RGB32
-           << QVideoFrame::Format_RGB24
-           << QVideoFrame::Format_RGB565
-           << QVideoFrame::Format_RGB555
-           << QVideoFrame::Format_ARGB8565_Premultiplied
-           << QVideoFrame::Format_BGRA32
-           << QVideoFrame::Format_BGRA32_Premultiplied
-           << QVideoFrame::Format_BGR32
-           << QVideoFrame::Format_BGR24
-           << QVideoFrame::Format_BGR565
-           << QVideoFrame::Format_BGR555
-           << QVideoFrame::Format_BGRA5658_Premultiplied
-           << QVideoFrame::Format_AYUV444
-           << QVideoFrame::Format_AYUV444_Premultiplied
-           << QVideoFrame::Format_YUV444
-           << QVideoFrame::Format_YUV420P
-           << QVideoFrame::Format_YV12
-           << QVideoFrame::Format_UYVY
-           << QVideoFrame::Format_YUYV
-           << QVideoFrame::Format_NV12
-           << QVideoFrame::Format_NV21
-           << QVideoFrame::Format_IMC1
-           << QVideoFrame::Format_IMC2
-           << QVideoFrame::Format_IMC3
-           << QVideoFrame::Format_IMC4
-           << QVideoFrame::Format_Y8
-           << QVideoFrame::Format_Y16
-           << QVideoFrame::Format_Jpeg
-           << QVideoFrame::Format_CameraRaw
-           << QVideoFrame::Format_AdobeDng;
-}
-
-/**
- * Returns the current processed camera frame
- */
-QImage QCCTV_ImageCapture::image() const
-{
-    return m_image;
-}
-
-/**
- * Returns \c true if the capturer is allowed to process image frames from
- * the media source (camera)
- */
-bool QCCTV_ImageCapture::isEnabled() const
-{
-    return m_enabled;
-}
-
-/**
- * Changes the source from which we shall obtain (and process) the images
- */
-void QCCTV_ImageCapture::setSource (QCamera* source)
-{
-    m_camera = source;
-    m_info = QCameraInfo (*source);
-
-#ifdef QCCTV_USE_FALLBACK_INTERFACE
-    if (m_probe)
-        delete m_probe;
-
-    m_probe = new QVideoProbe;
-    m_probe->setSource (source);
-    connect (m_probe, SIGNAL (videoFrameProbed (QVideoFrame)),
-             this,      SLOT (present          (QVideoFrame)));
-#else
-    m_camera->setViewfinder (this);
-#endif
-
-    if (m_camera->state() != QCamera::ActiveState)
-        m_camera->start();
-}
-
-/**
- * Changes the \a enabled state of the grabber
- */
-void QCCTV_ImageCapture::setEnabled (const bool enabled)
-{
-    m_enabled = enabled;
-}
-
-/**
- * Checks if the image is valid and rotates it to fix issues with mobile/touch screens
- */
-bool QCCTV_ImageCapture::publishImage()
-{
-    /* Image is invalid or camera not loaded */
-    if (m_image.isNull() || !m_camera)
-        m_image = QCCTV_CreateStatusImage (QSize (640, 480), "NO CAMERA IMAGE");
-
-    /* Image is valid, rotate image to compensate camera orientation */
-    else {
-        /* Get current display rotation */
-        const QScreen* screen = QGuiApplication::primaryScreen();
-        const int angle = screen->angleBetween (screen->nativeOrientation(),
-                                                screen->orientation());
-
-        /* Rotate image */
-        const int rotation = (360 - m_info.orientation() + angle) % 360;
-        m_image = m_image.transformed (QTransform().rotate (rotation));
-
-        /* Fix upside-down image on Windows */
-#if defined Q_OS_WIN
-        m_image = m_image.mirrored (false, true);
-#endif
-    }
-
-    /* Notify QCCTV */
-    emit newFrame();
-    return !m_image.isNull();
-}
-
-/**
- * Generates a \c QImage from the given \a frame
- */
-bool QCCTV_ImageCapture::present (const QVideoFrame& frame)
-{
-    /* Frame is invalid or grabber is disabled */
-    if (!frame.isValid() || !isEnabled())
-        return false;
-
-    /* Clone the frame (so that we can use it) */
-    QVideoFrame clone (frame);
-    if (!clone.map (QAbstractVideoBuffer::ReadOnly))
-        return false;
-
-    /* Get the image format from the pixel format of the frame */
-    const QImage::Format format = QVideoFrame::imageFormatFromPixelFormat (clone.pixelFormat());
-
-    /* This is simple, the format is supported natively by Qt */
-    if (format != QImage::Format_Invalid)
-        m_image = QImage (clone.bits(),
-                          clone.width(),
-                          clone.height(),
-                          clone.bytesPerLine(),
-                          format);
-
-    /* This is an NV12/NV21 image (Qt does not support YUV images yet) */
-    else if (clone.pixelFormat() == QVideoFrame::Format_NV12 ||
-             clone.pixelFormat() == QVideoFrame::Format_NV21) {
-        /* Create initial image */
-        bool success = false;
-        QImage image (clone.width(), clone.height(), QImage::Format_RGB888);
-
-        /* Perform NV12 to RGB conversion */
-        if (clone.pixelFormat() == QVideoFrame::Format_NV12)
-            success = nv12_to_rgb (image.bits(),
-                                   clone.bits(),
-                                   clone.width(),
-                                   clone.height());
-
-        /* Perform NV21 to RGB conversion */
-        else if (clone.pixelFormat() == QVideoFrame::Format_NV21)
-            success = nv21_to_rgb (image.bits(),
-                                   clone.bits(),
-                                   clone.width(),
-                                   clone.height());
-
-        /* Re-assign the image */
-        if (success)
-            m_image = image;
-    }
-
-    /* Image format is not handled by Qt or QCCTV, generate grayscale image */
-    else if (clone.bits()) {
-        m_image = QImage (clone.bits(),
-                          clone.width(),
-                          clone.height(),
-                          clone.bytesPerLine(),
-                          QImage::Format_Grayscale8);
-    }
-
-    /* Unmap the frame data and process the obtained image */
-    clone.unmap();
-    return publishImage();
-}
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "yuv2rgb.h"
+#include "QCCTV_ImageCapture.h"
+
+#include "QCCTV.h"
+
+#include <QScreen>
+#include <QCamera>
+#include <QVideoProbe>
+#include <QCameraInfo>
+#include <QGuiApplication>
+#include <QCameraViewfinderSettings>
+
+/**
+ * Generates a low-resolution luma plane (used for motion detection) by
+ * averaging the pixels of the given 8-bit \a plane. Only every other row
+ * and column is sampled to keep the cost low with large frames.
+ */
+static QByteArray downsample_luma (const uchar* plane,
+                                   const int width,
+                                   const int height,
+                                   const int stride)
+{
+    if (!plane || width < QCCTV_MOTION_WIDTH || height < QCCTV_MOTION_HEIGHT)
+        return QByteArray();
+
+    /* Get the output cell of each sampled column */
+    QVector<int> columns ((width + 1) / 2);
+    for (int i = 0; i < columns.size(); ++i)
+        columns [i] = (2 * i * QCCTV_MOTION_WIDTH) / width;
+
+    /* Accumulate the sampled pixels of each cell */
+    QVector<int> sums (QCCTV_MOTION_WIDTH * QCCTV_MOTION_HEIGHT, 0);
+    QVector<int> count (QCCTV_MOTION_WIDTH * QCCTV_MOTION_HEIGHT, 0);
+    for (int y = 0; y < height; y += 2) {
+        const int offset = (y * QCCTV_MOTION_HEIGHT / height) * QCCTV_MOTION_WIDTH;
+        const uchar* row = plane + y * stride;
+
+        for (int i = 0; i < columns.size(); ++i) {
+            sums [offset + columns [i]] += row [2 * i];
+            count [offset + columns [i]] += 1;
+        }
+    }
+
+    /* Get the average of each cell */
+    QByteArray luma (sums.size(), 0);
+    for (int i = 0; i < sums.size(); ++i)
+        luma [i] = count [i] > 0 ? sums [i] / count [i] : 0;
+
+    return luma;
+}
+
+/**
+ * Returns the mean chroma level (0-255) of the given 8-bit interleaved
+ * \a uv plane (as used by NV12/NV21 frames). Only every fourth sample of
+ * every fourth row is read, which is enough to tell if there is any color
+ */
+static int chroma_level (const uchar* uv,
+                         const int width,
+                         const int height,
+                         const int stride)
+{
+    if (!uv || width < 2 || height < 2)
+        return 0;
+
+    qint64 sum = 0;
+    qint64 count = 0;
+    for (int y = 0; y < height / 2; y += 4) {
+        const uchar* row = uv + y * stride;
+        for (int x = 0; x + 1 < width; x += 8) {
+            sum += qAbs (row [x] - 128) + qAbs (row [x + 1] - 128);
+            ++count;
+        }
+    }
+
+    return count > 0 ? sum / count : 0;
+}
+
+QCCTV_ImageCapture::QCCTV_ImageCapture (QObject* parent) :
+    QAbstractVideoSurface (parent)
+{
+    m_chroma = 0;
+    m_frameRate = 0;
+    m_maxFrameRate = 0;
+    m_enabled = false;
+    m_grayscale = false;
+    m_probe = Q_NULLPTR;
+    m_camera = Q_NULLPTR;
+
+    if (!parent) {
+        m_thread.start();
+        moveToThread (&m_thread);
+    }
+}
+
+QCCTV_ImageCapture::~QCCTV_ImageCapture()
+{
+    if (m_probe)
+        delete m_probe;
+}
+
+/**
+ * Returns the supported pixel formats of the frame grabber, we just return
+ * all available pixel formats to avoid issues...
+ */
+QList<QVideoFrame::PixelFormat> QCCTV_ImageCapture::supportedPixelFormats
+(QAbstractVideoBuffer::HandleType handleType) const
+{
+    Q_UNUSED (handleType);
+
+    return QList<QVideoFrame::PixelFormat>()
+           << QVideoFrame::Format_ARGB32
+           << QVideoFrame::Format_ARGB32_Premultiplied
+           << QVideoFrame::Format_RGB32
+           << QVideoFrame::Format_RGB24
+           << QVideoFrame::Format_RGB565
+           << QVideoFrame::Format_RGB555
+           << QVideoFrame::Format_ARGB8565_Premultiplied
+           << QVideoFrame::Format_BGRA32
+           << QVideoFrame::Format_BGRA32_Premultiplied
+           << QVideoFrame::Format_BGR32
+           << QVideoFrame::Format_BGR24
+           << QVideoFrame::Format_BGR565
+           << QVideoFrame::Format_BGR555
+           << QVideoFrame::Format_BGRA5658_Premultiplied
+           << QVideoFrame::Format_AYUV444
+           << QVideoFrame::Format_AYUV444_Premultiplied
+           << QVideoFrame::Format_YUV444
+           << QVideoFrame::Format_YUV420P
+           << QVideoFrame::Format_YV12
+           << QVideoFrame::Format_UYVY
+           << QVideoFrame::Format_YUYV
+           << QVideoFrame::Format_NV12
+           << QVideoFrame::Format_NV21
+           << QVideoFrame::Format_IMC1
+           << QVideoFrame::Format_IMC2
+           << QVideoFrame::Format_IMC3
+           << QVideoFrame::Format_IMC4
+           << QVideoFrame::Format_Y8
+           << QVideoFrame::Format_Y16
+           << QVideoFrame::Format_Jpeg
+           << QVideoFrame::Format_CameraRaw
+           << QVideoFrame::Format_AdobeDng;
+}
+
+/**
+ * Returns the current processed camera frame
+ */
+QImage QCCTV_ImageCapture::image() const
+{
+    return m_image;
+}
+
+/**
+ * Returns the low-resolution luma plane of the current camera frame
+ */
+QByteArray QCCTV_ImageCapture::luma() const
+{
+    return m_luma;
+}
+
+/**
+ * Returns the mean chroma level (0-255) of the current camera frame, which
+ * is close to zero for monochrome (e.g. infrared) images
+ */
+int QCCTV_ImageCapture::chroma() const
+{
+    return m_chroma;
+}
+
+/**
+ * Returns \c true if the capturer is allowed to process image frames from
+ * the media source (camera)
+ */
+bool QCCTV_ImageCapture::isEnabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns \c true if YUV frames are published as grayscale images (from the
+ * Y plane), without converting them to RGB
+ */
+bool QCCTV_ImageCapture::grayscale() const
+{
+    return m_grayscale;
+}
+
+/**
+ * Returns the highest frame rate supported by the camera, or zero if the
+ * camera did not report its frame rates (yet)
+ */
+int QCCTV_ImageCapture::maximumFrameRate()
+{
+    if (m_maxFrameRate <= 0 && m_camera) {
+        foreach (QCamera::FrameRateRange range,
+                 m_camera->supportedViewfinderFrameRateRanges())
+            m_maxFrameRate = qMax (m_maxFrameRate,
+                                   (int) range.maximumFrameRate);
+    }
+
+    return m_maxFrameRate;
+}
+
+/**
+ * Changes the source from which we shall obtain (and process) the images
+ */
+void QCCTV_ImageCapture::setSource (QCamera* source)
+{
+    m_camera = source;
+    m_frameRate = 0;
+    m_maxFrameRate = 0;
+    m_info = QCameraInfo (*source);
+
+#ifdef QCCTV_USE_FALLBACK_INTERFACE
+    if (m_probe)
+        delete m_probe;
+
+    m_probe = new QVideoProbe;
+    m_probe->setSource (source);
+    connect (m_probe, SIGNAL (videoFrameProbed (QVideoFrame)),
+             this,      SLOT (present          (QVideoFrame)));
+#else
+    m_camera->setViewfinder (this);
+#endif
+
+    if (m_camera->state() != QCamera::ActiveState)
+        m_camera->start();
+}
+
+/**
+ * Changes the \a enabled state of the grabber
+ */
+void QCCTV_ImageCapture::setEnabled (const bool enabled)
+{
+    m_enabled = enabled;
+}
+
+/**
+ * Asks the camera to deliver at least \a fps frames per second. The camera
+ * is only re-configured for high frame rates (and when going back to normal
+ * frame rates), the default configuration is used otherwise
+ */
+void QCCTV_ImageCapture::setFrameRate (const int fps)
+{
+    int rate = qMax (fps, QCCTV_MAX_FPS);
+    if (!m_camera || m_frameRate == rate)
+        return;
+
+    /* Normal frame rates use the default camera settings */
+    if (m_frameRate <= QCCTV_MAX_FPS && rate <= QCCTV_MAX_FPS) {
+        m_frameRate = rate;
+        return;
+    }
+
+    /* Re-configure the camera */
+    m_frameRate = rate;
+    QCameraViewfinderSettings settings = m_camera->viewfinderSettings();
+    settings.setMinimumFrameRate (0);
+    settings.setMaximumFrameRate (rate > QCCTV_MAX_FPS ? rate : 0);
+    m_camera->setViewfinderSettings (settings);
+}
+
+/**
+ * Publishes YUV frames as grayscale images (from the Y plane) if
+ * \a grayscale is set to \c true
+ */
+void QCCTV_ImageCapture::setGrayscale (const bool grayscale)
+{
+    m_grayscale = grayscale;
+}
+
+/**
+ * Checks if the image is valid and rotates it to fix issues with mobile/touch screens
+ */
+bool QCCTV_ImageCapture::publishImage()
+{
+    /* Image is invalid or camera not loaded */
+    if (m_image.isNull() || !m_camera)
+        m_image = QCCTV_CreateStatusImage (QSize (640, 480), "NO CAMERA IMAGE");
+
+    /* Image is valid, rotate image to compensate camera orientation */
+    else {
+        /* Get current display rotation */
+        const QScreen* screen = QGuiApplication::primaryScreen();
+        const int angle = screen->angleBetween (screen->nativeOrientation(),
+                                                screen->orientation());
+
+        /* Rotate image */
+        const int rotation = (360 - m_info.orientation() + angle) % 360;
+        m_image = m_image.transformed (QTransform().rotate (rotation));
+
+        /* Fix upside-down image on Windows */
+#if defined Q_OS_WIN
+        m_image = m_image.mirrored (false, true);
+#endif
+    }
+
+    /* Notify QCCTV */
+    emit newFrame();
+    return !m_image.isNull();
+}
+
+/**
+ * Generates a \c QImage from the given \a frame
+ */
+bool QCCTV_ImageCapture::present (const QVideoFrame& frame)
+{
+    /* Frame is invalid or grabber is disabled */
+    if (!frame.isValid() || !isEnabled())
+        return false;
+
+    /* Clone the frame (so that we can use it) */
+    QVideoFrame clone (frame);
+    if (!clone.map (QAbstractVideoBuffer::ReadOnly))
+        return false;
+
+    /* Get the image format from the pixel format of the frame */
+    const QImage::Format format = QVideoFrame::imageFormatFromPixelFormat (clone.pixelFormat());
+
+    /* This is simple, the format is supported natively by Qt */
+    if (format != QImage::Format_Invalid) {
+        m_image = QImage (clone.bits(),
+                          clone.width(),
+                          clone.height(),
+                          clone.bytesPerLine(),
+                          format);
+
+        m_luma = QCCTV_CreateLumaPlane (m_image);
+        m_chroma = QCCTV_ChromaLevel (m_image);
+    }
+
+    /* This is an NV12/NV21 image (Qt does not support YUV images yet) */
+    else if (clone.pixelFormat() == QVideoFrame::Format_NV12 ||
+             clone.pixelFormat() == QVideoFrame::Format_NV21) {
+        /* Get the chroma level from the UV plane */
+        m_chroma = chroma_level (clone.bits() + clone.bytesPerLine() * clone.height(),
+                                 clone.width(),
+                                 clone.height(),
+                                 clone.bytesPerLine());
+
+        /* Get the luma plane directly from the Y plane */
+        m_luma = downsample_luma (clone.bits(),
+                                  clone.width(),
+                                  clone.height(),
+                                  clone.bytesPerLine());
+
+        /* Luma-only stream, use the Y plane and skip the RGB conversion */
+        if (grayscale())
+            m_image = QImage (clone.bits(),
+                              clone.width(),
+                              clone.height(),
+                              clone.bytesPerLine(),
+                              QImage::Format_Grayscale8).copy();
+
+        /* Convert the frame to RGB */
+        else {
+            bool success = false;
+            QImage image (clone.width(), clone.height(), QImage::Format_RGB888);
+
+            /* Perform NV12 to RGB conversion */
+            if (clone.pixelFormat() == QVideoFrame::Format_NV12)
+                success = nv12_to_rgb (image.bits(),
+                                       clone.bits(),
+                                       clone.width(),
+                                       clone.height());
+
+            /* Perform NV21 to RGB conversion */
+            else if (clone.pixelFormat() == QVideoFrame::Format_NV21)
+                success = nv21_to_rgb (image.bits(),
+                                       clone.bits(),
+                                       clone.width(),
+                                       clone.height());
+
+            /* Re-assign the image */
+            if (success)
+                m_image = image;
+        }
+    }
+
+    /* Image format is not handled by Qt or QCCTV, generate grayscale image */
+    else if (clone.bits()) {
+        m_image = QImage (clone.bits(),
+                          clone.width(),
+                          clone.height(),
+                          clone.bytesPerLine(),
+                          QImage::Format_Grayscale8);
+
+        m_chroma = 0;
+        m_luma = downsample_luma (clone.bits(),
+                                  clone.width(),
+                                  clone.height(),
+                                  clone.bytesPerLine());
+    }
+
+    /* Unmap the frame data and process the obtained image */
+    clone.unmap();
+    return publishImage();
+}
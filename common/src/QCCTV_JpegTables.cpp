@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV_JpegTables.h"
+
+/* JPEG markers */
+static const quint8 MARKER_SOI  = 0xD8;
+static const quint8 MARKER_SOS  = 0xDA;
+static const quint8 MARKER_DQT  = 0xDB;
+static const quint8 MARKER_DHT  = 0xC4;
+static const quint8 MARKER_APP0 = 0xE0;
+static const quint8 MARKER_APPF = 0xEF;
+
+/**
+ * Returns \c true if the given \a data starts with a JPEG SOI marker
+ */
+static bool is_jpeg (const QByteArray& data)
+{
+    return data.size() >= 4 &&
+           (quint8) data.at (0) == 0xFF &&
+           (quint8) data.at (1) == MARKER_SOI;
+}
+
+/**
+ * Returns the marker of the segment at the given \a pos of the \a jpeg data
+ * and writes the length of the segment (including the marker) to \a length.
+ *
+ * If the data is not valid, this function shall return \c 0
+ */
+static quint8 segment_at (const QByteArray& jpeg, const int pos, int* length)
+{
+    if (pos + 4 > jpeg.size() || (quint8) jpeg.at (pos) != 0xFF)
+        return 0;
+
+    *length = (((quint8) jpeg.at (pos + 2) << 8) |
+               (quint8) jpeg.at (pos + 3)) + 2;
+
+    if (pos + *length > jpeg.size())
+        return 0;
+
+    return (quint8) jpeg.at (pos + 1);
+}
+
+/**
+ * Returns \c true if the given \a jpeg image contains quantization tables,
+ * abbreviated images (which lack them) cannot be decoded directly
+ */
+bool QCCTV_HasJpegTables (const QByteArray& jpeg)
+{
+    if (!is_jpeg (jpeg))
+        return false;
+
+    int pos = 2;
+    int length = 0;
+    quint8 marker = 0;
+    while ((marker = segment_at (jpeg, pos, &length)) != 0) {
+        if (marker == MARKER_DQT)
+            return true;
+        if (marker == MARKER_SOS)
+            return false;
+
+        pos += length;
+    }
+
+    return false;
+}
+
+/**
+ * Removes the quantization and Huffman tables from the given \a jpeg image
+ * and returns them (as a sequence of DQT and DHT segments).
+ *
+ * If the image is not valid, it shall not be modified and this function
+ * shall return an empty byte array
+ */
+QByteArray QCCTV_ExtractJpegTables (QByteArray* jpeg)
+{
+    if (!jpeg || !is_jpeg (*jpeg))
+        return QByteArray();
+
+    /* Split the segments that precede the scan data */
+    int pos = 2;
+    int length = 0;
+    QByteArray tables;
+    QByteArray image = jpeg->left (2);
+    while (true) {
+        quint8 marker = segment_at (*jpeg, pos, &length);
+        if (marker == 0)
+            return QByteArray();
+        if (marker == MARKER_SOS)
+            break;
+
+        if (marker == MARKER_DQT || marker == MARKER_DHT)
+            tables.append (jpeg->mid (pos, length));
+        else
+            image.append (jpeg->mid (pos, length));
+
+        pos += length;
+    }
+
+    /* Append the scan data */
+    if (!tables.isEmpty()) {
+        image.append (jpeg->mid (pos));
+        *jpeg = image;
+    }
+
+    return tables;
+}
+
+/**
+ * Inserts the given \a tables in the abbreviated \a jpeg image after the
+ * application segments, so that it can be decoded and saved normally
+ */
+QByteArray QCCTV_RestoreJpegTables (const QByteArray& jpeg,
+                                    const QByteArray& tables)
+{
+    if (!is_jpeg (jpeg) || tables.isEmpty() || QCCTV_HasJpegTables (jpeg))
+        return jpeg;
+
+    /* Skip the application segments (e.g. JFIF header) */
+    int pos = 2;
+    int length = 0;
+    quint8 marker = 0;
+    while ((marker = segment_at (jpeg, pos, &length)) != 0) {
+        if (marker < MARKER_APP0 || marker > MARKER_APPF)
+            break;
+
+        pos += length;
+    }
+
+    /* Insert the tables */
+    QByteArray image = jpeg;
+    image.insert (pos, tables);
+    return image;
+}
@@ -1,791 +1,2322 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#include <QThread>
-#include <QSysInfo>
-#include <QCameraInfo>
-#include <QCameraFocus>
-#include <QFutureWatcher>
-#include <QCameraExposure>
-#include <QCameraImageCapture>
-#include <QtConcurrent/QtConcurrent>
-
-#include "QCCTV.h"
-#include "QCCTV_Watchdog.h"
-#include "QCCTV_LocalCamera.h"
-#include "QCCTV_ImageCapture.h"
-#include "QCCTV_Communications.h"
-
-QCCTV_LocalCamera::QCCTV_LocalCamera (QObject* parent) : QObject (parent)
-{
-    /* Initialize pointers */
-    m_camera = Q_NULLPTR;
-    m_capture = Q_NULLPTR;
-    m_imageCapture = new QCCTV_ImageCapture;
-
-    /* Initialzie packet pointers */
-    m_infoPacket = new QCCTV_InfoPacket;
-    m_imagePacket = new QCCTV_ImagePacket;
-    m_commandPacket = new QCCTV_CommandPacket;
-
-    /* Set initial packet information */
-    QCCTV_InitInfo (infoPacket());
-    QCCTV_InitImage (imagePacket());
-    QCCTV_InitCommand (commandPacket(), infoPacket());
-
-    /* Set device name as camera name */
-    infoPacket()->cameraName = deviceName();
-
-    /* Configure sockets */
-    connect (&m_server,    SIGNAL (newConnection()),
-             this,           SLOT (acceptConnection()));
-    connect (&m_cmdSocket, SIGNAL (readyRead()),
-             this,           SLOT (readCommandPacket()));
-
-    /* Configure listener sockets */
-    m_server.listen (QHostAddress::Any, QCCTV_STREAM_PORT);
-    m_cmdSocket.bind (QCCTV_COMMAND_PORT, QUdpSocket::ShareAddress);
-
-    /* Setup the frame grabber */
-    connect (m_imageCapture, SIGNAL (newFrame()),
-             this,             SLOT (changeImage()));
-
-    /* Setup additional notifiers */
-    connect (this, SIGNAL (hostCountChanged()),
-             this, SIGNAL (hostNamesChanged()));
-
-    /* Start the event loops */
-    QTimer::singleShot (1000, Qt::CoarseTimer, this, SLOT (update()));
-    QTimer::singleShot (1000, Qt::CoarseTimer, this, SLOT (broadcastInfo()));
-}
-
-/**
- * Closes all the sockets and the frontal camera device
- */
-QCCTV_LocalCamera::~QCCTV_LocalCamera()
-{
-    /* Close all TCP connections */
-    foreach (QTcpSocket* socket, m_sockets) {
-        socket->close();
-        socket->deleteLater();
-    }
-
-    /* Delete all watchdogs */
-    foreach (QCCTV_Watchdog* watchdog, m_watchdogs)
-        watchdog->deleteLater();
-
-    /* Close TCP server and clear socket lists */
-    m_server.close();
-    m_sockets.clear();
-    m_watchdogs.clear();
-    m_broadcastSocket.close();
-
-    /* Delete camera capture object */
-    if (m_capture)
-        delete m_capture;
-
-    /* Delete children */
-    delete m_imageCapture;
-    delete m_infoPacket;
-    delete m_commandPacket;
-}
-
-/**
- * Returns the current FPS of the camera
- */
-int QCCTV_LocalCamera::fps()
-{
-    return infoPacket()->fps;
-}
-
-/**
- * Returns the user-assigned name of the camera
- */
-QString QCCTV_LocalCamera::name()
-{
-    return infoPacket()->cameraName;
-}
-
-/**
- * Returns the user-assigned group of the camera
- */
-QString QCCTV_LocalCamera::group()
-{
-    return infoPacket()->cameraGroup;
-}
-
-/**
- * Returns the current zoom level of the camera
- */
-int QCCTV_LocalCamera::zoomLevel()
-{
-    return infoPacket()->zoom;
-}
-
-/**
- * Returns the current resolution as an \c int, which can be used by QML
- * interfaces directly
- */
-int QCCTV_LocalCamera::resolution()
-{
-    return infoPacket()->resolution;
-}
-
-/**
- * Returns the current status of the camera itself
- */
-int QCCTV_LocalCamera::cameraStatus()
-{
-    return infoPacket()->cameraStatus;
-}
-
-/**
- * Returns \c true if the camera is able to perform either optical
- * or digital zoom operations
- */
-bool QCCTV_LocalCamera::supportsZoom()
-{
-    return infoPacket()->supportsZoom;
-}
-
-/**
- * Returns the image that is currently being sent to the QCCTV stations
- */
-QImage QCCTV_LocalCamera::currentImage()
-{
-    return imagePacket()->image;
-}
-
-/**
- * Returns the current status of QCCTV in a string
- */
-QString QCCTV_LocalCamera::statusString()
-{
-    return QCCTV_GetStatusString (cameraStatus());
-}
-
-/**
- * Returns the current status of the flash light, which can be
- * set either by the camera itself or a remote QCCTV Station
- */
-int QCCTV_LocalCamera::flashlightEnabled()
-{
-    return infoPacket()->flashlightEnabled;
-}
-
-/**
- * Returns \c true if the camera is allows to auto-regulate its image
- * resolution to improve communication times
- */
-bool QCCTV_LocalCamera::autoRegulateResolution()
-{
-    return infoPacket()->autoRegulateResolution;
-}
-
-/**
- * Returns the minimum FPS value allowed by QCCTV, this function can be used
- * to set control/widget limits of QML or classic interfaces
- */
-int QCCTV_LocalCamera::minimumFPS() const
-{
-    return QCCTV_MIN_FPS;
-}
-
-/**
- * Returns the maximum FPS value allowed by QCCTV, this function can be used
- * to set control/widget limits of QML or classic interfaces
- */
-int QCCTV_LocalCamera::maximumFPS() const
-{
-    return QCCTV_MAX_FPS;
-}
-
-/**
- * Returns \c true if the camera is ready for saving photos
- */
-bool QCCTV_LocalCamera::readyForCapture() const
-{
-    if (m_camera && m_capture)
-        return m_capture->isReadyForCapture();
-
-    return false;
-}
-
-/**
- * Returns \c true if the camera's flashlight is ready for use
- */
-bool QCCTV_LocalCamera::flashlightAvailable() const
-{
-    if (m_camera)
-        return m_camera->exposure()->isFlashReady();
-
-    return false;
-}
-
-/**
- * Returns the user-friendly host names of the connected QCCTV Stations
- */
-QStringList QCCTV_LocalCamera::hostNames() const
-{
-    return m_hostNames;
-}
-
-/**
- * Returns a list with all the connected QCCTV stations to this camera
- */
-QStringList QCCTV_LocalCamera::connectedHosts() const
-{
-    QStringList list;
-
-    foreach (QTcpSocket* socket, m_sockets) {
-        QHostAddress address (socket->peerAddress().toIPv4Address());
-        list.append (address.toString());
-    }
-
-    return list;
-}
-
-/**
- * Returns a list with all the image resolutions supported by QCCTV.
- * This function can be used to populate a \c QComboBox or a QML model
- */
-QStringList QCCTV_LocalCamera::availableResolutions() const
-{
-    return QCCTV_Resolutions();
-}
-
-/**
- * Attempts to take a photo using the current camera
- */
-void QCCTV_LocalCamera::takePhoto()
-{
-    if (readyForCapture())
-        m_capture->capture();
-}
-
-/**
- * Forces the camera to re-focus the image
- */
-void QCCTV_LocalCamera::focusCamera()
-{
-    if (m_camera) {
-        m_camera->searchAndLock (QCamera::LockFocus);
-        emit focusStatusChanged();
-    }
-}
-
-/**
- * Changes the FPS of the camera
- */
-void QCCTV_LocalCamera::setFPS (const int fps)
-{
-    if (infoPacket()->fps != QCCTV_ValidFps (fps)) {
-        infoPacket()->fps = QCCTV_ValidFps (fps);
-
-        int time = QCCTV_GetWatchdogTime (infoPacket()->fps) / 2;
-        foreach (QCCTV_Watchdog* watchdog, m_watchdogs)
-            watchdog->setExpirationTime (time);
-
-        emit fpsChanged();
-    }
-}
-
-/**
- * Changes the camera used to capture images to send to the QCCTV network
- */
-void QCCTV_LocalCamera::setCamera (QCamera* camera)
-{
-    if (camera) {
-        /* Re-assign camera */
-        m_camera = camera;
-        m_camera->setCaptureMode (QCamera::CaptureStillImage);
-        m_imageCapture->setSource (m_camera);
-
-        /* Delete old camera modules */
-        if (m_capture)
-            delete m_capture;
-
-        /* Determine if camera supports zoom */
-        qreal digital = m_camera->focus()->maximumDigitalZoom();
-        qreal optical = m_camera->focus()->maximumOpticalZoom();
-        infoPacket()->supportsZoom = (digital != 1 || optical != 1);
-
-        /* Re-assign camera modules */
-        m_capture = new QCameraImageCapture (m_camera);
-
-        /* Notify UI */
-        emit cameraChanged();
-        emit supportsZoomChanged();
-    }
-}
-
-/**
- * Changes the name assigned to this camera
- */
-void QCCTV_LocalCamera::setName (const QString& name)
-{
-    /* Names are the same, abort */
-    if (infoPacket()->cameraName == name)
-        return;
-
-    /* Check if user just gave us empty spaces as input */
-    QString no_spaces = name;
-    no_spaces = no_spaces.replace (" ", "");
-
-    /* Re-assign the camera name */
-    if (no_spaces.isEmpty())
-        infoPacket()->cameraName = deviceName();
-    else
-        infoPacket()->cameraName = name;
-
-    /* Notify UI */
-    emit nameChanged();
-}
-
-/**
- * Changes the zoom level of the camera
- */
-void QCCTV_LocalCamera::setZoomLevel (const int level)
-{
-    /* Current zoom is the same as input zoom */
-    if (zoomLevel() == level)
-        return;
-
-    /* Change the zoom level (from 0 to 100) */
-    infoPacket()->zoom = qMin (qMax (level, 0), 100);
-
-    /* Instruct the camera to zoom in or zoom out */
-    if (m_camera && supportsZoom()) {
-        /* Get maximum zoom values */
-        qreal max_optical = m_camera->focus()->maximumOpticalZoom() - 1;
-        qreal max_digital = m_camera->focus()->maximumDigitalZoom() - 1;
-
-        /* Get adjusted zoom value */
-        qreal range = max_optical + max_digital;
-        qreal value = (qreal) (infoPacket()->zoom * range) / 100;
-
-        /* Initialize zoom levels */
-        qreal optical = 0;
-        qreal digital = 0;
-
-        /* Perform optical zoom first, then digital*/
-        if (max_optical > 0)
-            if (max_optical < value) {
-                optical = max_optical;
-                if (max_digital > 0)
-                    digital = value - max_digital;
-            } else
-                optical = value;
-
-        /* Only apply digital zoom */
-        else if (max_digital > 0)
-            digital = value;
-
-        /* Perform zoom operation */
-        m_camera->focus()->zoomTo (1 + optical, 1 + digital);
-        emit zoomLevelChanged();
-    }
-}
-
-/**
- * Changes the \a group assigned to the camera
- */
-void QCCTV_LocalCamera::setGroup (const QString& group)
-{
-    /* Names are the same, abort */
-    if (infoPacket()->cameraGroup == group)
-        return;
-
-    /* Check if user just gave us empty spaces as input */
-    QString no_spaces = group;
-    no_spaces = no_spaces.replace (" ", "");
-
-    /* Re-assign group name */
-    if (no_spaces.isEmpty())
-        infoPacket()->cameraGroup = "Default";
-    else
-        infoPacket()->cameraGroup = group;
-
-    /* Notify UI */
-    emit groupChanged();
-}
-
-/**
- * Changes the resolution of the image that the camera sends to the station
- */
-void QCCTV_LocalCamera::setResolution (const int resolution)
-{
-    if (infoPacket()->resolution != resolution) {
-        infoPacket()->resolution = resolution;
-        emit resolutionChanged();
-    }
-}
-
-/**
- * Turns on or off the flashlight based on the value of the \a enabled
- * parameter
- */
-void QCCTV_LocalCamera::setFlashlightEnabled (const bool enabled)
-{
-    infoPacket()->flashlightEnabled = enabled && flashlightAvailable();
-
-    if (flashlightEnabled())
-        m_camera->exposure()->setFlashMode (QCameraExposure::FlashVideoLight);
-
-    else
-        m_camera->exposure()->setFlashMode (QCameraExposure::FlashOff);
-
-    emit lightStatusChanged();
-}
-
-/**
- * Allows or disallows the camera from auto-regulating the image resolution
- * to improve the communication times.
- */
-void QCCTV_LocalCamera::setAutoRegulateResolution (const bool regulate)
-{
-    if (infoPacket()->autoRegulateResolution != regulate) {
-        infoPacket()->autoRegulateResolution = regulate;
-        emit autoRegulateResolutionChanged();
-    }
-}
-
-/**
- * Obtains a new image from the camera and updates the camera status
- */
-void QCCTV_LocalCamera::update()
-{
-    /* Get another image from the camera */
-    if (!m_imageCapture->isEnabled())
-        m_imageCapture->setEnabled (true);
-
-    /* Update camera info and send it */
-    sendInfo();
-    sendImage();
-    updateStatus();
-
-    /* Call the update function again */
-    QTimer::singleShot (1000 / fps(), this, SLOT (update()));
-}
-
-/**
- * Sends a camera information packet to all connected hosts
- */
-void QCCTV_LocalCamera::sendInfo()
-{
-    QByteArray info = QCCTV_CreateInfoPacket (infoPacket());
-    foreach (QString address, connectedHosts())
-        m_infoSocket.writeDatagram (info,
-                                    QHostAddress (address),
-                                    QCCTV_INFO_PORT);
-}
-
-/**
- * Sends an image packet to all connected hosts
- */
-void QCCTV_LocalCamera::sendImage()
-{
-    if (!m_data.isEmpty()) {
-        foreach (QTcpSocket* socket, m_sockets)
-            if (socket->isWritable())
-                socket->write (m_data);
-    }
-}
-
-/**
- * Replaces the current image and notifies the application
- */
-void QCCTV_LocalCamera::changeImage()
-{
-    /* Disable the capturer */
-    m_imageCapture->setEnabled (false);
-
-    /* Re-assign image */
-    imagePacket()->image = m_imageCapture->image();
-    emit imageChanged();
-
-    /* Generate the socket data and send it */
-    QFutureWatcher<void>* watcher = new QFutureWatcher<void> (this);
-    connect (watcher, SIGNAL (finished()), watcher, SLOT (deleteLater()));
-    watcher->setFuture (QtConcurrent::run (QCCTV_WriteImagePacket,
-                                           &m_data, imagePacket(),
-                                           infoPacket()));
-
-}
-
-/**
- * Creates and sends a new packet that announces the existence of this
- * camera to the local network
- */
-void QCCTV_LocalCamera::broadcastInfo()
-{
-    QString str = "QCCTV_DISCOVERY_SERVICE";
-
-    m_broadcastSocket.writeDatagram (str.toUtf8(),
-                                     QHostAddress::Broadcast,
-                                     QCCTV_DISCOVERY_PORT);
-
-    QTimer::singleShot (1000, this, SLOT (broadcastInfo()));
-}
-
-/**
- * Closes and un-registers a station when the TCP connection is aborted
- */
-void QCCTV_LocalCamera::onDisconnected()
-{
-    QTcpSocket* socket = qobject_cast<QTcpSocket*> (sender());
-    int index = m_sockets.indexOf (socket);
-
-    /* Abort connection */
-    socket->abort();
-    socket->deleteLater();
-
-    /* Delete objects */
-    m_sockets.at (index)->deleteLater();
-    m_watchdogs.at (index)->deleteLater();
-
-    /* Unregister watchdog and socket */
-    m_sockets.removeAt (index);
-    m_watchdogs.removeAt (index);
-
-    /* Notify application */
-    emit hostCountChanged();
-}
-
-/**
- * Called when a QCCTV station wants to receive images from this camera
- * This function shall configure the TCP socket used for streaming data
- */
-void QCCTV_LocalCamera::acceptConnection()
-{
-    while (m_server.hasPendingConnections()) {
-        QCCTV_Watchdog* watchdog = new QCCTV_Watchdog (this);
-        watchdog->setExpirationTime (QCCTV_GetWatchdogTime (infoPacket()->fps));
-
-        m_watchdogs.append (watchdog);
-        m_hostNames.append ("Unknown");
-        m_sockets.append (m_server.nextPendingConnection());
-        m_sockets.last()->setSocketOption (QTcpSocket::LowDelayOption, 1);
-        m_sockets.last()->setSocketOption (QTcpSocket::KeepAliveOption, 1);
-
-        connect (m_watchdogs.last(), SIGNAL (expired()),
-                 this,                 SLOT (onWatchdogTimeout()));
-        connect (m_sockets.last(),   SIGNAL (disconnected()),
-                 this,                 SLOT (onDisconnected()));
-        connect (m_sockets.last(),   SIGNAL (bytesWritten (qint64)),
-                 this,                 SLOT (onBytesWritten (qint64)));
-
-        emit hostCountChanged();
-    }
-}
-
-/**
- * Interprets a command packet issued by the QCCTV station in the LAN.
- *
- * This packet contains the following data/instructions:
- *
- * - A new FPS to use
- * - The new light status
- * - A force focus request
- */
-void QCCTV_LocalCamera::readCommandPacket()
-{
-    /* Get data and address */
-    QByteArray data;
-    QHostAddress address;
-    data.resize (m_cmdSocket.pendingDatagramSize());
-    m_cmdSocket.readDatagram (data.data(), data.length(), &address);
-
-    /* Read the command packet */
-    bool success = QCCTV_ReadCommandPacket (commandPacket(), data);
-    if (!success)
-        return;
-
-    /* Change host name */
-    QString ip = QHostAddress (address.toIPv4Address()).toString();
-    if (connectedHosts().contains (ip)) {
-        int index = connectedHosts().indexOf (ip);
-        if (m_hostNames.at (index) != commandPacket()->host) {
-            m_hostNames.replace (index, commandPacket()->host);
-            emit hostNamesChanged();
-        }
-    }
-
-    /* Change FPS */
-    if (commandPacket()->fpsChanged)
-        if (commandPacket()->oldFps == fps())
-            setFPS (commandPacket()->newFps);
-
-    /* Change zoom */
-    if (commandPacket()->zoomChanged)
-        if (commandPacket()->oldZoom == zoomLevel())
-            setZoomLevel (commandPacket()->newZoom);
-
-    /* Set resolution */
-    if (commandPacket()->resolutionChanged)
-        if (commandPacket()->oldResolution == resolution())
-            setResolution (commandPacket()->newResolution);
-
-    /* Set flashlight status */
-    if (commandPacket()->flashlightEnabledChanged)
-        if (commandPacket()->oldFlashlightEnabled == flashlightEnabled())
-            setFlashlightEnabled (commandPacket()->newFlashlightEnabled);
-
-    /* Change the auto-regulate resolution option */
-    if (commandPacket()->autoRegulateResolutionChanged)
-        if (commandPacket()->oldAutoRegulateResolution == autoRegulateResolution())
-            setAutoRegulateResolution (commandPacket()->newAutoRegulateResolution);
-
-    /* Focus the camera */
-    if (commandPacket()->focusRequest)
-        focusCamera();
-}
-
-/**
- * Gradually lowers the image quality when the station fails to reply on time
- */
-void QCCTV_LocalCamera::onWatchdogTimeout()
-{
-    if (resolution() == QCCTV_QCIF || !autoRegulateResolution())
-        return;
-
-    if (connectedHosts().isEmpty())
-        return;
-
-    setResolution ((QCCTV_Resolution) qMax ((int) QCCTV_CIF, resolution() - 1));
-}
-
-/**
- * Resets the watchdog for the socket that called this function
- */
-void QCCTV_LocalCamera::onBytesWritten (const qint64 bytes)
-{
-    QTcpSocket* socket = qobject_cast<QTcpSocket*> (sender());
-
-    if (socket && bytes > 0)
-        m_watchdogs.at (m_sockets.indexOf (socket))->reset();
-}
-
-/**
- * Updates the status code of the camera
- */
-void QCCTV_LocalCamera::updateStatus()
-{
-    /* Check if camera exists */
-    if (!m_camera)
-        addStatusFlag (QCCTV_CAMSTATUS_VIDEO_FAILURE);
-
-    /* Check if camera is active */
-    else if (m_camera->status() != QCamera::ActiveStatus)
-        addStatusFlag (QCCTV_CAMSTATUS_VIDEO_FAILURE);
-    else
-        removeStatusFlag (QCCTV_CAMSTATUS_VIDEO_FAILURE);
-
-    /* Check if flash light is available */
-    if (!flashlightAvailable())
-        addStatusFlag (QCCTV_CAMSTATUS_LIGHT_FAILURE);
-    else
-        removeStatusFlag (QCCTV_CAMSTATUS_LIGHT_FAILURE);
-}
-
-
-/**
- * Registers the given \a status flag to the operation status flags
- */
-void QCCTV_LocalCamera::addStatusFlag (const int status)
-{
-    if (! (infoPacket()->cameraStatus & status)) {
-        infoPacket()->cameraStatus |= status;
-        emit cameraStatusChanged();
-    }
-}
-
-/**
- * Overrides the camera status flags with the given \a status
- */
-void QCCTV_LocalCamera::setCameraStatus (const int status)
-{
-    infoPacket()->cameraStatus = status;
-    emit cameraStatusChanged();
-}
-
-/**
- * Removes the given \a status flag from the operation status of the camera
- */
-void QCCTV_LocalCamera::removeStatusFlag (const int status)
-{
-    if (infoPacket()->cameraStatus & status) {
-        infoPacket()->cameraStatus ^= status;
-        emit cameraStatusChanged();
-    }
-}
-
-/**
- * Returns the name and operating system of the camera device
- */
-QString QCCTV_LocalCamera::deviceName()
-{
-    QString device = QSysInfo::machineHostName();
-    if (device.isEmpty())
-        device = QSysInfo::prettyProductName();
-    else
-        device += " (" + QSysInfo::prettyProductName() + ")";
-
-    return device;
-}
-
-/**
- * Returns the pointer to the stream packet structure
- */
-QCCTV_InfoPacket* QCCTV_LocalCamera::infoPacket()
-{
-    if (m_infoPacket)
-        return m_infoPacket;
-
-    m_infoPacket = new QCCTV_InfoPacket;
-    return m_infoPacket;
-}
-
-/**
- * Returns the pointer to the image packet structure
- */
-QCCTV_ImagePacket* QCCTV_LocalCamera::imagePacket()
-{
-    if (m_imagePacket)
-        return m_imagePacket;
-
-    m_imagePacket = new QCCTV_ImagePacket;
-    return m_imagePacket;
-}
-
-
-/**
- * Returns the pointer to the command packet structure
- */
-QCCTV_CommandPacket* QCCTV_LocalCamera::commandPacket()
-{
-    if (m_commandPacket)
-        return m_commandPacket;
-
-    m_commandPacket = new QCCTV_CommandPacket;
-    return m_commandPacket;
-}
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <QThread>
+#include <QSysInfo>
+#include <QCameraInfo>
+#include <QCameraFocus>
+#include <QFutureWatcher>
+#include <QCameraExposure>
+#include <QCameraImageCapture>
+#include <QtConcurrent/QtConcurrent>
+
+#include "QCCTV.h"
+#include "QCCTV_Pacer.h"
+#include "QCCTV_Session.h"
+#include "QCCTV_RtpStream.h"
+#include "QCCTV_Watchdog.h"
+#include "QCCTV_LocalCamera.h"
+#include "QCCTV_ImageCapture.h"
+#include "QCCTV_SharedFrames.h"
+#include "QCCTV_DatagramStream.h"
+#include "QCCTV_Communications.h"
+#include "QCCTV_MotionDetector.h"
+
+/**
+ * Encodes the shared image \a packet and the image packets of the stations
+ * that requested a crop of the image (digital PTZ). The first item of the
+ * returned list is the shared stream, followed by the stream of each crop.
+ *
+ * If \a rtp is set, the last item of the list is the image encoded for the
+ * RTP/JPEG output.
+ *
+ * The \a info packet is a copy of the camera information, since the main
+ * thread may change it (e.g. with a station command) while we encode
+ */
+static QList<QByteArray> encode_streams (QCCTV_ImagePacket* packet,
+                                         const QList<QCCTV_ImagePacket*> crops,
+                                         const QCCTV_InfoPacket info,
+                                         const bool rtp)
+{
+    QList<QByteArray> streams;
+    streams.append (QCCTV_CreateImagePacket (packet, &info));
+
+    foreach (QCCTV_ImagePacket* crop, crops) {
+        crop->image = packet->image;
+        streams.append (QCCTV_CreateImagePacket (crop, &info));
+    }
+
+    if (rtp)
+        streams.append (QCCTV_RtpStream::encodeFrame (packet->image,
+                                                      info.resolution,
+                                                      info.quality));
+
+    return streams;
+}
+
+QCCTV_LocalCamera::QCCTV_LocalCamera (QObject* parent) : QObject (parent)
+{
+    /* Initialize pointers */
+    m_camera = Q_NULLPTR;
+    m_capture = Q_NULLPTR;
+    m_imageCapture = new QCCTV_ImageCapture;
+    m_motionDetector = new QCCTV_MotionDetector;
+    m_encoder = new QFutureWatcher<QList<QByteArray>> (this);
+    m_snapshotEncoder = new QFutureWatcher<QByteArray> (this);
+    m_snapshotTarget = Q_NULLPTR;
+    m_rtpStream = new QCCTV_RtpStream (this);
+    m_rtpEncoded = false;
+    m_multicastStream = new QCCTV_DatagramStream (this);
+
+    /* Spread the frames over the frame interval */
+    m_pacingEnabled = true;
+    m_pacingBurst = QCCTV_DEFAULT_PACING_BURST;
+
+    /* Shared memory is only created when a local station connects */
+    m_sharedFrames = Q_NULLPTR;
+    m_sharedFrameId = -1;
+    m_sharedSlot = 0;
+    m_sharedSequence = 0;
+
+    /* Set default idle frame rate */
+    m_idleFps = QCCTV_DEFAULT_IDLE_FPS;
+    m_idleClock.start();
+
+    /* High frame rates must be enabled by the user */
+    m_highFpsEnabled = false;
+
+    /* Frames are captured on a fixed timeline (see update()) */
+    m_nextFrame = 0;
+    m_captureTime = 0;
+    m_frameClock.start();
+    m_frameTimer = new QTimer (this);
+    m_frameTimer->setSingleShot (true);
+    m_frameTimer->setTimerType (Qt::PreciseTimer);
+
+    /* Send a keyframe with the first image */
+    m_frameId = 0;
+    m_selfContained = false;
+    m_keyframeRequested = true;
+
+    /* The first info packet is always a full packet */
+    m_fullInfoRequested = false;
+    QCCTV_InitState (&m_infoState);
+
+    /* Initialzie packet pointers */
+    m_infoPacket = new QCCTV_InfoPacket;
+    m_imagePacket = new QCCTV_ImagePacket;
+    m_commandPacket = new QCCTV_CommandPacket;
+
+    /* Set initial packet information */
+    QCCTV_InitInfo (infoPacket());
+    QCCTV_InitImage (imagePacket());
+    QCCTV_InitCommand (commandPacket(), infoPacket());
+
+    /* Set device name as camera name */
+    infoPacket()->cameraName = deviceName();
+
+    /* Choose a random multicast group (stations filter the sender too) */
+    infoPacket()->multicastGroup = QString (QCCTV_MULTICAST_PREFIX) +
+                                   QString::number (1 + qrand() % 254);
+    infoPacket()->multicastPort = QCCTV_MULTICAST_PORT;
+    m_multicastStream->setDestination (QHostAddress (infoPacket()->multicastGroup),
+                                       infoPacket()->multicastPort);
+
+    /* Configure sockets */
+    connect (&m_server,    SIGNAL (newConnection()),
+             this,           SLOT (acceptConnection()));
+    connect (&m_sessionServer, SIGNAL (newConnection()),
+             this,               SLOT (acceptSession()));
+    connect (&m_cmdSocket, SIGNAL (readyRead()),
+             this,           SLOT (readCommandPacket()));
+
+    /* Configure listener sockets */
+    m_server.listen (QHostAddress::Any, QCCTV_STREAM_PORT);
+    m_sessionServer.listen (QHostAddress::Any, QCCTV_SESSION_PORT);
+    m_cmdSocket.bind (QCCTV_COMMAND_PORT, QUdpSocket::ShareAddress);
+
+    /* Setup the frame grabber */
+    connect (m_imageCapture, SIGNAL (newFrame()),
+             this,             SLOT (changeImage()));
+    connect (m_encoder,      SIGNAL (finished()),
+             this,             SLOT (onImageEncoded()));
+    connect (m_snapshotEncoder, SIGNAL (finished()),
+             this,                SLOT (onSnapshotEncoded()));
+    connect (m_frameTimer,      SIGNAL (timeout()),
+             this,                SLOT (update()));
+
+    /* Setup additional notifiers */
+    connect (this, SIGNAL (hostCountChanged()),
+             this, SIGNAL (hostNamesChanged()));
+
+    /* Start the event loops */
+    m_frameTimer->start (1000);
+    QTimer::singleShot (1000, Qt::CoarseTimer, this, SLOT (broadcastInfo()));
+}
+
+/**
+ * Closes all the sockets and the frontal camera device
+ */
+QCCTV_LocalCamera::~QCCTV_LocalCamera()
+{
+    /* Close all TCP connections */
+    foreach (QTcpSocket* socket, m_sockets) {
+        socket->close();
+        socket->deleteLater();
+    }
+
+    /* Delete all watchdogs and sessions */
+    foreach (QCCTV_Watchdog* watchdog, m_watchdogs)
+        watchdog->deleteLater();
+    foreach (QCCTV_Session* session, m_sessions)
+        if (session)
+            session->deleteLater();
+
+    /* Close TCP servers and clear socket lists */
+    m_server.close();
+    m_sessionServer.close();
+    m_sockets.clear();
+    m_sessions.clear();
+    m_watchdogs.clear();
+    m_broadcastSocket.close();
+
+    /* Wait for the image encoders to finish */
+    m_encoder->waitForFinished();
+    m_snapshotEncoder->waitForFinished();
+
+    /* Delete the cropped streams */
+    qDeleteAll (m_cropPackets);
+    m_cropPackets.clear();
+
+    /* Delete camera capture object */
+    if (m_capture)
+        delete m_capture;
+
+    /* Delete children */
+    delete m_imageCapture;
+    delete m_motionDetector;
+    delete m_sharedFrames;
+    delete m_infoPacket;
+    delete m_commandPacket;
+}
+
+/**
+ * Returns the current FPS of the camera
+ */
+int QCCTV_LocalCamera::fps()
+{
+    return infoPacket()->fps;
+}
+
+/**
+ * Returns the FPS used to send images while no motion is detected
+ */
+int QCCTV_LocalCamera::idleFps()
+{
+    return qMin (m_idleFps, fps());
+}
+
+/**
+ * Returns the user-assigned name of the camera
+ */
+QString QCCTV_LocalCamera::name()
+{
+    return infoPacket()->cameraName;
+}
+
+/**
+ * Returns the user-assigned group of the camera
+ */
+QString QCCTV_LocalCamera::group()
+{
+    return infoPacket()->cameraGroup;
+}
+
+/**
+ * Returns the target bitrate (in kbit/s) of the image stream, zero means that
+ * images are encoded at the maximum quality
+ */
+int QCCTV_LocalCamera::bitrate()
+{
+    return infoPacket()->bitrate;
+}
+
+/**
+ * Returns the JPEG quality chosen by the rate control
+ */
+int QCCTV_LocalCamera::quality()
+{
+    return infoPacket()->quality;
+}
+
+/**
+ * Returns the current zoom level of the camera
+ */
+int QCCTV_LocalCamera::zoomLevel()
+{
+    return infoPacket()->zoom;
+}
+
+/**
+ * Returns the current resolution as an \c int, which can be used by QML
+ * interfaces directly
+ */
+int QCCTV_LocalCamera::resolution()
+{
+    return infoPacket()->resolution;
+}
+
+/**
+ * Returns the stream options (e.g. delta frames) used by the camera
+ */
+int QCCTV_LocalCamera::streamFlags()
+{
+    return infoPacket()->streamFlags;
+}
+
+/**
+ * Returns the current status of the camera itself
+ */
+int QCCTV_LocalCamera::cameraStatus()
+{
+    return infoPacket()->cameraStatus;
+}
+
+/**
+ * Returns \c true if the camera is able to perform either optical
+ * or digital zoom operations
+ */
+bool QCCTV_LocalCamera::supportsZoom()
+{
+    return infoPacket()->supportsZoom;
+}
+
+/**
+ * Returns the image that is currently being sent to the QCCTV stations
+ */
+QImage QCCTV_LocalCamera::currentImage()
+{
+    return imagePacket()->image;
+}
+
+/**
+ * Returns the current status of QCCTV in a string
+ */
+QString QCCTV_LocalCamera::statusString()
+{
+    return QCCTV_GetStatusString (cameraStatus());
+}
+
+/**
+ * Returns the current status of the flash light, which can be
+ * set either by the camera itself or a remote QCCTV Station
+ */
+int QCCTV_LocalCamera::flashlightEnabled()
+{
+    return infoPacket()->flashlightEnabled;
+}
+
+/**
+ * Returns \c true if the motion detector found changes in the scene during
+ * the last few seconds
+ */
+bool QCCTV_LocalCamera::motionDetected()
+{
+    return infoPacket()->motionDetected;
+}
+
+/**
+ * Returns \c true if the camera always sends luma-only (grayscale) images
+ */
+bool QCCTV_LocalCamera::grayscaleEnabled()
+{
+    return streamFlags() & QCCTV_STREAM_GRAYSCALE;
+}
+
+/**
+ * Returns \c true if the camera only sends the image blocks that changed
+ * since the previous frame
+ */
+bool QCCTV_LocalCamera::deltaFramesEnabled()
+{
+    return streamFlags() & QCCTV_STREAM_DELTA_FRAMES;
+}
+
+/**
+ * Returns \c true if the camera is currently sending luma-only (grayscale)
+ * images, either because it was instructed to or because the image has no
+ * color
+ */
+bool QCCTV_LocalCamera::grayscale()
+{
+    return infoPacket()->grayscale;
+}
+
+/**
+ * Returns the region of interest (in normalized coordinates) of the image
+ * stream, an empty rectangle means that the whole image is of interest
+ */
+QRectF QCCTV_LocalCamera::regionOfInterest()
+{
+    return infoPacket()->regionOfInterest;
+}
+
+/**
+ * Returns the address and port (as "address:port") to which we publish the
+ * RTP/JPEG stream, an empty string means that the RTP output is disabled
+ */
+QString QCCTV_LocalCamera::rtpDestination()
+{
+    if (m_rtpStream->address().isNull())
+        return "";
+
+    return QString ("%1:%2").arg (m_rtpStream->address().toString())
+                            .arg (m_rtpStream->port());
+}
+
+/**
+ * Returns the session description (SDP) of the RTP/JPEG stream, which can be
+ * opened by standard players and recorders
+ */
+QString QCCTV_LocalCamera::rtpSessionDescription()
+{
+    if (m_rtpStream->address().isNull())
+        return "";
+
+    return m_rtpStream->sessionDescription (name(), fps());
+}
+
+/**
+ * Returns \c true if the camera switches to luma-only (grayscale) images
+ * when the image has (almost) no color, e.g. in infrared night mode
+ */
+bool QCCTV_LocalCamera::autoGrayscaleEnabled()
+{
+    return streamFlags() & QCCTV_STREAM_AUTO_GRAYSCALE;
+}
+
+/**
+ * Returns \c true if the camera filters the sensor noise of static regions
+ * before encoding each frame
+ */
+bool QCCTV_LocalCamera::noiseReductionEnabled()
+{
+    return streamFlags() & QCCTV_STREAM_NOISE_REDUCTION;
+}
+
+/**
+ * Returns \c true if the camera is allows to auto-regulate its image
+ * resolution to improve communication times
+ */
+bool QCCTV_LocalCamera::autoRegulateResolution()
+{
+    return infoPacket()->autoRegulateResolution;
+}
+
+/**
+ * Returns \c true if the camera shall analyze the captured frames and lower
+ * its frame rate while the scene does not change
+ */
+bool QCCTV_LocalCamera::motionDetectionEnabled()
+{
+    return infoPacket()->motionDetectionEnabled;
+}
+
+/**
+ * Returns \c true if the user allows frame rates above \c QCCTV_MAX_FPS
+ */
+bool QCCTV_LocalCamera::highFpsEnabled()
+{
+    return m_highFpsEnabled;
+}
+
+/**
+ * Returns \c true if the frames sent through the sessions and the UDP
+ * streams are spread over the frame interval
+ */
+bool QCCTV_LocalCamera::pacingEnabled()
+{
+    return m_pacingEnabled;
+}
+
+/**
+ * Returns the number of bytes that the pacers let through at once
+ */
+int QCCTV_LocalCamera::pacingBurst()
+{
+    return m_pacingBurst;
+}
+
+/**
+ * Returns the pacing counters of each connected station (in the same order
+ * as \c connectedHosts()), this can be used to tune the burst allowance
+ */
+QStringList QCCTV_LocalCamera::pacingStatistics()
+{
+    QStringList list;
+
+    for (int i = 0; i < m_sockets.count(); ++i) {
+        /* Get the pacer used for the images of the station */
+        QCCTV_Pacer* pacer = Q_NULLPTR;
+        if (m_multicast.at (i))
+            pacer = m_multicastStream->pacer();
+        else if (m_udpStreams.at (i))
+            pacer = m_udpStreams.at (i)->pacer();
+        else if (m_sessions.at (i))
+            pacer = m_sessions.at (i)->pacer();
+
+        /* Images are not paced (or are read from shared memory) */
+        if (!pacer || !pacer->isEnabled() || m_sharedMemory.at (i)) {
+            list.append (QObject::tr ("Not paced"));
+            continue;
+        }
+
+        /* Get the average wait */
+        QCCTV_PacingStats stats = pacer->statistics();
+        int average = 0;
+        if (stats.waits > 0)
+            average = stats.waitTime / stats.waits;
+
+        /* Add the counters */
+        list.append (QObject::tr ("%1 KB/s, %2 KB burst, %3 waits "
+                                  "(avg. %4 ms, max. %5 ms)")
+                     .arg (stats.rate / 1024)
+                     .arg (stats.burst / 1024)
+                     .arg (stats.waits)
+                     .arg (average)
+                     .arg (stats.maxWait));
+    }
+
+    return list;
+}
+
+/**
+ * Returns the minimum FPS value allowed by QCCTV, this function can be used
+ * to set control/widget limits of QML or classic interfaces
+ */
+int QCCTV_LocalCamera::minimumFPS() const
+{
+    return QCCTV_MIN_FPS;
+}
+
+/**
+ * Returns the maximum FPS value allowed by the camera, this function can be
+ * used to set control/widget limits of QML or classic interfaces.
+ *
+ * The value is above \c QCCTV_MAX_FPS only in high frame rate mode, see
+ * \c updateMaximumFps()
+ */
+int QCCTV_LocalCamera::maximumFPS() const
+{
+    if (m_infoPacket)
+        return m_infoPacket->maxFps;
+
+    return QCCTV_MAX_FPS;
+}
+
+/**
+ * Returns \c true if the camera is ready for saving photos
+ */
+bool QCCTV_LocalCamera::readyForCapture() const
+{
+    if (m_camera && m_capture)
+        return m_capture->isReadyForCapture();
+
+    return false;
+}
+
+/**
+ * Returns \c true if the camera's flashlight is ready for use
+ */
+bool QCCTV_LocalCamera::flashlightAvailable() const
+{
+    if (m_camera)
+        return m_camera->exposure()->isFlashReady();
+
+    return false;
+}
+
+/**
+ * Returns the user-friendly host names of the connected QCCTV Stations
+ */
+QStringList QCCTV_LocalCamera::hostNames() const
+{
+    return m_hostNames;
+}
+
+/**
+ * Returns a list with all the connected QCCTV stations to this camera
+ */
+QStringList QCCTV_LocalCamera::connectedHosts() const
+{
+    QStringList list;
+
+    foreach (QTcpSocket* socket, m_sockets) {
+        QHostAddress address (socket->peerAddress().toIPv4Address());
+        list.append (address.toString());
+    }
+
+    return list;
+}
+
+/**
+ * Returns a list with all the image resolutions supported by QCCTV.
+ * This function can be used to populate a \c QComboBox or a QML model
+ */
+QStringList QCCTV_LocalCamera::availableResolutions() const
+{
+    return QCCTV_Resolutions();
+}
+
+/**
+ * Attempts to take a photo using the current camera
+ */
+void QCCTV_LocalCamera::takePhoto()
+{
+    if (readyForCapture())
+        m_capture->capture();
+}
+
+/**
+ * Forces the camera to re-focus the image
+ */
+void QCCTV_LocalCamera::focusCamera()
+{
+    if (m_camera) {
+        m_camera->searchAndLock (QCamera::LockFocus);
+        emit focusStatusChanged();
+    }
+}
+
+/**
+ * Sends a full frame with the next image of every stream, this function is
+ * called when the format of the streams changes
+ */
+void QCCTV_LocalCamera::requestKeyframe()
+{
+    m_keyframeRequested = true;
+    for (int i = 0; i < m_keyframeRequests.count(); ++i)
+        m_keyframeRequests.replace (i, true);
+}
+
+/**
+ * Changes the FPS of the camera
+ */
+void QCCTV_LocalCamera::setFPS (const int fps)
+{
+    if (infoPacket()->fps != QCCTV_ValidFps (fps, maximumFPS())) {
+        infoPacket()->fps = QCCTV_ValidFps (fps, maximumFPS());
+        updateStreams();
+
+        int time = QCCTV_GetWatchdogTime (infoPacket()->fps) / 2;
+        foreach (QCCTV_Watchdog* watchdog, m_watchdogs)
+            watchdog->setExpirationTime (time);
+
+        emit fpsChanged();
+    }
+}
+
+/**
+ * Changes the FPS used to send images while the scene is static
+ */
+void QCCTV_LocalCamera::setIdleFps (const int fps)
+{
+    int validFps = qMax (qMin (fps, QCCTV_MAX_FPS), QCCTV_MIN_IDLE_FPS);
+
+    if (m_idleFps != validFps) {
+        m_idleFps = validFps;
+        emit idleFpsChanged();
+    }
+}
+
+/**
+ * Changes the target \a bitrate (in kbit/s) of the image stream, the JPEG
+ * quality is adjusted over the next frames to match it
+ */
+void QCCTV_LocalCamera::setBitrate (const int bitrate)
+{
+    if (infoPacket()->bitrate != QCCTV_ValidBitrate (bitrate)) {
+        infoPacket()->bitrate = QCCTV_ValidBitrate (bitrate);
+        emit bitrateChanged();
+    }
+}
+
+/**
+ * Changes the camera used to capture images to send to the QCCTV network
+ */
+void QCCTV_LocalCamera::setCamera (QCamera* camera)
+{
+    if (camera) {
+        /* Re-assign camera */
+        m_camera = camera;
+        m_camera->setCaptureMode (QCamera::CaptureStillImage);
+        m_imageCapture->setSource (m_camera);
+        m_imageCapture->setFrameRate (fps());
+
+        /* Delete old camera modules */
+        if (m_capture)
+            delete m_capture;
+
+        /* Determine if camera supports zoom */
+        qreal digital = m_camera->focus()->maximumDigitalZoom();
+        qreal optical = m_camera->focus()->maximumOpticalZoom();
+        infoPacket()->supportsZoom = (digital != 1 || optical != 1);
+
+        /* Re-assign camera modules */
+        m_capture = new QCameraImageCapture (m_camera);
+
+        /* Notify UI */
+        emit cameraChanged();
+        emit supportsZoomChanged();
+    }
+}
+
+/**
+ * Changes the name assigned to this camera
+ */
+void QCCTV_LocalCamera::setName (const QString& name)
+{
+    /* Names are the same, abort */
+    if (infoPacket()->cameraName == name)
+        return;
+
+    /* Check if user just gave us empty spaces as input */
+    QString no_spaces = name;
+    no_spaces = no_spaces.replace (" ", "");
+
+    /* Re-assign the camera name */
+    if (no_spaces.isEmpty())
+        infoPacket()->cameraName = deviceName();
+    else
+        infoPacket()->cameraName = name;
+
+    /* Notify UI */
+    emit nameChanged();
+}
+
+/**
+ * Changes the zoom level of the camera
+ */
+void QCCTV_LocalCamera::setZoomLevel (const int level)
+{
+    /* Current zoom is the same as input zoom */
+    if (zoomLevel() == level)
+        return;
+
+    /* Change the zoom level (from 0 to 100) */
+    infoPacket()->zoom = qMin (qMax (level, 0), 100);
+
+    /* Instruct the camera to zoom in or zoom out */
+    if (m_camera && supportsZoom()) {
+        /* Get maximum zoom values */
+        qreal max_optical = m_camera->focus()->maximumOpticalZoom() - 1;
+        qreal max_digital = m_camera->focus()->maximumDigitalZoom() - 1;
+
+        /* Get adjusted zoom value */
+        qreal range = max_optical + max_digital;
+        qreal value = (qreal) (infoPacket()->zoom * range) / 100;
+
+        /* Initialize zoom levels */
+        qreal optical = 0;
+        qreal digital = 0;
+
+        /* Perform optical zoom first, then digital*/
+        if (max_optical > 0)
+            if (max_optical < value) {
+                optical = max_optical;
+                if (max_digital > 0)
+                    digital = value - max_digital;
+            } else
+                optical = value;
+
+        /* Only apply digital zoom */
+        else if (max_digital > 0)
+            digital = value;
+
+        /* Perform zoom operation */
+        m_camera->focus()->zoomTo (1 + optical, 1 + digital);
+        emit zoomLevelChanged();
+    }
+}
+
+/**
+ * Changes the \a group assigned to the camera
+ */
+void QCCTV_LocalCamera::setGroup (const QString& group)
+{
+    /* Names are the same, abort */
+    if (infoPacket()->cameraGroup == group)
+        return;
+
+    /* Check if user just gave us empty spaces as input */
+    QString no_spaces = group;
+    no_spaces = no_spaces.replace (" ", "");
+
+    /* Re-assign group name */
+    if (no_spaces.isEmpty())
+        infoPacket()->cameraGroup = "Default";
+    else
+        infoPacket()->cameraGroup = group;
+
+    /* Notify UI */
+    emit groupChanged();
+}
+
+/**
+ * Changes the resolution of the image that the camera sends to the station
+ */
+void QCCTV_LocalCamera::setResolution (const int resolution)
+{
+    if (infoPacket()->resolution != resolution) {
+        infoPacket()->resolution = resolution;
+        emit resolutionChanged();
+    }
+}
+
+/**
+ * Changes the stream options used by the camera
+ */
+void QCCTV_LocalCamera::setStreamFlags (const int flags)
+{
+    if (infoPacket()->streamFlags != flags) {
+        infoPacket()->streamFlags = flags;
+        requestKeyframe();
+        emit streamFlagsChanged();
+    }
+}
+
+/**
+ * Enables or disables luma-only streaming. When enabled, the camera sends
+ * single-component (grayscale) JPEG images
+ */
+void QCCTV_LocalCamera::setGrayscaleEnabled (const bool enabled)
+{
+    if (enabled)
+        setStreamFlags (streamFlags() | QCCTV_STREAM_GRAYSCALE);
+    else
+        setStreamFlags (streamFlags() & ~QCCTV_STREAM_GRAYSCALE);
+}
+
+/**
+ * Enables or disables delta frames. When enabled, the camera only sends the
+ * image blocks that changed and a full frame every few seconds
+ */
+void QCCTV_LocalCamera::setDeltaFramesEnabled (const bool enabled)
+{
+    if (enabled)
+        setStreamFlags (streamFlags() | QCCTV_STREAM_DELTA_FRAMES);
+    else
+        setStreamFlags (streamFlags() & ~QCCTV_STREAM_DELTA_FRAMES);
+}
+
+/**
+ * Enables or disables automatic luma-only streaming. When enabled, the camera
+ * sends grayscale images while the image has (almost) no color
+ */
+void QCCTV_LocalCamera::setAutoGrayscaleEnabled (const bool enabled)
+{
+    if (enabled)
+        setStreamFlags (streamFlags() | QCCTV_STREAM_AUTO_GRAYSCALE);
+    else
+        setStreamFlags (streamFlags() & ~QCCTV_STREAM_AUTO_GRAYSCALE);
+}
+
+/**
+ * Enables or disables the temporal noise reduction filter. When enabled,
+ * static regions are blended with the previous frame, which lowers the
+ * size of the JPEG and delta frames
+ */
+void QCCTV_LocalCamera::setNoiseReductionEnabled (const bool enabled)
+{
+    if (enabled)
+        setStreamFlags (streamFlags() | QCCTV_STREAM_NOISE_REDUCTION);
+    else
+        setStreamFlags (streamFlags() & ~QCCTV_STREAM_NOISE_REDUCTION);
+}
+
+/**
+ * Changes the region of interest (in normalized coordinates) of the image
+ * stream. The image outside of the \a roi is flattened before encoding, an
+ * empty rectangle sends the whole image
+ */
+void QCCTV_LocalCamera::setRegionOfInterest (const QRectF& roi)
+{
+    QRectF valid = QCCTV_ValidRegionOfInterest (roi);
+    if (infoPacket()->regionOfInterest != valid) {
+        infoPacket()->regionOfInterest = valid;
+        emit regionOfInterestChanged();
+    }
+}
+
+/**
+ * Publishes the camera images as an RTP/JPEG stream to the given
+ * \a destination ("address:port" or "address", which uses the default
+ * RTP port). An empty or invalid destination disables the RTP output.
+ *
+ * The session description of the stream is saved in the recordings folder
+ * (as "<camera name>.sdp"), so that it can be copied to the receiver
+ */
+void QCCTV_LocalCamera::setRtpDestination (const QString& destination)
+{
+    /* Get the address and port */
+    int port = QCCTV_RTP_PORT;
+    QString host = destination.trimmed();
+    int separator = host.lastIndexOf (":");
+    if (separator > 0 && host.count (":") == 1) {
+        port = host.mid (separator + 1).toInt();
+        host = host.left (separator);
+    }
+
+    /* Invalid destination, disable the RTP output */
+    QHostAddress address (host);
+    if (address.protocol() != QAbstractSocket::IPv4Protocol ||
+        port <= 0 || port > 0xffff) {
+        address = QHostAddress();
+        port = 0;
+    }
+
+    /* Nothing changed */
+    if (m_rtpStream->address() == address && m_rtpStream->port() == port)
+        return;
+
+    m_rtpStream->setDestination (address, port);
+
+    /* Save the session description */
+    if (!address.isNull()) {
+        QDir dir (QCCTV_RECORDINGS_PATH);
+        if (dir.exists() || dir.mkpath (".")) {
+            QFile file (dir.absoluteFilePath (name() + ".sdp"));
+            if (file.open (QFile::WriteOnly)) {
+                file.write (rtpSessionDescription().toUtf8());
+                file.close();
+            }
+        }
+    }
+
+    emit rtpDestinationChanged();
+}
+
+/**
+ * Turns on or off the flashlight based on the value of the \a enabled
+ * parameter
+ */
+void QCCTV_LocalCamera::setFlashlightEnabled (const bool enabled)
+{
+    infoPacket()->flashlightEnabled = enabled && flashlightAvailable();
+
+    if (flashlightEnabled())
+        m_camera->exposure()->setFlashMode (QCameraExposure::FlashVideoLight);
+
+    else
+        m_camera->exposure()->setFlashMode (QCameraExposure::FlashOff);
+
+    emit lightStatusChanged();
+}
+
+/**
+ * Allows or disallows the camera from auto-regulating the image resolution
+ * to improve the communication times.
+ */
+void QCCTV_LocalCamera::setAutoRegulateResolution (const bool regulate)
+{
+    if (infoPacket()->autoRegulateResolution != regulate) {
+        infoPacket()->autoRegulateResolution = regulate;
+        emit autoRegulateResolutionChanged();
+    }
+}
+
+/**
+ * Enables or disables the motion detector. When enabled, the camera shall send
+ * images at the idle FPS while the scene does not change
+ */
+void QCCTV_LocalCamera::setMotionDetectionEnabled (const bool enabled)
+{
+    if (infoPacket()->motionDetectionEnabled != enabled) {
+        m_motionDetector->reset();
+        infoPacket()->motionDetectionEnabled = enabled;
+
+        setMotionDetected (false);
+        emit motionDetectionEnabledChanged();
+    }
+}
+
+/**
+ * Allows or forbids frame rates above \c QCCTV_MAX_FPS, they are only used
+ * if the capture device and the stations can sustain them
+ */
+void QCCTV_LocalCamera::setHighFpsEnabled (const bool enabled)
+{
+    if (m_highFpsEnabled != enabled) {
+        m_highFpsEnabled = enabled;
+        updateMaximumFps();
+        emit highFpsEnabledChanged();
+    }
+}
+
+/**
+ * Enables or disables the pacing of the frames, the pacers are updated
+ * with the next frame
+ */
+void QCCTV_LocalCamera::setPacingEnabled (const bool enabled)
+{
+    if (m_pacingEnabled != enabled) {
+        m_pacingEnabled = enabled;
+        emit pacingChanged();
+    }
+}
+
+/**
+ * Changes the number of bytes (\a burst) that the pacers let through at
+ * once, larger values send the frames faster but in bigger bursts
+ */
+void QCCTV_LocalCamera::setPacingBurst (const int burst)
+{
+    int value = qMin (qMax (burst, QCCTV_MIN_PACING_BURST),
+                      QCCTV_MAX_PACING_BURST);
+
+    if (m_pacingBurst != value) {
+        m_pacingBurst = value;
+        emit pacingChanged();
+    }
+}
+
+/**
+ * Obtains a new image from the camera and updates the camera status.
+ *
+ * The image is sent as soon as it is encoded (see \c onImageEncoded()), this
+ * function only decides when to capture. Frames are scheduled on a fixed
+ * timeline (in nanoseconds), so that the rounding of the frame interval and
+ * the time spent here do not slow down the frame rate
+ */
+void QCCTV_LocalCamera::update()
+{
+    /* Schedule the next frame, skip the frames that we are late for */
+    qint64 now = m_frameClock.nsecsElapsed();
+    qint64 interval = 1000000000LL / captureFps();
+    m_nextFrame += interval;
+    if (m_nextFrame <= now)
+        m_nextFrame = now + interval;
+
+    m_frameTimer->start ((m_nextFrame - now + 500000) / 1000000);
+
+    /* Get another image from the camera */
+    if (!m_imageCapture->isEnabled())
+        m_imageCapture->setEnabled (true);
+
+    /* Update camera info and send it */
+    updateMaximumFps();
+    sendInfo();
+    updateStatus();
+}
+
+/**
+ * Sends a camera information packet to all connected hosts
+ */
+void QCCTV_LocalCamera::sendInfo()
+{
+    /* Send full packets if a station does not support partial ones */
+    if (!(capabilities() & QCCTV_CAP_PARTIAL_STATE))
+        m_fullInfoRequested = true;
+
+    /* Get the changes since the last full packet */
+    QByteArray info = QCCTV_CreateInfoPacket (infoPacket(), &m_infoState,
+                                              m_fullInfoRequested);
+    m_fullInfoRequested = false;
+
+    /* Nothing changed */
+    if (info.isEmpty())
+        return;
+
+    /* Send the packet */
+    QStringList hosts = connectedHosts();
+
+    for (int i = 0; i < m_sockets.count(); ++i) {
+        if (m_sessions.at (i))
+            m_sessions.at (i)->sendInfo (info);
+        else
+            m_infoSocket.writeDatagram (info,
+                                        QHostAddress (hosts.at (i)),
+                                        QCCTV_INFO_PORT);
+    }
+}
+
+/**
+ * Sends an image packet to all connected hosts
+ */
+void QCCTV_LocalCamera::sendImage()
+{
+    for (int i = 0; i < m_sockets.count(); ++i)
+        sendFrame (i);
+}
+
+/**
+ * Replaces the current image and notifies the application
+ */
+void QCCTV_LocalCamera::changeImage()
+{
+    /* Disable the capturer and timestamp the frame */
+    m_imageCapture->setEnabled (false);
+    qint64 captureTime = m_frameClock.elapsed();
+
+    /* Look for changes in the scene */
+    if (motionDetectionEnabled())
+        setMotionDetected (m_motionDetector->process (m_imageCapture->luma()));
+
+    /* Snapshots are encoded separately from the live stream */
+    encodeSnapshot();
+
+    /* The previous image is still being encoded, drop this one */
+    if (m_encoder->isRunning())
+        return;
+
+    /* Re-assign image */
+    imagePacket()->image = m_imageCapture->image();
+    emit imageChanged();
+
+    /* Switch between color and luma-only images */
+    updateGrayscale();
+
+    /* Only send images at the idle FPS while the scene is static */
+    if (isIdle()) {
+        if (!idleFrameDue (500 / captureFps()))
+            return;
+
+        m_idleClock.restart();
+    }
+
+    /* Get the streams of the stations with a crop (or a lower FPS) that
+     * are due for a new frame */
+    m_encodedCrops.clear();
+    for (int i = 0; i < m_cropPackets.count(); ++i)
+        if (m_cropPackets.at (i) && frameDue (i, captureTime))
+            m_encodedCrops.append (m_cropPackets.at (i));
+
+    /* Give the rate control the rate at which each stream is delivered */
+    int rate = captureFps();
+    if (isIdle())
+        rate = qMin (rate, idleFps());
+
+    imagePacket()->fps = rate;
+    for (int i = 0; i < m_cropPackets.count(); ++i)
+        if (m_cropPackets.at (i))
+            m_cropPackets.at (i)->fps = qMin (rate, stationFps (i));
+
+    /* Only use the frame formats supported by the stations */
+    int shared = capabilities();
+    if (imagePacket()->capabilities != shared) {
+        imagePacket()->capabilities = shared;
+        imagePacket()->keyframeRequested = true;
+    }
+
+    for (int i = 0; i < m_cropPackets.count(); ++i) {
+        QCCTV_ImagePacket* packet = m_cropPackets.at (i);
+        int caps = m_peers.at (i).capabilities;
+        if (packet && packet->capabilities != caps) {
+            packet->capabilities = caps;
+            packet->keyframeRequested = true;
+        }
+    }
+
+    /* Forward keyframe requests to the encoder, the streams that are not
+     * due keep the request until their next frame */
+    if (m_keyframeRequested) {
+        imagePacket()->keyframeRequested = true;
+        m_keyframeRequested = false;
+    }
+
+    for (int i = 0; i < m_cropPackets.count(); ++i) {
+        if (m_cropPackets.at (i) && m_keyframeRequests.at (i)) {
+            m_cropPackets.at (i)->keyframeRequested = true;
+            m_keyframeRequests.replace (i, false);
+        }
+    }
+
+    /* Encode the RTP/JPEG image only if we have a destination */
+    m_rtpEncoded = !m_rtpStream->address().isNull();
+
+    /* Keep the capture time of the frame for the RTP timestamp */
+    m_captureTime = captureTime;
+
+    /* Generate the socket data in another thread */
+    m_encoder->setFuture (QtConcurrent::run (encode_streams,
+                                            imagePacket(),
+                                            m_encodedCrops,
+                                            *infoPacket(),
+                                            m_rtpEncoded));
+}
+
+/**
+ * Creates and sends a new packet that announces the existence of this
+ * camera to the local network
+ */
+void QCCTV_LocalCamera::broadcastInfo()
+{
+    QString str = "QCCTV_DISCOVERY_SERVICE";
+
+    m_broadcastSocket.writeDatagram (str.toUtf8(),
+                                     QHostAddress::Broadcast,
+                                     QCCTV_DISCOVERY_PORT);
+
+    /* Refresh the pacing counters shown to the user */
+    emit pacingStatisticsChanged();
+
+    QTimer::singleShot (1000, this, SLOT (broadcastInfo()));
+}
+
+/**
+ * Replaces the socket data with the newly encoded image packet
+ */
+void QCCTV_LocalCamera::onImageEncoded()
+{
+    /* Get the shared stream */
+    QList<QByteArray> streams = m_encoder->result();
+    m_data = streams.first();
+    m_selfContained = imagePacket()->selfContained;
+    ++m_frameId;
+
+    /* Add the frame to the stream of each station */
+    for (int i = 0; i < m_credits.count(); ++i)
+        if (!m_cropPackets.at (i))
+            addFrame (i, m_selfContained);
+
+    /* Get the cropped streams (stations may have left in the meantime) */
+    for (int i = 0; i < m_encodedCrops.count(); ++i) {
+        int index = m_cropPackets.indexOf (m_encodedCrops.at (i));
+        if (m_encodedCrops.at (i) && index >= 0) {
+            m_cropData.replace (index, streams.at (i + 1));
+            addFrame (index, m_encodedCrops.at (i)->selfContained);
+        }
+    }
+
+    /* Send the shared stream once to all the multicast stations */
+    if (m_multicast.contains (true)) {
+        updatePacer (m_multicastStream->pacer(), m_data.size(), captureFps());
+        m_multicastStream->sendFrame (m_data);
+    }
+
+    /* Publish the RTP/JPEG image */
+    if (m_rtpEncoded)
+        m_rtpStream->sendFrame (streams.last(), m_captureTime);
+
+    /* Send the new frame right away */
+    sendImage();
+
+    if (infoPacket()->quality != imagePacket()->quality) {
+        infoPacket()->quality = imagePacket()->quality;
+        emit qualityChanged();
+    }
+}
+
+/**
+ * Sends the encoded snapshot to the station that requested it (if it is
+ * still connected), the next snapshot is encoded with the next frame.
+ *
+ * Snapshots are only sent through multiplexed sessions
+ */
+void QCCTV_LocalCamera::onSnapshotEncoded()
+{
+    QByteArray data = m_snapshotEncoder->result();
+    int index = m_sockets.indexOf (m_snapshotTarget);
+    if (!data.isEmpty() && index >= 0 && m_sessions.at (index)) {
+        /* Snapshots are counted as frames by flow-controlled stations */
+        if (m_credits.at (index).granted >= 0)
+            m_credits[index].sent++;
+
+        m_sessions.at (index)->sendSnapshot (data);
+    }
+
+    m_snapshotTarget = Q_NULLPTR;
+}
+
+/**
+ * Closes and un-registers a station when the TCP connection is aborted
+ */
+void QCCTV_LocalCamera::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*> (sender());
+    int index = m_sockets.indexOf (socket);
+
+    /* Abort connection */
+    socket->abort();
+    socket->deleteLater();
+
+    /* Delete objects */
+    removeCrop (index);
+    m_snapshotQueue.removeAll (socket);
+    m_sockets.at (index)->deleteLater();
+    m_watchdogs.at (index)->deleteLater();
+    if (m_sessions.at (index))
+        m_sessions.at (index)->deleteLater();
+    if (m_udpStreams.at (index))
+        m_udpStreams.at (index)->deleteLater();
+
+    /* Unregister watchdog, socket, session and stream */
+    m_sockets.removeAt (index);
+    m_sessions.removeAt (index);
+    m_hostNames.removeAt (index);
+    m_watchdogs.removeAt (index);
+    m_cropData.removeAt (index);
+    m_cropPackets.removeAt (index);
+    m_snapshotRequests.removeAt (index);
+    m_commandStates.removeAt (index);
+    m_credits.removeAt (index);
+    m_peers.removeAt (index);
+    m_udpStreams.removeAt (index);
+    m_multicast.removeAt (index);
+    m_sharedMemory.removeAt (index);
+    m_stationFps.removeAt (index);
+    m_deliveryTimes.removeAt (index);
+    m_keyframeRequests.removeAt (index);
+
+    /* The capture rate may have changed */
+    updateStreams();
+
+    /* Do not send the snapshot being encoded to the next socket */
+    if (m_snapshotTarget == socket)
+        m_snapshotTarget = Q_NULLPTR;
+
+    /* Notify application */
+    emit hostCountChanged();
+}
+
+/**
+ * Called when a QCCTV station wants to receive images from this camera
+ * This function shall configure the TCP socket used for streaming data
+ */
+void QCCTV_LocalCamera::acceptConnection()
+{
+    while (m_server.hasPendingConnections())
+        addStation (m_server.nextPendingConnection(), false);
+}
+
+/**
+ * Called when a QCCTV station wants to use a multiplexed session, in which
+ * images, info packets and commands are sent through the same TCP socket
+ */
+void QCCTV_LocalCamera::acceptSession()
+{
+    while (m_sessionServer.hasPendingConnections())
+        addStation (m_sessionServer.nextPendingConnection(), true);
+}
+
+/**
+ * Reads a command packet received through the multiplexed session of
+ * a station. The station is identified by its session (not by its address),
+ * because several stations may connect from the same address.
+ *
+ * Like acks, commands tell us that the station is receiving our frames
+ */
+void QCCTV_LocalCamera::onSessionCommand (const QByteArray& data)
+{
+    QCCTV_Session* session = qobject_cast<QCCTV_Session*> (sender());
+    int index = m_sessions.indexOf (session);
+    if (session && index >= 0) {
+        m_watchdogs.at (index)->reset();
+        readCommand (data, index);
+    }
+}
+
+/**
+ * Resets the watchdog of the station that acknowledged our last frame
+ */
+void QCCTV_LocalCamera::onSessionAck()
+{
+    QCCTV_Session* session = qobject_cast<QCCTV_Session*> (sender());
+    int index = m_sessions.indexOf (session);
+
+    if (session && index >= 0)
+        m_watchdogs.at (index)->reset();
+}
+
+/**
+ * Called when the session of a station had to drop a frame that the next
+ * frames depend on, the station needs a keyframe to continue
+ */
+void QCCTV_LocalCamera::onSessionResync()
+{
+    QCCTV_Session* session = qobject_cast<QCCTV_Session*> (sender());
+    int index = m_sessions.indexOf (session);
+    if (session && index >= 0)
+        requestKeyframe (index);
+}
+
+/**
+ * Negotiates the protocol configuration with the station that sent us the
+ * given hello packet \a data and replies with the chosen configuration.
+ *
+ * The connection is closed if we do not support the protocol version of
+ * the station
+ */
+void QCCTV_LocalCamera::onSessionHello (const QByteArray& data)
+{
+    QCCTV_Session* session = qobject_cast<QCCTV_Session*> (sender());
+    int index = m_sessions.indexOf (session);
+    if (!session || index < 0)
+        return;
+
+    /* Get the best configuration supported by both sides */
+    QCCTV_HelloPacket local;
+    QCCTV_HelloPacket remote;
+    QCCTV_HelloPacket config;
+    QCCTV_InitHello (&local);
+    if (!QCCTV_ReadHelloPacket (&remote, data) ||
+        !QCCTV_NegotiateHello (&config, &local, &remote)) {
+        session->socket()->abort();
+        return;
+    }
+
+    /* Apply the configuration */
+    m_peers.replace (index, config);
+    session->setMaxFrameSize (config.maxFrameSize);
+    session->sendHello (QCCTV_CreateHelloPacket (&config));
+
+    /* Station does not grant credits, push frames to it */
+    if (!(config.capabilities & QCCTV_CAP_CREDITS))
+        m_credits[index].granted = -1;
+
+    /* Station runs in this host, offer it the shared memory segment */
+    if ((config.capabilities & QCCTV_CAP_SHARED_MEMORY) && !m_sharedFrames &&
+        QCCTV_IsLocalAddress (session->socket()->peerAddress())) {
+        m_sharedFrames = new QCCTV_SharedFrames;
+        if (m_sharedFrames->create())
+            infoPacket()->sharedMemoryKey = m_sharedFrames->key();
+    }
+
+    /* Station may not understand the frames that we sent so far */
+    requestKeyframe (index);
+    m_fullInfoRequested = true;
+}
+
+/**
+ * Retransmits the multicast frame with the given \a id through the session
+ * of the station that lost it (if we still have the frame)
+ */
+void QCCTV_LocalCamera::onSessionNack (const quint16 id)
+{
+    QCCTV_Session* session = qobject_cast<QCCTV_Session*> (sender());
+    int index = m_sessions.indexOf (session);
+    if (!session || index < 0 || !m_multicast.at (index))
+        return;
+
+    QByteArray data;
+    if (m_multicastStream->sentFrame (id, &data))
+        session->sendRetransmission (id, data);
+}
+
+/**
+ * Interprets a command packet issued by the QCCTV station in the LAN.
+ *
+ * This packet contains the following data/instructions:
+ *
+ * - A new FPS to use
+ * - The new light status
+ * - A force focus request
+ * - A snapshot request
+ */
+void QCCTV_LocalCamera::readCommandPacket()
+{
+    /* Get data and address */
+    QByteArray data;
+    QHostAddress address;
+    data.resize (m_cmdSocket.pendingDatagramSize());
+    m_cmdSocket.readDatagram (data.data(), data.length(), &address);
+
+    /* Interpret the command packet (UDP commands only tell us the address) */
+    QString ip = QHostAddress (address.toIPv4Address()).toString();
+    readCommand (data, connectedHosts().indexOf (ip));
+}
+
+/**
+ * Reads the command packet \a data sent by the station with the given
+ * socket \a index (or by an unknown station if \a index is negative) and
+ * applies its instructions
+ */
+void QCCTV_LocalCamera::readCommand (const QByteArray& data, const int index)
+{
+    /* Get the packet state of the station */
+    QCCTV_PacketState unknown;
+    QCCTV_InitState (&unknown);
+    QCCTV_PacketState* state = &unknown;
+    if (index >= 0)
+        state = &m_commandStates[index];
+
+    /* Read the command packet */
+    bool success = QCCTV_ReadCommandPacket (commandPacket(), state, data);
+    if (!success)
+        return;
+
+    /* Station missed an info packet */
+    if (commandPacket()->infoRequest)
+        m_fullInfoRequested = true;
+
+    /* Change host name and crop of the station */
+    if (index >= 0) {
+        if (m_hostNames.at (index) != commandPacket()->host) {
+            m_hostNames.replace (index, commandPacket()->host);
+            emit hostNamesChanged();
+        }
+
+        /* Send the images at the rate requested by the station */
+        if (m_peers.at (index).capabilities & QCCTV_CAP_STATION_FPS)
+            setStationFps (index, commandPacket()->requestedFps);
+
+        setCrop (index, commandPacket()->crop);
+
+        /* Send the shared stream through shared memory (same host only) */
+        bool shared = commandPacket()->sharedMemory && m_sessions.at (index) &&
+                      !m_cropPackets.at (index) && m_sharedFrames &&
+                      m_sharedFrames->isValid() &&
+                      (m_peers.at (index).capabilities & QCCTV_CAP_SHARED_MEMORY) &&
+                      QCCTV_IsLocalAddress (m_sockets.at (index)->peerAddress());
+        setSharedMemory (index, shared);
+
+        /* Switch the image transport of the station */
+        int port = commandPacket()->udpPort;
+        if (!(m_peers.at (index).capabilities & QCCTV_CAP_UDP_TRANSPORT) ||
+            shared)
+            port = 0;
+        setUdpTransport (index, port, commandPacket()->udpParity);
+
+        /* Send the shared stream through multicast (requires a session) */
+        bool multicast = commandPacket()->multicast && m_sessions.at (index) &&
+                         !m_cropPackets.at (index) && !shared &&
+                         (m_peers.at (index).capabilities & QCCTV_CAP_MULTICAST);
+        setMulticast (index, multicast);
+
+        /* Update the credits and send the newest frame if we can */
+        bool credits = m_peers.at (index).capabilities & QCCTV_CAP_CREDITS;
+        if (credits && m_sessions.at (index) && !m_udpStreams.at (index) &&
+            !m_multicast.at (index) && commandPacket()->credits >= 0) {
+            m_credits[index].granted = commandPacket()->credits;
+            sendFrame (index);
+        }
+
+        /* Queue snapshot (the first packet tells us the last request ID), the
+         * legacy stream cannot carry a snapshot and live frames at once */
+        int request = commandPacket()->snapshotRequest;
+        bool snapshots = m_peers.at (index).capabilities & QCCTV_CAP_SNAPSHOTS;
+        if (snapshots && m_sessions.at (index) &&
+            m_snapshotRequests.at (index) != request) {
+            QTcpSocket* socket = m_sockets.at (index);
+            if (m_snapshotRequests.at (index) >= 0 &&
+                !m_snapshotQueue.contains (socket))
+                m_snapshotQueue.append (socket);
+
+            m_snapshotRequests.replace (index, request);
+        }
+    }
+
+    /* Change FPS */
+    if (commandPacket()->fpsChanged)
+        if (commandPacket()->oldFps == fps())
+            setFPS (commandPacket()->newFps);
+
+    /* Change zoom */
+    if (commandPacket()->zoomChanged)
+        if (commandPacket()->oldZoom == zoomLevel())
+            setZoomLevel (commandPacket()->newZoom);
+
+    /* Set resolution */
+    if (commandPacket()->resolutionChanged)
+        if (commandPacket()->oldResolution == resolution())
+            setResolution (commandPacket()->newResolution);
+
+    /* Set flashlight status */
+    if (commandPacket()->flashlightEnabledChanged)
+        if (commandPacket()->oldFlashlightEnabled == flashlightEnabled())
+            setFlashlightEnabled (commandPacket()->newFlashlightEnabled);
+
+    /* Change the auto-regulate resolution option */
+    if (commandPacket()->autoRegulateResolutionChanged)
+        if (commandPacket()->oldAutoRegulateResolution == autoRegulateResolution())
+            setAutoRegulateResolution (commandPacket()->newAutoRegulateResolution);
+
+    /* Change the bitrate */
+    if (commandPacket()->bitrateChanged)
+        if (commandPacket()->oldBitrate == bitrate())
+            setBitrate (commandPacket()->newBitrate);
+
+    /* Change the region of interest */
+    if (commandPacket()->regionOfInterestChanged)
+        if (commandPacket()->oldRegionOfInterest == regionOfInterest())
+            setRegionOfInterest (commandPacket()->newRegionOfInterest);
+
+    /* Change the stream options */
+    if (commandPacket()->streamFlagsChanged)
+        if (commandPacket()->oldStreamFlags == streamFlags())
+            setStreamFlags (commandPacket()->newStreamFlags);
+
+    /* Focus the camera */
+    if (commandPacket()->focusRequest)
+        focusCamera();
+
+    /* Send a full frame (only in the stream of the station, if we know it) */
+    if (commandPacket()->keyframeRequest) {
+        if (index >= 0)
+            requestKeyframe (index);
+        else
+            requestKeyframe();
+    }
+}
+
+/**
+ * Gradually lowers the image quality when the station fails to reply on time
+ */
+void QCCTV_LocalCamera::onWatchdogTimeout()
+{
+    if (resolution() == QCCTV_QCIF || !autoRegulateResolution())
+        return;
+
+    if (connectedHosts().isEmpty())
+        return;
+
+    /* We do not write anything while idle, the watchdogs will expire */
+    if (isIdle())
+        return;
+
+    setResolution ((QCCTV_Resolution) qMax ((int) QCCTV_CIF, resolution() - 1));
+}
+
+/**
+ * Resets the watchdog for the socket that called this function
+ */
+void QCCTV_LocalCamera::onBytesWritten (const qint64 bytes)
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*> (sender());
+
+    if (socket && bytes > 0)
+        m_watchdogs.at (m_sockets.indexOf (socket))->reset();
+}
+
+/**
+ * Returns the capabilities supported by all the connected stations
+ */
+int QCCTV_LocalCamera::capabilities()
+{
+    int caps = QCCTV_CAP_ALL;
+    foreach (QCCTV_HelloPacket peer, m_peers)
+        caps &= peer.capabilities;
+
+    return caps;
+}
+
+/**
+ * Returns \c true if motion detection is enabled and the scene is static
+ */
+bool QCCTV_LocalCamera::isIdle()
+{
+    return motionDetectionEnabled() && !motionDetected();
+}
+
+/**
+ * Returns \c true if an idle frame must be sent within the next \a lookahead
+ * milliseconds
+ */
+bool QCCTV_LocalCamera::idleFrameDue (const int lookahead)
+{
+    return m_idleClock.elapsed() + lookahead >= 1000 / idleFps();
+}
+
+/**
+ * Changes the motion status reported to the stations
+ */
+void QCCTV_LocalCamera::setMotionDetected (const bool detected)
+{
+    if (infoPacket()->motionDetected != detected) {
+        infoPacket()->motionDetected = detected;
+        emit motionDetectedChanged();
+    }
+}
+
+/**
+ * Decides if the camera should send luma-only images, based on the stream
+ * flags and the chroma level of the current frame. The automatic mode uses
+ * two thresholds to avoid switching back and forth with every frame
+ */
+void QCCTV_LocalCamera::updateGrayscale()
+{
+    bool gray = false;
+    const int chroma = m_imageCapture->chroma();
+
+    /* Get the new luma-only state */
+    if (streamFlags() & QCCTV_STREAM_GRAYSCALE)
+        gray = true;
+    else if (streamFlags() & QCCTV_STREAM_AUTO_GRAYSCALE) {
+        gray = grayscale();
+        if (chroma <= QCCTV_GRAYSCALE_ENTER_CHROMA)
+            gray = true;
+        else if (chroma >= QCCTV_GRAYSCALE_LEAVE_CHROMA)
+            gray = false;
+    }
+
+    /* Update the capturer and start the new stream with a keyframe */
+    if (grayscale() != gray) {
+        infoPacket()->grayscale = gray;
+        m_imageCapture->setGrayscale (gray);
+        requestKeyframe();
+        emit grayscaleChanged();
+    }
+}
+
+/**
+ * Registers the given station \a socket and the objects used to stream
+ * images to it. If \a session is \c true, all packets are multiplexed
+ * through the socket
+ */
+void QCCTV_LocalCamera::addStation (QTcpSocket* socket, const bool session)
+{
+    QCCTV_Watchdog* watchdog = new QCCTV_Watchdog (this);
+    watchdog->setExpirationTime (QCCTV_GetWatchdogTime (infoPacket()->fps));
+
+    m_watchdogs.append (watchdog);
+    m_hostNames.append ("Unknown");
+    m_cropData.append (QByteArray());
+    m_cropPackets.append (Q_NULLPTR);
+    m_snapshotRequests.append (-1);
+    m_commandStates.append (QCCTV_PacketState());
+    QCCTV_InitState (&m_commandStates.last());
+
+    /* Stations in a session must grant credits before we send frames */
+    QCCTV_StationCredits credits;
+    credits.granted = session ? 0 : -1;
+    credits.sent = 0;
+    credits.frame = -1;
+    credits.latest = -1;
+    credits.previous = -1;
+    credits.selfContained = false;
+    credits.resync = true;
+    m_credits.append (credits);
+
+    /* Stations receive the images at the FPS of the camera until they ask
+     * for their own rate */
+    m_stationFps.append (0);
+    m_deliveryTimes.append (0);
+    m_keyframeRequests.append (false);
+
+    /* Treat the station as a legacy station until it sends its hello */
+    m_peers.append (QCCTV_HelloPacket());
+    QCCTV_InitLegacyHello (&m_peers.last());
+
+    /* Images are sent through the TCP socket until the station asks for UDP */
+    m_udpStreams.append (Q_NULLPTR);
+    m_multicast.append (false);
+    m_sharedMemory.append (false);
+
+    m_sockets.append (socket);
+    m_sockets.last()->setSocketOption (QTcpSocket::LowDelayOption, 1);
+    m_sockets.last()->setSocketOption (QTcpSocket::KeepAliveOption, 1);
+
+    connect (m_watchdogs.last(), SIGNAL (expired()),
+             this,                 SLOT (onWatchdogTimeout()));
+    connect (m_sockets.last(),   SIGNAL (disconnected()),
+             this,                 SLOT (onDisconnected()));
+    connect (m_sockets.last(),   SIGNAL (bytesWritten (qint64)),
+             this,                 SLOT (onBytesWritten (qint64)));
+
+    /* Create the multiplexed session */
+    if (session) {
+        m_sessions.append (new QCCTV_Session (socket, this));
+        connect (m_sessions.last(), SIGNAL (ackReceived()),
+                 this,                SLOT (onSessionAck()));
+        connect (m_sessions.last(), SIGNAL (resyncRequested()),
+                 this,                SLOT (onSessionResync()));
+        connect (m_sessions.last(), SIGNAL (helloReceived (QByteArray)),
+                 this,                SLOT (onSessionHello (QByteArray)));
+        connect (m_sessions.last(), SIGNAL (nackReceived (quint16)),
+                 this,                SLOT (onSessionNack (quint16)));
+        connect (m_sessions.last(), SIGNAL (commandReceived (QByteArray)),
+                 this,                SLOT (onSessionCommand (QByteArray)));
+    }
+
+    else
+        m_sessions.append (Q_NULLPTR);
+
+    /* New station does not know the reference image and camera info */
+    requestKeyframe (m_sockets.count() - 1);
+    m_fullInfoRequested = true;
+    emit hostCountChanged();
+}
+
+/**
+ * Sends the current frame to the station with the given socket \a index.
+ *
+ * Stations only receive each frame of their stream once. Stations with flow
+ * control only receive frames while they have credit left and while their
+ * session is not holding a previous frame. If such a station misses a
+ * frame, it only receives frames again after the next self-contained frame
+ * (delta frames and JPEG tables depend on the previous frames)
+ */
+void QCCTV_LocalCamera::sendFrame (const int index)
+{
+    /* Get the shared stream or the stream of the station's crop */
+    QByteArray data = m_data;
+    if (m_cropPackets.at (index))
+        data = m_cropData.at (index);
+
+    /* Nothing to send or the station does not accept the frame */
+    if (data.isEmpty() || data.size() > m_peers.at (index).maxFrameSize)
+        return;
+
+    /* Station receives the shared stream through multicast */
+    if (m_multicast.at (index))
+        return;
+
+    /* Frame was already sent */
+    QCCTV_StationCredits& credits = m_credits[index];
+    if (credits.frame == credits.latest)
+        return;
+
+    /* Check the credits of the station */
+    if (credits.granted >= 0) {
+        /* Station cannot receive the frame, the session would drop or
+         * replace the frame if it did not start sending the previous one,
+         * and the station would never give us that credit back */
+        if (credits.sent >= credits.granted)
+            return;
+        if (m_sessions.at (index) && m_sessions.at (index)->imagePending())
+            return;
+
+        /* Station missed a frame of its stream, wait for a keyframe that
+         * carries its JPEG tables */
+        if (credits.frame != credits.previous)
+            credits.resync = true;
+        if (credits.resync && !credits.selfContained) {
+            requestKeyframe (index);
+            return;
+        }
+
+        /* Register the frame */
+        credits.sent++;
+        credits.resync = false;
+    }
+
+    credits.frame = credits.latest;
+
+    /* Send the data */
+    if (m_sharedMemory.at (index) && writeSharedFrame())
+        m_sessions.at (index)->sendSharedFrame (m_sharedSlot, m_sharedSequence);
+    else if (m_udpStreams.at (index)) {
+        updatePacer (m_udpStreams.at (index)->pacer(), data.size(),
+                     stationFps (index));
+        m_udpStreams.at (index)->sendFrame (data);
+    }
+
+    else if (m_sessions.at (index)) {
+        updatePacer (m_sessions.at (index)->pacer(), data.size(),
+                     stationFps (index));
+        m_sessions.at (index)->sendImage (data, credits.selfContained);
+    }
+
+    /* The bytes taken by the kernel are not reported by bytesWritten() */
+    else if (m_sockets.at (index)->isWritable()) {
+        if (QCCTV_WriteSocket (m_sockets.at (index), QByteArray(),
+                               data.constData(), data.size()) > 0)
+            m_watchdogs.at (index)->reset();
+    }
+}
+
+/**
+ * Configures the given \a pacer so that a frame with the given number of
+ * \a bytes is spread over the frame interval (at the given \a fps). If the
+ * bitrate target (the rate that we expect the link to carry) is faster, the
+ * bitrate target is used instead
+ */
+void QCCTV_LocalCamera::updatePacer (QCCTV_Pacer* pacer, const int bytes,
+                                     const int fps)
+{
+    /* Enable or disable the pacer */
+    if (pacer->isEnabled() != m_pacingEnabled)
+        pacer->setEnabled (m_pacingEnabled);
+
+    /* Get the rate needed to send the frame in time */
+    qint64 frameRate = (qint64) bytes * fps * 100 / QCCTV_PACING_SPREAD;
+    qint64 linkRate = (qint64) bitrate() * 1000 / 8;
+
+    /* Update the pacer */
+    pacer->setBurst (m_pacingBurst);
+    pacer->setRate (qMax (frameRate, linkRate));
+}
+
+/**
+ * Encodes a full-resolution snapshot of the current frame for the first
+ * station in the snapshot queue. The snapshot uses the crop of the station
+ * (if any) and is encoded in another thread, so that the live stream is
+ * not affected
+ */
+void QCCTV_LocalCamera::encodeSnapshot()
+{
+    /* No pending snapshots or the last snapshot is still being encoded */
+    if (m_snapshotQueue.isEmpty() || m_snapshotEncoder->isRunning())
+        return;
+
+    /* Get the station and its crop */
+    QRectF crop;
+    m_snapshotTarget = m_snapshotQueue.takeFirst();
+    int index = m_sockets.indexOf (m_snapshotTarget);
+    if (index >= 0 && m_cropPackets.at (index))
+        crop = m_cropPackets.at (index)->crop;
+
+    /* Get the largest frame that the station accepts */
+    int maxSize = QCCTV_MAX_SNAPSHOT_SIZE;
+    if (index >= 0)
+        maxSize = m_peers.at (index).maxFrameSize;
+
+    /* Encode the snapshot in another thread */
+    m_snapshotEncoder->setFuture (QtConcurrent::run (QCCTV_CreateSnapshotPacket,
+                                                     m_imageCapture->image(),
+                                                     crop,
+                                                     maxSize));
+}
+
+/**
+ * Sends the images of the station with the given socket \a index through
+ * UDP datagrams to the given \a port of the station (with the given
+ * \a parity group), a \a port of zero switches back to the TCP socket.
+ *
+ * Lost datagrams cannot be acknowledged, so the station does not use flow
+ * control while it receives UDP images
+ */
+void QCCTV_LocalCamera::setUdpTransport (const int index,
+                                         const int port,
+                                         const int parity)
+{
+    QCCTV_DatagramStream* stream = m_udpStreams.at (index);
+
+    /* Switch back to the TCP socket */
+    if (port <= 0 || port > 0xffff) {
+        if (stream) {
+            stream->deleteLater();
+            m_udpStreams.replace (index, Q_NULLPTR);
+            m_credits[index].resync = true;
+            requestKeyframe (index);
+        }
+
+        return;
+    }
+
+    /* Create the UDP stream */
+    if (!stream) {
+        stream = new QCCTV_DatagramStream (this);
+        m_udpStreams.replace (index, stream);
+        m_credits[index].granted = -1;
+        requestKeyframe (index);
+    }
+
+    /* Update the destination and parity of the stream */
+    stream->setParityGroup (parity);
+    stream->setDestination (m_sockets.at (index)->peerAddress(), port);
+}
+
+/**
+ * Enables or disables the multicast delivery for the station with the given
+ * socket \a index. Stations with a crop receive their own stream through
+ * their socket instead.
+ *
+ * Multicast frames cannot be acknowledged, so the station does not use
+ * flow control while it receives multicast images
+ */
+void QCCTV_LocalCamera::setMulticast (const int index, const bool enabled)
+{
+    if (m_multicast.at (index) == enabled)
+        return;
+
+    m_multicast.replace (index, enabled);
+    if (enabled)
+        m_credits[index].granted = -1;
+    else
+        m_credits[index].resync = true;
+
+    /* Station must synchronize with the new stream */
+    requestKeyframe (index);
+}
+
+/**
+ * Enables or disables the shared-memory transport for the station with the
+ * given socket \a index. The station is still notified of each frame (and
+ * grants its credits) through its session
+ */
+void QCCTV_LocalCamera::setSharedMemory (const int index, const bool enabled)
+{
+    if (m_sharedMemory.at (index) == enabled)
+        return;
+
+    m_sharedMemory.replace (index, enabled);
+    m_credits[index].resync = true;
+    requestKeyframe (index);
+}
+
+/**
+ * Writes the current frame to the shared memory segment (only once per
+ * frame), returns \c false if the frame cannot be written
+ */
+bool QCCTV_LocalCamera::writeSharedFrame()
+{
+    if (m_sharedFrameId == m_frameId)
+        return true;
+
+    if (!m_sharedFrames || !m_sharedFrames->write (m_data, &m_sharedSlot,
+                                                   &m_sharedSequence))
+        return false;
+
+    m_sharedFrameId = m_frameId;
+    return true;
+}
+
+/**
+ * Deletes the cropped stream of the station with the given socket \a index
+ */
+void QCCTV_LocalCamera::removeCrop (const int index)
+{
+    QCCTV_ImagePacket* packet = m_cropPackets.at (index);
+    if (!packet)
+        return;
+
+    /* Wait until the encoder is done with the packet */
+    m_encoder->waitForFinished();
+
+    /* Do not assign the encoded data to another stream */
+    for (int i = 0; i < m_encodedCrops.count(); ++i)
+        if (m_encodedCrops.at (i) == packet)
+            m_encodedCrops.replace (i, Q_NULLPTR);
+
+    /* Delete the stream */
+    delete packet;
+    m_cropData.replace (index, QByteArray());
+    m_cropPackets.replace (index, Q_NULLPTR);
+}
+
+/**
+ * Changes the \a crop rectangle (digital PTZ) requested by the station with
+ * the given socket \a index. Each station with a crop gets its own stream,
+ * which is encoded from the full-resolution image. Stations that receive
+ * fewer frames than we capture also get their own (uncropped) stream
+ */
+void QCCTV_LocalCamera::setCrop (const int index, const QRectF& crop)
+{
+    QRectF valid = QCCTV_ValidCrop (crop);
+    QCCTV_ImagePacket* packet = m_cropPackets.at (index);
+
+    /* Stations with a lower FPS also need their own stream */
+    bool own = !valid.isEmpty() || reducedRate (index);
+
+    /* Crop did not change */
+    if ((packet && own && packet->crop == valid) || (!packet && !own))
+        return;
+
+    /* Station wants the shared stream again, which must start with a keyframe */
+    if (!own) {
+        removeCrop (index);
+        requestKeyframe (index);
+        return;
+    }
+
+    /* Wait until the encoder is done with the packet */
+    m_encoder->waitForFinished();
+
+    /* Create the stream of the station */
+    if (!packet) {
+        packet = new QCCTV_ImagePacket;
+        m_cropPackets.replace (index, packet);
+    }
+
+    /* Discard the data encoded with the previous crop */
+    else {
+        for (int i = 0; i < m_encodedCrops.count(); ++i)
+            if (m_encodedCrops.at (i) == packet)
+                m_encodedCrops.replace (i, Q_NULLPTR);
+    }
+
+    /* Start the new crop with a keyframe */
+    QCCTV_InitImage (packet);
+    packet->crop = valid;
+    m_cropData.replace (index, QByteArray());
+}
+
+/**
+ * Returns the rate at which we capture and encode the images, which is the
+ * highest rate wanted by the stations
+ */
+int QCCTV_LocalCamera::captureFps()
+{
+    if (m_sockets.isEmpty())
+        return fps();
+
+    int rate = QCCTV_MIN_FPS;
+    for (int i = 0; i < m_sockets.count(); ++i)
+        rate = qMax (rate, stationFps (i));
+
+    return rate;
+}
+
+/**
+ * Returns the rate at which the station with the given socket \a index
+ * wants to receive the images, stations that did not ask for their own
+ * rate use the FPS of the camera
+ */
+int QCCTV_LocalCamera::stationFps (const int index)
+{
+    if (m_stationFps.at (index) > 0)
+        return QCCTV_ValidFps (m_stationFps.at (index), maximumFPS(),
+                               QCCTV_MIN_STATION_FPS);
+
+    return fps();
+}
+
+/**
+ * Returns \c true if the station with the given socket \a index receives
+ * fewer frames than we capture. Such stations need their own stream, since
+ * delta frames depend on the previous frame. Multicast and shared-memory
+ * stations always receive the shared stream
+ */
+bool QCCTV_LocalCamera::reducedRate (const int index)
+{
+    if (m_multicast.at (index) || m_sharedMemory.at (index))
+        return false;
+
+    return stationFps (index) < captureFps();
+}
+
+/**
+ * Returns \c true if the frame captured at the given \a time (in ms) must
+ * be encoded for the station with the given socket \a index. The frames
+ * are picked from a fixed timeline at the rate of the station, so that the
+ * rounding of the intervals does not slow the station down
+ */
+bool QCCTV_LocalCamera::frameDue (const int index, const qint64 time)
+{
+    /* Station receives every frame */
+    int capture = captureFps();
+    int rate = stationFps (index);
+    if (rate >= capture)
+        return true;
+
+    /* Pick the first frame captured around the due time */
+    qreal due = m_deliveryTimes.at (index);
+    if (time + 500.0 / capture < due)
+        return false;
+
+    /* Get the next due time, skip the frames that we missed */
+    due += 1000.0 / rate;
+    if (due <= time)
+        due = time + 1000.0 / rate;
+
+    m_deliveryTimes.replace (index, due);
+    return true;
+}
+
+/**
+ * Updates the capture rate and creates (or removes) the streams of the
+ * stations that receive fewer frames than we capture
+ */
+void QCCTV_LocalCamera::updateStreams()
+{
+    m_imageCapture->setFrameRate (captureFps());
+
+    for (int i = 0; i < m_sockets.count(); ++i) {
+        QRectF crop;
+        if (m_cropPackets.at (i))
+            crop = m_cropPackets.at (i)->crop;
+
+        setCrop (i, crop);
+    }
+}
+
+/**
+ * Changes the rate at which the station with the given socket \a index
+ * wants to receive the images, zero uses the FPS of the camera
+ */
+void QCCTV_LocalCamera::setStationFps (const int index, const int fps)
+{
+    int rate = qMax (fps, 0);
+    if (m_stationFps.at (index) != rate) {
+        m_stationFps.replace (index, rate);
+        updateStreams();
+    }
+}
+
+/**
+ * Adds the newly encoded frame to the stream of the station with the given
+ * socket \a index
+ */
+void QCCTV_LocalCamera::addFrame (const int index, const bool selfContained)
+{
+    QCCTV_StationCredits& credits = m_credits[index];
+    credits.previous = credits.latest;
+    credits.latest = m_frameId;
+    credits.selfContained = selfContained;
+}
+
+/**
+ * Sends a full frame with the next image of the stream of the station with
+ * the given socket \a index (its own stream or the shared stream). The
+ * request is kept until the stream of the station is encoded again
+ */
+void QCCTV_LocalCamera::requestKeyframe (const int index)
+{
+    if (m_cropPackets.at (index))
+        m_keyframeRequests.replace (index, true);
+    else
+        m_keyframeRequested = true;
+}
+
+/**
+ * Updates the highest FPS allowed by the camera. Frame rates above
+ * \c QCCTV_MAX_FPS are only allowed if the user enabled them, the capture
+ * device supports them, all the stations support them and all the stations
+ * use flow control (so that a slow link skips frames instead of queuing
+ * them). The FPS is lowered if it goes above the new limit
+ */
+void QCCTV_LocalCamera::updateMaximumFps()
+{
+    /* Get the highest rate of the capture device */
+    int maxFps = QCCTV_MAX_FPS;
+    if (m_highFpsEnabled && (capabilities() & QCCTV_CAP_HIGH_FPS))
+        maxFps = qBound (QCCTV_MAX_FPS,
+                         m_imageCapture->maximumFrameRate(),
+                         QCCTV_MAX_HIGH_FPS);
+
+    /* Stations without flow control could fall behind */
+    foreach (QCCTV_StationCredits credits, m_credits)
+        if (credits.granted < 0)
+            maxFps = QCCTV_MAX_FPS;
+
+    /* Nothing changed */
+    if (infoPacket()->maxFps == maxFps)
+        return;
+
+    /* Update the limit and the FPS (of the camera and the stations) */
+    infoPacket()->maxFps = maxFps;
+    if (fps() > maxFps)
+        setFPS (maxFps);
+
+    updateStreams();
+
+    emit maximumFpsChanged();
+}
+
+/**
+ * Updates the status code of the camera
+ */
+void QCCTV_LocalCamera::updateStatus()
+{
+    /* Check if camera exists */
+    if (!m_camera)
+        addStatusFlag (QCCTV_CAMSTATUS_VIDEO_FAILURE);
+
+    /* Check if camera is active */
+    else if (m_camera->status() != QCamera::ActiveStatus)
+        addStatusFlag (QCCTV_CAMSTATUS_VIDEO_FAILURE);
+    else
+        removeStatusFlag (QCCTV_CAMSTATUS_VIDEO_FAILURE);
+
+    /* Check if flash light is available */
+    if (!flashlightAvailable())
+        addStatusFlag (QCCTV_CAMSTATUS_LIGHT_FAILURE);
+    else
+        removeStatusFlag (QCCTV_CAMSTATUS_LIGHT_FAILURE);
+}
+
+
+/**
+ * Registers the given \a status flag to the operation status flags
+ */
+void QCCTV_LocalCamera::addStatusFlag (const int status)
+{
+    if (! (infoPacket()->cameraStatus & status)) {
+        infoPacket()->cameraStatus |= status;
+        emit cameraStatusChanged();
+    }
+}
+
+/**
+ * Overrides the camera status flags with the given \a status
+ */
+void QCCTV_LocalCamera::setCameraStatus (const int status)
+{
+    infoPacket()->cameraStatus = status;
+    emit cameraStatusChanged();
+}
+
+/**
+ * Removes the given \a status flag from the operation status of the camera
+ */
+void QCCTV_LocalCamera::removeStatusFlag (const int status)
+{
+    if (infoPacket()->cameraStatus & status) {
+        infoPacket()->cameraStatus ^= status;
+        emit cameraStatusChanged();
+    }
+}
+
+/**
+ * Returns the name and operating system of the camera device
+ */
+QString QCCTV_LocalCamera::deviceName()
+{
+    QString device = QSysInfo::machineHostName();
+    if (device.isEmpty())
+        device = QSysInfo::prettyProductName();
+    else
+        device += " (" + QSysInfo::prettyProductName() + ")";
+
+    return device;
+}
+
+/**
+ * Returns the pointer to the stream packet structure
+ */
+QCCTV_InfoPacket* QCCTV_LocalCamera::infoPacket()
+{
+    if (m_infoPacket)
+        return m_infoPacket;
+
+    m_infoPacket = new QCCTV_InfoPacket;
+    return m_infoPacket;
+}
+
+/**
+ * Returns the pointer to the image packet structure
+ */
+QCCTV_ImagePacket* QCCTV_LocalCamera::imagePacket()
+{
+    if (m_imagePacket)
+        return m_imagePacket;
+
+    m_imagePacket = new QCCTV_ImagePacket;
+    return m_imagePacket;
+}
+
+
+/**
+ * Returns the pointer to the command packet structure
+ */
+QCCTV_CommandPacket* QCCTV_LocalCamera::commandPacket()
+{
+    if (m_commandPacket)
+        return m_commandPacket;
+
+    m_commandPacket = new QCCTV_CommandPacket;
+    return m_commandPacket;
+}
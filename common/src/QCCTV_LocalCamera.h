@@ -1,201 +1,409 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#ifndef _QCCTV_LOCAL_CAMERA_H
-#define _QCCTV_LOCAL_CAMERA_H
-
-#include <QObject>
-#include <QTcpServer>
-#include <QTcpSocket>
-#include <QUdpSocket>
-
-#include <QCCTV.h>
-
-class QCamera;
-class QCCTV_Watchdog;
-class QCCTV_ImageCapture;
-class QCameraImageCapture;
-
-struct QCCTV_InfoPacket;
-struct QCCTV_ImagePacket;
-struct QCCTV_CommandPacket;
-
-class QCCTV_LocalCamera : public QObject
-{
-    Q_OBJECT
-    Q_PROPERTY (int fps
-                READ fps
-                WRITE setFPS
-                NOTIFY fpsChanged)
-    Q_PROPERTY (QString name
-                READ name
-                WRITE setName
-                NOTIFY nameChanged)
-    Q_PROPERTY (QString group
-                READ group
-                WRITE setGroup
-                NOTIFY groupChanged)
-    Q_PROPERTY (int resolution
-                READ resolution
-                WRITE setResolution
-                NOTIFY resolutionChanged)
-    Q_PROPERTY (int zoomLevel
-                READ zoomLevel
-                WRITE setZoomLevel
-                NOTIFY zoomLevelChanged)
-    Q_PROPERTY (bool flashlightEnabled
-                READ flashlightEnabled
-                WRITE setFlashlightEnabled
-                NOTIFY lightStatusChanged)
-    Q_PROPERTY (bool autoRegulateResolution
-                READ autoRegulateResolution
-                WRITE setAutoRegulateResolution
-                NOTIFY autoRegulateResolutionChanged)
-    Q_PROPERTY (int minimumFps
-                READ minimumFPS
-                CONSTANT)
-    Q_PROPERTY (int maximumFps
-                READ maximumFPS
-                CONSTANT)
-    Q_PROPERTY (bool supportsZoom
-                READ supportsZoom
-                NOTIFY supportsZoomChanged)
-    Q_PROPERTY (int statusCode
-                READ cameraStatus
-                NOTIFY cameraStatusChanged)
-    Q_PROPERTY (QString statusString
-                READ statusString
-                NOTIFY cameraStatusChanged)
-    Q_PROPERTY (bool readyForCapture
-                READ readyForCapture
-                NOTIFY cameraStatusChanged)
-    Q_PROPERTY (bool flashlightAvailable
-                READ flashlightAvailable
-                NOTIFY cameraStatusChanged)
-    Q_PROPERTY (QStringList connectedHosts
-                READ connectedHosts
-                NOTIFY hostCountChanged)
-    Q_PROPERTY (QStringList hostNames
-                READ hostNames
-                NOTIFY hostNamesChanged)
-    Q_PROPERTY (QStringList resolutions
-                READ availableResolutions
-                NOTIFY hostCountChanged)
-
-Q_SIGNALS:
-    void fpsChanged();
-    void nameChanged();
-    void imageChanged();
-    void groupChanged();
-    void cameraChanged();
-    void hostNamesChanged();
-    void zoomLevelChanged();
-    void hostCountChanged();
-    void resolutionChanged();
-    void lightStatusChanged();
-    void focusStatusChanged();
-    void supportsZoomChanged();
-    void cameraStatusChanged();
-    void autoRegulateResolutionChanged();
-
-public:
-    QCCTV_LocalCamera (QObject* parent = NULL);
-    ~QCCTV_LocalCamera();
-
-    int fps();
-    QString name();
-    QString group();
-    int zoomLevel();
-    int resolution();
-    int cameraStatus();
-    bool supportsZoom();
-    QImage currentImage();
-    QString statusString();
-    int flashlightEnabled();
-    bool autoRegulateResolution();
-
-    int minimumFPS() const;
-    int maximumFPS() const;
-    bool readyForCapture() const;
-    bool flashlightAvailable() const;
-    QStringList hostNames() const;
-    QStringList connectedHosts() const;
-    QStringList availableResolutions() const;
-
-public Q_SLOTS:
-    void takePhoto();
-    void focusCamera();
-    void setFPS (const int fps);
-    void setCamera (QCamera* camera);
-    void setName (const QString& name);
-    void setZoomLevel (const int level);
-    void setGroup (const QString& group);
-    void setResolution (const int resolution);
-    void setFlashlightEnabled (const bool enabled);
-    void setAutoRegulateResolution (const bool regulate);
-
-private Q_SLOTS:
-    void update();
-    void sendInfo();
-    void sendImage();
-    void changeImage();
-    void broadcastInfo();
-    void onDisconnected();
-    void acceptConnection();
-    void readCommandPacket();
-    void onWatchdogTimeout();
-    void onBytesWritten (const qint64 bytes);
-
-private:
-    void updateStatus();
-    void addStatusFlag (const int status);
-    void setCameraStatus (const int status);
-    void removeStatusFlag (const int status);
-
-    QString deviceName();
-    QCCTV_InfoPacket* infoPacket();
-    QCCTV_ImagePacket* imagePacket();
-    QCCTV_CommandPacket* commandPacket();
-
-private:
-    QCamera* m_camera;
-    QCameraImageCapture* m_capture;
-
-    QTcpServer m_server;
-    QUdpSocket m_cmdSocket;
-    QUdpSocket m_infoSocket;
-    QUdpSocket m_broadcastSocket;
-
-    QByteArray m_data;
-
-    QStringList m_hostNames;
-    QList<QTcpSocket*> m_sockets;
-    QList<QCCTV_Watchdog*> m_watchdogs;
-
-    QCCTV_ImageCapture* m_imageCapture;
-
-    QCCTV_InfoPacket* m_infoPacket;
-    QCCTV_ImagePacket* m_imagePacket;
-    QCCTV_CommandPacket* m_commandPacket;
-};
-
-#endif
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_LOCAL_CAMERA_H
+#define _QCCTV_LOCAL_CAMERA_H
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+
+#include <QCCTV.h>
+#include <QCCTV_Communications.h>
+
+class QTimer;
+class QCamera;
+class QCCTV_Session;
+class QCCTV_Watchdog;
+class QCCTV_ImageCapture;
+class QCameraImageCapture;
+class QCCTV_MotionDetector;
+class QCCTV_DatagramStream;
+class QCCTV_RtpStream;
+class QCCTV_SharedFrames;
+class QCCTV_Pacer;
+
+/**
+ * Receive credits of a station, stations that do not use flow control have
+ * a negative number of granted frames. The station's stream is made of the
+ * frames with the \c latest and \c previous IDs (stations with their own
+ * stream do not get every frame)
+ */
+struct QCCTV_StationCredits {
+    int granted;
+    int sent;
+    int frame;
+    int latest;
+    int previous;
+    bool selfContained;
+    bool resync;
+};
+
+class QCCTV_LocalCamera : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY (int fps
+                READ fps
+                WRITE setFPS
+                NOTIFY fpsChanged)
+    Q_PROPERTY (QString name
+                READ name
+                WRITE setName
+                NOTIFY nameChanged)
+    Q_PROPERTY (QString group
+                READ group
+                WRITE setGroup
+                NOTIFY groupChanged)
+    Q_PROPERTY (int resolution
+                READ resolution
+                WRITE setResolution
+                NOTIFY resolutionChanged)
+    Q_PROPERTY (int zoomLevel
+                READ zoomLevel
+                WRITE setZoomLevel
+                NOTIFY zoomLevelChanged)
+    Q_PROPERTY (bool flashlightEnabled
+                READ flashlightEnabled
+                WRITE setFlashlightEnabled
+                NOTIFY lightStatusChanged)
+    Q_PROPERTY (bool autoRegulateResolution
+                READ autoRegulateResolution
+                WRITE setAutoRegulateResolution
+                NOTIFY autoRegulateResolutionChanged)
+    Q_PROPERTY (bool motionDetectionEnabled
+                READ motionDetectionEnabled
+                WRITE setMotionDetectionEnabled
+                NOTIFY motionDetectionEnabledChanged)
+    Q_PROPERTY (int idleFps
+                READ idleFps
+                WRITE setIdleFps
+                NOTIFY idleFpsChanged)
+    Q_PROPERTY (int bitrate
+                READ bitrate
+                WRITE setBitrate
+                NOTIFY bitrateChanged)
+    Q_PROPERTY (int quality
+                READ quality
+                NOTIFY qualityChanged)
+    Q_PROPERTY (bool deltaFramesEnabled
+                READ deltaFramesEnabled
+                WRITE setDeltaFramesEnabled
+                NOTIFY streamFlagsChanged)
+    Q_PROPERTY (bool grayscale
+                READ grayscale
+                NOTIFY grayscaleChanged)
+    Q_PROPERTY (bool grayscaleEnabled
+                READ grayscaleEnabled
+                WRITE setGrayscaleEnabled
+                NOTIFY streamFlagsChanged)
+    Q_PROPERTY (bool autoGrayscaleEnabled
+                READ autoGrayscaleEnabled
+                WRITE setAutoGrayscaleEnabled
+                NOTIFY streamFlagsChanged)
+    Q_PROPERTY (QRectF regionOfInterest
+                READ regionOfInterest
+                WRITE setRegionOfInterest
+                NOTIFY regionOfInterestChanged)
+    Q_PROPERTY (bool noiseReductionEnabled
+                READ noiseReductionEnabled
+                WRITE setNoiseReductionEnabled
+                NOTIFY streamFlagsChanged)
+    Q_PROPERTY (bool motionDetected
+                READ motionDetected
+                NOTIFY motionDetectedChanged)
+    Q_PROPERTY (int minimumFps
+                READ minimumFPS
+                CONSTANT)
+    Q_PROPERTY (int maximumFps
+                READ maximumFPS
+                NOTIFY maximumFpsChanged)
+    Q_PROPERTY (bool highFpsEnabled
+                READ highFpsEnabled
+                WRITE setHighFpsEnabled
+                NOTIFY highFpsEnabledChanged)
+    Q_PROPERTY (bool supportsZoom
+                READ supportsZoom
+                NOTIFY supportsZoomChanged)
+    Q_PROPERTY (int statusCode
+                READ cameraStatus
+                NOTIFY cameraStatusChanged)
+    Q_PROPERTY (QString statusString
+                READ statusString
+                NOTIFY cameraStatusChanged)
+    Q_PROPERTY (bool readyForCapture
+                READ readyForCapture
+                NOTIFY cameraStatusChanged)
+    Q_PROPERTY (bool flashlightAvailable
+                READ flashlightAvailable
+                NOTIFY cameraStatusChanged)
+    Q_PROPERTY (QStringList connectedHosts
+                READ connectedHosts
+                NOTIFY hostCountChanged)
+    Q_PROPERTY (QStringList hostNames
+                READ hostNames
+                NOTIFY hostNamesChanged)
+    Q_PROPERTY (QStringList resolutions
+                READ availableResolutions
+                NOTIFY hostCountChanged)
+    Q_PROPERTY (QString rtpDestination
+                READ rtpDestination
+                WRITE setRtpDestination
+                NOTIFY rtpDestinationChanged)
+    Q_PROPERTY (QString rtpSessionDescription
+                READ rtpSessionDescription
+                NOTIFY rtpDestinationChanged)
+    Q_PROPERTY (bool pacingEnabled
+                READ pacingEnabled
+                WRITE setPacingEnabled
+                NOTIFY pacingChanged)
+    Q_PROPERTY (int pacingBurst
+                READ pacingBurst
+                WRITE setPacingBurst
+                NOTIFY pacingChanged)
+    Q_PROPERTY (QStringList pacingStatistics
+                READ pacingStatistics
+                NOTIFY pacingStatisticsChanged)
+
+Q_SIGNALS:
+    void fpsChanged();
+    void maximumFpsChanged();
+    void highFpsEnabledChanged();
+    void nameChanged();
+    void imageChanged();
+    void groupChanged();
+    void bitrateChanged();
+    void qualityChanged();
+    void grayscaleChanged();
+    void cameraChanged();
+    void idleFpsChanged();
+    void hostNamesChanged();
+    void zoomLevelChanged();
+    void streamFlagsChanged();
+    void hostCountChanged();
+    void resolutionChanged();
+    void lightStatusChanged();
+    void focusStatusChanged();
+    void supportsZoomChanged();
+    void regionOfInterestChanged();
+    void rtpDestinationChanged();
+    void pacingChanged();
+    void pacingStatisticsChanged();
+    void cameraStatusChanged();
+    void motionDetectedChanged();
+    void autoRegulateResolutionChanged();
+    void motionDetectionEnabledChanged();
+
+public:
+    QCCTV_LocalCamera (QObject* parent = NULL);
+    ~QCCTV_LocalCamera();
+
+    int fps();
+    int idleFps();
+    QString name();
+    QString group();
+    int bitrate();
+    int quality();
+    int zoomLevel();
+    int resolution();
+    int streamFlags();
+    int cameraStatus();
+    bool supportsZoom();
+    QImage currentImage();
+    QString statusString();
+    int flashlightEnabled();
+    bool motionDetected();
+    bool grayscale();
+    QRectF regionOfInterest();
+    QString rtpDestination();
+    QString rtpSessionDescription();
+    bool grayscaleEnabled();
+    bool deltaFramesEnabled();
+    bool autoGrayscaleEnabled();
+    bool noiseReductionEnabled();
+    bool autoRegulateResolution();
+    bool motionDetectionEnabled();
+    bool highFpsEnabled();
+    bool pacingEnabled();
+    int pacingBurst();
+    QStringList pacingStatistics();
+
+    int minimumFPS() const;
+    int maximumFPS() const;
+    bool readyForCapture() const;
+    bool flashlightAvailable() const;
+    QStringList hostNames() const;
+    QStringList connectedHosts() const;
+    QStringList availableResolutions() const;
+
+public Q_SLOTS:
+    void takePhoto();
+    void focusCamera();
+    void requestKeyframe();
+    void setFPS (const int fps);
+    void setIdleFps (const int fps);
+    void setBitrate (const int bitrate);
+    void setCamera (QCamera* camera);
+    void setName (const QString& name);
+    void setZoomLevel (const int level);
+    void setGroup (const QString& group);
+    void setResolution (const int resolution);
+    void setStreamFlags (const int flags);
+    void setGrayscaleEnabled (const bool enabled);
+    void setDeltaFramesEnabled (const bool enabled);
+    void setAutoGrayscaleEnabled (const bool enabled);
+    void setNoiseReductionEnabled (const bool enabled);
+    void setRegionOfInterest (const QRectF& roi);
+    void setRtpDestination (const QString& destination);
+    void setFlashlightEnabled (const bool enabled);
+    void setAutoRegulateResolution (const bool regulate);
+    void setMotionDetectionEnabled (const bool enabled);
+    void setHighFpsEnabled (const bool enabled);
+    void setPacingEnabled (const bool enabled);
+    void setPacingBurst (const int burst);
+
+private Q_SLOTS:
+    void update();
+    void sendInfo();
+    void sendImage();
+    void changeImage();
+    void broadcastInfo();
+    void onDisconnected();
+    void acceptSession();
+    void acceptConnection();
+    void onImageEncoded();
+    void onSessionAck();
+    void onSessionResync();
+    void readCommandPacket();
+    void onSnapshotEncoded();
+    void onSessionHello (const QByteArray& data);
+    void onSessionNack (const quint16 id);
+    void onSessionCommand (const QByteArray& data);
+    void onWatchdogTimeout();
+    void onBytesWritten (const qint64 bytes);
+
+private:
+    bool isIdle();
+    int capabilities();
+    void updateStatus();
+    void updateMaximumFps();
+    void updateGrayscale();
+    void encodeSnapshot();
+    void sendFrame (const int index);
+    int captureFps();
+    int stationFps (const int index);
+    bool reducedRate (const int index);
+    bool frameDue (const int index, const qint64 time);
+    void updateStreams();
+    void setStationFps (const int index, const int fps);
+    void addFrame (const int index, const bool selfContained);
+    void requestKeyframe (const int index);
+    void updatePacer (QCCTV_Pacer* pacer, const int bytes, const int fps);
+    void addStation (QTcpSocket* socket, const bool session);
+    void readCommand (const QByteArray& data, const int index);
+    void removeCrop (const int index);
+    void setUdpTransport (const int index, const int port, const int parity);
+    void setMulticast (const int index, const bool enabled);
+    void setSharedMemory (const int index, const bool enabled);
+    bool writeSharedFrame();
+    void setCrop (const int index, const QRectF& crop);
+    bool idleFrameDue (const int lookahead);
+    void setMotionDetected (const bool detected);
+    void addStatusFlag (const int status);
+    void setCameraStatus (const int status);
+    void removeStatusFlag (const int status);
+
+    QString deviceName();
+    QCCTV_InfoPacket* infoPacket();
+    QCCTV_ImagePacket* imagePacket();
+    QCCTV_CommandPacket* commandPacket();
+
+private:
+    QCamera* m_camera;
+    QCameraImageCapture* m_capture;
+
+    QTcpServer m_server;
+    QTcpServer m_sessionServer;
+    QUdpSocket m_cmdSocket;
+    QUdpSocket m_infoSocket;
+    QUdpSocket m_broadcastSocket;
+
+    int m_idleFps;
+    bool m_highFpsEnabled;
+    int m_frameId;
+    bool m_selfContained;
+    QByteArray m_data;
+    bool m_fullInfoRequested;
+    QCCTV_PacketState m_infoState;
+    QElapsedTimer m_idleClock;
+    bool m_keyframeRequested;
+
+    QTimer* m_frameTimer;
+    qint64 m_nextFrame;
+    qint64 m_captureTime;
+    QElapsedTimer m_frameClock;
+
+    QStringList m_hostNames;
+    QList<QTcpSocket*> m_sockets;
+    QList<QCCTV_Session*> m_sessions;
+    QList<QCCTV_Watchdog*> m_watchdogs;
+    QList<QCCTV_PacketState> m_commandStates;
+    QList<QCCTV_StationCredits> m_credits;
+    QList<QCCTV_HelloPacket> m_peers;
+    QList<QCCTV_DatagramStream*> m_udpStreams;
+    QList<bool> m_multicast;
+    QCCTV_DatagramStream* m_multicastStream;
+    QList<bool> m_sharedMemory;
+    QList<int> m_stationFps;
+    QList<qreal> m_deliveryTimes;
+    QList<bool> m_keyframeRequests;
+    QCCTV_SharedFrames* m_sharedFrames;
+    int m_sharedFrameId;
+    quint16 m_sharedSlot;
+    quint32 m_sharedSequence;
+
+    QCCTV_ImageCapture* m_imageCapture;
+    QCCTV_MotionDetector* m_motionDetector;
+    QFutureWatcher<QList<QByteArray>>* m_encoder;
+    QCCTV_RtpStream* m_rtpStream;
+    bool m_rtpEncoded;
+
+    int m_pacingBurst;
+    bool m_pacingEnabled;
+
+    QList<QByteArray> m_cropData;
+    QList<QCCTV_ImagePacket*> m_cropPackets;
+    QList<QCCTV_ImagePacket*> m_encodedCrops;
+
+    QList<int> m_snapshotRequests;
+    QTcpSocket* m_snapshotTarget;
+    QList<QTcpSocket*> m_snapshotQueue;
+    QFutureWatcher<QByteArray>* m_snapshotEncoder;
+
+    QCCTV_InfoPacket* m_infoPacket;
+    QCCTV_ImagePacket* m_imagePacket;
+    QCCTV_CommandPacket* m_commandPacket;
+};
+
+#endif
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_MotionAnalyzer.h"
+#include "QCCTV_MotionDetector.h"
+
+#include <QBuffer>
+#include <QThread>
+#include <QThreadPool>
+#include <QImageReader>
+#include <QtConcurrent/QtConcurrent>
+
+/**
+ * Decodes the given \a jpeg at a reduced scale (libjpeg only performs a
+ * fraction of the IDCT work in this case) and feeds it to the \a detector.
+ *
+ * The time spent in the analysis is written to \a cost (in microseconds)
+ */
+static bool analyze_frame (QCCTV_MotionDetector* detector,
+                           const QByteArray& jpeg,
+                           qint64* cost)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    /* Decode a small version of the image */
+    QByteArray data = jpeg;
+    QBuffer buffer (&data);
+    QImageReader reader (&buffer, "jpg");
+    reader.setScaledSize (QSize (QCCTV_MOTION_WIDTH, QCCTV_MOTION_HEIGHT));
+
+    /* Run the motion detector */
+    bool motion = detector->motionDetected();
+    QImage image = reader.read();
+    if (!image.isNull())
+        motion = detector->process (QCCTV_CreateLumaPlane (image));
+
+    *cost = timer.nsecsElapsed() / 1000;
+    return motion;
+}
+
+/**
+ * Feeds the given (already decoded) \a image to the \a detector, this is used
+ * for the frames that are not available as JPEG data (e.g. delta frames).
+ *
+ * The time spent in the analysis is written to \a cost (in microseconds)
+ */
+static bool analyze_image (QCCTV_MotionDetector* detector,
+                           const QImage& image,
+                           qint64* cost)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool motion = detector->motionDetected();
+    if (!image.isNull())
+        motion = detector->process (QCCTV_CreateLumaPlane (image));
+
+    *cost = timer.nsecsElapsed() / 1000;
+    return motion;
+}
+
+/**
+ * Creates the thread pool shared by all the motion analyzers, half of the
+ * available cores are left for decoding and displaying the streams
+ */
+static QThreadPool* create_pool()
+{
+    QThreadPool* pool = new QThreadPool;
+    pool->setMaxThreadCount (qMax (1, QThread::idealThreadCount() / 2));
+    return pool;
+}
+
+/**
+ * Initializes the analyzer (which is disabled by default)
+ */
+QCCTV_MotionAnalyzer::QCCTV_MotionAnalyzer (QObject* parent) : QObject (parent)
+{
+    m_cost = 0;
+    m_lastCost = 0;
+    m_motion = false;
+    m_enabled = false;
+    m_budget = QCCTV_DEFAULT_ANALYSIS_BUDGET;
+    m_detector = new QCCTV_MotionDetector;
+    m_watcher = new QFutureWatcher<bool> (this);
+
+    connect (m_watcher, SIGNAL (finished()),
+             this,        SLOT (onAnalysisFinished()));
+}
+
+/**
+ * Waits for the current analysis to finish and deletes the detector
+ */
+QCCTV_MotionAnalyzer::~QCCTV_MotionAnalyzer()
+{
+    m_watcher->waitForFinished();
+    delete m_detector;
+}
+
+/**
+ * Returns the maximum percentage of a CPU core that the analyzer may use
+ */
+int QCCTV_MotionAnalyzer::cpuBudget() const
+{
+    return m_budget;
+}
+
+/**
+ * Returns \c true if the analyzer shall process the frames given to it
+ */
+bool QCCTV_MotionAnalyzer::isEnabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns \c true if motion was detected in the latest analyzed frames
+ */
+bool QCCTV_MotionAnalyzer::motionDetected() const
+{
+    return m_motion;
+}
+
+/**
+ * Starts analyzing the given decoded \a image in the thread pool.
+ *
+ * \sa acceptFrame()
+ */
+void QCCTV_MotionAnalyzer::analyze (const QImage& image)
+{
+    if (image.isNull() || !acceptFrame())
+        return;
+
+    m_clock.start();
+    m_watcher->setFuture (QtConcurrent::run (threadPool(), analyze_image,
+                                             m_detector, image,
+                                             &m_lastCost));
+}
+
+/**
+ * Starts analyzing the given \a jpeg frame in the thread pool.
+ *
+ * \sa acceptFrame()
+ */
+void QCCTV_MotionAnalyzer::analyze (const QByteArray& jpeg)
+{
+    if (jpeg.isEmpty() || !acceptFrame())
+        return;
+
+    m_clock.start();
+    m_watcher->setFuture (QtConcurrent::run (threadPool(), analyze_frame,
+                                             m_detector, jpeg,
+                                             &m_lastCost));
+}
+
+/**
+ * Enables or disables the analyzer, the background model is discarded
+ * when the analyzer is disabled
+ */
+void QCCTV_MotionAnalyzer::setEnabled (const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_watcher->waitForFinished();
+
+    m_enabled = enabled;
+    m_detector->reset();
+
+    if (!enabled && m_motion) {
+        m_motion = false;
+        emit motionDetectedChanged();
+    }
+}
+
+/**
+ * Changes the maximum percentage of a CPU core that the analyzer may use
+ */
+void QCCTV_MotionAnalyzer::setCpuBudget (const int budget)
+{
+    m_budget = qMin (qMax (budget, 1), 100);
+}
+
+/**
+ * Updates the average analysis cost and the motion status
+ */
+void QCCTV_MotionAnalyzer::onAnalysisFinished()
+{
+    /* Update average cost */
+    if (m_cost == 0)
+        m_cost = m_lastCost;
+    else
+        m_cost = (m_cost * 7 + m_lastCost) / 8;
+
+    /* Update motion status */
+    bool motion = isEnabled() && m_watcher->result();
+    if (m_motion != motion) {
+        m_motion = motion;
+        emit motionDetectedChanged();
+    }
+}
+
+/**
+ * Returns \c true if a new frame can be analyzed.
+ *
+ * The frame is dropped if the analyzer is disabled, if the previous frame is
+ * still being analyzed, if the pool has no free threads or if analyzing the
+ * frame now would exceed the CPU budget (based on the average cost of the
+ * previous analyses)
+ */
+bool QCCTV_MotionAnalyzer::acceptFrame()
+{
+    /* Analyzer is disabled or busy */
+    if (!isEnabled() || m_watcher->isRunning())
+        return false;
+
+    /* Station is loaded, skip this frame */
+    QThreadPool* pool = threadPool();
+    if (pool->activeThreadCount() >= pool->maxThreadCount())
+        return false;
+
+    /* Keep the time spent analyzing below the CPU budget */
+    if (m_clock.isValid()) {
+        qint64 interval = (m_cost * 100) / qMax (cpuBudget(), 1);
+        if (m_clock.nsecsElapsed() / 1000 < interval)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Returns the thread pool shared by all the motion analyzers
+ */
+QThreadPool* QCCTV_MotionAnalyzer::threadPool()
+{
+    static QThreadPool* pool = create_pool();
+    return pool;
+}
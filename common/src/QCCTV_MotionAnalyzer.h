@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_MOTION_ANALYZER_H
+#define _QCCTV_MOTION_ANALYZER_H
+
+#include <QImage>
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+
+class QThreadPool;
+class QCCTV_MotionDetector;
+
+/**
+ * \brief Runs motion detection on the frames received from a remote camera.
+ *
+ * Frames are decoded at a reduced scale and analyzed in a thread pool that
+ * is shared by all the analyzers of the station. Frames are skipped (instead
+ * of being queued) when the previous analysis has not finished yet or when
+ * running the analysis would exceed the CPU budget of the camera.
+ */
+class QCCTV_MotionAnalyzer : public QObject
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void motionDetectedChanged();
+
+public:
+    QCCTV_MotionAnalyzer (QObject* parent = NULL);
+    ~QCCTV_MotionAnalyzer();
+
+    int cpuBudget() const;
+    bool isEnabled() const;
+    bool motionDetected() const;
+
+public Q_SLOTS:
+    void analyze (const QImage& image);
+    void analyze (const QByteArray& jpeg);
+    void setEnabled (const bool enabled);
+    void setCpuBudget (const int budget);
+
+private Q_SLOTS:
+    void onAnalysisFinished();
+
+private:
+    bool acceptFrame();
+    static QThreadPool* threadPool();
+
+private:
+    int m_budget;
+    bool m_enabled;
+    bool m_motion;
+    qint64 m_cost;
+    qint64 m_lastCost;
+    QElapsedTimer m_clock;
+    QFutureWatcher<bool>* m_watcher;
+    QCCTV_MotionDetector* m_detector;
+};
+
+#endif
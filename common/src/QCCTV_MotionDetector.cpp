@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_MotionDetector.h"
+
+/*
+ * The background model is stored with 4 fractional bits, the thresholds
+ * below are expressed in luma units (0-255) and per-mille of the plane
+ */
+static const int FRACTION_BITS    = 4;
+static const int LEARNING_SHIFT   = 4;
+static const int FOREGROUND_SHIFT = 7;
+static const int PIXEL_THRESHOLD  = 18;
+static const int AREA_THRESHOLD   = 10;
+
+/**
+ * Initializes the detector with an empty background model
+ */
+QCCTV_MotionDetector::QCCTV_MotionDetector()
+{
+    reset();
+}
+
+/**
+ * Returns \c true if motion was detected within the last
+ * \c QCCTV_MOTION_HOLD_TIME milliseconds
+ */
+bool QCCTV_MotionDetector::motionDetected() const
+{
+    return m_motion;
+}
+
+/**
+ * Discards the background model, the next frame given to \c process() shall
+ * be used as the new background.
+ *
+ * The scene is considered to be in motion until the hold time expires, so
+ * that the stations receive a few frames at full rate after a reset.
+ */
+void QCCTV_MotionDetector::reset()
+{
+    m_motion = true;
+    m_background.clear();
+    m_lastMotion.start();
+}
+
+/**
+ * Compares the given \a luma plane with the background model, updates the
+ * model and returns \c true if the scene is (or recently was) in motion.
+ *
+ * Global brightness changes (e.g. auto-exposure) are compensated by removing
+ * the mean difference before thresholding each pixel.
+ */
+bool QCCTV_MotionDetector::process (const QByteArray& luma)
+{
+    const int count = QCCTV_MOTION_WIDTH * QCCTV_MOTION_HEIGHT;
+    if (luma.size() != count)
+        return m_motion;
+
+    const uchar* data = reinterpret_cast<const uchar*> (luma.constData());
+
+    /* First frame, use it as the background */
+    if (m_background.size() != count) {
+        m_background.resize (count);
+        for (int i = 0; i < count; ++i)
+            m_background [i] = data [i] << FRACTION_BITS;
+
+        return m_motion;
+    }
+
+    /* Get mean difference between frame and background */
+    qint64 sum = 0;
+    for (int i = 0; i < count; ++i)
+        sum += (data [i] << FRACTION_BITS) - m_background [i];
+
+    const int offset = sum / count;
+    const int threshold = PIXEL_THRESHOLD << FRACTION_BITS;
+
+    /* Count foreground pixels and update the background model */
+    int changed = 0;
+    for (int i = 0; i < count; ++i) {
+        const int value = data [i] << FRACTION_BITS;
+        const int delta = value - m_background [i];
+
+        if (qAbs (delta - offset) > threshold) {
+            ++changed;
+            m_background [i] += delta >> FOREGROUND_SHIFT;
+        }
+
+        else
+            m_background [i] += delta >> LEARNING_SHIFT;
+    }
+
+    /* Update motion state */
+    if (changed * 1000 >= count * AREA_THRESHOLD) {
+        m_motion = true;
+        m_lastMotion.restart();
+    }
+
+    else if (m_lastMotion.hasExpired (QCCTV_MOTION_HOLD_TIME))
+        m_motion = false;
+
+    return m_motion;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_MOTION_DETECTOR_H
+#define _QCCTV_MOTION_DETECTOR_H
+
+#include <QVector>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+/**
+ * \brief Detects motion by comparing a low-resolution luma plane against a
+ *        slowly-adapting background model.
+ *
+ * The luma planes fed to this class must have a size of
+ * \c QCCTV_MOTION_WIDTH x \c QCCTV_MOTION_HEIGHT pixels.
+ */
+class QCCTV_MotionDetector
+{
+public:
+    explicit QCCTV_MotionDetector();
+
+    bool motionDetected() const;
+
+    void reset();
+    bool process (const QByteArray& luma);
+
+private:
+    bool m_motion;
+    QElapsedTimer m_lastMotion;
+    QVector<int> m_background;
+};
+
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_Pacer.h"
+
+#include <math.h>
+
+/**
+ * Initializes a disabled pacer with a full bucket
+ */
+QCCTV_Pacer::QCCTV_Pacer()
+{
+    m_rate = 0;
+    m_enabled = false;
+    m_waiting = false;
+    m_burst = QCCTV_DEFAULT_PACING_BURST;
+    m_tokens = m_burst;
+
+    m_clock.start();
+    resetStatistics();
+}
+
+/**
+ * Returns the max. number of bytes that can be sent at once
+ */
+int QCCTV_Pacer::burst() const
+{
+    return m_burst;
+}
+
+/**
+ * Returns the rate (bytes per second) at which the bucket is refilled
+ */
+qint64 QCCTV_Pacer::rate() const
+{
+    return m_rate;
+}
+
+/**
+ * Returns \c true if the pacer delays the sender
+ */
+bool QCCTV_Pacer::isEnabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the pacing counters (and the current rate and burst)
+ */
+QCCTV_PacingStats QCCTV_Pacer::statistics() const
+{
+    QCCTV_PacingStats stats = m_stats;
+    stats.rate = m_rate;
+    stats.burst = m_burst;
+    return stats;
+}
+
+/**
+ * Returns the time (in ms) that the sender must wait before sending the
+ * given number of \a bytes, chunks larger than the burst allowance only
+ * wait for a full bucket
+ */
+int QCCTV_Pacer::delay (const int bytes)
+{
+    /* Pacing is disabled */
+    if (!m_enabled || m_rate <= 0)
+        return 0;
+
+    /* Enough tokens for the chunk */
+    refill();
+    double needed = qMin (bytes, m_burst);
+    if (m_tokens >= needed)
+        return 0;
+
+    /* Start counting the wait */
+    if (!m_waiting) {
+        m_waiting = true;
+        m_waitClock.start();
+        ++m_stats.waits;
+    }
+
+    /* Time until the bucket has enough tokens */
+    return qMax (1, (int) ceil ((needed - m_tokens) * 1000 / m_rate));
+}
+
+/**
+ * Takes the given number of \a bytes from the bucket, the bucket may go
+ * below zero if the chunk was larger than the burst allowance
+ */
+void QCCTV_Pacer::consume (const int bytes)
+{
+    m_stats.bytes += bytes;
+
+    /* Update the wait counters */
+    if (m_waiting) {
+        int wait = (int) m_waitClock.elapsed();
+        m_stats.waitTime += wait;
+        m_stats.maxWait = qMax (m_stats.maxWait, wait);
+        m_waiting = false;
+    }
+
+    /* Take the tokens */
+    if (m_enabled && m_rate > 0) {
+        refill();
+        m_tokens -= bytes;
+    }
+}
+
+/**
+ * Clears the pacing counters
+ */
+void QCCTV_Pacer::resetStatistics()
+{
+    m_stats.rate = 0;
+    m_stats.burst = 0;
+    m_stats.bytes = 0;
+    m_stats.waits = 0;
+    m_stats.maxWait = 0;
+    m_stats.waitTime = 0;
+}
+
+/**
+ * Changes the \a rate (bytes per second) at which the bucket is refilled
+ */
+void QCCTV_Pacer::setRate (const qint64 rate)
+{
+    refill();
+    m_rate = qMax ((qint64) 0, rate);
+}
+
+/**
+ * Changes the max. number of bytes that can be sent at once
+ */
+void QCCTV_Pacer::setBurst (const int burst)
+{
+    m_burst = qMin (qMax (burst, QCCTV_MIN_PACING_BURST),
+                    QCCTV_MAX_PACING_BURST);
+    m_tokens = qMin (m_tokens, (double) m_burst);
+}
+
+/**
+ * Enables or disables the pacing, the bucket starts full
+ */
+void QCCTV_Pacer::setEnabled (const bool enabled)
+{
+    m_enabled = enabled;
+    m_waiting = false;
+    m_tokens = m_burst;
+    m_clock.restart();
+}
+
+/**
+ * Adds the tokens earned since the last refill
+ */
+void QCCTV_Pacer::refill()
+{
+    qint64 elapsed = m_clock.nsecsElapsed();
+    m_clock.restart();
+
+    m_tokens += (double) m_rate * elapsed / 1000000000.0;
+    m_tokens = qMin (m_tokens, (double) m_burst);
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_PACER_H
+#define _QCCTV_PACER_H
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+
+/**
+ * Counters used to tune the pacing of a connection
+ */
+typedef struct {
+    qint64 rate;      /**< Current rate (bytes per second) */
+    int burst;        /**< Current burst allowance (bytes) */
+    qint64 bytes;     /**< Bytes sent through the pacer */
+    int waits;        /**< Number of times that the sender had to wait */
+    qint64 waitTime;  /**< Total time spent waiting (ms) */
+    int maxWait;      /**< Longest wait (ms) */
+} QCCTV_PacingStats;
+
+/**
+ * \brief Token bucket used to spread the data of a frame over time.
+ *
+ * The bucket is refilled at the given rate (bytes per second) and holds up
+ * to the burst allowance. The sender asks how long it has to wait before
+ * sending a chunk of data, and consumes the tokens when the chunk is sent.
+ *
+ * Disabled pacers (or pacers without a rate) never delay the sender.
+ */
+class QCCTV_Pacer
+{
+public:
+    explicit QCCTV_Pacer();
+
+    int burst() const;
+    qint64 rate() const;
+    bool isEnabled() const;
+    QCCTV_PacingStats statistics() const;
+
+    int delay (const int bytes);
+    void consume (const int bytes);
+
+    void resetStatistics();
+    void setRate (const qint64 rate);
+    void setBurst (const int burst);
+    void setEnabled (const bool enabled);
+
+private:
+    void refill();
+
+private:
+    int m_burst;
+    qint64 m_rate;
+    bool m_enabled;
+    bool m_waiting;
+    double m_tokens;
+
+    QElapsedTimer m_clock;
+    QElapsedTimer m_waitClock;
+    QCCTV_PacingStats m_stats;
+};
+
+#endif
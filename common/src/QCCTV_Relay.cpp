@@ -0,0 +1,455 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_Relay.h"
+#include "QCCTV_Session.h"
+
+#include <QTimer>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+/**
+ * Frame formats that viewers must understand, since we cannot change the
+ * frames that we forward
+ */
+static const int REQUIRED_CAPABILITIES = QCCTV_CAP_DELTA_FRAMES |
+                                         QCCTV_CAP_JPEG_TABLES;
+
+/**
+ * Features of the protocol that the relay offers to its viewers
+ */
+static const int RELAY_CAPABILITIES = REQUIRED_CAPABILITIES |
+                                      QCCTV_CAP_PARTIAL_STATE |
+                                      QCCTV_CAP_CREDITS;
+
+/**
+ * Starts announcing the relayed cameras (once the relay is enabled)
+ */
+QCCTV_Relay::QCCTV_Relay (QObject* parent) : QObject (parent)
+{
+    m_enabled = false;
+    announce();
+}
+
+/**
+ * Closes the connections with the viewers
+ */
+QCCTV_Relay::~QCCTV_Relay()
+{
+    foreach (Feed* feed, m_feeds)
+        stopServer (feed);
+
+    qDeleteAll (m_feeds);
+    m_feeds.clear();
+}
+
+/**
+ * Returns \c true if the cameras are relayed to other stations
+ */
+bool QCCTV_Relay::isEnabled() const
+{
+    return m_enabled;
+}
+
+/**
+ * Returns the number of stations that receive our relayed cameras
+ */
+int QCCTV_Relay::viewerCount() const
+{
+    int count = 0;
+    foreach (Feed* feed, m_feeds)
+        count += feed->viewers.count();
+
+    return count;
+}
+
+/**
+ * Starts or stops relaying the cameras, the viewers are disconnected when
+ * the relay is disabled
+ */
+void QCCTV_Relay::setEnabled (const bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    foreach (Feed* feed, m_feeds) {
+        if (enabled)
+            startServer (feed);
+        else
+            stopServer (feed);
+    }
+}
+
+/**
+ * Registers the given remote \a camera (with the given \a address), its
+ * stream is received through the \c publishInfo() and \c publishImage()
+ * slots
+ */
+void QCCTV_Relay::addCamera (QObject* camera, const QHostAddress& address)
+{
+    if (!camera || findFeed (camera))
+        return;
+
+    Feed* feed = new Feed;
+    feed->camera = camera;
+    feed->address = address;
+    feed->server = Q_NULLPTR;
+    feed->selfContained = false;
+    feed->keyframeRequested = false;
+    feed->frameId = 0;
+    m_feeds.append (feed);
+
+    if (m_enabled)
+        startServer (feed);
+}
+
+/**
+ * Stops relaying the given \a camera and disconnects its viewers
+ */
+void QCCTV_Relay::removeCamera (QObject* camera)
+{
+    Feed* feed = findFeed (camera);
+    if (feed) {
+        stopServer (feed);
+        m_feeds.removeAll (feed);
+        delete feed;
+    }
+}
+
+/**
+ * Forwards the (full) info packet \a data of the camera that emitted the
+ * signal connected to this slot
+ */
+void QCCTV_Relay::publishInfo (const QByteArray& data)
+{
+    Feed* feed = findFeed (sender());
+    if (!feed || data.isEmpty())
+        return;
+
+    feed->info = data;
+    foreach (Viewer* viewer, feed->viewers)
+        if (viewer->ready)
+            viewer->session->sendInfo (data);
+}
+
+/**
+ * Forwards the image packet \a data of the camera that emitted the signal
+ * connected to this slot to the viewers that can receive it
+ */
+void QCCTV_Relay::publishImage (const QByteArray& data,
+                                const bool selfContained)
+{
+    Feed* feed = findFeed (sender());
+    if (!feed || data.isEmpty())
+        return;
+
+    feed->image = data;
+    feed->selfContained = selfContained;
+    feed->frameId++;
+    if (selfContained)
+        feed->keyframeRequested = false;
+
+    foreach (Viewer* viewer, feed->viewers)
+        sendFrame (feed, viewer);
+}
+
+/**
+ * Announces the relayed cameras to the local network, the discovery packet
+ * contains the port of the session server of each camera and the address
+ * of the camera that it serves
+ */
+void QCCTV_Relay::announce()
+{
+    if (m_enabled) {
+        foreach (Feed* feed, m_feeds) {
+            if (!feed->server || !feed->server->isListening())
+                continue;
+
+            QString str = QString ("QCCTV_DISCOVERY_SERVICE:%1:%2")
+                          .arg (feed->server->serverPort())
+                          .arg (feed->address.toString());
+            m_broadcastSocket.writeDatagram (str.toUtf8(),
+                                             QHostAddress::Broadcast,
+                                             QCCTV_DISCOVERY_PORT);
+        }
+    }
+
+    QTimer::singleShot (1000, this, SLOT (announce()));
+}
+
+/**
+ * Registers the stations that want to receive a relayed camera
+ */
+void QCCTV_Relay::acceptViewers()
+{
+    QTcpServer* server = qobject_cast<QTcpServer*> (sender());
+    Feed* feed = Q_NULLPTR;
+    foreach (Feed* f, m_feeds)
+        if (f->server == server)
+            feed = f;
+
+    if (!server || !feed)
+        return;
+
+    while (server->hasPendingConnections()) {
+        Viewer* viewer = new Viewer;
+        viewer->socket = server->nextPendingConnection();
+        viewer->session = new QCCTV_Session (viewer->socket, this);
+        viewer->ready = false;
+        viewer->resync = true;
+        viewer->granted = 0;
+        viewer->sent = 0;
+        viewer->frame = -1;
+        QCCTV_InitState (&viewer->state);
+        feed->viewers.append (viewer);
+
+        viewer->socket->setSocketOption (QTcpSocket::LowDelayOption, 1);
+        viewer->socket->setSocketOption (QTcpSocket::KeepAliveOption, 1);
+
+        connect (viewer->socket,  SIGNAL (disconnected()),
+                 this,              SLOT (onDisconnected()));
+        connect (viewer->session, SIGNAL (helloReceived (QByteArray)),
+                 this,              SLOT (onSessionHello (QByteArray)));
+        connect (viewer->session, SIGNAL (commandReceived (QByteArray)),
+                 this,              SLOT (onSessionCommand (QByteArray)));
+    }
+}
+
+/**
+ * Unregisters the viewer whose socket was closed
+ */
+void QCCTV_Relay::onDisconnected()
+{
+    QTcpSocket* socket = qobject_cast<QTcpSocket*> (sender());
+    foreach (Feed* feed, m_feeds) {
+        for (int i = 0; i < feed->viewers.count(); ++i) {
+            Viewer* viewer = feed->viewers.at (i);
+            if (viewer->socket == socket) {
+                viewer->session->deleteLater();
+                viewer->socket->deleteLater();
+                feed->viewers.removeAt (i);
+                delete viewer;
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Negotiates the protocol configuration with a viewer. Viewers that do not
+ * understand the frame formats of the camera are disconnected
+ */
+void QCCTV_Relay::onSessionHello (const QByteArray& data)
+{
+    Viewer* viewer = Q_NULLPTR;
+    Feed* feed = findViewer (sender(), &viewer);
+    if (!feed)
+        return;
+
+    /* Get the best configuration supported by both sides */
+    QCCTV_HelloPacket local;
+    QCCTV_HelloPacket remote;
+    QCCTV_HelloPacket config;
+    QCCTV_InitHello (&local);
+    local.capabilities = RELAY_CAPABILITIES;
+    if (!QCCTV_ReadHelloPacket (&remote, data) ||
+        !QCCTV_NegotiateHello (&config, &local, &remote) ||
+        (config.capabilities & REQUIRED_CAPABILITIES) != REQUIRED_CAPABILITIES) {
+        viewer->socket->abort();
+        return;
+    }
+
+    /* Apply the configuration */
+    viewer->ready = true;
+    viewer->session->setMaxFrameSize (config.maxFrameSize);
+    viewer->session->sendHello (QCCTV_CreateHelloPacket (&config));
+
+    /* Viewer does not grant credits, push frames to it */
+    if (!(config.capabilities & QCCTV_CAP_CREDITS))
+        viewer->granted = -1;
+
+    /* Send the camera information, the viewer waits for a keyframe */
+    if (!feed->info.isEmpty())
+        viewer->session->sendInfo (feed->info);
+
+    sendFrame (feed, viewer);
+}
+
+/**
+ * Reads the command packet of a viewer, we only use its credits and its
+ * keyframe and info requests
+ */
+void QCCTV_Relay::onSessionCommand (const QByteArray& data)
+{
+    Viewer* viewer = Q_NULLPTR;
+    Feed* feed = findViewer (sender(), &viewer);
+    if (!feed || !viewer->ready)
+        return;
+
+    /* Read the command packet */
+    QCCTV_InfoPacket info;
+    QCCTV_CommandPacket command;
+    QCCTV_InitInfo (&info);
+    QCCTV_InitCommand (&command, &info);
+    if (!QCCTV_ReadCommandPacket (&command, &viewer->state, data))
+        return;
+
+    /* Viewer missed an info packet */
+    if (command.infoRequest && !feed->info.isEmpty())
+        viewer->session->sendInfo (feed->info);
+
+    /* Viewer cannot decode the stream */
+    if (command.keyframeRequest)
+        viewer->resync = true;
+
+    /* Update the credits and send the newest frame if we can */
+    if (viewer->granted >= 0 && command.credits >= 0)
+        viewer->granted = command.credits;
+
+    sendFrame (feed, viewer);
+}
+
+/**
+ * Returns the feed of the given \a camera
+ */
+QCCTV_Relay::Feed* QCCTV_Relay::findFeed (QObject* camera) const
+{
+    foreach (Feed* feed, m_feeds)
+        if (feed->camera == camera)
+            return feed;
+
+    return Q_NULLPTR;
+}
+
+/**
+ * Returns the feed watched by the viewer with the given \a session and
+ * writes the viewer to the given \a viewer pointer
+ */
+QCCTV_Relay::Feed* QCCTV_Relay::findViewer (QObject* session,
+                                            Viewer** viewer) const
+{
+    foreach (Feed* feed, m_feeds) {
+        foreach (Viewer* v, feed->viewers) {
+            if (v->session == session) {
+                *viewer = v;
+                return feed;
+            }
+        }
+    }
+
+    return Q_NULLPTR;
+}
+
+/**
+ * Starts the session server of the given \a feed on the first free relay
+ * port
+ */
+void QCCTV_Relay::startServer (Feed* feed)
+{
+    if (feed->server)
+        return;
+
+    feed->server = new QTcpServer (this);
+    connect (feed->server, SIGNAL (newConnection()),
+             this,           SLOT (acceptViewers()));
+
+    for (int i = 0; i < QCCTV_MAX_RELAYED_CAMERAS; ++i)
+        if (feed->server->listen (QHostAddress::Any, QCCTV_RELAY_PORT + i))
+            return;
+}
+
+/**
+ * Stops the session server of the given \a feed and disconnects its viewers
+ */
+void QCCTV_Relay::stopServer (Feed* feed)
+{
+    foreach (Viewer* viewer, feed->viewers) {
+        viewer->socket->disconnect (this);
+        viewer->socket->abort();
+        viewer->session->deleteLater();
+        viewer->socket->deleteLater();
+        delete viewer;
+    }
+
+    feed->viewers.clear();
+
+    if (feed->server) {
+        feed->server->close();
+        feed->server->deleteLater();
+        feed->server = Q_NULLPTR;
+    }
+}
+
+/**
+ * Asks the camera of the given \a feed for a keyframe, unless we are
+ * already waiting for one
+ */
+void QCCTV_Relay::requestKeyframe (Feed* feed)
+{
+    if (!feed->keyframeRequested) {
+        feed->keyframeRequested = true;
+        QMetaObject::invokeMethod (feed->camera, "requestKeyframe",
+                                   Qt::QueuedConnection);
+    }
+}
+
+/**
+ * Sends the newest frame of the given \a feed to the given \a viewer.
+ *
+ * Each frame is only sent once, and only while the viewer has credit left
+ * and its session already started sending the previous frame. If a viewer
+ * misses a frame, it only receives frames again after the next keyframe
+ * that carries its JPEG tables (delta frames and abbreviated JPEG data
+ * depend on the previous frames)
+ */
+void QCCTV_Relay::sendFrame (Feed* feed, Viewer* viewer)
+{
+    /* Nothing to send or the frame was already sent */
+    if (!viewer->ready || feed->image.isEmpty() ||
+        viewer->frame == feed->frameId)
+        return;
+
+    /* Frame is too large for the viewer */
+    if (feed->image.size() > viewer->session->maxFrameSize())
+        return;
+
+    /* Viewer cannot receive the frame */
+    if (viewer->session->imagePending() ||
+        (viewer->granted >= 0 && viewer->sent >= viewer->granted))
+        return;
+
+    /* Viewer missed a frame, wait for a self-contained frame */
+    if (viewer->frame + 1 != feed->frameId)
+        viewer->resync = true;
+    if (viewer->resync && !feed->selfContained) {
+        requestKeyframe (feed);
+        return;
+    }
+
+    /* Send the frame */
+    viewer->sent++;
+    viewer->resync = false;
+    viewer->frame = feed->frameId;
+    viewer->session->sendImage (feed->image, feed->selfContained);
+}
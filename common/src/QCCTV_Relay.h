@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_RELAY_H
+#define _QCCTV_RELAY_H
+
+#include <QList>
+#include <QObject>
+#include <QUdpSocket>
+#include <QByteArray>
+#include <QHostAddress>
+
+#include "QCCTV_Communications.h"
+
+class QTcpServer;
+class QTcpSocket;
+class QCCTV_Session;
+
+/**
+ * \brief Re-publishes the streams received by a station to other stations.
+ *
+ * Each relayed camera gets its own session server (see \c QCCTV_RELAY_PORT),
+ * which is announced to the local network like a normal camera, along with
+ * the address of the camera (so that stations do not connect to the same
+ * camera directly and through the relay). The frames
+ * are forwarded exactly as we received them, so the camera only sends its
+ * stream once, regardless of the number of viewers.
+ *
+ * Flow control is done by the relay: viewers only receive a frame when they
+ * have credit left and their session is not still waiting to send the
+ * previous frame. A viewer that misses a frame waits for the next keyframe
+ * that carries its JPEG tables, which we request from the camera (once per
+ * keyframe).
+ *
+ * Viewers cannot control the relayed cameras, we only read their credits,
+ * keyframe requests and info requests.
+ */
+class QCCTV_Relay : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QCCTV_Relay (QObject* parent = Q_NULLPTR);
+    ~QCCTV_Relay();
+
+    bool isEnabled() const;
+    int viewerCount() const;
+
+public Q_SLOTS:
+    void setEnabled (const bool enabled);
+    void addCamera (QObject* camera, const QHostAddress& address);
+    void removeCamera (QObject* camera);
+    void publishInfo (const QByteArray& data);
+    void publishImage (const QByteArray& data, const bool selfContained);
+
+private Q_SLOTS:
+    void announce();
+    void acceptViewers();
+    void onDisconnected();
+    void onSessionHello (const QByteArray& data);
+    void onSessionCommand (const QByteArray& data);
+
+private:
+    struct Viewer {
+        QTcpSocket* socket;
+        QCCTV_Session* session;
+        QCCTV_PacketState state;
+        bool ready;
+        bool resync;
+        int granted;
+        int sent;
+        int frame;
+    };
+
+    struct Feed {
+        QObject* camera;
+        QHostAddress address;
+        QTcpServer* server;
+        QByteArray info;
+        QByteArray image;
+        bool selfContained;
+        bool keyframeRequested;
+        int frameId;
+        QList<Viewer*> viewers;
+    };
+
+    Feed* findFeed (QObject* camera) const;
+    Feed* findViewer (QObject* session, Viewer** viewer) const;
+
+    void startServer (Feed* feed);
+    void stopServer (Feed* feed);
+    void requestKeyframe (Feed* feed);
+    void sendFrame (Feed* feed, Viewer* viewer);
+
+private:
+    bool m_enabled;
+    QList<Feed*> m_feeds;
+    QUdpSocket m_broadcastSocket;
+};
+
+#endif
@@ -1,644 +1,1627 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#include <QDir>
-#include <QSysInfo>
-#include <QtConcurrent/QtConcurrent>
-
-#include "QCCTV.h"
-#include "QCCTV_Watchdog.h"
-#include "QCCTV_ImageSaver.h"
-#include "QCCTV_RemoteCamera.h"
-#include "QCCTV_Communications.h"
-
-static const QString hostName()
-{
-    QString host = QSysInfo::machineHostName();
-    if (host.isEmpty())
-        host = QSysInfo::prettyProductName();
-    else
-        host += " (" + QSysInfo::prettyProductName() + ")";
-
-    return host;
-}
-
-QCCTV_RemoteCamera::QCCTV_RemoteCamera (QObject* parent) : QObject (parent)
-{
-    m_id = 0;
-    m_connected = false;
-    m_saveIncomingMedia = false;
-    m_saver = new QCCTV_ImageSaver (this);
-    m_infoPacket = new QCCTV_InfoPacket;
-    m_imagePacket = new QCCTV_ImagePacket;
-    m_commandPacket = new QCCTV_CommandPacket;
-
-    setIncomingMediaPath ("");
-    QCCTV_InitInfo (infoPacket());
-    QCCTV_InitImage (imagePacket());
-    QCCTV_InitCommand (commandPacket(), infoPacket());
-
-    commandPacket()->host = hostName();
-}
-
-/**
- * Close the TCP sockets during the destruction of the class
- */
-QCCTV_RemoteCamera::~QCCTV_RemoteCamera()
-{
-    if (m_socket) {
-        m_socket->close();
-        delete m_socket;
-    }
-
-    if (m_commandSocket) {
-        m_commandSocket->close();
-        delete m_commandSocket;
-    }
-
-    if (m_watchdog)
-        delete m_watchdog;
-
-    delete m_saver;
-    delete m_infoPacket;
-    delete m_imagePacket;
-    delete m_commandPacket;
-}
-
-/**
- * Returns the FPS set by the station or by the camera itself
- */
-int QCCTV_RemoteCamera::fps()
-{
-    return infoPacket()->fps;
-}
-
-/**
- * Returns the current zoom level of the camera
- */
-int QCCTV_RemoteCamera::zoom()
-{
-    return infoPacket()->zoom;
-}
-
-/**
- * Returns the operation status reported by the camera
- */
-int QCCTV_RemoteCamera::status()
-{
-    return infoPacket()->cameraStatus;
-}
-
-/**
- * Returns the latest image captured by the camera
- */
-QImage QCCTV_RemoteCamera::image()
-{
-    return imagePacket()->image;
-}
-
-/**
- * Returns the name of the camera
- */
-QString QCCTV_RemoteCamera::name()
-{
-    return infoPacket()->cameraName;
-}
-
-/**
- * Returns the group assigned to the camera
- */
-QString QCCTV_RemoteCamera::group()
-{
-    return infoPacket()->cameraGroup;
-}
-
-/**
- * Returns the current resolution used by the camera
- */
-int QCCTV_RemoteCamera::resolution()
-{
-    return infoPacket()->resolution;
-}
-
-/**
- * Returns \c true if the remote camera supports zooming
- */
-bool QCCTV_RemoteCamera::supportsZoom()
-{
-    return infoPacket()->supportsZoom;
-}
-
-/**
- * Returns the camera status flags as a string
- */
-QString QCCTV_RemoteCamera::statusString()
-{
-    return QCCTV_GetStatusString (status());
-}
-
-/**
- * Returns \c true if the flashlight of the camera is turned on
- */
-bool QCCTV_RemoteCamera::flashlightEnabled()
-{
-    return infoPacket()->flashlightEnabled;
-}
-
-/**
- * Returns \c true if the camera is allowed to autoregulate its resolution
- */
-bool QCCTV_RemoteCamera::autoRegulateResolution()
-{
-    return infoPacket()->autoRegulateResolution;
-}
-
-/**
- * Returns the camera ID set by the station
- */
-int QCCTV_RemoteCamera::id() const
-{
-    return m_id;
-}
-
-/**
- * Returns \c true if the station has an active connection
- * with a QCCTV camera
- */
-bool QCCTV_RemoteCamera::isConnected() const
-{
-    return m_connected;
-}
-
-/**
- * Returns the network address of the camera
- */
-QHostAddress QCCTV_RemoteCamera::address() const
-{
-    return m_address;
-}
-
-/**
- * Returns \c true if the class shall save to the disk the received images
- */
-bool QCCTV_RemoteCamera::saveIncomingMedia() const
-{
-    return m_saveIncomingMedia;
-}
-
-/**
- * Returns the folder path in which the incoming media is saved
- */
-QString QCCTV_RemoteCamera::incomingMediaPath() const
-{
-    return m_incomingMediaPath;
-}
-
-/**
- * Initializes the watchdog timers after the thread has been created
- */
-void QCCTV_RemoteCamera::start()
-{
-    /* Initialize the watchdog */
-    m_watchdog = new QCCTV_Watchdog (this);
-    m_watchdog->setExpirationTime (QCCTV_MIN_WATCHDOG_TIME);
-    connect (m_watchdog, SIGNAL (expired()),
-             this,         SLOT (clearBuffer()));
-
-    /* Initialize sockets */
-    m_socket = new QTcpSocket (this);
-    m_commandSocket = new QUdpSocket (this);
-
-    /* Configure signals/slots */
-    connect (m_socket,     SIGNAL (readyRead()),
-             this,           SLOT (onImageDataReceived()));
-    connect (m_socket,     SIGNAL (disconnected()),
-             this,           SLOT (endConnection()));
-
-    /* Connect to camera */
-    m_socket->connectToHost (m_address, QCCTV_STREAM_PORT);
-    m_socket->setSocketOption (QTcpSocket::LowDelayOption, 1);
-    m_socket->setSocketOption (QTcpSocket::KeepAliveOption, 1);
-}
-
-/**
- * Instructs the class to generate a packet that requests the camera to perform
- * a forced focus.
- *
- * The focus byte will be reset after sending some packets to the camera
- */
-void QCCTV_RemoteCamera::requestFocus()
-{
-    m_commandPacket->focusRequest = true;
-    QTimer::singleShot (500, this, SLOT (resetFocusRequest()));
-}
-
-/**
- * Changes the ID of the camera
- */
-void QCCTV_RemoteCamera::changeID (const int id)
-{
-    m_id = id;
-}
-
-/**
- * Updates the FPS value reported (or assigned) by the camera
- */
-void QCCTV_RemoteCamera::changeFPS (const int fps)
-{
-    int validFps = QCCTV_ValidFps (fps);
-    commandPacket()->newFps = validFps;
-
-    if (m_watchdog)
-        m_watchdog->setExpirationTime (QCCTV_GetWatchdogTime (validFps));
-}
-
-/**
- * Updates the zoom level used by the remote camera
- */
-void QCCTV_RemoteCamera::changeZoom (const int zoom)
-{
-    commandPacket()->newZoom = qMin (qMax (zoom, 0), 100);
-}
-
-/**
- * Allows or disallows saving the incoming images to the disk
- */
-void QCCTV_RemoteCamera::setSaveIncomingMedia (const bool save)
-{
-    m_saveIncomingMedia = save;
-}
-
-/**
- * Reads and interprets an information packet coming from the camera
- */
-void QCCTV_RemoteCamera::readInfoPacket (const QByteArray& data)
-{
-    QCCTV_InfoPacket packet;
-    if (QCCTV_ReadInfoPacket (&packet, data)) {
-        updateFPS (packet.fps);
-        updateZoom (packet.zoom);
-        updateName (packet.cameraName);
-        updateGroup (packet.cameraGroup);
-        updateStatus (packet.cameraStatus);
-        updateResolution (packet.resolution);
-        updateZoomSupport (packet.supportsZoom);
-        updateAutoRegulate (packet.autoRegulateResolution);
-        updateFlashlightEnabled (packet.flashlightEnabled);
-        acknowledgeReception();
-    }
-}
-
-/**
- * Changes the resoltion of the camera
- */
-void QCCTV_RemoteCamera::changeResolution (const int resolution)
-{
-    commandPacket()->newResolution = resolution;
-}
-
-/**
- * Changes the camera's remote address, this can be done only
- * once during the instance's runtime
- */
-void QCCTV_RemoteCamera::setAddress (const QHostAddress& address)
-{
-    if (!m_address.isNull() || address.isNull())
-        return;
-
-    m_address = address;
-}
-
-/**
- * Allows or disallows the camera from autoregulating its resolution
- */
-void QCCTV_RemoteCamera::changeAutoRegulate (const bool regulate)
-{
-    commandPacket()->newAutoRegulateResolution = regulate;
-}
-
-/**
- * Changes the flashlight status of the camera and emits the appropiate signals
- */
-void QCCTV_RemoteCamera::changeFlashlightStatus (const int status)
-{
-    commandPacket()->newFlashlightEnabled = status;
-}
-
-/**
- * Changes the path in which we should save incoming images
- */
-void QCCTV_RemoteCamera::setIncomingMediaPath (const QString& path)
-{
-    if (!path.isEmpty())
-        m_incomingMediaPath = path;
-    else
-        m_incomingMediaPath = QDir::homePath() + "/QCCTV/QCCTV_Media/";
-}
-
-/**
- * Called when we stop receiving constant packets from the camera, this
- * function deletes the temporary data buffer to avoid storing too much
- * information that we cannot use directly.
- *
- * Also, this function is called when the class successfully reads a stream
- * packet from the remote camera.
- */
-void QCCTV_RemoteCamera::clearBuffer()
-{
-    m_data.clear();
-}
-
-/**
- * Called when the TCP connection with the camera is closed. This function
- * clears the temporary buffers and notifies the station that the
- * connection with the camera has ended, which is sort like commiting suicide
- * for this class...
- */
-void QCCTV_RemoteCamera::endConnection()
-{
-    if (m_socket)
-        m_socket->abort();
-
-    clearBuffer();
-    updateConnected (false);
-    emit disconnected (id());
-}
-
-/**
- * Disables the focus flag. This function is called after 3 command packets
- * instructing the camera to re-focus itself have been sent.
- */
-void QCCTV_RemoteCamera::resetFocusRequest()
-{
-    commandPacket()->focusRequest = false;
-}
-
-/**
- * Obtains the information received by the TCP socket and calls the functions
- * neccessary to interpret the received data
- */
-void QCCTV_RemoteCamera::onImageDataReceived()
-{
-    if (!m_socket) {
-        clearBuffer();
-        return;
-    }
-
-    else {
-        m_data.append (m_socket->readAll());
-
-        if (!m_data.isEmpty())
-            readImagePacket();
-
-        if (m_data.size() >= QCCTV_MAX_BUFFER_SIZE)
-            clearBuffer();
-    }
-}
-
-
-/**
- * Sends a command packet to the camera, which instructs it to:
- *
- * - Change its FPS
- * - Change its light status
- * - Focus the camera device (if required)
- */
-void QCCTV_RemoteCamera::sendCommandPacket()
-{
-    QByteArray data = QCCTV_CreateCommandPacket (commandPacket());
-
-    if (m_commandSocket)
-        m_commandSocket->writeDatagram (data, address(), QCCTV_COMMAND_PORT);
-}
-
-/**
- * Updates the \a fps reported by the camera
- */
-void QCCTV_RemoteCamera::updateFPS (const int fps)
-{
-    if (infoPacket()->fps != fps) {
-        infoPacket()->fps = fps;
-        commandPacket()->oldFps = fps;
-        commandPacket()->newFps = fps;
-        emit fpsChanged (id());
-    }
-}
-
-/**
- * Updates the zoom level of the camera and emits the appropiate signals
- */
-void QCCTV_RemoteCamera::updateZoom (const int zoom)
-{
-    if (infoPacket()->zoom != zoom) {
-        infoPacket()->zoom = zoom;
-        commandPacket()->oldZoom = zoom;
-        commandPacket()->newZoom = zoom;
-        emit zoomLevelChanged (id());
-    }
-}
-
-/**
- * Updates the operation status of the camera and emits the appropiate signals
- */
-void QCCTV_RemoteCamera::updateStatus (const int status)
-{
-    if (infoPacket()->cameraStatus != status) {
-        infoPacket()->cameraStatus = status;
-        emit newCameraStatus (id());
-    }
-}
-
-/**
- * Updates the \a name reported by the camera
- */
-void QCCTV_RemoteCamera::updateName (const QString& name)
-{
-    if (infoPacket()->cameraName != name) {
-        infoPacket()->cameraName = name;
-        if (infoPacket()->cameraName.isEmpty())
-            infoPacket()->cameraName = "Unknown Camera";
-
-        emit newCameraName (id());
-    }
-}
-
-/**
- * Updates the \a group reported by the camera
- */
-void QCCTV_RemoteCamera::updateGroup (const QString& group)
-{
-    if (infoPacket()->cameraGroup != group) {
-        infoPacket()->cameraGroup = group;
-        if (infoPacket()->cameraGroup.isEmpty())
-            infoPacket()->cameraGroup = "Default";
-
-        emit newCameraGroup();
-    }
-}
-
-/**
- * Updates the connection status of the camera and emits the appropiate signals
- */
-void QCCTV_RemoteCamera::updateConnected (const bool status)
-{
-    m_connected = status;
-
-    if (m_connected) {
-        emit connected (id());
-        emit fpsChanged (id());
-        emit resolutionChanged (id());
-        emit autoRegulateResolutionChanged (id());
-    }
-}
-
-/**
- * Changes the zoom support status of the camera and emits the appropiate signals
- */
-void QCCTV_RemoteCamera::updateZoomSupport (const bool support)
-{
-    if (infoPacket()->supportsZoom != support) {
-        infoPacket()->supportsZoom = support;
-        emit zoomSupportChanged (id());
-    }
-}
-
-/**
- * Updates the image resolution status of the camera
- */
-void QCCTV_RemoteCamera::updateResolution (const int resolution)
-{
-    if (infoPacket()->resolution != resolution) {
-        infoPacket()->resolution = resolution;
-        commandPacket()->oldResolution = resolution;
-        commandPacket()->newResolution = resolution;
-        emit resolutionChanged (id());
-    }
-}
-
-/**
- * Updates the auto-regulate status flag of the camera
- */
-void QCCTV_RemoteCamera::updateAutoRegulate (const bool regulate)
-{
-    if (infoPacket()->autoRegulateResolution != regulate) {
-        infoPacket()->autoRegulateResolution = regulate;
-        commandPacket()->oldAutoRegulateResolution = regulate;
-        commandPacket()->newAutoRegulateResolution = regulate;
-        emit autoRegulateResolutionChanged (id());
-    }
-}
-
-/**
- * Updates the flashlight status flag of the camera
- */
-void QCCTV_RemoteCamera::updateFlashlightEnabled (const bool enabled)
-{
-    if (infoPacket()->flashlightEnabled != enabled) {
-        infoPacket()->flashlightEnabled = enabled;
-        commandPacket()->oldFlashlightEnabled = enabled;
-        commandPacket()->newFlashlightEnabled = enabled;
-        emit lightStatusChanged (id());
-    }
-}
-
-/**
- * Called when we receive a datagram from the camera, this function
- * obtains the latest image from the camera
- */
-void QCCTV_RemoteCamera::readImagePacket()
-{
-    QCCTV_ImagePacket packet;
-    if (QCCTV_ReadImagePacket (&packet, m_data)) {
-        /* Clear buffer and send another command packet */
-        clearBuffer();
-        acknowledgeReception();
-
-        /* Re-assign image */
-        imagePacket()->image = packet.image;
-        emit newImage (id());
-
-        /* Reset the watchdog */
-        if (m_watchdog)
-            m_watchdog->reset();
-
-        /* Save image to disk */
-        if (saveIncomingMedia()) {
-            QtConcurrent::run (m_saver, &QCCTV_ImageSaver::saveImage,
-                               incomingMediaPath(),
-                               name(),
-                               address().toString(),
-                               image());
-        }
-    }
-}
-
-/**
- * Resets the watchdog and sends a command packet to the camera, which allows
- * it to know if we are doing OK.
- *
- * If the camera does not receive a command packet after some time, it will
- * try to reduce its image size automatically
- */
-void QCCTV_RemoteCamera::acknowledgeReception()
-{
-    sendCommandPacket();
-
-    if (!isConnected())
-        updateConnected (true);
-}
-
-/**
- * Returns the pointer to the stream packet structure
- */
-QCCTV_InfoPacket* QCCTV_RemoteCamera::infoPacket()
-{
-    if (m_infoPacket)
-        return m_infoPacket;
-
-    m_infoPacket = new QCCTV_InfoPacket;
-    return m_infoPacket;
-}
-
-/**
- * Returns the pointer to the image packet structure
- */
-QCCTV_ImagePacket* QCCTV_RemoteCamera::imagePacket()
-{
-    if (m_imagePacket)
-        return m_imagePacket;
-
-    m_imagePacket = new QCCTV_ImagePacket;
-    return m_imagePacket;
-}
-
-/**
- * Returns the pointer to the stream command structure
- */
-QCCTV_CommandPacket* QCCTV_RemoteCamera::commandPacket()
-{
-    if (m_commandPacket)
-        return m_commandPacket;
-
-    m_commandPacket = new QCCTV_CommandPacket;
-    return m_commandPacket;
-}
-
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include <QDir>
+#include <QTimer>
+#include <QSysInfo>
+#include <QtConcurrent/QtConcurrent>
+
+#include "QCCTV.h"
+#include "QCCTV_Session.h"
+#include "QCCTV_Watchdog.h"
+#include "QCCTV_ImageSaver.h"
+#include "QCCTV_RemoteCamera.h"
+#include "QCCTV_Communications.h"
+#include "QCCTV_MotionAnalyzer.h"
+#include "QCCTV_SharedFrames.h"
+#include "QCCTV_DatagramStream.h"
+
+static const QString hostName()
+{
+    QString host = QSysInfo::machineHostName();
+    if (host.isEmpty())
+        host = QSysInfo::prettyProductName();
+    else
+        host += " (" + QSysInfo::prettyProductName() + ")";
+
+    return host;
+}
+
+QCCTV_RemoteCamera::QCCTV_RemoteCamera (QObject* parent) : QObject (parent)
+{
+    m_id = 0;
+    m_connected = false;
+    m_relay = false;
+    m_port = QCCTV_SESSION_PORT;
+    m_snapshotPending = false;
+    m_snapshotTimer = Q_NULLPTR;
+    m_saveIncomingMedia = false;
+    m_legacyStream = false;
+    m_session = Q_NULLPTR;
+    m_displayQueue = 0;
+    m_framesReceived = 0;
+    m_udpTransport = false;
+    m_udpStream = Q_NULLPTR;
+    m_multicast = false;
+    m_multicastStream = Q_NULLPTR;
+    m_sharedFrames = Q_NULLPTR;
+    m_recordOnMotionOnly = false;
+    m_saver = new QCCTV_ImageSaver (this);
+    m_analyzer = new QCCTV_MotionAnalyzer (this);
+    m_infoPacket = new QCCTV_InfoPacket;
+    m_imagePacket = new QCCTV_ImagePacket;
+    m_commandPacket = new QCCTV_CommandPacket;
+
+    setIncomingMediaPath ("");
+    QCCTV_InitInfo (infoPacket());
+    QCCTV_InitImage (imagePacket());
+    QCCTV_InitCommand (commandPacket(), infoPacket());
+    QCCTV_InitState (&m_infoState);
+    QCCTV_InitState (&m_commandState);
+    QCCTV_InitLegacyHello (&m_hello);
+
+    commandPacket()->host = hostName();
+
+    connect (m_analyzer, SIGNAL (motionDetectedChanged()),
+             this,         SLOT (onMotionAnalyzed()));
+}
+
+/**
+ * Close the TCP sockets during the destruction of the class
+ */
+QCCTV_RemoteCamera::~QCCTV_RemoteCamera()
+{
+    if (m_socket) {
+        m_socket->close();
+        delete m_socket;
+    }
+
+    if (m_commandSocket) {
+        m_commandSocket->close();
+        delete m_commandSocket;
+    }
+
+    if (m_watchdog)
+        delete m_watchdog;
+
+    delete m_saver;
+    delete m_sharedFrames;
+    delete m_infoPacket;
+    delete m_imagePacket;
+    delete m_commandPacket;
+}
+
+/**
+ * Returns the FPS set by the station or by the camera itself. If the camera
+ * sends the images at the rate requested by this station, that rate is
+ * returned instead of the FPS of the camera
+ */
+int QCCTV_RemoteCamera::fps()
+{
+    bool requested = m_session &&
+                     (m_hello.capabilities & QCCTV_CAP_STATION_FPS);
+    if (requested && commandPacket()->requestedFps > 0)
+        return commandPacket()->requestedFps;
+
+    return infoPacket()->fps;
+}
+
+/**
+ * Returns the lowest FPS that we can ask for, cameras that send the images
+ * at the rate requested by this station allow slower rates
+ */
+int QCCTV_RemoteCamera::minimumFps()
+{
+    if (m_session && (m_hello.capabilities & QCCTV_CAP_STATION_FPS))
+        return QCCTV_MIN_STATION_FPS;
+
+    return QCCTV_MIN_FPS;
+}
+
+/**
+ * Returns the highest FPS allowed by the camera (it is only above
+ * \c QCCTV_MAX_FPS if the camera is in high frame rate mode)
+ */
+int QCCTV_RemoteCamera::maximumFps()
+{
+    return infoPacket()->maxFps;
+}
+
+/**
+ * Returns the current zoom level of the camera
+ */
+int QCCTV_RemoteCamera::zoom()
+{
+    return infoPacket()->zoom;
+}
+
+/**
+ * Returns the operation status reported by the camera
+ */
+int QCCTV_RemoteCamera::status()
+{
+    return infoPacket()->cameraStatus;
+}
+
+/**
+ * Returns the target bitrate (in kbit/s) of the camera's image stream
+ */
+int QCCTV_RemoteCamera::bitrate()
+{
+    return infoPacket()->bitrate;
+}
+
+/**
+ * Returns the JPEG quality chosen by the camera's rate control
+ */
+int QCCTV_RemoteCamera::quality()
+{
+    return infoPacket()->quality;
+}
+
+/**
+ * Returns the latest image captured by the camera
+ */
+QImage QCCTV_RemoteCamera::image()
+{
+    return imagePacket()->image;
+}
+
+/**
+ * Returns the last full-resolution snapshot received from the camera
+ */
+QImage QCCTV_RemoteCamera::snapshot()
+{
+    return m_snapshot;
+}
+
+/**
+ * Returns the crop rectangle (digital PTZ, in normalized coordinates) that
+ * this station requested, an empty rectangle means that the whole image is
+ * received
+ */
+QRectF QCCTV_RemoteCamera::crop()
+{
+    return commandPacket()->crop;
+}
+
+/**
+ * Returns the name of the camera
+ */
+QString QCCTV_RemoteCamera::name()
+{
+    return infoPacket()->cameraName;
+}
+
+/**
+ * Returns the group assigned to the camera
+ */
+QString QCCTV_RemoteCamera::group()
+{
+    return infoPacket()->cameraGroup;
+}
+
+/**
+ * Returns the current resolution used by the camera
+ */
+int QCCTV_RemoteCamera::resolution()
+{
+    return infoPacket()->resolution;
+}
+
+/**
+ * Returns the stream options (e.g. delta frames) used by the camera
+ */
+int QCCTV_RemoteCamera::streamFlags()
+{
+    return infoPacket()->streamFlags;
+}
+
+/**
+ * Returns \c true if the remote camera supports zooming
+ */
+bool QCCTV_RemoteCamera::supportsZoom()
+{
+    return infoPacket()->supportsZoom;
+}
+
+/**
+ * Returns the region of interest (in normalized coordinates) of the camera,
+ * an empty rectangle means that the whole image is sent
+ */
+QRectF QCCTV_RemoteCamera::regionOfInterest()
+{
+    return infoPacket()->regionOfInterest;
+}
+
+/**
+ * Returns the camera status flags as a string
+ */
+QString QCCTV_RemoteCamera::statusString()
+{
+    return QCCTV_GetStatusString (status());
+}
+
+/**
+ * Returns \c true if the camera is sending luma-only (grayscale) images
+ */
+bool QCCTV_RemoteCamera::grayscale()
+{
+    return infoPacket()->grayscale;
+}
+
+/**
+ * Returns \c true if the camera (or the station-side analyzer, for cameras
+ * that do not detect motion themselves) reports motion in the scene
+ */
+bool QCCTV_RemoteCamera::motionDetected()
+{
+    if (infoPacket()->motionDetectionEnabled)
+        return infoPacket()->motionDetected;
+
+    return m_analyzer->motionDetected();
+}
+
+/**
+ * Returns \c true if the flashlight of the camera is turned on
+ */
+bool QCCTV_RemoteCamera::flashlightEnabled()
+{
+    return infoPacket()->flashlightEnabled;
+}
+
+/**
+ * Returns \c true if the camera is allowed to autoregulate its resolution
+ */
+bool QCCTV_RemoteCamera::autoRegulateResolution()
+{
+    return infoPacket()->autoRegulateResolution;
+}
+
+/**
+ * Returns the camera ID set by the station
+ */
+int QCCTV_RemoteCamera::id() const
+{
+    return m_id;
+}
+
+/**
+ * Returns \c true if the station has an active connection
+ * with a QCCTV camera
+ */
+bool QCCTV_RemoteCamera::isConnected() const
+{
+    return m_connected;
+}
+
+/**
+ * Returns the network address of the camera
+ */
+QHostAddress QCCTV_RemoteCamera::address() const
+{
+    return m_address;
+}
+
+/**
+ * Returns the port of the session server of the camera, which is only
+ * different from the default port for cameras served by a relay
+ */
+quint16 QCCTV_RemoteCamera::port() const
+{
+    return m_port;
+}
+
+/**
+ * Returns \c true if the class shall save to the disk the received images
+ */
+bool QCCTV_RemoteCamera::saveIncomingMedia() const
+{
+    return m_saveIncomingMedia;
+}
+
+/**
+ * Returns \c true if the camera shall send us its images through UDP
+ * datagrams instead of the TCP connection
+ */
+bool QCCTV_RemoteCamera::udpTransportEnabled() const
+{
+    return m_udpTransport;
+}
+
+/**
+ * Returns \c true if we shall receive the shared image stream of the camera
+ * through its multicast group
+ */
+bool QCCTV_RemoteCamera::multicastEnabled() const
+{
+    return m_multicast;
+}
+
+/**
+ * Returns \c true if the received frames are forwarded to the relay of the
+ * station
+ */
+bool QCCTV_RemoteCamera::relayEnabled() const
+{
+    return m_relay;
+}
+
+/**
+ * Returns \c true if incoming images shall only be saved while there is
+ * motion in the scene
+ */
+bool QCCTV_RemoteCamera::recordOnMotionOnly() const
+{
+    return m_recordOnMotionOnly;
+}
+
+/**
+ * Returns the path of the file in which the last snapshot was saved
+ */
+QString QCCTV_RemoteCamera::snapshotFile() const
+{
+    return m_snapshotFile;
+}
+
+/**
+ * Returns the folder path in which the incoming media is saved
+ */
+QString QCCTV_RemoteCamera::incomingMediaPath() const
+{
+    return m_incomingMediaPath;
+}
+
+/**
+ * Returns \c true if the station analyzes the received images to detect
+ * motion (for cameras that do not detect motion themselves)
+ */
+bool QCCTV_RemoteCamera::motionAnalysisEnabled() const
+{
+    return m_analyzer->isEnabled();
+}
+
+/**
+ * Initializes the watchdog timers after the thread has been created
+ */
+void QCCTV_RemoteCamera::start()
+{
+    /* Initialize the watchdog */
+    m_watchdog = new QCCTV_Watchdog (this);
+    m_watchdog->setExpirationTime (QCCTV_MIN_WATCHDOG_TIME);
+    connect (m_watchdog, SIGNAL (expired()),
+             this,         SLOT (discardBuffer()));
+
+    /* Stop waiting for snapshots that the camera does not send */
+    m_snapshotTimer = new QTimer (this);
+    m_snapshotTimer->setSingleShot (true);
+    m_snapshotTimer->setInterval (QCCTV_SNAPSHOT_TIMEOUT);
+    connect (m_snapshotTimer, SIGNAL (timeout()),
+             this,              SLOT (resetSnapshotRequest()));
+
+    /* Initialize sockets */
+    m_socket = new QTcpSocket (this);
+    m_commandSocket = new QUdpSocket (this);
+
+    /* Configure signals/slots */
+    connect (m_socket,     SIGNAL (connected()),
+             this,           SLOT (onSocketConnected()));
+    connect (m_socket,     SIGNAL (disconnected()),
+             this,           SLOT (endConnection()));
+    connect (m_socket,     SIGNAL (error (QAbstractSocket::SocketError)),
+             this,           SLOT (useLegacyStream()));
+
+    /* Try to open a multiplexed session with the camera */
+    m_socket->connectToHost (m_address, m_port);
+    m_socket->setSocketOption (QTcpSocket::LowDelayOption, 1);
+    m_socket->setSocketOption (QTcpSocket::KeepAliveOption, 1);
+
+    /* Do not wait forever for cameras that drop the connection request */
+    QTimer::singleShot (QCCTV_MAX_WATCHDOG_TIME, this, SLOT (useLegacyStream()));
+}
+
+/**
+ * Instructs the class to generate a packet that requests the camera to perform
+ * a forced focus.
+ *
+ * The focus byte will be reset after sending some packets to the camera
+ */
+void QCCTV_RemoteCamera::requestFocus()
+{
+    m_commandPacket->focusRequest = true;
+    QTimer::singleShot (500, this, SLOT (resetFocusRequest()));
+}
+
+/**
+ * Instructs the camera to send a full-resolution snapshot of its current
+ * image. Each request has its own number, which is repeated in every command
+ * packet, so that the camera knows when a new snapshot is requested.
+ *
+ * Snapshots are only sent through multiplexed sessions, the request is
+ * dropped if the snapshot does not arrive on time
+ */
+void QCCTV_RemoteCamera::requestSnapshot()
+{
+    if (m_session && m_snapshotTimer) {
+        m_snapshotPending = true;
+        m_snapshotTimer->start();
+    }
+
+    ++commandPacket()->snapshotRequest;
+    sendCommandPacket();
+}
+
+/**
+ * Instructs the camera to send a full frame. The request is repeated in every
+ * command packet until the station receives a keyframe
+ */
+void QCCTV_RemoteCamera::requestKeyframe()
+{
+    commandPacket()->keyframeRequest = true;
+}
+
+/**
+ * Called by the station when it displays the latest image of the camera,
+ * which allows the camera to send us more frames
+ */
+void QCCTV_RemoteCamera::imageDisplayed()
+{
+    m_displayQueue = 0;
+
+    if (m_session) {
+        grantCredits();
+        sendCommandPacket();
+    }
+}
+
+/**
+ * Changes the ID of the camera
+ */
+void QCCTV_RemoteCamera::changeID (const int id)
+{
+    m_id = id;
+}
+
+/**
+ * Updates the FPS value reported (or assigned) by the camera
+ */
+void QCCTV_RemoteCamera::changeFPS (const int fps)
+{
+    int validFps = QCCTV_ValidFps (fps, maximumFps(), minimumFps());
+
+    /* Ask for our own rate, the other stations keep theirs */
+    if (m_session && (m_hello.capabilities & QCCTV_CAP_STATION_FPS)) {
+        commandPacket()->requestedFps = validFps;
+        emit fpsChanged (id());
+    }
+
+    /* Change the FPS of the camera */
+    else
+        commandPacket()->newFps = validFps;
+
+    if (m_watchdog)
+        m_watchdog->setExpirationTime (QCCTV_GetWatchdogTime (validFps));
+}
+
+/**
+ * Updates the zoom level used by the remote camera
+ */
+void QCCTV_RemoteCamera::changeZoom (const int zoom)
+{
+    commandPacket()->newZoom = qMin (qMax (zoom, 0), 100);
+}
+
+/**
+ * Instructs the camera to send the given region (in normalized coordinates)
+ * of its full-resolution image to this station. Other stations are not
+ * affected, an empty rectangle receives the whole image again
+ */
+void QCCTV_RemoteCamera::changeCrop (const QRectF& crop)
+{
+    QRectF valid = QCCTV_ValidCrop (crop);
+    if (commandPacket()->crop != valid) {
+        commandPacket()->crop = valid;
+        updateSharedFrames();
+        updateUdpStream();
+        updateMulticastStream();
+        emit cropChanged (id());
+    }
+}
+
+/**
+ * Changes the target bitrate (in kbit/s) of the camera's image stream
+ */
+void QCCTV_RemoteCamera::changeBitrate (const int bitrate)
+{
+    commandPacket()->newBitrate = QCCTV_ValidBitrate (bitrate);
+}
+
+/**
+ * Sets or clears the given stream option \a flag (e.g. delta frames)
+ */
+void QCCTV_RemoteCamera::changeStreamFlag (const int flag, const bool enabled)
+{
+    if (enabled)
+        commandPacket()->newStreamFlags |= flag;
+    else
+        commandPacket()->newStreamFlags &= ~flag;
+}
+
+/**
+ * Allows or disallows saving the incoming images to the disk
+ */
+void QCCTV_RemoteCamera::setSaveIncomingMedia (const bool save)
+{
+    m_saveIncomingMedia = save;
+}
+
+/**
+ * Asks the camera to send us its images through UDP datagrams (which are
+ * dropped instead of stalling the stream on lossy networks), control
+ * packets and snapshots are still sent through the TCP connection
+ */
+void QCCTV_RemoteCamera::setUdpTransportEnabled (const bool enabled)
+{
+    m_udpTransport = enabled;
+    updateUdpStream();
+}
+
+/**
+ * Changes the number of UDP fragments protected by each parity fragment,
+ * zero disables the parity fragments
+ */
+void QCCTV_RemoteCamera::setUdpParityGroup (const int group)
+{
+    commandPacket()->udpParity = qBound (0, group, 255);
+}
+
+/**
+ * Asks the camera to send us its images through its multicast group, so
+ * that all the stations share a single stream. Lost frames are requested
+ * again through the TCP connection.
+ *
+ * Stations with a crop always receive their own stream
+ */
+void QCCTV_RemoteCamera::setMulticastEnabled (const bool enabled)
+{
+    m_multicast = enabled;
+    updateMulticastStream();
+}
+
+/**
+ * Allows or disallows saving incoming images while the scene is static
+ */
+void QCCTV_RemoteCamera::setRecordOnMotionOnly (const bool enabled)
+{
+    m_recordOnMotionOnly = enabled;
+}
+
+/**
+ * Reads and interprets an information packet coming from the camera
+ */
+void QCCTV_RemoteCamera::readInfoPacket (const QByteArray& data)
+{
+    QCCTV_InfoPacket packet;
+    bool success = QCCTV_ReadInfoPacket (&packet, &m_infoState, data);
+
+    /* Ask for a full packet if we missed an update */
+    commandPacket()->infoRequest = !m_infoState.synchronized;
+
+    /* Update the camera information */
+    if (success) {
+        updateMaximumFps (packet.maxFps);
+        updateFPS (packet.fps);
+        updateZoom (packet.zoom);
+        updateBitrate (packet.bitrate);
+        updateQuality (packet.quality);
+        updateName (packet.cameraName);
+        updateGroup (packet.cameraGroup);
+        updateMulticastGroup (packet.multicastGroup, packet.multicastPort);
+        updateSharedMemoryKey (packet.sharedMemoryKey);
+        updateStatus (packet.cameraStatus);
+        updateStreamFlags (packet.streamFlags);
+        updateGrayscale (packet.grayscale);
+        updateResolution (packet.resolution);
+        updateZoomSupport (packet.supportsZoom);
+        updateAutoRegulate (packet.autoRegulateResolution);
+        updateRegionOfInterest (packet.regionOfInterest);
+        updateFlashlightEnabled (packet.flashlightEnabled);
+        updateMotionDetection (packet.motionDetectionEnabled);
+        updateMotionDetected (packet.motionDetected);
+        acknowledgeReception();
+
+        if (m_relay)
+            publishInfo();
+    }
+}
+
+/**
+ * Changes the resoltion of the camera
+ */
+void QCCTV_RemoteCamera::changeResolution (const int resolution)
+{
+    commandPacket()->newResolution = resolution;
+}
+
+/**
+ * Changes the camera's remote address, this can be done only
+ * once during the instance's runtime
+ */
+void QCCTV_RemoteCamera::setAddress (const QHostAddress& address)
+{
+    if (!m_address.isNull() || address.isNull())
+        return;
+
+    m_address = address;
+}
+
+/**
+ * Changes the port of the session server of the camera, this must be done
+ * before the camera is started
+ */
+void QCCTV_RemoteCamera::setPort (const quint16 port)
+{
+    m_port = port;
+}
+
+/**
+ * If \a enabled is set to \c true, the info packets and the frames of the
+ * camera are forwarded (as received) through the \c relayedInfo() and
+ * \c relayedImage() signals
+ */
+void QCCTV_RemoteCamera::setRelayEnabled (const bool enabled)
+{
+    m_relay = enabled;
+    if (m_relay && isConnected()) {
+        publishInfo();
+        requestKeyframe();
+    }
+}
+
+/**
+ * Allows or disallows the camera from autoregulating its resolution
+ */
+void QCCTV_RemoteCamera::changeAutoRegulate (const bool regulate)
+{
+    commandPacket()->newAutoRegulateResolution = regulate;
+}
+
+/**
+ * Changes the region of interest (in normalized coordinates) of the camera,
+ * an empty rectangle instructs the camera to send the whole image
+ */
+void QCCTV_RemoteCamera::changeRegionOfInterest (const QRectF& roi)
+{
+    commandPacket()->newRegionOfInterest = QCCTV_ValidRegionOfInterest (roi);
+}
+
+/**
+ * Changes the flashlight status of the camera and emits the appropiate signals
+ */
+void QCCTV_RemoteCamera::changeFlashlightStatus (const int status)
+{
+    commandPacket()->newFlashlightEnabled = status;
+}
+
+/**
+ * Changes the path in which we should save incoming images
+ */
+void QCCTV_RemoteCamera::setIncomingMediaPath (const QString& path)
+{
+    if (!path.isEmpty())
+        m_incomingMediaPath = path;
+    else
+        m_incomingMediaPath = QDir::homePath() + "/QCCTV/QCCTV_Media/";
+}
+
+/**
+ * Changes the maximum percentage of a CPU core used to analyze the images
+ * received from this camera
+ */
+void QCCTV_RemoteCamera::setMotionAnalysisBudget (const int budget)
+{
+    m_analyzer->setCpuBudget (budget);
+}
+
+/**
+ * Enables or disables the station-side motion analysis for this camera
+ */
+void QCCTV_RemoteCamera::setMotionAnalysisEnabled (const bool enabled)
+{
+    m_analyzer->setEnabled (enabled);
+}
+
+/**
+ * Called when we stop receiving constant packets from the camera, this
+ * function deletes the temporary data buffer to avoid storing too much
+ * information that we cannot use directly.
+ *
+ * Also, this function is called when the class successfully reads a stream
+ * packet from the remote camera.
+ */
+void QCCTV_RemoteCamera::clearBuffer()
+{
+    m_data.clear();
+}
+
+/**
+ * Called when the temporary data buffer grows too much (or when we stop
+ * receiving packets from the camera), the frames in the buffer are lost, so
+ * the next delta frames cannot be applied until we receive a keyframe
+ */
+void QCCTV_RemoteCamera::discardBuffer()
+{
+    if (!m_data.isEmpty())
+        onFramesLost();
+
+    clearBuffer();
+}
+
+/**
+ * Called when we lose frames of the camera. The reference image and the
+ * JPEG tables may be outdated, so they are discarded, which makes us drop
+ * the next frames that depend on them until we receive a keyframe
+ */
+void QCCTV_RemoteCamera::onFramesLost()
+{
+    imagePacket()->reference = QImage();
+    imagePacket()->tables.clear();
+    requestKeyframe();
+}
+
+/**
+ * Called when the camera does not accept multiplexed sessions (or when the
+ * session could not be opened on time), connects to the legacy image stream
+ * port of the camera. Info and command packets are then sent through UDP
+ */
+void QCCTV_RemoteCamera::useLegacyStream()
+{
+    if (m_session || m_legacyStream)
+        return;
+
+    if (m_socket->state() == QAbstractSocket::ConnectedState)
+        return;
+
+    /* Relays only serve multiplexed sessions */
+    if (m_port != QCCTV_SESSION_PORT) {
+        endConnection();
+        return;
+    }
+
+    m_legacyStream = true;
+    m_socket->abort();
+    m_socket->connectToHost (m_address, QCCTV_STREAM_PORT);
+    m_socket->setSocketOption (QTcpSocket::LowDelayOption, 1);
+    m_socket->setSocketOption (QTcpSocket::KeepAliveOption, 1);
+}
+
+/**
+ * Configures the way in which we read the data of the camera, depending on
+ * the port to which we are connected
+ */
+void QCCTV_RemoteCamera::onSocketConnected()
+{
+    /* Legacy stream, the socket only transports images */
+    if (m_legacyStream) {
+        connect (m_socket, SIGNAL (readyRead()),
+                 this,       SLOT (onImageDataReceived()));
+        updateUdpStream();
+        return;
+    }
+
+    /* Multiplexed session, read all packets from the socket */
+    m_session = new QCCTV_Session (m_socket, this);
+    connect (m_session, SIGNAL (helloReceived (QByteArray)),
+             this,        SLOT (onSessionHello (QByteArray)));
+    connect (m_session, SIGNAL (imageReceived (QByteArray)),
+             this,        SLOT (onSessionImage (QByteArray)));
+    connect (m_session, SIGNAL (infoReceived (QByteArray)),
+             this,        SLOT (readInfoPacket (QByteArray)));
+    connect (m_session, SIGNAL (retransmissionReceived (quint16, QByteArray)),
+             this,        SLOT (onRetransmission (quint16, QByteArray)));
+    connect (m_session, SIGNAL (sharedFrameReceived (quint16, quint32)),
+             this,        SLOT (onSharedFrame (quint16, quint32)));
+
+    /* Tell the camera what we support, but do not use any capability until
+     * the camera replies */
+    QCCTV_HelloPacket local;
+    QCCTV_InitHello (&local);
+    QCCTV_InitLegacyHello (&m_hello);
+    m_session->sendHello (QCCTV_CreateHelloPacket (&local));
+
+    /* Allow the camera to send us the first frames */
+    m_displayQueue = 0;
+    m_framesReceived = 0;
+    grantCredits();
+    updateSharedFrames();
+    updateUdpStream();
+    updateMulticastStream();
+    sendCommandPacket();
+}
+
+/**
+ * Called when the TCP connection with the camera is closed. This function
+ * clears the temporary buffers and notifies the station that the
+ * connection with the camera has ended, which is sort like commiting suicide
+ * for this class...
+ */
+void QCCTV_RemoteCamera::endConnection()
+{
+    if (m_socket)
+        m_socket->abort();
+
+    clearBuffer();
+    updateConnected (false);
+    emit disconnected (id());
+}
+
+/**
+ * Notifies the station that the analyzer changed its motion status
+ */
+void QCCTV_RemoteCamera::onMotionAnalyzed()
+{
+    emit motionDetectedChanged (id());
+}
+
+/**
+ * Disables the focus flag. This function is called after 3 command packets
+ * instructing the camera to re-focus itself have been sent.
+ */
+void QCCTV_RemoteCamera::resetFocusRequest()
+{
+    commandPacket()->focusRequest = false;
+}
+
+/**
+ * Called when the camera does not send the requested snapshot on time, the
+ * receive buffer is reduced to its normal size again
+ */
+void QCCTV_RemoteCamera::resetSnapshotRequest()
+{
+    m_snapshotPending = false;
+}
+
+/**
+ * Obtains the information received by the TCP socket and calls the functions
+ * neccessary to interpret the received data
+ */
+void QCCTV_RemoteCamera::onImageDataReceived()
+{
+    if (!m_socket) {
+        clearBuffer();
+        return;
+    }
+
+    else {
+        m_data.append (m_socket->readAll());
+
+        /* Snapshots are large, keep the buffer while they are being received */
+        if (m_snapshotPending && m_watchdog)
+            m_watchdog->reset();
+
+        if (!m_data.isEmpty())
+            readImagePacket();
+
+        int limit = QCCTV_MAX_BUFFER_SIZE;
+        if (m_snapshotPending)
+            limit = QCCTV_MAX_SNAPSHOT_SIZE;
+
+        if (m_data.size() >= limit)
+            discardBuffer();
+    }
+}
+
+/**
+ * Applies the protocol configuration chosen by the camera, the connection
+ * is closed if we do not support the protocol version of the camera
+ */
+void QCCTV_RemoteCamera::onSessionHello (const QByteArray& data)
+{
+    QCCTV_HelloPacket local;
+    QCCTV_HelloPacket remote;
+    QCCTV_InitHello (&local);
+    if (!QCCTV_ReadHelloPacket (&remote, data) ||
+        !QCCTV_NegotiateHello (&m_hello, &local, &remote)) {
+        endConnection();
+        return;
+    }
+
+    m_session->setMaxFrameSize (m_hello.maxFrameSize);
+    updateSharedFrames();
+    updateUdpStream();
+    updateMulticastStream();
+
+    /* Allow the camera to send us the first frames */
+    grantCredits();
+    sendCommandPacket();
+}
+
+/**
+ * Reads the image packet received through the multiplexed session, the
+ * session already joined the fragments of the packet
+ */
+void QCCTV_RemoteCamera::onSessionImage (const QByteArray& data)
+{
+    /* Update the credits of the camera */
+    ++m_framesReceived;
+    grantCredits();
+
+    /* Read the image */
+    m_data = data;
+    readImagePacket();
+    clearBuffer();
+
+    /* Grant the credits even if the image was not valid */
+    sendCommandPacket();
+}
+
+/**
+ * Reads the image packet received through UDP datagrams, the datagram
+ * stream already joined the fragments of the packet
+ */
+void QCCTV_RemoteCamera::onDatagramFrame (const QByteArray& data)
+{
+    m_data = data;
+    readImagePacket();
+    clearBuffer();
+}
+
+/**
+ * Hands a multicast frame that the camera sent again through the session
+ * to the multicast stream, which delivers it in order
+ */
+void QCCTV_RemoteCamera::onRetransmission (const quint16 id,
+                                           const QByteArray& data)
+{
+    if (m_multicastStream)
+        m_multicastStream->insertFrame (id, data);
+}
+
+/**
+ * Reads the image that the camera wrote to the given shared memory \a slot,
+ * the frame is lost if the camera already reused the slot
+ */
+void QCCTV_RemoteCamera::onSharedFrame (const quint16 slot,
+                                        const quint32 sequence)
+{
+    /* Update the credits of the camera */
+    ++m_framesReceived;
+    grantCredits();
+
+    /* Read the image */
+    if (m_sharedFrames && m_sharedFrames->read (slot, sequence, &m_data))
+        readImagePacket();
+    else
+        onFramesLost();
+
+    clearBuffer();
+
+    /* Grant the credits even if the image was not valid */
+    sendCommandPacket();
+}
+
+/**
+ * Asks the camera to send the frame with the given \a id again
+ */
+void QCCTV_RemoteCamera::onFrameMissing (const quint16 id)
+{
+    if (m_session)
+        m_session->sendNack (id);
+}
+
+/**
+ * Sends a command packet to the camera, which instructs it to:
+ *
+ * - Change its FPS
+ * - Change its light status
+ * - Focus the camera device (if required)
+ *
+ * Only the fields that changed since the last full command packet are sent,
+ * this function returns \c false if there was nothing to send
+ */
+bool QCCTV_RemoteCamera::sendCommandPacket()
+{
+    /* Get the changes since the last full packet (if the camera supports it) */
+    bool full = !(m_hello.capabilities & QCCTV_CAP_PARTIAL_STATE);
+    QByteArray data = QCCTV_CreateCommandPacket (commandPacket(),
+                                                 &m_commandState, full);
+    if (data.isEmpty())
+        return false;
+
+    /* Send the packet */
+    if (m_session)
+        m_session->sendCommand (data);
+    else if (m_commandSocket)
+        m_commandSocket->writeDatagram (data, address(), QCCTV_COMMAND_PORT);
+
+    return true;
+}
+
+/**
+ * Updates the \a fps reported by the camera
+ */
+void QCCTV_RemoteCamera::updateFPS (const int fps)
+{
+    if (infoPacket()->fps != fps) {
+        infoPacket()->fps = fps;
+        commandPacket()->oldFps = fps;
+        commandPacket()->newFps = fps;
+        emit fpsChanged (id());
+    }
+}
+
+/**
+ * Updates the highest \a fps allowed by the camera
+ */
+void QCCTV_RemoteCamera::updateMaximumFps (const int fps)
+{
+    if (infoPacket()->maxFps != fps) {
+        infoPacket()->maxFps = fps;
+        emit fpsChanged (id());
+    }
+}
+
+/**
+ * Updates the zoom level of the camera and emits the appropiate signals
+ */
+void QCCTV_RemoteCamera::updateZoom (const int zoom)
+{
+    if (infoPacket()->zoom != zoom) {
+        infoPacket()->zoom = zoom;
+        commandPacket()->oldZoom = zoom;
+        commandPacket()->newZoom = zoom;
+        emit zoomLevelChanged (id());
+    }
+}
+
+/**
+ * Updates the target bitrate reported by the camera
+ */
+void QCCTV_RemoteCamera::updateBitrate (const int bitrate)
+{
+    if (infoPacket()->bitrate != bitrate) {
+        infoPacket()->bitrate = bitrate;
+        commandPacket()->oldBitrate = bitrate;
+        commandPacket()->newBitrate = bitrate;
+        emit bitrateChanged (id());
+    }
+}
+
+/**
+ * Updates the JPEG quality reported by the camera
+ */
+void QCCTV_RemoteCamera::updateQuality (const int quality)
+{
+    if (infoPacket()->quality != quality) {
+        infoPacket()->quality = quality;
+        emit qualityChanged (id());
+    }
+}
+
+/**
+ * Updates the operation status of the camera and emits the appropiate signals
+ */
+void QCCTV_RemoteCamera::updateStatus (const int status)
+{
+    if (infoPacket()->cameraStatus != status) {
+        infoPacket()->cameraStatus = status;
+        emit newCameraStatus (id());
+    }
+}
+
+/**
+ * Updates the stream options reported by the camera
+ */
+void QCCTV_RemoteCamera::updateStreamFlags (const int flags)
+{
+    if (infoPacket()->streamFlags != flags) {
+        infoPacket()->streamFlags = flags;
+        commandPacket()->oldStreamFlags = flags;
+        commandPacket()->newStreamFlags = flags;
+        emit streamFlagsChanged (id());
+    }
+}
+
+/**
+ * Updates the luma-only (grayscale) status reported by the camera
+ */
+void QCCTV_RemoteCamera::updateGrayscale (const bool grayscale)
+{
+    if (infoPacket()->grayscale != grayscale) {
+        infoPacket()->grayscale = grayscale;
+        emit grayscaleChanged (id());
+    }
+}
+
+/**
+ * Updates the \a name reported by the camera
+ */
+void QCCTV_RemoteCamera::updateName (const QString& name)
+{
+    if (infoPacket()->cameraName != name) {
+        infoPacket()->cameraName = name;
+        if (infoPacket()->cameraName.isEmpty())
+            infoPacket()->cameraName = "Unknown Camera";
+
+        emit newCameraName (id());
+    }
+}
+
+/**
+ * Updates the \a group reported by the camera
+ */
+void QCCTV_RemoteCamera::updateGroup (const QString& group)
+{
+    if (infoPacket()->cameraGroup != group) {
+        infoPacket()->cameraGroup = group;
+        if (infoPacket()->cameraGroup.isEmpty())
+            infoPacket()->cameraGroup = "Default";
+
+        emit newCameraGroup();
+    }
+}
+
+/**
+ * Updates the key of the shared memory segment in which the camera writes
+ * its frames for the stations in the same host
+ */
+void QCCTV_RemoteCamera::updateSharedMemoryKey (const QString& key)
+{
+    if (infoPacket()->sharedMemoryKey != key) {
+        infoPacket()->sharedMemoryKey = key;
+
+        /* Attach to the new segment */
+        delete m_sharedFrames;
+        m_sharedFrames = Q_NULLPTR;
+
+        updateSharedFrames();
+        updateUdpStream();
+        updateMulticastStream();
+    }
+}
+
+/**
+ * Updates the multicast group in which the camera sends its shared stream
+ */
+void QCCTV_RemoteCamera::updateMulticastGroup (const QString& group,
+                                               const int port)
+{
+    if (infoPacket()->multicastGroup != group ||
+        infoPacket()->multicastPort != port) {
+        infoPacket()->multicastGroup = group;
+        infoPacket()->multicastPort = port;
+
+        /* Join the new group */
+        if (m_multicastStream) {
+            m_multicastStream->deleteLater();
+            m_multicastStream = Q_NULLPTR;
+        }
+
+        updateMulticastStream();
+    }
+}
+
+/**
+ * Updates the connection status of the camera and emits the appropiate signals
+ */
+void QCCTV_RemoteCamera::updateConnected (const bool status)
+{
+    m_connected = status;
+
+    if (m_connected) {
+        emit connected (id());
+        emit fpsChanged (id());
+        emit resolutionChanged (id());
+        emit autoRegulateResolutionChanged (id());
+    }
+}
+
+/**
+ * Updates the region of interest reported by the camera
+ */
+void QCCTV_RemoteCamera::updateRegionOfInterest (const QRectF& roi)
+{
+    if (infoPacket()->regionOfInterest != roi) {
+        infoPacket()->regionOfInterest = roi;
+        commandPacket()->oldRegionOfInterest = roi;
+        commandPacket()->newRegionOfInterest = roi;
+        emit regionOfInterestChanged (id());
+    }
+}
+
+/**
+ * Changes the zoom support status of the camera and emits the appropiate signals
+ */
+void QCCTV_RemoteCamera::updateZoomSupport (const bool support)
+{
+    if (infoPacket()->supportsZoom != support) {
+        infoPacket()->supportsZoom = support;
+        emit zoomSupportChanged (id());
+    }
+}
+
+/**
+ * Updates the image resolution status of the camera
+ */
+void QCCTV_RemoteCamera::updateResolution (const int resolution)
+{
+    if (infoPacket()->resolution != resolution) {
+        infoPacket()->resolution = resolution;
+        commandPacket()->oldResolution = resolution;
+        commandPacket()->newResolution = resolution;
+        emit resolutionChanged (id());
+    }
+}
+
+/**
+ * Updates the auto-regulate status flag of the camera
+ */
+void QCCTV_RemoteCamera::updateAutoRegulate (const bool regulate)
+{
+    if (infoPacket()->autoRegulateResolution != regulate) {
+        infoPacket()->autoRegulateResolution = regulate;
+        commandPacket()->oldAutoRegulateResolution = regulate;
+        commandPacket()->newAutoRegulateResolution = regulate;
+        emit autoRegulateResolutionChanged (id());
+    }
+}
+
+/**
+ * Updates the flashlight status flag of the camera
+ */
+void QCCTV_RemoteCamera::updateFlashlightEnabled (const bool enabled)
+{
+    if (infoPacket()->flashlightEnabled != enabled) {
+        infoPacket()->flashlightEnabled = enabled;
+        commandPacket()->oldFlashlightEnabled = enabled;
+        commandPacket()->newFlashlightEnabled = enabled;
+        emit lightStatusChanged (id());
+    }
+}
+
+/**
+ * Updates the motion status reported by the camera
+ */
+void QCCTV_RemoteCamera::updateMotionDetected (const bool detected)
+{
+    if (infoPacket()->motionDetected != detected) {
+        infoPacket()->motionDetected = detected;
+        emit motionDetectedChanged (id());
+    }
+}
+
+/**
+ * Updates the motion detection flag of the camera
+ */
+void QCCTV_RemoteCamera::updateMotionDetection (const bool enabled)
+{
+    if (infoPacket()->motionDetectionEnabled != enabled) {
+        infoPacket()->motionDetectionEnabled = enabled;
+        emit motionDetectedChanged (id());
+    }
+}
+
+/**
+ * Called when we receive a datagram from the camera, this function
+ * obtains the latest image from the camera
+ */
+void QCCTV_RemoteCamera::readImagePacket()
+{
+    /* Delta frames are applied to the last image */
+    QCCTV_ImagePacket packet;
+    packet.tables = imagePacket()->tables;
+    packet.reference = imagePacket()->reference;
+    packet.frameCount = imagePacket()->frameCount;
+
+    /* Read the packet */
+    if (QCCTV_ReadImagePacket (&packet, m_data)) {
+        /* Save the snapshot, the live stream is not changed */
+        if (packet.snapshot) {
+            clearBuffer();
+            acknowledgeReception();
+
+            m_snapshotPending = false;
+            m_snapshotTimer->stop();
+            m_snapshot = packet.image;
+            m_snapshotFile = m_saver->saveSnapshot (incomingMediaPath(),
+                                                    name(),
+                                                    address().toString(),
+                                                    packet.jpeg);
+
+            emit snapshotReceived (id());
+            return;
+        }
+
+        /* Stop requesting keyframes (once we also got the JPEG tables) */
+        if (packet.selfContained)
+            commandPacket()->keyframeRequest = false;
+
+        /* Forward the frame to the relay (only the whole image) */
+        if (m_relay && commandPacket()->crop.isEmpty())
+            emit relayedImage (m_data, packet.selfContained);
+
+        /* Clear buffer and send another command packet */
+        clearBuffer();
+        acknowledgeReception();
+
+        /* Re-assign image */
+        imagePacket()->image = packet.image;
+        imagePacket()->tables = packet.tables;
+        imagePacket()->reference = packet.reference;
+        imagePacket()->frameCount = packet.frameCount;
+        ++m_displayQueue;
+        emit newImage (id());
+
+        /* Reset the watchdog */
+        if (m_watchdog)
+            m_watchdog->reset();
+
+        /* Analyze the image if the camera does not detect motion itself */
+        if (!infoPacket()->motionDetectionEnabled) {
+            if (packet.keyframe)
+                m_analyzer->analyze (packet.jpeg);
+            else
+                m_analyzer->analyze (packet.image);
+        }
+
+        /* Save image to disk */
+        if (saveIncomingMedia() && (motionDetected() || !recordOnMotionOnly())) {
+            QtConcurrent::run (m_saver, &QCCTV_ImageSaver::saveImage,
+                               incomingMediaPath(),
+                               name(),
+                               address().toString(),
+                               image());
+        }
+    }
+
+    /* We cannot apply the delta frame, ask the camera for a full frame */
+    else if (packet.keyframeRequested) {
+        clearBuffer();
+        requestKeyframe();
+    }
+}
+
+/**
+ * Allows the camera to send us more frames in a multiplexed session. The
+ * number of granted frames is cumulative (so that lost command packets do
+ * not matter) and decreases while our images wait to be displayed, but we
+ * always allow the camera to send us the newest frame
+ */
+void QCCTV_RemoteCamera::grantCredits()
+{
+    if (m_session && (m_hello.capabilities & QCCTV_CAP_CREDITS)) {
+        int window = qMax (1, QCCTV_CREDIT_WINDOW - m_displayQueue);
+        commandPacket()->credits = m_framesReceived + window;
+    }
+}
+
+/**
+ * Forwards the current camera information to the relay as a full info
+ * packet (the relay does not use our multicast group)
+ */
+void QCCTV_RemoteCamera::publishInfo()
+{
+    QCCTV_InfoPacket info = *infoPacket();
+    info.multicastGroup = "";
+    info.multicastPort = 0;
+    info.sharedMemoryKey = "";
+
+    QCCTV_PacketState state;
+    QCCTV_InitState (&state);
+    emit relayedInfo (QCCTV_CreateInfoPacket (&info, &state, true));
+}
+
+/**
+ * Opens or closes the UDP socket that receives the images of the camera and
+ * tells the camera to which port it should send them (zero means that the
+ * images are sent through the TCP connection)
+ */
+void QCCTV_RemoteCamera::updateUdpStream()
+{
+    /* Check if we can use UDP images */
+    bool enabled = m_udpTransport && m_socket &&
+                   !commandPacket()->sharedMemory &&
+                   m_socket->state() == QAbstractSocket::ConnectedState &&
+                   (m_hello.capabilities & QCCTV_CAP_UDP_TRANSPORT);
+
+    /* Close the UDP socket */
+    if (!enabled) {
+        if (m_udpStream) {
+            m_udpStream->deleteLater();
+            m_udpStream = Q_NULLPTR;
+            requestKeyframe();
+        }
+
+        commandPacket()->udpPort = 0;
+        return;
+    }
+
+    /* Open the UDP socket */
+    if (!m_udpStream) {
+        m_udpStream = new QCCTV_DatagramStream (this);
+        connect (m_udpStream, SIGNAL (frameReceived (QByteArray)),
+                 this,          SLOT (onDatagramFrame (QByteArray)));
+        connect (m_udpStream, SIGNAL (framesLost()),
+                 this,          SLOT (onFramesLost()));
+
+        if (!m_udpStream->listen()) {
+            m_udpStream->deleteLater();
+            m_udpStream = Q_NULLPTR;
+            commandPacket()->udpPort = 0;
+            return;
+        }
+
+        requestKeyframe();
+    }
+
+    commandPacket()->udpPort = m_udpStream->port();
+}
+
+/**
+ * Attaches to (or detaches from) the shared memory segment of the camera,
+ * which is only used if the camera runs in this host and we receive the
+ * whole image through a session
+ */
+void QCCTV_RemoteCamera::updateSharedFrames()
+{
+    /* Check if we can read the images from shared memory */
+    QString key = infoPacket()->sharedMemoryKey;
+    bool enabled = m_session && m_socket &&
+                   m_socket->state() == QAbstractSocket::ConnectedState &&
+                   (m_hello.capabilities & QCCTV_CAP_SHARED_MEMORY) &&
+                   !key.isEmpty() && commandPacket()->crop.isEmpty() &&
+                   QCCTV_IsLocalAddress (address());
+
+    /* Detach from the segment */
+    if (!enabled) {
+        if (m_sharedFrames) {
+            delete m_sharedFrames;
+            m_sharedFrames = Q_NULLPTR;
+            requestKeyframe();
+        }
+
+        commandPacket()->sharedMemory = false;
+        return;
+    }
+
+    /* Attach to the segment */
+    if (!m_sharedFrames) {
+        m_sharedFrames = new QCCTV_SharedFrames;
+        if (!m_sharedFrames->attach (key)) {
+            delete m_sharedFrames;
+            m_sharedFrames = Q_NULLPTR;
+            commandPacket()->sharedMemory = false;
+            return;
+        }
+
+        requestKeyframe();
+    }
+
+    commandPacket()->sharedMemory = true;
+}
+
+/**
+ * Joins or leaves the multicast group of the camera and tells the camera
+ * if it should stop sending us our own copy of the images
+ */
+void QCCTV_RemoteCamera::updateMulticastStream()
+{
+    /* Check if we can use the multicast stream */
+    QHostAddress group (infoPacket()->multicastGroup);
+    bool enabled = m_multicast && m_session && m_socket &&
+                   m_socket->state() == QAbstractSocket::ConnectedState &&
+                   (m_hello.capabilities & QCCTV_CAP_MULTICAST) &&
+                   group.isMulticast() && infoPacket()->multicastPort > 0 &&
+                   commandPacket()->crop.isEmpty() &&
+                   !commandPacket()->sharedMemory;
+
+    /* Leave the multicast group */
+    if (!enabled) {
+        if (m_multicastStream) {
+            m_multicastStream->deleteLater();
+            m_multicastStream = Q_NULLPTR;
+        }
+
+        commandPacket()->multicast = false;
+        return;
+    }
+
+    /* Join the multicast group */
+    if (!m_multicastStream) {
+        m_multicastStream = new QCCTV_DatagramStream (this);
+        connect (m_multicastStream, SIGNAL (frameReceived (QByteArray)),
+                 this,                SLOT (onDatagramFrame (QByteArray)));
+        connect (m_multicastStream, SIGNAL (frameMissing (quint16)),
+                 this,                SLOT (onFrameMissing (quint16)));
+        connect (m_multicastStream, SIGNAL (framesLost()),
+                 this,                SLOT (onFramesLost()));
+
+        if (!m_multicastStream->listen (group, infoPacket()->multicastPort)) {
+            m_multicastStream->deleteLater();
+            m_multicastStream = Q_NULLPTR;
+            commandPacket()->multicast = false;
+            return;
+        }
+
+        m_multicastStream->setSource (address());
+        m_multicastStream->setRetransmissionsEnabled (true);
+    }
+
+    commandPacket()->multicast = true;
+}
+
+/**
+ * Resets the watchdog and sends a command packet to the camera, which allows
+ * it to know if we are doing OK.
+ *
+ * Commands are only sent when they differ from the last full command packet
+ * (or when a full packet is due). In a multiplexed session, we send an ack
+ * frame to the camera when there is nothing else to send.
+ *
+ * If the camera does not receive a command packet after some time, it will
+ * try to reduce its image size automatically
+ */
+void QCCTV_RemoteCamera::acknowledgeReception()
+{
+    if (!sendCommandPacket() && m_session)
+        m_session->sendAck();
+
+    if (!isConnected())
+        updateConnected (true);
+}
+
+/**
+ * Returns the pointer to the stream packet structure
+ */
+QCCTV_InfoPacket* QCCTV_RemoteCamera::infoPacket()
+{
+    if (m_infoPacket)
+        return m_infoPacket;
+
+    m_infoPacket = new QCCTV_InfoPacket;
+    return m_infoPacket;
+}
+
+/**
+ * Returns the pointer to the image packet structure
+ */
+QCCTV_ImagePacket* QCCTV_RemoteCamera::imagePacket()
+{
+    if (m_imagePacket)
+        return m_imagePacket;
+
+    m_imagePacket = new QCCTV_ImagePacket;
+    return m_imagePacket;
+}
+
+/**
+ * Returns the pointer to the stream command structure
+ */
+QCCTV_CommandPacket* QCCTV_RemoteCamera::commandPacket()
+{
+    if (m_commandPacket)
+        return m_commandPacket;
+
+    m_commandPacket = new QCCTV_CommandPacket;
+    return m_commandPacket;
+}
+
@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_RtpStream.h"
+
+#include <QDateTime>
+#include <QUdpSocket>
+#include <QNetworkInterface>
+
+/* RTP/JPEG constants (RFC 2435 and RFC 3551) */
+static const quint8 RTP_VERSION       = 0x80;
+static const quint8 RTP_MARKER        = 0x80;
+static const quint8 RTP_PAYLOAD_JPEG  = 26;
+static const int RTP_CLOCK_RATE       = 90000;
+static const quint8 JPEG_TYPE_422     = 0;
+static const quint8 JPEG_TYPE_420     = 1;
+static const quint8 JPEG_TYPE_RESTART = 64;
+static const quint8 JPEG_Q_DYNAMIC    = 255;
+static const int JPEG_MAX_SIZE        = 2040;
+
+/* JPEG markers */
+static const quint8 MARKER_SOF0 = 0xC0;
+static const quint8 MARKER_DHT  = 0xC4;
+static const quint8 MARKER_RST0 = 0xD0;
+static const quint8 MARKER_RST7 = 0xD7;
+static const quint8 MARKER_SOI  = 0xD8;
+static const quint8 MARKER_EOI  = 0xD9;
+static const quint8 MARKER_SOS  = 0xDA;
+static const quint8 MARKER_DQT  = 0xDB;
+static const quint8 MARKER_DRI  = 0xDD;
+
+/**
+ * Information obtained from the headers of a JPEG image
+ */
+struct JpegInfo {
+    quint8 type;
+    int width;
+    int height;
+    int restartInterval;
+    QByteArray tables[2];
+    QByteArray scan;
+};
+
+/**
+ * Appends the given 16-bit \a value to the \a data (big-endian)
+ */
+static void write_u16 (QByteArray* data, const quint16 value)
+{
+    data->append ((char) ((value & 0xff00) >> 8));
+    data->append ((char) (value & 0xff));
+}
+
+/**
+ * Appends the given 24-bit \a value to the \a data (big-endian)
+ */
+static void write_u24 (QByteArray* data, const quint32 value)
+{
+    data->append ((char) ((value & 0xff0000) >> 16));
+    write_u16 (data, value & 0xffff);
+}
+
+/**
+ * Appends the given 32-bit \a value to the \a data (big-endian)
+ */
+static void write_u32 (QByteArray* data, const quint32 value)
+{
+    write_u16 (data, (value & 0xffff0000) >> 16);
+    write_u16 (data, value & 0xffff);
+}
+
+/**
+ * Reads a 16-bit value from the given \a data at the given \a offset
+ */
+static int read_u16 (const QByteArray& data, const int offset)
+{
+    return ((quint8) data.at (offset) << 8) | (quint8) data.at (offset + 1);
+}
+
+/**
+ * Reads the headers of the given \a jpeg image and writes the values used
+ * by RTP/JPEG to the given \a info structure.
+ *
+ * This function shall return \c false if the image cannot be sent through
+ * RTP/JPEG (progressive or grayscale images, unusual sampling factors or
+ * images that are too large)
+ */
+static bool read_jpeg (const QByteArray& jpeg, JpegInfo* info)
+{
+    if (jpeg.size() < 4 || (quint8) jpeg.at (1) != MARKER_SOI)
+        return false;
+
+    info->type = 0xff;
+    info->restartInterval = 0;
+
+    int pos = 2;
+    while (pos + 4 <= jpeg.size()) {
+        /* Find the next marker */
+        if ((quint8) jpeg.at (pos) != 0xFF)
+            return false;
+
+        quint8 marker = jpeg.at (pos + 1);
+        if (marker == 0xFF) {
+            ++pos;
+            continue;
+        }
+
+        /* Get the segment */
+        int length = read_u16 (jpeg, pos + 2);
+        if (length < 2 || pos + 2 + length > jpeg.size())
+            return false;
+
+        QByteArray segment = jpeg.mid (pos + 4, length - 2);
+
+        /* Quantization tables (8-bit precision only) */
+        if (marker == MARKER_DQT) {
+            for (int i = 0; i + 65 <= segment.size(); i += 65) {
+                quint8 pq = segment.at (i);
+                if ((pq >> 4) != 0 || (pq & 0x0F) > 1)
+                    return false;
+
+                info->tables[pq & 0x0F] = segment.mid (i + 1, 64);
+            }
+        }
+
+        /* Restart interval */
+        else if (marker == MARKER_DRI && segment.size() >= 2)
+            info->restartInterval = read_u16 (segment, 0);
+
+        /* Baseline frame header, we need YCbCr with the chroma subsampled */
+        else if (marker == MARKER_SOF0) {
+            if (segment.size() < 15 || segment.at (5) != 3)
+                return false;
+
+            info->height = read_u16 (segment, 1);
+            info->width = read_u16 (segment, 3);
+
+            quint8 luma = segment.at (7);
+            if (luma == 0x21)
+                info->type = JPEG_TYPE_422;
+            else if (luma == 0x22)
+                info->type = JPEG_TYPE_420;
+            else
+                return false;
+
+            /* Luma uses table 0, chroma uses table 1 */
+            if (segment.at (8) != 0 ||
+                segment.at (10) != 0x11 || segment.at (11) != 1 ||
+                segment.at (13) != 0x11 || segment.at (14) != 1)
+                return false;
+        }
+
+        /* Other frame types (progressive, arithmetic coding, etc.) */
+        else if (marker > MARKER_SOF0 && marker <= 0xCF &&
+                 marker != MARKER_DHT && marker != 0xC8 && marker != 0xCC)
+            return false;
+
+        /* Entropy-coded data starts after the scan header */
+        else if (marker == MARKER_SOS) {
+            int start = pos + 2 + length;
+            int end = jpeg.size();
+            if ((quint8) jpeg.at (end - 2) == 0xFF &&
+                (quint8) jpeg.at (end - 1) == MARKER_EOI)
+                end -= 2;
+
+            info->scan = jpeg.mid (start, end - start);
+            break;
+        }
+
+        pos += 2 + length;
+    }
+
+    /* Check that we have everything */
+    if (info->type == 0xff || info->scan.isEmpty())
+        return false;
+    if (info->tables[0].size() != 64 || info->tables[1].size() != 64)
+        return false;
+    if (info->width % 8 || info->height % 8)
+        return false;
+    if (info->width > JPEG_MAX_SIZE || info->height > JPEG_MAX_SIZE)
+        return false;
+
+    return true;
+}
+
+/**
+ * Returns the offsets at which each restart interval of the given
+ * entropy-coded \a scan starts (the first interval starts at zero)
+ */
+static QList<int> restart_intervals (const QByteArray& scan)
+{
+    QList<int> offsets;
+    offsets.append (0);
+
+    for (int i = 0; i + 1 < scan.size(); ++i) {
+        if ((quint8) scan.at (i) == 0xFF) {
+            quint8 marker = scan.at (i + 1);
+            if (marker >= MARKER_RST0 && marker <= MARKER_RST7)
+                offsets.append (i + 2);
+        }
+    }
+
+    return offsets;
+}
+
+/**
+ * Creates a stream without destination, frames are not sent until
+ * \c setDestination() is called
+ */
+QCCTV_RtpStream::QCCTV_RtpStream (QObject* parent) : QObject (parent)
+{
+    m_port = 0;
+    m_sequence = 0;
+    m_frameTimestamp = 0;
+    m_socket = new QUdpSocket (this);
+
+    /* Random SSRC and timestamp base (RFC 3550) */
+    qsrand (QDateTime::currentMSecsSinceEpoch() ^ (quintptr) this);
+    m_ssrc = ((quint32) qrand() << 16) ^ qrand();
+    m_timestamp = ((quint32) qrand() << 16) ^ qrand();
+}
+
+/**
+ * Returns the port to which we send the RTP packets
+ */
+quint16 QCCTV_RtpStream::port() const
+{
+    return m_port;
+}
+
+/**
+ * Returns the address to which we send the RTP packets
+ */
+QHostAddress QCCTV_RtpStream::address() const
+{
+    return m_address;
+}
+
+/**
+ * Returns a session description (SDP) that allows standard players and
+ * recorders to receive the stream, the session is named after the camera
+ * \a name and announces the given \a fps
+ */
+QString QCCTV_RtpStream::sessionDescription (const QString& name,
+                                             const int fps) const
+{
+    /* Get the address of this device */
+    QString origin = "127.0.0.1";
+    foreach (QHostAddress address, QNetworkInterface::allAddresses()) {
+        if (!address.isLoopback() &&
+            address.protocol() == QAbstractSocket::IPv4Protocol) {
+            origin = address.toString();
+            break;
+        }
+    }
+
+    /* Multicast destinations need a TTL */
+    QString connection = address().toString();
+    if (address().isMulticast())
+        connection += "/1";
+
+    QString sdp;
+    sdp += "v=0\r\n";
+    sdp += QString ("o=- %1 1 IN IP4 %2\r\n").arg (m_ssrc).arg (origin);
+    sdp += QString ("s=QCCTV %1\r\n").arg (name);
+    sdp += QString ("c=IN IP4 %1\r\n").arg (connection);
+    sdp += "t=0 0\r\n";
+    sdp += QString ("m=video %1 RTP/AVP %2\r\n").arg (port())
+                                                .arg (RTP_PAYLOAD_JPEG);
+    sdp += QString ("a=rtpmap:%1 JPEG/%2\r\n").arg (RTP_PAYLOAD_JPEG)
+                                              .arg (RTP_CLOCK_RATE);
+    sdp += QString ("a=framerate:%1\r\n").arg (fps);
+    sdp += "a=recvonly\r\n";
+    return sdp;
+}
+
+/**
+ * Encodes the given \a image with the given resolution and \a quality as a
+ * JPEG image that can be sent through RTP/JPEG (color image with a size
+ * that is a multiple of 8 pixels and not larger than 2040 pixels)
+ */
+QByteArray QCCTV_RtpStream::encodeFrame (const QImage& image,
+                                         const int res,
+                                         const int quality)
+{
+    /* Scale the image and limit its size */
+    QImage frame = QCCTV_ScaleImage (image, res);
+    if (frame.width() > JPEG_MAX_SIZE || frame.height() > JPEG_MAX_SIZE)
+        frame = frame.scaled (JPEG_MAX_SIZE, JPEG_MAX_SIZE,
+                              Qt::KeepAspectRatio, Qt::FastTransformation);
+
+    /* Crop the image to a multiple of 8 pixels */
+    frame = frame.copy (0, 0, frame.width() & ~7, frame.height() & ~7);
+    if (frame.isNull())
+        return QByteArray();
+
+    /* RTP/JPEG does not support grayscale images */
+    frame = frame.convertToFormat (QImage::Format_RGB32);
+    return QCCTV_EncodeImage (frame, QCCTV_Original, quality);
+}
+
+/**
+ * Splits the given \a jpeg image in RTP/JPEG packets and sends them to the
+ * destination, returns \c false if the image cannot be sent.
+ *
+ * The RTP timestamp is obtained from the capture \a time of the image (in
+ * milliseconds), so that the encoding time does not add jitter to it
+ */
+bool QCCTV_RtpStream::sendFrame (const QByteArray& jpeg, const qint64 time)
+{
+    /* No destination */
+    if (m_address.isNull() || m_port == 0)
+        return false;
+
+    /* Read the JPEG headers */
+    JpegInfo info;
+    if (!read_jpeg (jpeg, &info))
+        return false;
+
+    /* All the packets of the frame have the same timestamp */
+    m_frameTimestamp = m_timestamp + time * (RTP_CLOCK_RATE / 1000);
+
+    /* Get the restart intervals (only if the encoder used restart markers) */
+    QList<int> intervals;
+    if (info.restartInterval > 0)
+        intervals = restart_intervals (info.scan);
+    else
+        intervals.append (0);
+
+    intervals.append (info.scan.size());
+
+    /* Send the intervals, several intervals fit in a packet */
+    int interval = 0;
+    int offset = 0;
+    while (offset < info.scan.size()) {
+        /* Get the intervals that fit in the packet */
+        int next = interval + 1;
+        while (next + 1 < intervals.count() &&
+               intervals.at (next + 1) - intervals.at (interval) <= QCCTV_RTP_PAYLOAD_SIZE)
+            ++next;
+
+        /* Get the data of the packet (large intervals are split) */
+        int end = qMin (intervals.at (next), offset + QCCTV_RTP_PAYLOAD_SIZE);
+        bool first = (offset == intervals.at (interval));
+        bool last = (end == intervals.at (next));
+
+        /* Main JPEG header */
+        QByteArray payload;
+        quint8 type = info.type;
+        if (info.restartInterval > 0)
+            type += JPEG_TYPE_RESTART;
+
+        payload.append ((char) 0);
+        write_u24 (&payload, offset);
+        payload.append ((char) type);
+        payload.append ((char) JPEG_Q_DYNAMIC);
+        payload.append ((char) (info.width / 8));
+        payload.append ((char) (info.height / 8));
+
+        /* Restart marker header */
+        if (info.restartInterval > 0) {
+            quint16 count = interval & 0x3FFF;
+            if (first)
+                count |= 0x8000;
+            if (last)
+                count |= 0x4000;
+
+            write_u16 (&payload, info.restartInterval);
+            write_u16 (&payload, count);
+        }
+
+        /* Quantization table header (first packet only) */
+        if (offset == 0) {
+            payload.append ((char) 0);
+            payload.append ((char) 0);
+            write_u16 (&payload, 128);
+            payload.append (info.tables[0]);
+            payload.append (info.tables[1]);
+        }
+
+        /* Send the packet */
+        payload.append (info.scan.mid (offset, end - offset));
+        sendPacket (payload, end >= info.scan.size());
+
+        /* Continue with the next intervals */
+        offset = end;
+        if (last)
+            interval = next;
+    }
+
+    return true;
+}
+
+/**
+ * Changes the \a address and \a port to which we send the RTP packets
+ */
+void QCCTV_RtpStream::setDestination (const QHostAddress& address,
+                                      const quint16 port)
+{
+    m_port = port;
+    m_address = address;
+}
+
+/**
+ * Adds the RTP header to the given \a payload and sends it, the marker bit
+ * is set on the \a last packet of each frame
+ */
+void QCCTV_RtpStream::sendPacket (const QByteArray& payload, const bool last)
+{
+    QByteArray packet;
+    packet.append ((char) RTP_VERSION);
+    packet.append ((char) (RTP_PAYLOAD_JPEG | (last ? RTP_MARKER : 0)));
+    write_u16 (&packet, m_sequence++);
+    write_u32 (&packet, m_frameTimestamp);
+    write_u32 (&packet, m_ssrc);
+    packet.append (payload);
+
+    m_socket->writeDatagram (packet, m_address, m_port);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_RTP_STREAM_H
+#define _QCCTV_RTP_STREAM_H
+
+#include <QImage>
+#include <QObject>
+#include <QByteArray>
+#include <QHostAddress>
+
+class QUdpSocket;
+
+/**
+ * \brief Publishes JPEG frames as an RTP/JPEG stream (RFC 2435).
+ *
+ * The entropy-coded data of each frame is split in RTP packets, the
+ * quantization tables are sent in-band (Q = 255) with the first packet of
+ * each frame. If the JPEG data contains restart markers, the packets are
+ * aligned to the restart intervals, so that receivers can decode the rest of
+ * a frame when a packet is lost.
+ *
+ * Only baseline YCbCr images with 4:2:0 or 4:2:2 sampling can be sent, use
+ * \c encodeFrame() to obtain such images.
+ */
+class QCCTV_RtpStream : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QCCTV_RtpStream (QObject* parent = Q_NULLPTR);
+
+    quint16 port() const;
+    QHostAddress address() const;
+    QString sessionDescription (const QString& name, const int fps) const;
+
+    static QByteArray encodeFrame (const QImage& image,
+                                   const int res,
+                                   const int quality);
+
+public Q_SLOTS:
+    bool sendFrame (const QByteArray& jpeg, const qint64 time);
+    void setDestination (const QHostAddress& address, const quint16 port);
+
+private:
+    void sendPacket (const QByteArray& payload, const bool last);
+
+private:
+    QUdpSocket* m_socket;
+
+    quint16 m_port;
+    QHostAddress m_address;
+
+    quint32 m_ssrc;
+    quint16 m_sequence;
+    quint32 m_timestamp;
+    quint32 m_frameTimestamp;
+};
+
+#endif
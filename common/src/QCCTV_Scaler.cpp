@@ -0,0 +1,680 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_Scaler.h"
+
+#include <QVector>
+#include <string.h>
+
+/*
+ * Select the available SIMD instruction sets
+ */
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define QCCTV_SCALER_SSE2
+    #include <emmintrin.h>
+#endif
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+    #define QCCTV_SCALER_AVX2
+    #include <immintrin.h>
+#endif
+#if defined (ARM_NEON_ENABLE) || defined (__ARM_NEON) || defined (__ARM_NEON__)
+    #define QCCTV_SCALER_NEON
+    #include <arm_neon.h>
+#endif
+
+/* Maximum integer reduction factor (keeps the 16-bit accumulators safe) */
+static const int MAX_BOX_FACTOR = 16;
+
+/*
+ * Row accumulation kernels: acc [i] += src [i]
+ */
+
+#ifdef QCCTV_SCALER_AVX2
+__attribute__ ((target ("avx2")))
+static int accumulate_avx2 (quint16* acc, const uchar* src, const int count)
+{
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m128i lo = _mm_loadu_si128 ((const __m128i*) (src + i));
+        __m128i hi = _mm_loadu_si128 ((const __m128i*) (src + i + 16));
+        __m256i a = _mm256_loadu_si256 ((const __m256i*) (acc + i));
+        __m256i b = _mm256_loadu_si256 ((const __m256i*) (acc + i + 16));
+        a = _mm256_add_epi16 (a, _mm256_cvtepu8_epi16 (lo));
+        b = _mm256_add_epi16 (b, _mm256_cvtepu8_epi16 (hi));
+        _mm256_storeu_si256 ((__m256i*) (acc + i), a);
+        _mm256_storeu_si256 ((__m256i*) (acc + i + 16), b);
+    }
+
+    return i;
+}
+#endif
+
+#ifdef QCCTV_SCALER_SSE2
+static int accumulate_sse2 (quint16* acc, const uchar* src, const int count)
+{
+    int i = 0;
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= count; i += 16) {
+        __m128i s = _mm_loadu_si128 ((const __m128i*) (src + i));
+        __m128i a = _mm_loadu_si128 ((const __m128i*) (acc + i));
+        __m128i b = _mm_loadu_si128 ((const __m128i*) (acc + i + 8));
+        a = _mm_add_epi16 (a, _mm_unpacklo_epi8 (s, zero));
+        b = _mm_add_epi16 (b, _mm_unpackhi_epi8 (s, zero));
+        _mm_storeu_si128 ((__m128i*) (acc + i), a);
+        _mm_storeu_si128 ((__m128i*) (acc + i + 8), b);
+    }
+
+    return i;
+}
+#endif
+
+#ifdef QCCTV_SCALER_NEON
+static int accumulate_neon (quint16* acc, const uchar* src, const int count)
+{
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t s = vld1q_u8 (src + i);
+        uint16x8_t a = vld1q_u16 (acc + i);
+        uint16x8_t b = vld1q_u16 (acc + i + 8);
+        vst1q_u16 (acc + i, vaddw_u8 (a, vget_low_u8 (s)));
+        vst1q_u16 (acc + i + 8, vaddw_u8 (b, vget_high_u8 (s)));
+    }
+
+    return i;
+}
+#endif
+
+/**
+ * Adds the first \a count bytes of \a src to the \a acc accumulators
+ */
+static void accumulate_row (quint16* acc, const uchar* src, const int count)
+{
+    int i = 0;
+    const int simd = QCCTV_EnabledSimd();
+    Q_UNUSED (simd);
+
+#ifdef QCCTV_SCALER_AVX2
+    if (simd & QCCTV_SIMD_AVX2)
+        i = accumulate_avx2 (acc, src, count);
+#endif
+#ifdef QCCTV_SCALER_SSE2
+    if (simd & QCCTV_SIMD_SSE2)
+        i += accumulate_sse2 (acc + i, src + i, count - i);
+#endif
+#ifdef QCCTV_SCALER_NEON
+    if (simd & QCCTV_SIMD_NEON)
+        i += accumulate_neon (acc + i, src + i, count - i);
+#endif
+
+    for (; i < count; ++i)
+        acc [i] += src [i];
+}
+
+/*
+ * Row blending kernels: dst [i] = (a [i] * (256 - w) + b [i] * w + 128) >> 8
+ * (the weight is always in the [1, 255] range)
+ */
+
+#ifdef QCCTV_SCALER_AVX2
+__attribute__ ((target ("avx2")))
+static int blend_avx2 (uchar* dst, const uchar* a, const uchar* b,
+                       const int count, const int weight)
+{
+    int i = 0;
+    const __m256i wa = _mm256_set1_epi16 (256 - weight);
+    const __m256i wb = _mm256_set1_epi16 (weight);
+    const __m256i round = _mm256_set1_epi16 (128);
+    for (; i + 16 <= count; i += 16) {
+        __m256i pa = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i*) (a + i)));
+        __m256i pb = _mm256_cvtepu8_epi16 (_mm_loadu_si128 ((const __m128i*) (b + i)));
+        __m256i r = _mm256_add_epi16 (_mm256_mullo_epi16 (pa, wa),
+                                      _mm256_mullo_epi16 (pb, wb));
+        r = _mm256_srli_epi16 (_mm256_add_epi16 (r, round), 8);
+        __m128i p = _mm_packus_epi16 (_mm256_castsi256_si128 (r),
+                                      _mm256_extracti128_si256 (r, 1));
+        _mm_storeu_si128 ((__m128i*) (dst + i), p);
+    }
+
+    return i;
+}
+#endif
+
+#ifdef QCCTV_SCALER_SSE2
+static int blend_sse2 (uchar* dst, const uchar* a, const uchar* b,
+                       const int count, const int weight)
+{
+    int i = 0;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wa = _mm_set1_epi16 (256 - weight);
+    const __m128i wb = _mm_set1_epi16 (weight);
+    const __m128i round = _mm_set1_epi16 (128);
+    for (; i + 16 <= count; i += 16) {
+        __m128i pa = _mm_loadu_si128 ((const __m128i*) (a + i));
+        __m128i pb = _mm_loadu_si128 ((const __m128i*) (b + i));
+        __m128i lo = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpacklo_epi8 (pa, zero), wa),
+                                    _mm_mullo_epi16 (_mm_unpacklo_epi8 (pb, zero), wb));
+        __m128i hi = _mm_add_epi16 (_mm_mullo_epi16 (_mm_unpackhi_epi8 (pa, zero), wa),
+                                    _mm_mullo_epi16 (_mm_unpackhi_epi8 (pb, zero), wb));
+        lo = _mm_srli_epi16 (_mm_add_epi16 (lo, round), 8);
+        hi = _mm_srli_epi16 (_mm_add_epi16 (hi, round), 8);
+        _mm_storeu_si128 ((__m128i*) (dst + i), _mm_packus_epi16 (lo, hi));
+    }
+
+    return i;
+}
+#endif
+
+#ifdef QCCTV_SCALER_NEON
+static int blend_neon (uchar* dst, const uchar* a, const uchar* b,
+                       const int count, const int weight)
+{
+    int i = 0;
+    const uint8x8_t wa = vdup_n_u8 ((uint8_t) (256 - weight));
+    const uint8x8_t wb = vdup_n_u8 ((uint8_t) weight);
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t r = vmull_u8 (vld1_u8 (a + i), wa);
+        r = vmlal_u8 (r, vld1_u8 (b + i), wb);
+        vst1_u8 (dst + i, vrshrn_n_u16 (r, 8));
+    }
+
+    return i;
+}
+#endif
+
+/**
+ * Blends the rows \a a and \a b with the given \a weight (from 0 to 256,
+ * where 0 returns \a a) and writes the result to \a dst
+ */
+static void blend_rows (uchar* dst, const uchar* a, const uchar* b,
+                        const int count, const int weight)
+{
+    if (weight <= 0) {
+        memcpy (dst, a, count);
+        return;
+    }
+
+    if (weight >= 256) {
+        memcpy (dst, b, count);
+        return;
+    }
+
+    int i = 0;
+    const int simd = QCCTV_EnabledSimd();
+    Q_UNUSED (simd);
+
+#ifdef QCCTV_SCALER_AVX2
+    if (simd & QCCTV_SIMD_AVX2)
+        i = blend_avx2 (dst, a, b, count, weight);
+#endif
+#ifdef QCCTV_SCALER_SSE2
+    if (simd & QCCTV_SIMD_SSE2)
+        i += blend_sse2 (dst + i, a + i, b + i, count - i, weight);
+#endif
+#ifdef QCCTV_SCALER_NEON
+    if (simd & QCCTV_SIMD_NEON)
+        i += blend_neon (dst + i, a + i, b + i, count - i, weight);
+#endif
+
+    for (; i < count; ++i)
+        dst [i] = (a [i] * (256 - weight) + b [i] * weight + 128) >> 8;
+}
+
+/*
+ * Column reduction kernels for 4-channel planes, for each pixel and channel:
+ * dst = (sum of the fx accumulators of the block * scale + 32768) >> 16
+ * (the sum always fits in 16 bits and the scale is at most 32768)
+ */
+
+#ifdef QCCTV_SCALER_SSE2
+static int reduce4_sse2 (uchar* dst, const quint16* acc, const int width,
+                         const int fx, const int scale)
+{
+    int x = 0;
+    const __m128i s = _mm_set1_epi16 ((short) scale);
+    for (; x + 2 <= width; x += 2) {
+        const quint16* a = acc + x * fx * 4;
+        const quint16* b = a + fx * 4;
+
+        __m128i sum = _mm_setzero_si128();
+        for (int k = 0; k < fx; ++k) {
+            __m128i pa = _mm_loadl_epi64 ((const __m128i*) (a + k * 4));
+            __m128i pb = _mm_loadl_epi64 ((const __m128i*) (b + k * 4));
+            sum = _mm_add_epi16 (sum, _mm_unpacklo_epi64 (pa, pb));
+        }
+
+        /* Get the rounded high half of the 32-bit products */
+        __m128i r = _mm_add_epi16 (_mm_mulhi_epu16 (sum, s),
+                                   _mm_srli_epi16 (_mm_mullo_epi16 (sum, s), 15));
+        _mm_storel_epi64 ((__m128i*) (dst + x * 4), _mm_packus_epi16 (r, r));
+    }
+
+    return x;
+}
+#endif
+
+#ifdef QCCTV_SCALER_NEON
+static int reduce4_neon (uchar* dst, const quint16* acc, const int width,
+                         const int fx, const int scale)
+{
+    int x = 0;
+    for (; x + 2 <= width; x += 2) {
+        const quint16* a = acc + x * fx * 4;
+        const quint16* b = a + fx * 4;
+
+        uint16x8_t sum = vdupq_n_u16 (0);
+        for (int k = 0; k < fx; ++k)
+            sum = vaddq_u16 (sum, vcombine_u16 (vld1_u16 (a + k * 4),
+                                                vld1_u16 (b + k * 4)));
+
+        uint32x4_t lo = vmull_n_u16 (vget_low_u16 (sum), (uint16_t) scale);
+        uint32x4_t hi = vmull_n_u16 (vget_high_u16 (sum), (uint16_t) scale);
+        uint16x8_t r = vcombine_u16 (vrshrn_n_u32 (lo, 16),
+                                     vrshrn_n_u32 (hi, 16));
+        vst1_u8 (dst + x * 4, vqmovn_u16 (r));
+    }
+
+    return x;
+}
+#endif
+
+/**
+ * Sums each block of \a fx accumulators (per channel) of the \a acc row and
+ * writes the average of the block (given the \a scale of the block area)
+ * to the \a dst row, which is \a width pixels wide
+ */
+static void reduce_row (uchar* dst, const quint16* acc, const int width,
+                        const int channels, const int fx, const int scale)
+{
+    int x = 0;
+    const int simd = QCCTV_EnabledSimd();
+    Q_UNUSED (simd);
+
+    if (channels == 4) {
+#ifdef QCCTV_SCALER_SSE2
+        if (simd & QCCTV_SIMD_SSE2)
+            x = reduce4_sse2 (dst, acc, width, fx, scale);
+#endif
+#ifdef QCCTV_SCALER_NEON
+        if (simd & QCCTV_SIMD_NEON)
+            x = reduce4_neon (dst, acc, width, fx, scale);
+#endif
+    }
+
+    const quint16* in = acc + x * fx * channels;
+    uchar* out = dst + x * channels;
+    for (; x < width; ++x) {
+        for (int c = 0; c < channels; ++c) {
+            quint32 sum = 0;
+            for (int k = 0; k < fx; ++k)
+                sum += in [k * channels + c];
+
+            out [c] = (uchar) ((sum * scale + (1 << 15)) >> 16);
+        }
+
+        in += fx * channels;
+        out += channels;
+    }
+}
+
+/**
+ * Returns the scale factor (in 16.16 fixed point) that turns the sum of a
+ * \a fx x \a fy block of pixels into their average
+ */
+static int box_scale (const int fx, const int fy)
+{
+    return ((1 << 16) + (fx * fy) / 2) / (fx * fy);
+}
+
+/**
+ * Writes the row \a y of the \a src plane reduced by the integer factors
+ * \a fx and \a fy (by averaging each \a fx x \a fy block of pixels) to the
+ * \a dst row, the \a acc row must hold \a dstWidth * \a fx * \a channels
+ * accumulators
+ */
+static void box_row (const uchar* src, const int srcStride, uchar* dst,
+                     const int dstWidth, const int channels, const int fx,
+                     const int fy, const int y, quint16* acc)
+{
+    const int count = dstWidth * fx * channels;
+
+    /* Sum the rows of the block */
+    memset (acc, 0, count * sizeof (quint16));
+    for (int r = 0; r < fy; ++r)
+        accumulate_row (acc, src + (y * fy + r) * srcStride, count);
+
+    /* Sum the columns of the block and get the average */
+    reduce_row (dst, acc, dstWidth, channels, fx, box_scale (fx, fy));
+}
+
+/**
+ * Reduces the \a src plane by the integer factors \a fx and \a fy by
+ * averaging each \a fx x \a fy block of pixels
+ */
+static void box_filter (const uchar* src, const int srcStride,
+                        uchar* dst, const int dstWidth, const int dstHeight,
+                        const int dstStride, const int channels,
+                        const int fx, const int fy)
+{
+    QVector<quint16> acc (dstWidth * fx * channels);
+    for (int y = 0; y < dstHeight; ++y)
+        box_row (src, srcStride, dst + y * dstStride, dstWidth, channels,
+                 fx, fy, y, acc.data());
+}
+
+/**
+ * Rows read by the bilinear filter, which are either the rows of the source
+ * plane or the rows of the source plane reduced by the box filter. Reduced
+ * rows are generated when they are needed, and only the last two are kept
+ * (the bilinear filter reads the rows in order), so that we never allocate
+ * and write the whole reduced plane
+ */
+struct QCCTV_ScalerRows {
+    const uchar* src;
+    int srcStride;
+    int width;
+    int channels;
+    int fx;
+    int fy;
+    int cached [2];
+    QVector<uchar> rows [2];
+    QVector<quint16> acc;
+};
+
+/**
+ * Returns the row \a y of the given \a rows
+ */
+static const uchar* scaler_row (QCCTV_ScalerRows* rows, const int y)
+{
+    if (rows->fx == 1 && rows->fy == 1)
+        return rows->src + y * rows->srcStride;
+
+    const int slot = y & 1;
+    if (rows->cached [slot] != y) {
+        box_row (rows->src, rows->srcStride, rows->rows [slot].data(),
+                 rows->width, rows->channels, rows->fx, rows->fy, y,
+                 rows->acc.data());
+        rows->cached [slot] = y;
+    }
+
+    return rows->rows [slot].constData();
+}
+
+/*
+ * Column interpolation kernels for 4-channel rows, for each pixel and
+ * channel: dst = (row [x0] * (256 - w) + row [x1] * w + 128) >> 8
+ */
+
+/**
+ * Returns the 4-channel pixel at the given \a data address
+ */
+static inline quint32 load_pixel (const uchar* data)
+{
+    quint32 pixel;
+    memcpy (&pixel, data, sizeof (pixel));
+    return pixel;
+}
+
+#ifdef QCCTV_SCALER_SSE2
+static int interpolate4_sse2 (uchar* dst, const uchar* row, const int* x0,
+                              const int* x1, const int* wx, const int width)
+{
+    int x = 0;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16 (128);
+    const __m128i full = _mm_set1_epi16 (256);
+    for (; x + 2 <= width; x += 2) {
+        __m128i a = _mm_unpacklo_epi32 (
+                        _mm_cvtsi32_si128 ((int) load_pixel (row + x0 [x])),
+                        _mm_cvtsi32_si128 ((int) load_pixel (row + x0 [x + 1])));
+        __m128i b = _mm_unpacklo_epi32 (
+                        _mm_cvtsi32_si128 ((int) load_pixel (row + x1 [x])),
+                        _mm_cvtsi32_si128 ((int) load_pixel (row + x1 [x + 1])));
+        __m128i w = _mm_unpacklo_epi64 (_mm_set1_epi16 ((short) wx [x]),
+                                        _mm_set1_epi16 ((short) wx [x + 1]));
+
+        __m128i r = _mm_add_epi16 (
+                        _mm_mullo_epi16 (_mm_unpacklo_epi8 (a, zero),
+                                         _mm_sub_epi16 (full, w)),
+                        _mm_mullo_epi16 (_mm_unpacklo_epi8 (b, zero), w));
+        r = _mm_srli_epi16 (_mm_add_epi16 (r, round), 8);
+        _mm_storel_epi64 ((__m128i*) (dst + x * 4), _mm_packus_epi16 (r, r));
+    }
+
+    return x;
+}
+#endif
+
+#ifdef QCCTV_SCALER_NEON
+static int interpolate4_neon (uchar* dst, const uchar* row, const int* x0,
+                              const int* x1, const int* wx, const int width)
+{
+    int x = 0;
+    const uint16x8_t full = vdupq_n_u16 (256);
+    for (; x + 2 <= width; x += 2) {
+        uint8x8_t a = vreinterpret_u8_u32 (vset_lane_u32 (load_pixel (row + x0 [x + 1]),
+                                           vdup_n_u32 (load_pixel (row + x0 [x])), 1));
+        uint8x8_t b = vreinterpret_u8_u32 (vset_lane_u32 (load_pixel (row + x1 [x + 1]),
+                                           vdup_n_u32 (load_pixel (row + x1 [x])), 1));
+        uint16x8_t w = vcombine_u16 (vdup_n_u16 ((uint16_t) wx [x]),
+                                     vdup_n_u16 ((uint16_t) wx [x + 1]));
+
+        uint16x8_t r = vmulq_u16 (vmovl_u8 (a), vsubq_u16 (full, w));
+        r = vmlaq_u16 (r, vmovl_u8 (b), w);
+        vst1_u8 (dst + x * 4, vrshrn_n_u16 (r, 8));
+    }
+
+    return x;
+}
+#endif
+
+/**
+ * Interpolates the columns \a x0 and \a x1 of the \a row with the weights
+ * \a wx for each of the \a width pixels of the \a dst row
+ */
+static void interpolate_row (uchar* dst, const uchar* row, const int* x0,
+                             const int* x1, const int* wx, const int width,
+                             const int channels)
+{
+    int x = 0;
+    const int simd = QCCTV_EnabledSimd();
+    Q_UNUSED (simd);
+
+    if (channels == 4) {
+#ifdef QCCTV_SCALER_SSE2
+        if (simd & QCCTV_SIMD_SSE2)
+            x = interpolate4_sse2 (dst, row, x0, x1, wx, width);
+#endif
+#ifdef QCCTV_SCALER_NEON
+        if (simd & QCCTV_SIMD_NEON)
+            x = interpolate4_neon (dst, row, x0, x1, wx, width);
+#endif
+    }
+
+    uchar* out = dst + x * channels;
+    for (; x < width; ++x) {
+        const int w = wx [x];
+        for (int c = 0; c < channels; ++c)
+            out [c] = (row [x0 [x] + c] * (256 - w) +
+                       row [x1 [x] + c] * w + 128) >> 8;
+
+        out += channels;
+    }
+}
+
+/**
+ * Returns the source position (in 24.8 fixed point) of the center of the
+ * given destination pixel, clamped to the source bounds
+ */
+static int source_position (const int pos, const int srcSize, const int dstSize)
+{
+    int p = (int) ((((qint64) pos * 2 + 1) * srcSize * 128) / dstSize) - 128;
+    return qMax (qMin (p, (srcSize - 1) * 256), 0);
+}
+
+/**
+ * Resamples the given source \a rows (which are \a srcWidth x \a srcHeight
+ * pixels) to the size of the \a dst plane using bilinear interpolation
+ */
+static void bilinear_filter (QCCTV_ScalerRows* rows, const int srcWidth,
+                             const int srcHeight, uchar* dst,
+                             const int dstWidth, const int dstHeight,
+                             const int dstStride, const int channels)
+{
+    /* Get the source columns and weights of each destination column */
+    QVector<int> x0 (dstWidth);
+    QVector<int> x1 (dstWidth);
+    QVector<int> wx (dstWidth);
+    for (int x = 0; x < dstWidth; ++x) {
+        const int p = source_position (x, srcWidth, dstWidth);
+        x0 [x] = (p >> 8) * channels;
+        x1 [x] = qMin ((p >> 8) + 1, srcWidth - 1) * channels;
+        wx [x] = p & 0xff;
+    }
+
+    /* Blend the rows first, then the columns */
+    QVector<uchar> row (srcWidth * channels);
+    for (int y = 0; y < dstHeight; ++y) {
+        const int p = source_position (y, srcHeight, dstHeight);
+        const int y0 = p >> 8;
+        const int y1 = qMin (y0 + 1, srcHeight - 1);
+
+        const uchar* a = scaler_row (rows, y0);
+        const uchar* b = scaler_row (rows, y1);
+        blend_rows (row.data(), a, b, srcWidth * channels, p & 0xff);
+
+        interpolate_row (dst + y * dstStride, row.constData(),
+                         x0.constData(), x1.constData(), wx.constData(),
+                         dstWidth, channels);
+    }
+}
+
+/**
+ * Downscales the given \a src plane (with the given number of interleaved
+ * \a channels) to the size of the \a dst plane.
+ *
+ * If \a mode is \c QCCTV_SCALE_AREA, the plane is first reduced by the
+ * largest integer factor that does not go below the destination size. The
+ * remaining (less than 2x) reduction is done with bilinear interpolation
+ */
+void QCCTV_ScalePlane (const uchar* src,
+                       const int srcWidth,
+                       const int srcHeight,
+                       const int srcStride,
+                       uchar* dst,
+                       const int dstWidth,
+                       const int dstHeight,
+                       const int dstStride,
+                       const int channels,
+                       const int mode)
+{
+    if (!src || !dst || dstWidth <= 0 || dstHeight <= 0)
+        return;
+
+    /* Get integer reduction factors */
+    int fx = 1;
+    int fy = 1;
+    if (mode == QCCTV_SCALE_AREA) {
+        fx = qMax (qMin (srcWidth / dstWidth, MAX_BOX_FACTOR), 1);
+        fy = qMax (qMin (srcHeight / dstHeight, MAX_BOX_FACTOR), 1);
+    }
+
+    /* Box filter gives the final size */
+    const int boxWidth = srcWidth / fx;
+    const int boxHeight = srcHeight / fy;
+    if ((fx > 1 || fy > 1) && boxWidth == dstWidth && boxHeight == dstHeight) {
+        box_filter (src, srcStride, dst, dstWidth, dstHeight, dstStride,
+                    channels, fx, fy);
+        return;
+    }
+
+    /* Interpolate the (reduced) source rows */
+    QCCTV_ScalerRows rows;
+    rows.src = src;
+    rows.srcStride = srcStride;
+    rows.width = boxWidth;
+    rows.channels = channels;
+    rows.fx = fx;
+    rows.fy = fy;
+    rows.cached [0] = -1;
+    rows.cached [1] = -1;
+    if (fx > 1 || fy > 1) {
+        rows.rows [0].resize (boxWidth * channels);
+        rows.rows [1].resize (boxWidth * channels);
+        rows.acc.resize (boxWidth * fx * channels);
+    }
+
+    bilinear_filter (&rows, boxWidth, boxHeight, dst, dstWidth, dstHeight,
+                     dstStride, channels);
+}
+
+/**
+ * Downscales the given \a image to the given \a size using the given
+ * scaling \a mode.
+ *
+ * Grayscale, 24-bit RGB and 32-bit RGB images are scaled in place, other
+ * images are converted to 32-bit RGB first. If the given \a size is larger
+ * than the image, this function shall use the (nearest-neighbour) scaling
+ * provided by Qt
+ */
+QImage QCCTV_DownscaleImage (const QImage& image,
+                             const QSize& size,
+                             const int mode)
+{
+    /* Invalid size or upscaling */
+    if (image.isNull() || size.isEmpty() ||
+        size.width() > image.width() || size.height() > image.height())
+        return image.scaled (size, Qt::IgnoreAspectRatio,
+                             Qt::FastTransformation);
+
+    /* Nothing to do */
+    if (size == image.size())
+        return image;
+
+    /* Get source image in a supported format */
+    QImage source = image;
+    switch (source.format()) {
+    case QImage::Format_Grayscale8:
+    case QImage::Format_RGB888:
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        break;
+    default:
+        source = source.convertToFormat (QImage::Format_RGB32);
+        break;
+    }
+
+    /* Scale the image */
+    QImage scaled (size, source.format());
+    QCCTV_ScalePlane (source.constBits(),
+                      source.width(),
+                      source.height(),
+                      source.bytesPerLine(),
+                      scaled.bits(),
+                      scaled.width(),
+                      scaled.height(),
+                      scaled.bytesPerLine(),
+                      source.depth() / 8,
+                      mode);
+
+    return scaled;
+}
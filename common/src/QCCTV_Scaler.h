@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_SCALER_H
+#define _QCCTV_SCALER_H
+
+#include <QImage>
+
+/*
+ * Fixed-point image downscaler. Images are first reduced by an integer factor
+ * using area averaging (box filter) and then resampled to the final size with
+ * a bilinear filter, which avoids the aliasing of nearest-neighbour scaling.
+ *
+ * The inner loops use SSE2, AVX2 or NEON when they are available
+ */
+extern void QCCTV_ScalePlane (const uchar* src,
+                              const int srcWidth,
+                              const int srcHeight,
+                              const int srcStride,
+                              uchar* dst,
+                              const int dstWidth,
+                              const int dstHeight,
+                              const int dstStride,
+                              const int channels,
+                              const int mode);
+
+extern QImage QCCTV_DownscaleImage (const QImage& image,
+                                    const QSize& size,
+                                    const int mode);
+
+#endif
@@ -0,0 +1,418 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_Session.h"
+
+#include <QTimer>
+#include <QTcpSocket>
+
+/* Frame types */
+static const quint8 FRAME_IMAGE   = 0x01;
+static const quint8 FRAME_INFO    = 0x02;
+static const quint8 FRAME_COMMAND = 0x03;
+static const quint8 FRAME_ACK     = 0x04;
+static const quint8 FRAME_HELLO   = 0x05;
+static const quint8 FRAME_NACK    = 0x06;
+static const quint8 FRAME_SHARED  = 0x07;
+
+/* Frame flags */
+static const quint8 FLAG_MORE_FRAGMENTS = 0x01;
+static const quint8 FLAG_RETRANSMISSION = 0x02;
+
+/* Type, flags and 32-bit payload length */
+static const int HEADER_SIZE = 6;
+
+/**
+ * Returns the header of a frame with the given \a type, \a flags and payload
+ * \a length
+ */
+static QByteArray frame_header (const quint8 type,
+                                const quint8 flags,
+                                const quint32 length)
+{
+    QByteArray header;
+    header.append ((char) type);
+    header.append ((char) flags);
+    header.append ((char) ((length & 0xff000000) >> 24));
+    header.append ((char) ((length & 0xff0000) >> 16));
+    header.append ((char) ((length & 0xff00) >> 8));
+    header.append ((char) (length & 0xff));
+    return header;
+}
+
+/**
+ * Creates a session on the given (connected) \a socket. The session does not
+ * take ownership of the socket
+ */
+QCCTV_Session::QCCTV_Session (QTcpSocket* socket, QObject* parent) :
+    QObject (parent)
+{
+    m_offset = 0;
+    m_imageFlags = 0;
+    m_currentFlags = 0;
+    m_resync = false;
+    m_socket = socket;
+    m_maxFrameSize = QCCTV_MAX_SNAPSHOT_SIZE;
+
+    connect (m_socket, SIGNAL (readyRead()),
+             this,       SLOT (readFrames()));
+    connect (m_socket, SIGNAL (bytesWritten (qint64)),
+             this,       SLOT (writeFrames()));
+
+    /* Resumes the image fragments held back by the pacer */
+    m_pacingTimer = new QTimer (this);
+    m_pacingTimer->setSingleShot (true);
+    m_pacingTimer->setTimerType (Qt::PreciseTimer);
+    connect (m_pacingTimer, SIGNAL (timeout()),
+             this,            SLOT (writeFrames()));
+}
+
+/**
+ * Returns the TCP socket used by the session
+ */
+QTcpSocket* QCCTV_Session::socket() const
+{
+    return m_socket;
+}
+
+/**
+ * Returns the maximum size of the images that we accept
+ */
+int QCCTV_Session::maxFrameSize() const
+{
+    return m_maxFrameSize;
+}
+
+/**
+ * Returns \c true if we did not start sending the last live image yet
+ */
+bool QCCTV_Session::imagePending() const
+{
+    return !m_liveImage.isEmpty();
+}
+
+/**
+ * Returns the pacer used for the image fragments (disabled by default)
+ */
+QCCTV_Pacer* QCCTV_Session::pacer()
+{
+    return &m_pacer;
+}
+
+/**
+ * Tells the other side that we received its last frame (and that we have
+ * nothing else to say)
+ */
+void QCCTV_Session::sendAck()
+{
+    sendControl (FRAME_ACK, QByteArray());
+}
+
+/**
+ * Changes the maximum \a size of the images that we accept, the connection
+ * is aborted if the other side sends larger images
+ */
+void QCCTV_Session::setMaxFrameSize (const int size)
+{
+    m_maxFrameSize = size;
+}
+
+/**
+ * Queues the given hello packet \a data
+ */
+void QCCTV_Session::sendHello (const QByteArray& data)
+{
+    sendControl (FRAME_HELLO, data);
+}
+
+/**
+ * Asks the other side to retransmit the (multicast) frame with the given
+ * \a id
+ */
+void QCCTV_Session::sendNack (const quint16 id)
+{
+    QByteArray data;
+    data.append ((char) ((id & 0xff00) >> 8));
+    data.append ((char) (id & 0xff));
+    sendControl (FRAME_NACK, data);
+}
+
+/**
+ * Queues the given info packet \a data
+ */
+void QCCTV_Session::sendInfo (const QByteArray& data)
+{
+    sendControl (FRAME_INFO, data);
+}
+
+/**
+ * Queues the given live image packet \a data, which replaces the previous
+ * live image if we did not start sending it yet.
+ *
+ * Images that are not \a selfContained (delta frames and abbreviated JPEG
+ * data without tables) cannot replace the previous image, because they
+ * depend on it. In that case the image is dropped, along with the next
+ * images, until we get a self-contained image. The \c resyncRequested()
+ * signal is emitted so that the other side asks the encoder for one
+ */
+void QCCTV_Session::sendImage (const QByteArray& data,
+                               const bool selfContained)
+{
+    if (data.isEmpty())
+        return;
+
+    /* Image depends on an image that the other side will not receive */
+    if (!selfContained && (m_resync || !m_liveImage.isEmpty())) {
+        m_resync = true;
+        emit resyncRequested();
+        return;
+    }
+
+    m_resync = false;
+    m_liveImage = data;
+    writeFrames();
+}
+
+/**
+ * Queues the given command packet \a data
+ */
+void QCCTV_Session::sendCommand (const QByteArray& data)
+{
+    sendControl (FRAME_COMMAND, data);
+}
+
+/**
+ * Queues the given snapshot packet \a data, snapshots are sent as image
+ * frames, but they are never replaced by newer images
+ */
+void QCCTV_Session::sendSnapshot (const QByteArray& data)
+{
+    if (!data.isEmpty()) {
+        m_snapshots.append (data);
+        writeFrames();
+    }
+}
+
+/**
+ * Queues the given image \a data, which is a retransmission of the lost
+ * (multicast) frame with the given \a id. Retransmissions are sent before
+ * the other images
+ */
+void QCCTV_Session::sendRetransmission (const quint16 id,
+                                        const QByteArray& data)
+{
+    if (!data.isEmpty()) {
+        QByteArray frame;
+        frame.append ((char) ((id & 0xff00) >> 8));
+        frame.append ((char) (id & 0xff));
+        m_retransmissions.append (frame + data);
+        writeFrames();
+    }
+}
+
+/**
+ * Tells the other side that the next image is in the given shared memory
+ * \a slot, with the given \a sequence number
+ */
+void QCCTV_Session::sendSharedFrame (const quint16 slot,
+                                     const quint32 sequence)
+{
+    QByteArray data;
+    data.append ((char) ((slot & 0xff00) >> 8));
+    data.append ((char) (slot & 0xff));
+    data.append ((char) ((sequence & 0xff000000) >> 24));
+    data.append ((char) ((sequence & 0xff0000) >> 16));
+    data.append ((char) ((sequence & 0xff00) >> 8));
+    data.append ((char) (sequence & 0xff));
+    sendControl (FRAME_SHARED, data);
+}
+
+/**
+ * Reads the complete frames received by the socket and emits the signals
+ * that correspond to each frame type. Image fragments are joined before
+ * being reported.
+ *
+ * The connection is aborted if the other side sends invalid frames
+ */
+void QCCTV_Session::readFrames()
+{
+    m_buffer.append (m_socket->readAll());
+
+    while (m_buffer.size() >= HEADER_SIZE) {
+        /* Read the frame header */
+        quint8 type = m_buffer.at (0);
+        quint8 flags = m_buffer.at (1);
+        quint32 length = ((quint8) m_buffer.at (2) << 24) |
+                         ((quint8) m_buffer.at (3) << 16) |
+                         ((quint8) m_buffer.at (4) << 8) |
+                         ((quint8) m_buffer.at (5));
+
+        /* Frame is too large, the stream is corrupted */
+        if (length > QCCTV_MAX_BUFFER_SIZE) {
+            m_buffer.clear();
+            m_socket->abort();
+            return;
+        }
+
+        /* Wait for the rest of the frame */
+        if ((quint32) m_buffer.size() < HEADER_SIZE + length)
+            return;
+
+        /* Get the payload */
+        QByteArray payload = m_buffer.mid (HEADER_SIZE, length);
+        m_buffer.remove (0, HEADER_SIZE + length);
+
+        /* Join image fragments */
+        if (type == FRAME_IMAGE) {
+            m_image.append (payload);
+            m_imageFlags |= flags;
+            if (m_image.size() > m_maxFrameSize) {
+                m_image.clear();
+                m_buffer.clear();
+                m_socket->abort();
+                return;
+            }
+
+            if (!(flags & FLAG_MORE_FRAGMENTS)) {
+                QByteArray image = m_image;
+                bool retransmission = m_imageFlags & FLAG_RETRANSMISSION;
+                m_image.clear();
+                m_imageFlags = 0;
+
+                /* Retransmitted frames start with their ID */
+                if (retransmission && image.size() > 2) {
+                    quint16 id = ((quint8) image.at (0) << 8) |
+                                 (quint8) image.at (1);
+                    emit retransmissionReceived (id, image.mid (2));
+                }
+
+                else if (!retransmission)
+                    emit imageReceived (image);
+            }
+        }
+
+        /* Control frames */
+        else if (type == FRAME_INFO)
+            emit infoReceived (payload);
+        else if (type == FRAME_COMMAND)
+            emit commandReceived (payload);
+        else if (type == FRAME_ACK)
+            emit ackReceived();
+        else if (type == FRAME_HELLO)
+            emit helloReceived (payload);
+        else if (type == FRAME_NACK && payload.size() == 2)
+            emit nackReceived (((quint8) payload.at (0) << 8) |
+                               (quint8) payload.at (1));
+        else if (type == FRAME_SHARED && payload.size() == 6)
+            emit sharedFrameReceived (((quint8) payload.at (0) << 8) |
+                                      (quint8) payload.at (1),
+                                      ((quint8) payload.at (2) << 24) |
+                                      ((quint8) payload.at (3) << 16) |
+                                      ((quint8) payload.at (4) << 8) |
+                                      (quint8) payload.at (5));
+    }
+}
+
+/**
+ * Hands the queued frames to the socket while its write buffer is below the
+ * watermark. Control frames are written first, image frames are written in
+ * fragments, so that control frames do not wait for a whole image.
+ *
+ * The fragments are written straight from the (shared) image data when
+ * possible, see \c QCCTV_WriteSocket()
+ */
+void QCCTV_Session::writeFrames()
+{
+    while (m_socket->isWritable() &&
+           m_socket->bytesToWrite() < QCCTV_SESSION_WATERMARK) {
+        /* Write control frames first */
+        if (!m_control.isEmpty()) {
+            QCCTV_WriteSocket (m_socket, m_control.takeFirst(), Q_NULLPTR, 0);
+            continue;
+        }
+
+        /* Start sending the next image (retransmissions and snapshots first) */
+        if (m_current.isEmpty()) {
+            m_offset = 0;
+            m_currentFlags = 0;
+            if (!m_retransmissions.isEmpty()) {
+                m_current = m_retransmissions.takeFirst();
+                m_currentFlags = FLAG_RETRANSMISSION;
+            }
+
+            else if (!m_snapshots.isEmpty())
+                m_current = m_snapshots.takeFirst();
+            else if (!m_liveImage.isEmpty()) {
+                m_current = m_liveImage;
+                m_liveImage.clear();
+            }
+
+            else
+                return;
+        }
+
+        /* Get the length of the next fragment */
+        int length = qMin (m_current.size() - m_offset,
+                           QCCTV_SESSION_FRAGMENT_SIZE);
+
+        /* Wait until the pacer lets the fragment through */
+        if (m_pacer.isEnabled()) {
+            length = qMin (length, m_pacer.burst());
+
+            int wait = m_pacer.delay (length);
+            if (wait > 0) {
+                if (!m_pacingTimer->isActive())
+                    m_pacingTimer->start (wait);
+
+                return;
+            }
+
+            m_pacer.consume (length);
+        }
+
+        /* Write the next fragment */
+        bool last = (m_offset + length >= m_current.size());
+        quint8 flags = m_currentFlags;
+        if (!last)
+            flags |= FLAG_MORE_FRAGMENTS;
+
+        QCCTV_WriteSocket (m_socket, frame_header (FRAME_IMAGE, flags, length),
+                           m_current.constData() + m_offset, length);
+
+        /* Image was sent */
+        m_offset += length;
+        if (last) {
+            m_offset = 0;
+            m_current.clear();
+        }
+    }
+}
+
+/**
+ * Queues a control frame with the given \a type and payload \a data
+ */
+void QCCTV_Session::sendControl (const quint8 type, const QByteArray& data)
+{
+    m_control.append (frame_header (type, 0, data.size()) + data);
+    writeFrames();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_SESSION_H
+#define _QCCTV_SESSION_H
+
+#include <QList>
+#include <QObject>
+#include <QByteArray>
+
+#include "QCCTV_Pacer.h"
+
+class QTimer;
+class QTcpSocket;
+
+/**
+ * \brief Multiplexes images, info, command and ack frames over a single TCP
+ *        connection between a camera and a station.
+ *
+ * Each frame starts with a type byte, a flags byte and the (big-endian)
+ * length of the payload. Image frames are sent in fragments, and pending
+ * control frames are always written before the next fragment. A live image
+ * that was not started yet is replaced by newer self-contained live images
+ * (keyframes with their JPEG tables), snapshots are never dropped. If a
+ * newer live image depends on the one that is waiting, it is dropped and
+ * the live images are skipped until the next self-contained image.
+ *
+ * Both sides send a hello frame when the session starts (see
+ * \c QCCTV_HelloPacket), frames with an unknown type are ignored.
+ *
+ * Stations that receive the images through multicast use the session to
+ * ask for lost frames (NACK), which are retransmitted as image frames with
+ * the ID of the lost frame.
+ *
+ * Stations in the same host as the camera read the images from shared
+ * memory, the session only tells them which slot to read.
+ *
+ * Image fragments can be paced (see \c QCCTV_Pacer) so that a frame is not
+ * written to the network in a single burst, control frames are never paced.
+ */
+class QCCTV_Session : public QObject
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void ackReceived();
+    void resyncRequested();
+    void helloReceived (const QByteArray& data);
+    void nackReceived (const quint16 id);
+    void infoReceived (const QByteArray& data);
+    void imageReceived (const QByteArray& data);
+    void commandReceived (const QByteArray& data);
+    void retransmissionReceived (const quint16 id, const QByteArray& data);
+    void sharedFrameReceived (const quint16 slot, const quint32 sequence);
+
+public:
+    explicit QCCTV_Session (QTcpSocket* socket, QObject* parent = Q_NULLPTR);
+
+    QTcpSocket* socket() const;
+    int maxFrameSize() const;
+    bool imagePending() const;
+    QCCTV_Pacer* pacer();
+
+public Q_SLOTS:
+    void sendAck();
+    void setMaxFrameSize (const int size);
+    void sendHello (const QByteArray& data);
+    void sendNack (const quint16 id);
+    void sendInfo (const QByteArray& data);
+    void sendImage (const QByteArray& data, const bool selfContained);
+    void sendCommand (const QByteArray& data);
+    void sendSnapshot (const QByteArray& data);
+    void sendRetransmission (const quint16 id, const QByteArray& data);
+    void sendSharedFrame (const quint16 slot, const quint32 sequence);
+
+private Q_SLOTS:
+    void readFrames();
+    void writeFrames();
+
+private:
+    void sendControl (const quint8 type, const QByteArray& data);
+
+private:
+    QTcpSocket* m_socket;
+    QTimer* m_pacingTimer;
+    QCCTV_Pacer m_pacer;
+
+    QByteArray m_buffer;
+    QByteArray m_image;
+    quint8 m_imageFlags;
+
+    int m_offset;
+    int m_maxFrameSize;
+    QByteArray m_current;
+    quint8 m_currentFlags;
+    QByteArray m_liveImage;
+    bool m_resync;
+    QList<QByteArray> m_control;
+    QList<QByteArray> m_snapshots;
+    QList<QByteArray> m_retransmissions;
+};
+
+#endif
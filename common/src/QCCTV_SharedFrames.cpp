@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_SharedFrames.h"
+
+#include <string.h>
+#include <QSharedMemory>
+#include <QCoreApplication>
+
+/* Sequence number and length of the frame in each slot */
+static const int SLOT_HEADER_SIZE = 2 * sizeof (quint32);
+static const int SLOT_SIZE = SLOT_HEADER_SIZE + QCCTV_MAX_BUFFER_SIZE;
+
+/**
+ * Initializes the class, no segment is created or attached
+ */
+QCCTV_SharedFrames::QCCTV_SharedFrames()
+{
+    m_sequence = 0;
+    m_memory = Q_NULLPTR;
+}
+
+/**
+ * Detaches from the segment (the segment is destroyed with its last user)
+ */
+QCCTV_SharedFrames::~QCCTV_SharedFrames()
+{
+#ifndef QT_NO_SHAREDMEMORY
+    delete m_memory;
+#endif
+}
+
+/**
+ * Returns the key of the segment, which is given to the stations
+ */
+QString QCCTV_SharedFrames::key() const
+{
+#ifndef QT_NO_SHAREDMEMORY
+    if (m_memory)
+        return m_memory->key();
+#endif
+
+    return "";
+}
+
+/**
+ * Returns \c true if we created or attached to a segment
+ */
+bool QCCTV_SharedFrames::isValid() const
+{
+#ifndef QT_NO_SHAREDMEMORY
+    return m_memory && m_memory->isAttached();
+#else
+    return false;
+#endif
+}
+
+/**
+ * Creates a new segment (with a random key) in which we write the frames,
+ * returns \c false if shared memory is not available
+ */
+bool QCCTV_SharedFrames::create()
+{
+#ifndef QT_NO_SHAREDMEMORY
+    if (m_memory)
+        return isValid();
+
+    QString key = QString ("QCCTV_%1_%2")
+                  .arg (QCoreApplication::applicationPid())
+                  .arg (qrand());
+
+    m_memory = new QSharedMemory (key);
+    if (!m_memory->create (QCCTV_SHARED_FRAME_SLOTS * SLOT_SIZE))
+        return false;
+
+    /* Mark all slots as empty */
+    m_memory->lock();
+    memset (m_memory->data(), 0, m_memory->size());
+    m_memory->unlock();
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Attaches to the segment with the given \a key (read-only), returns
+ * \c false if the segment does not exist or is too small
+ */
+bool QCCTV_SharedFrames::attach (const QString& key)
+{
+#ifndef QT_NO_SHAREDMEMORY
+    if (m_memory)
+        return isValid();
+
+    m_memory = new QSharedMemory (key);
+    if (!m_memory->attach (QSharedMemory::ReadOnly))
+        return false;
+
+    if (m_memory->size() < QCCTV_SHARED_FRAME_SLOTS * SLOT_SIZE) {
+        m_memory->detach();
+        return false;
+    }
+
+    return true;
+#else
+    Q_UNUSED (key);
+    return false;
+#endif
+}
+
+/**
+ * Writes the given frame \a data to the next slot, the \a slot and
+ * \a sequence number that the stations must read are written to the given
+ * pointers
+ */
+bool QCCTV_SharedFrames::write (const QByteArray& data,
+                                quint16* slot,
+                                quint32* sequence)
+{
+#ifndef QT_NO_SHAREDMEMORY
+    if (!isValid() || data.isEmpty() || data.size() > QCCTV_MAX_BUFFER_SIZE)
+        return false;
+
+    /* Get the next slot (zero means that a slot is empty) */
+    if (++m_sequence == 0)
+        ++m_sequence;
+
+    *sequence = m_sequence;
+    *slot = m_sequence % QCCTV_SHARED_FRAME_SLOTS;
+
+    /* Write the header and the frame */
+    quint32 length = data.size();
+    char* ptr = (char*) m_memory->data() + (*slot * SLOT_SIZE);
+    m_memory->lock();
+    memcpy (ptr, sequence, sizeof (quint32));
+    memcpy (ptr + sizeof (quint32), &length, sizeof (quint32));
+    memcpy (ptr + SLOT_HEADER_SIZE, data.constData(), length);
+    m_memory->unlock();
+    return true;
+#else
+    Q_UNUSED (data);
+    Q_UNUSED (slot);
+    Q_UNUSED (sequence);
+    return false;
+#endif
+}
+
+/**
+ * Copies the frame with the given \a sequence number from the given \a slot
+ * to the \a data array, returns \c false if the slot was reused
+ */
+bool QCCTV_SharedFrames::read (const quint16 slot,
+                               const quint32 sequence,
+                               QByteArray* data)
+{
+#ifndef QT_NO_SHAREDMEMORY
+    if (!isValid() || !data || slot >= QCCTV_SHARED_FRAME_SLOTS)
+        return false;
+
+    quint32 current = 0;
+    quint32 length = 0;
+    const char* ptr = (const char*) m_memory->constData() + (slot * SLOT_SIZE);
+
+    /* Copy the frame if it is still there */
+    m_memory->lock();
+    memcpy (&current, ptr, sizeof (quint32));
+    memcpy (&length, ptr + sizeof (quint32), sizeof (quint32));
+    bool valid = (current == sequence && length > 0 &&
+                  length <= QCCTV_MAX_BUFFER_SIZE);
+    if (valid)
+        *data = QByteArray (ptr + SLOT_HEADER_SIZE, length);
+    m_memory->unlock();
+
+    return valid;
+#else
+    Q_UNUSED (slot);
+    Q_UNUSED (sequence);
+    Q_UNUSED (data);
+    return false;
+#endif
+}
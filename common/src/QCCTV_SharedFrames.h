@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_SHARED_FRAMES_H
+#define _QCCTV_SHARED_FRAMES_H
+
+#include <QString>
+#include <QByteArray>
+
+class QSharedMemory;
+
+/**
+ * \brief Ring of image packet slots in a shared memory segment.
+ *
+ * Used when the camera and the station run in the same host. The camera
+ * writes each frame once to the next slot and tells the station (through
+ * the session) which slot and sequence number to read. The station copies
+ * the frame out of the slot, if the slot was reused in the meantime the
+ * frame is reported as lost.
+ *
+ * Each slot starts with the sequence number and the length of its frame,
+ * the segment is locked while a slot is written or read.
+ */
+class QCCTV_SharedFrames
+{
+public:
+    explicit QCCTV_SharedFrames();
+    ~QCCTV_SharedFrames();
+
+    QString key() const;
+    bool isValid() const;
+
+    bool create();
+    bool attach (const QString& key);
+    bool write (const QByteArray& data, quint16* slot, quint32* sequence);
+    bool read (const quint16 slot, const quint32 sequence, QByteArray* data);
+
+private:
+    quint32 m_sequence;
+    QSharedMemory* m_memory;
+};
+
+#endif
@@ -1,652 +1,1260 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#include "QCCTV.h"
-#include "QCCTV_Station.h"
-#include "QCCTV_Discovery.h"
-
-#include <QDir>
-#include <QThread>
-#include <QFileDialog>
-#include <QDesktopServices>
-
-QCCTV_Station::QCCTV_Station()
-{
-    /* Attempt to connect to a camera as we find it */
-    QCCTV_Discovery* discovery = QCCTV_Discovery::getInstance();
-    connect (discovery, SIGNAL (newCamera       (QHostAddress)),
-             this,        SLOT (connectToCamera (QHostAddress)));
-    connect (discovery, SIGNAL (newInfoPacket   (QHostAddress, QByteArray)),
-             this,        SLOT (readInfoPacket  (QHostAddress, QByteArray)));
-
-    /* Remove a camera when we disconnect from it */
-    connect (this, SIGNAL (connected (int)),
-             this, SIGNAL (cameraCountChanged()));
-    connect (this, SIGNAL (disconnected (int)),
-             this,   SLOT (removeCamera (int)));
-    connect (this, SIGNAL (cameraCountChanged()),
-             this,   SLOT (updateGroups()));
-
-    /* Set camera error image */
-    setRecordingsPath ("");
-    setSaveIncomingMedia (true);
-    m_cameraError = QCCTV_CreateStatusImage (QSize (640, 480), "CAMERA ERROR");
-}
-
-/**
- * Removes all the registered cameras during the deconstruction of the
- * \c QCCTV_Station class
- */
-QCCTV_Station::~QCCTV_Station()
-{
-    for (int i = 0; i < cameraCount(); ++i)
-        removeCamera (i);
-}
-
-/**
- * Returns the minimum FPS value allowed by QCCTV, this function can be used
- * to set control/widget limits of QML or classic interfaces
- */
-int QCCTV_Station::minimumFPS() const
-{
-    return QCCTV_MIN_FPS;
-}
-
-/**
- * Returns the maximum FPS value allowed by QCCTV, this function can be used
- * to set control/widget limits of QML or classic interfaces
- */
-int QCCTV_Station::maximumFPS() const
-{
-    return QCCTV_MAX_FPS;
-}
-
-/**
- * Returns the number of groups that have been found by the station
- */
-int QCCTV_Station::groupCount() const
-{
-    return m_groups.count();
-}
-
-/**
- * Returns the number of cameras that the station is connected to
- */
-int QCCTV_Station::cameraCount() const
-{
-    return m_cameras.count();
-}
-
-/**
- * Returns the number of cameras associated with the given \a group ID
- */
-int QCCTV_Station::cameraCount (const int group) const
-{
-    return getGroupCameras (group).count();
-}
-
-/**
- * Returns a list with all available groups
- */
-QStringList QCCTV_Station::groups() const
-{
-    return m_groups;
-}
-
-/**
- * Returns the path in which the QCCTV recordings are saved
- */
-QString QCCTV_Station::recordingsPath() const
-{
-    return m_recordingsPath;
-}
-
-/**
- * Returns \c true if the station should save received camera frames
- * to the hard disk
- */
-bool QCCTV_Station::saveIncomingMedia() const
-{
-    return m_saveIncomingMedia;
-}
-
-/**
- * Returns an ordered list with the available image resolutions, this function
- * can be used to populate a combobox or a QML model
- */
-QStringList QCCTV_Station::availableResolutions() const
-{
-    return QCCTV_Resolutions();
-}
-
-/**
- * Returns a list with the ID of each camera assigned to the given \a group ID.
- *
- * The \a group ID can be obtained by using the \c indexOf(QString) function
- * of the list returned by \a groups().
- */
-QList<int> QCCTV_Station::getGroupCameraIDs (const int group) const
-{
-    QList<int> list;
-
-    foreach (QCCTV_RemoteCamera* camera, getGroupCameras (group))
-        list.append (camera->id());
-
-    return list;
-}
-
-/**
- * Returns a list with the pointers to the cameras that are assigned to the given
- * \a group ID
- *
- * The \a group ID can be obtained by using the \c indexOf(QString) function
- * of the list returned by \a groups().
- */
-QList<QCCTV_RemoteCamera*> QCCTV_Station::getGroupCameras (const int group) const
-{
-    QList<QCCTV_RemoteCamera*> list;
-
-    if (group < groupCount()) {
-        QString name = groups().at (group);
-        foreach (QCCTV_RemoteCamera* camera, m_cameras) {
-            if (camera) {
-                if (camera->group().toLower() == name.toLower())
-                    list.append (camera);
-            }
-        }
-    }
-
-    return list;
-}
-
-/**
- * Returns the FPS reported by the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return \c -1
- */
-int QCCTV_Station::fps (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->fps();
-
-    return -1;
-}
-
-/**
- * Returns the current zoom level used by the given \a camera
- */
-int QCCTV_Station::zoom (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->zoom();
-
-    return 0;
-}
-
-/**
- * Returns the current resolution used by the camera
- */
-int QCCTV_Station::resolution (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->resolution();
-
-    return (int) QCCTV_QCIF;
-}
-
-/**
- * Returns \c true if the given \a camera supports zooming
- */
-bool QCCTV_Station::supportsZoom (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->supportsZoom();
-
-    return false;
-}
-
-/**
- * Returns the camera status byte for the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return \c -1
- */
-int QCCTV_Station::cameraStatus (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->status();
-
-    return -1;
-}
-
-/**
- * Returns the name of the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return an empty string
- */
-QString QCCTV_Station::cameraName (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->name();
-
-    return "";
-}
-
-/**
- * Returns the latest image captured by the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return a generic error image
- */
-QImage QCCTV_Station::currentImage (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->image();
-
-    return m_cameraError;
-}
-
-/**
- * Returns the network address of the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return an empty address
- */
-QHostAddress QCCTV_Station::address (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->address();
-
-    return QHostAddress ("");
-}
-
-/**
- * Returns the status string of the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return an empty string
- */
-QString QCCTV_Station::statusString (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->statusString();
-
-    return "";
-}
-
-/**
- * Returns the IP address of the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return an empty string
- */
-QString QCCTV_Station::addressString (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->address().toString();
-
-    return "";
-}
-
-/**
- * Returns the flash light status of the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return \c QCCTV_FLASHLIGHT_OFF
- */
-bool QCCTV_Station::flashlightEnabled (const int camera)
-{
-    if (flashlightAvailable (camera))
-        return (getCamera (camera)->flashlightEnabled());
-
-    return false;
-}
-
-/**
- * Returns \c true if the flashlight of the given \a camera works
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return \c flase
- */
-bool QCCTV_Station::flashlightAvailable (const int camera)
-{
-    if (getCamera (camera))
-        return ! (getCamera (camera)->status() & QCCTV_CAMSTATUS_LIGHT_FAILURE);
-
-    return false;
-}
-
-/**
- * Returns \c true if the camera is allowed to auto-regulate the image
- * resolution to improve communication times
- *
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return \c false
- */
-bool QCCTV_Station::autoRegulateResolution (const int camera)
-{
-    if (getCamera (camera))
-        return getCamera (camera)->autoRegulateResolution();
-
-    return false;
-}
-
-/**
- * Returns a list with the IP's of the connected cameras
- */
-QList<QHostAddress> QCCTV_Station::cameraIPs()
-{
-    QList<QHostAddress> list;
-
-    for (int i = 0; i < cameraCount(); ++i) {
-        if (getCamera (i))
-            list.append (getCamera (i)->address());
-    }
-
-    return list;
-}
-
-/**
- * Returns the name of the group at the given \a index
- * This function is made available to ease QML-based implementations
- */
-QString QCCTV_Station::getGroupName (const int group)
-{
-    if (group < groupCount())
-        return groups().at (group);
-
-    return "";
-}
-
-/**
- * Returns a pointer to the controller of the given \a camera
- * \note If an invalid camera ID is given to this function,
- *       then this function shall return a \c NULL pointer
- */
-QCCTV_RemoteCamera* QCCTV_Station::getCamera (const int camera)
-{
-    if (camera >= 0 && camera < cameraCount())
-        return m_cameras.at (camera);
-
-    return NULL;
-}
-
-/**
- * Re-generates the camera groups list
- */
-void QCCTV_Station::updateGroups()
-{
-    m_groups.clear();
-
-    foreach (QCCTV_RemoteCamera* camera, m_cameras)
-        if (!m_groups.contains (camera->group().toLower()))
-            m_groups.append (camera->group().toLower());
-
-    emit groupCountChanged();
-}
-
-/**
- * De-registers all the cameras from the station, this can be useful in the
- * case that the user wants to force the station to reconnect to all cameras
- * again.
- */
-void QCCTV_Station::removeAllCameras()
-{
-    for (int i = 0; i < cameraCount(); ++i)
-        removeCamera (i);
-}
-
-/**
- * Opens the folder in which we save QCCTV recordings
- */
-void QCCTV_Station::openRecordingsPath()
-{
-    QDesktopServices::openUrl (QUrl::fromLocalFile (recordingsPath()));
-}
-
-/**
- * Prompts the user to select where to save the QCCTV recordings
- */
-void QCCTV_Station::chooseRecordingsPath()
-{
-    QString dir = QFileDialog::getExistingDirectory (NULL,
-                                                     tr ("Select recordings folder"),
-                                                     QDir::homePath(),
-                                                     QFileDialog::ShowDirsOnly |
-                                                     QFileDialog::DontResolveSymlinks);
-
-    if (!dir.isEmpty())
-        setRecordingsPath (dir);
-}
-
-/**
- * Instructs the remote \a camera to perform a focus
- * \note If the \a camera parameter is invalid, then this function
- *       shall have no effect
- */
-void QCCTV_Station::focusCamera (const int camera)
-{
-    if (getCamera (camera))
-        getCamera (camera)->requestFocus();
-}
-
-/**
- * Allows or disallows the QCCTV Station to save incoming media
- */
-void QCCTV_Station::setSaveIncomingMedia (const bool save)
-{
-    m_saveIncomingMedia = save;
-
-    foreach (QCCTV_RemoteCamera* camera, m_cameras)
-        camera->setSaveIncomingMedia (saveIncomingMedia());
-
-    emit saveIncomingMediaChanged();
-}
-
-/**
- * Changes the directory in which the QCCTV recordings are saved.
- *
- * \note If the \a path is empty, then the default directory shall
- *       be used to store QCCTV recordings
- */
-void QCCTV_Station::setRecordingsPath (const QString& path)
-{
-    if (!path.isEmpty() && m_recordingsPath == path)
-        return;
-
-    if (!path.isEmpty())
-        m_recordingsPath = QDir (path).absolutePath();
-    else
-        m_recordingsPath = QDir (QCCTV_RECORDINGS_PATH).absolutePath();
-
-    if (!m_recordingsPath.endsWith ("/QCCTV_Media/") &&
-        !m_recordingsPath.endsWith ("/QCCTV_Media")) {
-        m_recordingsPath += "/QCCTV_Media/";
-        m_recordingsPath = QDir (m_recordingsPath).absolutePath();
-    }
-
-    foreach (QCCTV_RemoteCamera* camera, m_cameras)
-        if (camera)
-            camera->setIncomingMediaPath (recordingsPath());
-
-    emit recordingsPathChanged();
-}
-
-/**
- * Changes the zoom status of the given \a camera
- */
-void QCCTV_Station::setZoom (const int camera, const int zoom)
-{
-    if (getCamera (camera))
-        getCamera (camera)->changeZoom (zoom);
-}
-
-/**
- * Changes the \a fps value of the given \a camera
- * \note If the \a camera parameter is invalid, then this function
- *       shall have no effect
- */
-void QCCTV_Station::changeFPS (const int camera, const int fps)
-{
-    if (getCamera (camera))
-        getCamera (camera)->changeFPS (fps);
-}
-
-/**
- * Changes the flashlight \a status for all cameras connected to the station
- */
-void QCCTV_Station::setFlashlightEnabledAll (const bool enabled)
-{
-    for (int i = 0; i < cameraCount(); ++i)
-        setFlashlightEnabled (i, enabled);
-}
-
-/**
- * Changes the \a resoltion for the given \a camera
- * \note If the \a camera parameter is invalid, then this function
- *       shall have no effect
- */
-void QCCTV_Station::changeResolution (const int camera, const int resolution)
-{
-    if (getCamera (camera))
-        getCamera (camera)->changeResolution (resolution);
-}
-
-/**
- * Changes the flashlight \a status value of the given \a camera
- * \note If the \a camera parameter is invalid, then this function
- *       shall have no effect
- */
-void QCCTV_Station::setFlashlightEnabled (const int camera, const bool enabled)
-{
-    if (getCamera (camera))
-        getCamera (camera)->changeFlashlightStatus ((int) enabled);
-}
-
-/**
- * Allows or disallows the \a camera to autoregulate its image resolution to
- * improve communication tiems
- * \note If the \a camera parameter is invalid, then this function shall
- *       have no effect
- */
-void QCCTV_Station::setAutoRegulateResolution (const int camera,
-                                               const bool regulate)
-{
-    if (getCamera (camera))
-        getCamera (camera)->changeAutoRegulate (regulate);
-}
-
-/**
- * Removes the given \a camera from the registered cameras list
- * \note Cameras that where registered after the removed camera shall
- *       change their respective ID's after calling this function
- */
-void QCCTV_Station::removeCamera (const int camera)
-{
-    if (getCamera (camera)) {
-        /* Stop the camera */
-        m_cameras.at (camera)->deleteLater();
-        m_cameras.removeAt (camera);
-
-        /* Stop the thread */
-        m_threads.at (camera)->deleteLater();
-        m_threads.removeAt (camera);
-
-        /* Change the ID of cameras following the removed camera */
-        foreach (QCCTV_RemoteCamera* cam, m_cameras) {
-            if (cam) {
-                if (cam->id() > camera)
-                    cam->changeID (cam->id() - 1);
-            }
-        }
-
-        /* Notify UI */
-        emit cameraCountChanged();
-    }
-}
-
-/**
- * Tries to establish a connection with a QCCTV camera running
- * in a host with the given \a ip address
- *
- * If the remote camera does not respond after some seconds,
- * then the new camera controller shall be automatically
- * deleted from the camera list
- */
-void QCCTV_Station::connectToCamera (const QHostAddress& ip)
-{
-    if (!ip.isNull() && !cameraIPs().contains (ip)) {
-        QThread* thread = new QThread;
-        QCCTV_RemoteCamera* camera = new QCCTV_RemoteCamera;
-
-        /* Register thread and camera pointers */
-        m_threads.append (thread);
-        m_cameras.append (camera);
-
-        /* Configure camera */
-        camera->setAddress (ip);
-        camera->changeID (cameraCount() - 1);
-        camera->setIncomingMediaPath (recordingsPath());
-        camera->setSaveIncomingMedia (saveIncomingMedia());
-
-        /* Start timers when thread is started */
-        connect (thread, SIGNAL (started()),
-                 camera,   SLOT (start()));
-
-        /* Move remote camera to different thread */
-        thread->start (QThread::HighPriority);
-        camera->moveToThread (thread);
-
-        /* Connect equivalent signals between station and camera */
-        connect (camera, SIGNAL (connected (int)),
-                 this,   SIGNAL (connected (int)));
-        connect (camera, SIGNAL (disconnected (int)),
-                 this,   SIGNAL (disconnected (int)));
-        connect (camera, SIGNAL (fpsChanged (int)),
-                 this,   SIGNAL (fpsChanged (int)));
-        connect (camera, SIGNAL (newCameraName (int)),
-                 this,   SIGNAL (cameraNameChanged (int)));
-        connect (camera, SIGNAL (newCameraStatus (int)),
-                 this,   SIGNAL (cameraStatusChanged (int)));
-        connect (camera, SIGNAL (newImage (int)),
-                 this,   SIGNAL (newCameraImage (int)));
-        connect (camera, SIGNAL (zoomLevelChanged (int)),
-                 this,   SIGNAL (zoomLevelChanged (int)));
-        connect (camera, SIGNAL (zoomSupportChanged (int)),
-                 this,   SIGNAL (zoomSupportChanged (int)));
-        connect (camera, SIGNAL (resolutionChanged (int)),
-                 this,   SIGNAL (resolutionChanged (int)));
-        connect (camera, SIGNAL (lightStatusChanged (int)),
-                 this,   SIGNAL (lightStatusChanged (int)));
-        connect (camera, SIGNAL (autoRegulateResolutionChanged (int)),
-                 this,   SIGNAL (autoRegulateResolutionChanged (int)));
-        connect (camera, SIGNAL (newCameraGroup()),
-                 this,     SLOT (updateGroups()));
-    }
-}
-
-/**
- * Figures out from which remote camera did the \a data come from and instructs
- * the remote camera manager assigned to that \a address to read the \a data
- */
-void QCCTV_Station::readInfoPacket (const QHostAddress& address,
-                                    const QByteArray& data)
-{
-    if (cameraIPs().contains (address)) {
-        int camera = cameraIPs().indexOf (address);
-        if (getCamera (camera))
-            getCamera (camera)->readInfoPacket (data);
-    }
-}
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include "QCCTV.h"
+#include "QCCTV_Relay.h"
+#include "QCCTV_Station.h"
+#include "QCCTV_Discovery.h"
+
+#include <QDir>
+#include <QThread>
+#include <QFileDialog>
+#include <QDesktopServices>
+
+QCCTV_Station::QCCTV_Station()
+{
+    /* Attempt to connect to a camera as we find it */
+    QCCTV_Discovery* discovery = QCCTV_Discovery::getInstance();
+    connect (discovery, SIGNAL (newCamera       (QHostAddress, quint16,
+                                                 QHostAddress)),
+             this,        SLOT (connectToCamera (QHostAddress, quint16,
+                                                 QHostAddress)));
+    connect (discovery, SIGNAL (newInfoPacket   (QHostAddress, QByteArray)),
+             this,        SLOT (readInfoPacket  (QHostAddress, QByteArray)));
+
+    /* Remove a camera when we disconnect from it */
+    connect (this, SIGNAL (connected (int)),
+             this, SIGNAL (cameraCountChanged()));
+    connect (this, SIGNAL (disconnected (int)),
+             this,   SLOT (removeCamera (int)));
+    connect (this, SIGNAL (cameraCountChanged()),
+             this,   SLOT (updateGroups()));
+
+    /* Re-publish the cameras to other stations (if enabled) */
+    m_relay = new QCCTV_Relay (this);
+
+    /* Set camera error image */
+    setRecordingsPath ("");
+    setSaveIncomingMedia (true);
+    setRecordOnMotionOnly (false);
+    setUdpTransportEnabled (false);
+    setUdpParityGroup (QCCTV_UDP_PARITY_GROUP);
+    setMulticastEnabled (false);
+    setRelayEnabled (false);
+    setMotionAnalysisEnabled (false);
+    m_cameraError = QCCTV_CreateStatusImage (QSize (640, 480), "CAMERA ERROR");
+}
+
+/**
+ * Removes all the registered cameras during the deconstruction of the
+ * \c QCCTV_Station class
+ */
+QCCTV_Station::~QCCTV_Station()
+{
+    for (int i = 0; i < cameraCount(); ++i)
+        removeCamera (i);
+}
+
+/**
+ * Returns the minimum FPS value allowed by QCCTV, this function can be used
+ * to set control/widget limits of QML or classic interfaces
+ */
+int QCCTV_Station::minimumFPS() const
+{
+    return QCCTV_MIN_FPS;
+}
+
+/**
+ * Returns the maximum FPS value allowed by QCCTV, this function can be used
+ * to set control/widget limits of QML or classic interfaces
+ */
+int QCCTV_Station::maximumFPS() const
+{
+    return QCCTV_MAX_FPS;
+}
+
+/**
+ * Returns the number of groups that have been found by the station
+ */
+int QCCTV_Station::groupCount() const
+{
+    return m_groups.count();
+}
+
+/**
+ * Returns the number of cameras that the station is connected to
+ */
+int QCCTV_Station::cameraCount() const
+{
+    return m_cameras.count();
+}
+
+/**
+ * Returns the number of cameras associated with the given \a group ID
+ */
+int QCCTV_Station::cameraCount (const int group) const
+{
+    return getGroupCameras (group).count();
+}
+
+/**
+ * Returns a list with all available groups
+ */
+QStringList QCCTV_Station::groups() const
+{
+    return m_groups;
+}
+
+/**
+ * Returns the path in which the QCCTV recordings are saved
+ */
+QString QCCTV_Station::recordingsPath() const
+{
+    return m_recordingsPath;
+}
+
+/**
+ * Returns \c true if the station should save received camera frames
+ * to the hard disk
+ */
+bool QCCTV_Station::saveIncomingMedia() const
+{
+    return m_saveIncomingMedia;
+}
+
+/**
+ * Returns \c true if the station should only save received camera frames
+ * while motion is detected in the scene
+ */
+bool QCCTV_Station::recordOnMotionOnly() const
+{
+    return m_recordOnMotionOnly;
+}
+
+/**
+ * Returns \c true if the cameras send their images to the station through
+ * UDP datagrams
+ */
+bool QCCTV_Station::udpTransportEnabled() const
+{
+    return m_udpTransport;
+}
+
+/**
+ * Returns the number of UDP fragments protected by each parity fragment
+ */
+int QCCTV_Station::udpParityGroup() const
+{
+    return m_udpParityGroup;
+}
+
+/**
+ * Returns \c true if the cameras send their shared stream to the station
+ * through their multicast groups
+ */
+bool QCCTV_Station::multicastEnabled() const
+{
+    return m_multicast;
+}
+
+/**
+ * Returns \c true if the station re-publishes the streams of the cameras
+ * to other stations
+ */
+bool QCCTV_Station::relayEnabled() const
+{
+    return m_relay->isEnabled();
+}
+
+/**
+ * Returns \c true if the station analyzes the received camera frames to
+ * detect motion (for cameras that do not detect motion themselves)
+ */
+bool QCCTV_Station::motionAnalysisEnabled() const
+{
+    return m_motionAnalysisEnabled;
+}
+
+/**
+ * Returns an ordered list with the available image resolutions, this function
+ * can be used to populate a combobox or a QML model
+ */
+QStringList QCCTV_Station::availableResolutions() const
+{
+    return QCCTV_Resolutions();
+}
+
+/**
+ * Returns a list with the ID of each camera assigned to the given \a group ID.
+ *
+ * The \a group ID can be obtained by using the \c indexOf(QString) function
+ * of the list returned by \a groups().
+ */
+QList<int> QCCTV_Station::getGroupCameraIDs (const int group) const
+{
+    QList<int> list;
+
+    foreach (QCCTV_RemoteCamera* camera, getGroupCameras (group))
+        list.append (camera->id());
+
+    return list;
+}
+
+/**
+ * Returns a list with the pointers to the cameras that are assigned to the given
+ * \a group ID
+ *
+ * The \a group ID can be obtained by using the \c indexOf(QString) function
+ * of the list returned by \a groups().
+ */
+QList<QCCTV_RemoteCamera*> QCCTV_Station::getGroupCameras (const int group) const
+{
+    QList<QCCTV_RemoteCamera*> list;
+
+    if (group < groupCount()) {
+        QString name = groups().at (group);
+        foreach (QCCTV_RemoteCamera* camera, m_cameras) {
+            if (camera) {
+                if (camera->group().toLower() == name.toLower())
+                    list.append (camera);
+            }
+        }
+    }
+
+    return list;
+}
+
+/**
+ * Returns the FPS reported by the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c -1
+ */
+int QCCTV_Station::fps (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->fps();
+
+    return -1;
+}
+
+/**
+ * Returns the lowest FPS that we can ask for to the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c -1
+ */
+int QCCTV_Station::minimumFPS (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->minimumFps();
+
+    return -1;
+}
+
+/**
+ * Returns the highest FPS allowed by the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c -1
+ */
+int QCCTV_Station::maximumFPS (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->maximumFps();
+
+    return -1;
+}
+
+/**
+ * Returns the current zoom level used by the given \a camera
+ */
+int QCCTV_Station::zoom (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->zoom();
+
+    return 0;
+}
+
+/**
+ * Returns the target bitrate (in kbit/s) of the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c 0
+ */
+int QCCTV_Station::bitrate (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->bitrate();
+
+    return 0;
+}
+
+/**
+ * Returns the JPEG quality used by the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c 0
+ */
+int QCCTV_Station::quality (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->quality();
+
+    return 0;
+}
+
+/**
+ * Returns the current resolution used by the camera
+ */
+int QCCTV_Station::resolution (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->resolution();
+
+    return (int) QCCTV_QCIF;
+}
+
+/**
+ * Returns \c true if the given \a camera supports zooming
+ */
+bool QCCTV_Station::supportsZoom (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->supportsZoom();
+
+    return false;
+}
+
+/**
+ * Returns the camera status byte for the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c -1
+ */
+int QCCTV_Station::cameraStatus (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->status();
+
+    return -1;
+}
+
+/**
+ * Returns the name of the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty string
+ */
+QString QCCTV_Station::cameraName (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->name();
+
+    return "";
+}
+
+/**
+ * Returns the latest image captured by the given \a camera, this also
+ * allows the camera to send us more frames
+ *
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return a generic error image
+ */
+QImage QCCTV_Station::currentImage (const int camera)
+{
+    if (getCamera (camera)) {
+        QMetaObject::invokeMethod (getCamera (camera), "imageDisplayed",
+                                   Qt::QueuedConnection);
+        return getCamera (camera)->image();
+    }
+
+    return m_cameraError;
+}
+
+/**
+ * Returns the last full-resolution snapshot received from the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty image
+ */
+QImage QCCTV_Station::snapshot (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->snapshot();
+
+    return QImage();
+}
+
+/**
+ * Returns the path of the file in which the last snapshot of the given
+ * \a camera was saved
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty string
+ */
+QString QCCTV_Station::snapshotFile (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->snapshotFile();
+
+    return "";
+}
+
+/**
+ * Returns the network address of the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty address
+ */
+QHostAddress QCCTV_Station::address (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->address();
+
+    return QHostAddress ("");
+}
+
+/**
+ * Returns the status string of the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty string
+ */
+QString QCCTV_Station::statusString (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->statusString();
+
+    return "";
+}
+
+/**
+ * Returns the IP address of the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty string
+ */
+QString QCCTV_Station::addressString (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->address().toString();
+
+    return "";
+}
+
+/**
+ * Returns the flash light status of the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c QCCTV_FLASHLIGHT_OFF
+ */
+bool QCCTV_Station::flashlightEnabled (const int camera)
+{
+    if (flashlightAvailable (camera))
+        return (getCamera (camera)->flashlightEnabled());
+
+    return false;
+}
+
+/**
+ * Returns \c true if the flashlight of the given \a camera works
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c flase
+ */
+bool QCCTV_Station::flashlightAvailable (const int camera)
+{
+    if (getCamera (camera))
+        return ! (getCamera (camera)->status() & QCCTV_CAMSTATUS_LIGHT_FAILURE);
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given \a camera only sends the image blocks that
+ * changed since the previous frame
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::deltaFramesEnabled (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->streamFlags() & QCCTV_STREAM_DELTA_FRAMES;
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given \a camera only sends the JPEG tables when they
+ * change (instead of sending them with every image)
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::abbreviatedJpegEnabled (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->streamFlags() & QCCTV_STREAM_ABBREVIATED;
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given \a camera filters the noise of static regions
+ * before encoding each frame
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::noiseReductionEnabled (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->streamFlags() & QCCTV_STREAM_NOISE_REDUCTION;
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given \a camera is currently sending luma-only
+ * (grayscale) images
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::grayscale (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->grayscale();
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given \a camera was instructed to always send
+ * luma-only (grayscale) images
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::grayscaleEnabled (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->streamFlags() & QCCTV_STREAM_GRAYSCALE;
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given \a camera sends luma-only (grayscale) images
+ * while its image has (almost) no color
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::autoGrayscaleEnabled (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->streamFlags() & QCCTV_STREAM_AUTO_GRAYSCALE;
+
+    return false;
+}
+
+/**
+ * Returns \c true if the given \a camera reports motion in its scene
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::motionDetected (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->motionDetected();
+
+    return false;
+}
+
+/**
+ * Returns \c true if the camera is allowed to auto-regulate the image
+ * resolution to improve communication times
+ *
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return \c false
+ */
+bool QCCTV_Station::autoRegulateResolution (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->autoRegulateResolution();
+
+    return false;
+}
+
+/**
+ * Returns the region of interest (in normalized coordinates) of the given
+ * \a camera, an empty rectangle means that the whole image is sent
+ *
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty rectangle
+ */
+QRectF QCCTV_Station::regionOfInterest (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->regionOfInterest();
+
+    return QRectF();
+}
+
+/**
+ * Returns the crop rectangle (digital PTZ, in normalized coordinates) that
+ * this station receives from the given \a camera, an empty rectangle means
+ * that the whole image is received
+ *
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return an empty rectangle
+ */
+QRectF QCCTV_Station::crop (const int camera)
+{
+    if (getCamera (camera))
+        return getCamera (camera)->crop();
+
+    return QRectF();
+}
+
+/**
+ * Returns a list with the IP's of the connected cameras
+ */
+QList<QHostAddress> QCCTV_Station::cameraIPs()
+{
+    QList<QHostAddress> list;
+
+    for (int i = 0; i < cameraCount(); ++i) {
+        if (getCamera (i))
+            list.append (getCamera (i)->address());
+    }
+
+    return list;
+}
+
+/**
+ * Returns the name of the group at the given \a index
+ * This function is made available to ease QML-based implementations
+ */
+QString QCCTV_Station::getGroupName (const int group)
+{
+    if (group < groupCount())
+        return groups().at (group);
+
+    return "";
+}
+
+/**
+ * Returns a pointer to the controller of the given \a camera
+ * \note If an invalid camera ID is given to this function,
+ *       then this function shall return a \c NULL pointer
+ */
+QCCTV_RemoteCamera* QCCTV_Station::getCamera (const int camera)
+{
+    if (camera >= 0 && camera < cameraCount())
+        return m_cameras.at (camera);
+
+    return NULL;
+}
+
+/**
+ * Re-generates the camera groups list
+ */
+void QCCTV_Station::updateGroups()
+{
+    m_groups.clear();
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        if (!m_groups.contains (camera->group().toLower()))
+            m_groups.append (camera->group().toLower());
+
+    emit groupCountChanged();
+}
+
+/**
+ * De-registers all the cameras from the station, this can be useful in the
+ * case that the user wants to force the station to reconnect to all cameras
+ * again.
+ */
+void QCCTV_Station::removeAllCameras()
+{
+    for (int i = 0; i < cameraCount(); ++i)
+        removeCamera (i);
+}
+
+/**
+ * Opens the folder in which we save QCCTV recordings
+ */
+void QCCTV_Station::openRecordingsPath()
+{
+    QDesktopServices::openUrl (QUrl::fromLocalFile (recordingsPath()));
+}
+
+/**
+ * Prompts the user to select where to save the QCCTV recordings
+ */
+void QCCTV_Station::chooseRecordingsPath()
+{
+    QString dir = QFileDialog::getExistingDirectory (NULL,
+                                                     tr ("Select recordings folder"),
+                                                     QDir::homePath(),
+                                                     QFileDialog::ShowDirsOnly |
+                                                     QFileDialog::DontResolveSymlinks);
+
+    if (!dir.isEmpty())
+        setRecordingsPath (dir);
+}
+
+/**
+ * Instructs the remote \a camera to perform a focus
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::focusCamera (const int camera)
+{
+    if (getCamera (camera))
+        getCamera (camera)->requestFocus();
+}
+
+/**
+ * Instructs the given \a camera to send a full frame
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::requestKeyframe (const int camera)
+{
+    if (getCamera (camera))
+        getCamera (camera)->requestKeyframe();
+}
+
+/**
+ * Instructs the given \a camera to send a full-resolution snapshot, without
+ * changing the settings of the live stream
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::requestSnapshot (const int camera)
+{
+    if (getCamera (camera))
+        getCamera (camera)->requestSnapshot();
+}
+
+/**
+ * Allows or disallows the QCCTV Station to save incoming media
+ */
+void QCCTV_Station::setSaveIncomingMedia (const bool save)
+{
+    m_saveIncomingMedia = save;
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        camera->setSaveIncomingMedia (saveIncomingMedia());
+
+    emit saveIncomingMediaChanged();
+}
+
+/**
+ * If \a enabled is set to \c true, the station shall only save incoming
+ * media while there is motion in the scene
+ */
+void QCCTV_Station::setRecordOnMotionOnly (const bool enabled)
+{
+    m_recordOnMotionOnly = enabled;
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        camera->setRecordOnMotionOnly (recordOnMotionOnly());
+
+    emit recordOnMotionOnlyChanged();
+}
+
+/**
+ * If \a enabled is set to \c true, the cameras shall send their images
+ * through UDP datagrams, which are dropped instead of stalling the stream
+ * on lossy networks
+ */
+void QCCTV_Station::setUdpTransportEnabled (const bool enabled)
+{
+    m_udpTransport = enabled;
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        QMetaObject::invokeMethod (camera, "setUdpTransportEnabled",
+                                   Qt::QueuedConnection,
+                                   Q_ARG (bool, enabled));
+
+    emit udpTransportChanged();
+}
+
+/**
+ * Changes the number of UDP fragments protected by each parity fragment
+ * (zero disables the parity fragments)
+ */
+void QCCTV_Station::setUdpParityGroup (const int group)
+{
+    m_udpParityGroup = qBound (0, group, 255);
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        QMetaObject::invokeMethod (camera, "setUdpParityGroup",
+                                   Qt::QueuedConnection,
+                                   Q_ARG (int, m_udpParityGroup));
+
+    emit udpTransportChanged();
+}
+
+/**
+ * If \a enabled is set to \c true, the station joins the multicast group of
+ * each camera, so that the camera sends its images only once to all the
+ * stations in the LAN
+ */
+void QCCTV_Station::setMulticastEnabled (const bool enabled)
+{
+    m_multicast = enabled;
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        QMetaObject::invokeMethod (camera, "setMulticastEnabled",
+                                   Qt::QueuedConnection,
+                                   Q_ARG (bool, enabled));
+
+    emit multicastChanged();
+}
+
+/**
+ * If \a enabled is set to \c true, the station re-publishes the frames of
+ * the cameras (without re-encoding them) to other stations, so that each
+ * camera only sends its stream once. Cameras served by other relays are
+ * not relayed again
+ */
+void QCCTV_Station::setRelayEnabled (const bool enabled)
+{
+    m_relay->setEnabled (enabled);
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        if (camera->port() == QCCTV_SESSION_PORT)
+            QMetaObject::invokeMethod (camera, "setRelayEnabled",
+                                       Qt::QueuedConnection,
+                                       Q_ARG (bool, enabled));
+
+    emit relayEnabledChanged();
+}
+
+/**
+ * Enables or disables the station-side motion analysis for all cameras
+ */
+void QCCTV_Station::setMotionAnalysisEnabled (const bool enabled)
+{
+    m_motionAnalysisEnabled = enabled;
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        camera->setMotionAnalysisEnabled (motionAnalysisEnabled());
+
+    emit motionAnalysisEnabledChanged();
+}
+
+/**
+ * Changes the directory in which the QCCTV recordings are saved.
+ *
+ * \note If the \a path is empty, then the default directory shall
+ *       be used to store QCCTV recordings
+ */
+void QCCTV_Station::setRecordingsPath (const QString& path)
+{
+    if (!path.isEmpty() && m_recordingsPath == path)
+        return;
+
+    if (!path.isEmpty())
+        m_recordingsPath = QDir (path).absolutePath();
+    else
+        m_recordingsPath = QDir (QCCTV_RECORDINGS_PATH).absolutePath();
+
+    if (!m_recordingsPath.endsWith ("/QCCTV_Media/") &&
+        !m_recordingsPath.endsWith ("/QCCTV_Media")) {
+        m_recordingsPath += "/QCCTV_Media/";
+        m_recordingsPath = QDir (m_recordingsPath).absolutePath();
+    }
+
+    foreach (QCCTV_RemoteCamera* camera, m_cameras)
+        if (camera)
+            camera->setIncomingMediaPath (recordingsPath());
+
+    emit recordingsPathChanged();
+}
+
+/**
+ * Changes the zoom status of the given \a camera
+ */
+void QCCTV_Station::setZoom (const int camera, const int zoom)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeZoom (zoom);
+}
+
+/**
+ * Changes the \a fps value of the given \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::changeFPS (const int camera, const int fps)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeFPS (fps);
+}
+
+/**
+ * Changes the target \a bitrate (in kbit/s) of the given \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::changeBitrate (const int camera, const int bitrate)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeBitrate (bitrate);
+}
+
+/**
+ * Changes the flashlight \a status for all cameras connected to the station
+ */
+void QCCTV_Station::setFlashlightEnabledAll (const bool enabled)
+{
+    for (int i = 0; i < cameraCount(); ++i)
+        setFlashlightEnabled (i, enabled);
+}
+
+/**
+ * Changes the \a resoltion for the given \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::changeResolution (const int camera, const int resolution)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeResolution (resolution);
+}
+
+/**
+ * Changes the flashlight \a status value of the given \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setFlashlightEnabled (const int camera, const bool enabled)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeFlashlightStatus ((int) enabled);
+}
+
+/**
+ * Enables or disables delta frames for the given \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setDeltaFramesEnabled (const int camera, const bool enabled)
+{
+    setStreamFlag (camera, QCCTV_STREAM_DELTA_FRAMES, enabled);
+}
+
+/**
+ * Instructs the given \a camera to only send the JPEG tables when they change
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setAbbreviatedJpegEnabled (const int camera,
+                                               const bool enabled)
+{
+    setStreamFlag (camera, QCCTV_STREAM_ABBREVIATED, enabled);
+}
+
+/**
+ * Enables or disables the temporal noise reduction filter of the given
+ * \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setNoiseReductionEnabled (const int camera,
+                                              const bool enabled)
+{
+    setStreamFlag (camera, QCCTV_STREAM_NOISE_REDUCTION, enabled);
+}
+
+/**
+ * Instructs the given \a camera to always send luma-only (grayscale) images
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setGrayscaleEnabled (const int camera, const bool enabled)
+{
+    setStreamFlag (camera, QCCTV_STREAM_GRAYSCALE, enabled);
+}
+
+/**
+ * Instructs the given \a camera to send luma-only (grayscale) images while
+ * its image has (almost) no color
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setAutoGrayscaleEnabled (const int camera,
+                                             const bool enabled)
+{
+    setStreamFlag (camera, QCCTV_STREAM_AUTO_GRAYSCALE, enabled);
+}
+
+/**
+ * Changes the maximum percentage of a CPU core that the station may use to
+ * analyze the images of the given \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setMotionAnalysisBudget (const int camera, const int budget)
+{
+    if (getCamera (camera))
+        getCamera (camera)->setMotionAnalysisBudget (budget);
+}
+
+/**
+ * Allows or disallows the \a camera to autoregulate its image resolution to
+ * improve communication tiems
+ * \note If the \a camera parameter is invalid, then this function shall
+ *       have no effect
+ */
+void QCCTV_Station::setAutoRegulateResolution (const int camera,
+                                               const bool regulate)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeAutoRegulate (regulate);
+}
+
+/**
+ * Instructs the \a camera to spend its bits on the given region of interest
+ * (in normalized coordinates), an empty rectangle sends the whole image
+ * \note If the \a camera parameter is invalid, then this function shall
+ *       have no effect
+ */
+void QCCTV_Station::setRegionOfInterest (const int camera, const QRectF& roi)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeRegionOfInterest (roi);
+}
+
+/**
+ * Instructs the \a camera to send the given region (in normalized
+ * coordinates) of its full-resolution image to this station, without
+ * affecting other stations. An empty rectangle receives the whole image
+ * \note If the \a camera parameter is invalid, then this function shall
+ *       have no effect
+ */
+void QCCTV_Station::setCrop (const int camera, const QRectF& crop)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeCrop (crop);
+}
+
+/**
+ * Sets or clears the given stream \a flag of the given \a camera
+ * \note If the \a camera parameter is invalid, then this function
+ *       shall have no effect
+ */
+void QCCTV_Station::setStreamFlag (const int camera, const int flag,
+                                   const bool enabled)
+{
+    if (getCamera (camera))
+        getCamera (camera)->changeStreamFlag (flag, enabled);
+}
+
+/**
+ * Returns the index of the camera with the given \a ip address and session
+ * \a port, or -1 if we are not connected to such camera
+ */
+int QCCTV_Station::indexOf (const QHostAddress& ip, const quint16 port)
+{
+    for (int i = 0; i < cameraCount(); ++i) {
+        if (getCamera (i) && getCamera (i)->address() == ip &&
+            getCamera (i)->port() == port)
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Returns the index of the relayed camera that is served from the camera
+ * with the given \a source address, or -1 if we are not connected to a
+ * relay that serves such camera
+ */
+int QCCTV_Station::relayIndexOf (const QHostAddress& source)
+{
+    if (source.isNull())
+        return -1;
+
+    for (int i = 0; i < cameraCount(); ++i) {
+        if (getCamera (i) && getCamera (i)->port() != QCCTV_SESSION_PORT &&
+            m_sources.at (i) == source)
+            return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Removes the given \a camera from the registered cameras list
+ * \note Cameras that where registered after the removed camera shall
+ *       change their respective ID's after calling this function
+ */
+void QCCTV_Station::removeCamera (const int camera)
+{
+    if (getCamera (camera)) {
+        /* Stop the camera */
+        m_relay->removeCamera (m_cameras.at (camera));
+        m_cameras.at (camera)->deleteLater();
+        m_cameras.removeAt (camera);
+        m_sources.removeAt (camera);
+
+        /* Stop the thread */
+        m_threads.at (camera)->deleteLater();
+        m_threads.removeAt (camera);
+
+        /* Change the ID of cameras following the removed camera */
+        foreach (QCCTV_RemoteCamera* cam, m_cameras) {
+            if (cam) {
+                if (cam->id() > camera)
+                    cam->changeID (cam->id() - 1);
+            }
+        }
+
+        /* Notify UI */
+        emit cameraCountChanged();
+    }
+}
+
+/**
+ * Tries to establish a connection with a QCCTV camera running
+ * in a host with the given \a ip address (or served by a relay in that
+ * host, in which case the session \a port is not the default one and the
+ * \a source is the address of the camera, if the relay sends it)
+ *
+ * We only keep one connection to each camera. Stations that relay the
+ * cameras themselves prefer direct connections, the other stations prefer
+ * the relays, so that the camera does not get one more subscriber for each
+ * station that views it
+ *
+ * If the remote camera does not respond after some seconds,
+ * then the new camera controller shall be automatically
+ * deleted from the camera list
+ */
+void QCCTV_Station::connectToCamera (const QHostAddress& ip,
+                                     const quint16 port,
+                                     const QHostAddress& source)
+{
+    /* Do not connect to our own relay */
+    bool relayed = (port != QCCTV_SESSION_PORT);
+    if (relayed && QCCTV_IsLocalAddress (ip))
+        return;
+
+    /* Invalid address or we are already connected to the camera */
+    if (ip.isNull() || indexOf (ip, port) >= 0)
+        return;
+
+    /* Get the other connection to the same camera (direct or relayed) */
+    int other = relayIndexOf (ip);
+    if (relayed)
+        other = source.isNull() ? -1 : indexOf (source, QCCTV_SESSION_PORT);
+
+    /* Keep the preferred connection, replace the other one */
+    bool preferRelay = !relayEnabled();
+    if (getCamera (other)) {
+        if (relayed != preferRelay)
+            return;
+
+        removeCamera (other);
+    }
+
+    QThread* thread = new QThread;
+    QCCTV_RemoteCamera* camera = new QCCTV_RemoteCamera;
+
+    /* Register thread and camera pointers */
+    m_threads.append (thread);
+    m_cameras.append (camera);
+    m_sources.append (relayed ? source : ip);
+
+    /* Configure camera */
+    camera->setPort (port);
+    camera->setAddress (ip);
+    camera->changeID (cameraCount() - 1);
+    camera->setIncomingMediaPath (recordingsPath());
+    camera->setSaveIncomingMedia (saveIncomingMedia());
+    camera->setRecordOnMotionOnly (recordOnMotionOnly());
+    camera->setUdpParityGroup (udpParityGroup());
+    camera->setUdpTransportEnabled (udpTransportEnabled());
+    camera->setMulticastEnabled (multicastEnabled());
+    camera->setMotionAnalysisEnabled (motionAnalysisEnabled());
+
+    /* Forward the stream of the camera to the relay */
+    if (!relayed) {
+        m_relay->addCamera (camera, ip);
+        camera->setRelayEnabled (relayEnabled());
+        connect (camera,  SIGNAL (relayedInfo (QByteArray)),
+                 m_relay,   SLOT (publishInfo (QByteArray)));
+        connect (camera,  SIGNAL (relayedImage (QByteArray, bool)),
+                 m_relay,   SLOT (publishImage (QByteArray, bool)));
+    }
+
+    /* Start timers when thread is started */
+    connect (thread, SIGNAL (started()),
+             camera,   SLOT (start()));
+
+    /* Move remote camera to different thread */
+    thread->start (QThread::HighPriority);
+    camera->moveToThread (thread);
+
+    /* Connect equivalent signals between station and camera */
+    connect (camera, SIGNAL (connected (int)),
+             this,   SIGNAL (connected (int)));
+    connect (camera, SIGNAL (disconnected (int)),
+             this,   SIGNAL (disconnected (int)));
+    connect (camera, SIGNAL (fpsChanged (int)),
+             this,   SIGNAL (fpsChanged (int)));
+    connect (camera, SIGNAL (bitrateChanged (int)),
+             this,   SIGNAL (bitrateChanged (int)));
+    connect (camera, SIGNAL (qualityChanged (int)),
+             this,   SIGNAL (qualityChanged (int)));
+    connect (camera, SIGNAL (newCameraName (int)),
+             this,   SIGNAL (cameraNameChanged (int)));
+    connect (camera, SIGNAL (newCameraStatus (int)),
+             this,   SIGNAL (cameraStatusChanged (int)));
+    connect (camera, SIGNAL (newImage (int)),
+             this,   SIGNAL (newCameraImage (int)));
+    connect (camera, SIGNAL (snapshotReceived (int)),
+             this,   SIGNAL (snapshotReceived (int)));
+    connect (camera, SIGNAL (zoomLevelChanged (int)),
+             this,   SIGNAL (zoomLevelChanged (int)));
+    connect (camera, SIGNAL (zoomSupportChanged (int)),
+             this,   SIGNAL (zoomSupportChanged (int)));
+    connect (camera, SIGNAL (resolutionChanged (int)),
+             this,   SIGNAL (resolutionChanged (int)));
+    connect (camera, SIGNAL (lightStatusChanged (int)),
+             this,   SIGNAL (lightStatusChanged (int)));
+    connect (camera, SIGNAL (autoRegulateResolutionChanged (int)),
+             this,   SIGNAL (autoRegulateResolutionChanged (int)));
+    connect (camera, SIGNAL (motionDetectedChanged (int)),
+             this,   SIGNAL (motionDetectedChanged (int)));
+    connect (camera, SIGNAL (regionOfInterestChanged (int)),
+             this,   SIGNAL (regionOfInterestChanged (int)));
+    connect (camera, SIGNAL (grayscaleChanged (int)),
+             this,   SIGNAL (grayscaleChanged (int)));
+    connect (camera, SIGNAL (cropChanged (int)),
+             this,   SIGNAL (cropChanged (int)));
+    connect (camera, SIGNAL (streamFlagsChanged (int)),
+             this,   SIGNAL (streamFlagsChanged (int)));
+    connect (camera, SIGNAL (newCameraGroup()),
+             this,     SLOT (updateGroups()));
+}
+
+/**
+ * Figures out from which remote camera did the \a data come from and instructs
+ * the remote camera manager assigned to that \a address to read the \a data
+ */
+void QCCTV_Station::readInfoPacket (const QHostAddress& address,
+                                    const QByteArray& data)
+{
+    int camera = indexOf (address, QCCTV_SESSION_PORT);
+    if (getCamera (camera))
+        getCamera (camera)->readInfoPacket (data);
+}
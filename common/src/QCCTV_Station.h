@@ -1,119 +1,185 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-#ifndef _QCCTV_STATION_H
-#define _QCCTV_STATION_H
-
-#include <QImage>
-#include <QObject>
-
-#include "QCCTV_RemoteCamera.h"
-
-class QThread;
-class QCCTV_Station : public QObject
-{
-    Q_OBJECT
-
-Q_SIGNALS:
-    void groupCountChanged();
-    void cameraCountChanged();
-    void recordingsPathChanged();
-    void saveIncomingMediaChanged();
-    void connected (const int camera);
-    void fpsChanged (const int camera);
-    void disconnected (const int camera);
-    void newCameraImage (const int camera);
-    void zoomLevelChanged (const int camera);
-    void cameraNameChanged (const int camera);
-    void resolutionChanged (const int camera);
-    void lightStatusChanged (const int camera);
-    void zoomSupportChanged (const int camera);
-    void cameraStatusChanged (const int camera);
-    void autoRegulateResolutionChanged (const int camera);
-
-public:
-    QCCTV_Station();
-    ~QCCTV_Station();
-
-    Q_INVOKABLE int minimumFPS() const;
-    Q_INVOKABLE int maximumFPS() const;
-
-    Q_INVOKABLE int groupCount() const;
-    Q_INVOKABLE int cameraCount() const;
-    Q_INVOKABLE int cameraCount (const int group) const;
-
-    Q_INVOKABLE QStringList groups() const;
-    Q_INVOKABLE QString recordingsPath() const;
-    Q_INVOKABLE bool saveIncomingMedia() const;
-    Q_INVOKABLE QStringList availableResolutions() const;
-
-    Q_INVOKABLE QList<int> getGroupCameraIDs (const int group) const;
-    Q_INVOKABLE QList<QCCTV_RemoteCamera*> getGroupCameras (const int group) const;
-
-    Q_INVOKABLE int fps (const int camera);
-    Q_INVOKABLE int zoom (const int camera);
-    Q_INVOKABLE int resolution (const int camera);
-    Q_INVOKABLE int cameraStatus (const int camera);
-    Q_INVOKABLE bool supportsZoom (const int camera);
-    Q_INVOKABLE QString cameraName (const int camera);
-    Q_INVOKABLE QImage currentImage (const int camera);
-    Q_INVOKABLE QHostAddress address (const int camera);
-    Q_INVOKABLE QString statusString (const int camera);
-    Q_INVOKABLE QString addressString (const int camera);
-    Q_INVOKABLE bool flashlightEnabled (const int camera);
-    Q_INVOKABLE bool flashlightAvailable (const int camera);
-    Q_INVOKABLE bool autoRegulateResolution (const int camera);
-
-    Q_INVOKABLE QList<QHostAddress> cameraIPs();
-    Q_INVOKABLE QString getGroupName (const int group);
-    Q_INVOKABLE QCCTV_RemoteCamera* getCamera (const int camera);
-
-public Q_SLOTS:
-    void updateGroups();
-    void removeAllCameras();
-    void openRecordingsPath();
-    void chooseRecordingsPath();
-    void focusCamera (const int camera);
-    void setSaveIncomingMedia (const bool save);
-    void setRecordingsPath (const QString& path);
-    void setZoom (const int camera, const int zoom);
-    void changeFPS (const int camera, const int fps);
-    void setFlashlightEnabledAll (const bool enabled);
-    void changeResolution (const int camera, const int resolution);
-    void setFlashlightEnabled (const int camera, const bool enabled);
-    void setAutoRegulateResolution (const int camera, const bool regulate);
-
-private Q_SLOTS:
-    void removeCamera (const int camera);
-    void connectToCamera (const QHostAddress& ip);
-    void readInfoPacket (const QHostAddress& address, const QByteArray& data);
-
-private:
-    QImage m_cameraError;
-    QStringList m_groups;
-    QString m_recordingsPath;
-    bool m_saveIncomingMedia;
-    QList<QThread*> m_threads;
-    QList<QCCTV_RemoteCamera*> m_cameras;
-};
-
-#endif
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#ifndef _QCCTV_STATION_H
+#define _QCCTV_STATION_H
+
+#include <QImage>
+#include <QObject>
+
+#include "QCCTV_RemoteCamera.h"
+
+class QThread;
+class QCCTV_Relay;
+class QCCTV_Station : public QObject
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void groupCountChanged();
+    void cameraCountChanged();
+    void recordingsPathChanged();
+    void saveIncomingMediaChanged();
+    void recordOnMotionOnlyChanged();
+    void udpTransportChanged();
+    void multicastChanged();
+    void relayEnabledChanged();
+    void motionAnalysisEnabledChanged();
+    void connected (const int camera);
+    void cropChanged (const int camera);
+    void fpsChanged (const int camera);
+    void bitrateChanged (const int camera);
+    void qualityChanged (const int camera);
+    void grayscaleChanged (const int camera);
+    void disconnected (const int camera);
+    void newCameraImage (const int camera);
+    void snapshotReceived (const int camera);
+    void zoomLevelChanged (const int camera);
+    void cameraNameChanged (const int camera);
+    void resolutionChanged (const int camera);
+    void streamFlagsChanged (const int camera);
+    void lightStatusChanged (const int camera);
+    void zoomSupportChanged (const int camera);
+    void cameraStatusChanged (const int camera);
+    void motionDetectedChanged (const int camera);
+    void regionOfInterestChanged (const int camera);
+    void autoRegulateResolutionChanged (const int camera);
+
+public:
+    QCCTV_Station();
+    ~QCCTV_Station();
+
+    Q_INVOKABLE int minimumFPS() const;
+    Q_INVOKABLE int maximumFPS() const;
+
+    Q_INVOKABLE int groupCount() const;
+    Q_INVOKABLE int cameraCount() const;
+    Q_INVOKABLE int cameraCount (const int group) const;
+
+    Q_INVOKABLE QStringList groups() const;
+    Q_INVOKABLE QString recordingsPath() const;
+    Q_INVOKABLE bool saveIncomingMedia() const;
+    Q_INVOKABLE bool recordOnMotionOnly() const;
+    Q_INVOKABLE bool udpTransportEnabled() const;
+    Q_INVOKABLE int udpParityGroup() const;
+    Q_INVOKABLE bool multicastEnabled() const;
+    Q_INVOKABLE bool relayEnabled() const;
+    Q_INVOKABLE bool motionAnalysisEnabled() const;
+    Q_INVOKABLE QStringList availableResolutions() const;
+
+    Q_INVOKABLE QList<int> getGroupCameraIDs (const int group) const;
+    Q_INVOKABLE QList<QCCTV_RemoteCamera*> getGroupCameras (const int group) const;
+
+    Q_INVOKABLE int fps (const int camera);
+    Q_INVOKABLE int minimumFPS (const int camera);
+    Q_INVOKABLE int maximumFPS (const int camera);
+    Q_INVOKABLE int zoom (const int camera);
+    Q_INVOKABLE int bitrate (const int camera);
+    Q_INVOKABLE int quality (const int camera);
+    Q_INVOKABLE int resolution (const int camera);
+    Q_INVOKABLE int cameraStatus (const int camera);
+    Q_INVOKABLE bool supportsZoom (const int camera);
+    Q_INVOKABLE QString cameraName (const int camera);
+    Q_INVOKABLE QImage currentImage (const int camera);
+    Q_INVOKABLE QImage snapshot (const int camera);
+    Q_INVOKABLE QString snapshotFile (const int camera);
+    Q_INVOKABLE QHostAddress address (const int camera);
+    Q_INVOKABLE QString statusString (const int camera);
+    Q_INVOKABLE QString addressString (const int camera);
+    Q_INVOKABLE bool flashlightEnabled (const int camera);
+    Q_INVOKABLE bool flashlightAvailable (const int camera);
+    Q_INVOKABLE bool grayscale (const int camera);
+    Q_INVOKABLE bool motionDetected (const int camera);
+    Q_INVOKABLE bool grayscaleEnabled (const int camera);
+    Q_INVOKABLE bool deltaFramesEnabled (const int camera);
+    Q_INVOKABLE bool abbreviatedJpegEnabled (const int camera);
+    Q_INVOKABLE bool noiseReductionEnabled (const int camera);
+    Q_INVOKABLE bool autoGrayscaleEnabled (const int camera);
+    Q_INVOKABLE bool autoRegulateResolution (const int camera);
+    Q_INVOKABLE QRectF regionOfInterest (const int camera);
+    Q_INVOKABLE QRectF crop (const int camera);
+
+    Q_INVOKABLE QList<QHostAddress> cameraIPs();
+    Q_INVOKABLE QString getGroupName (const int group);
+    Q_INVOKABLE QCCTV_RemoteCamera* getCamera (const int camera);
+
+public Q_SLOTS:
+    void updateGroups();
+    void removeAllCameras();
+    void openRecordingsPath();
+    void chooseRecordingsPath();
+    void focusCamera (const int camera);
+    void requestKeyframe (const int camera);
+    void requestSnapshot (const int camera);
+    void setSaveIncomingMedia (const bool save);
+    void setRecordOnMotionOnly (const bool enabled);
+    void setUdpTransportEnabled (const bool enabled);
+    void setUdpParityGroup (const int group);
+    void setMulticastEnabled (const bool enabled);
+    void setRelayEnabled (const bool enabled);
+    void setMotionAnalysisEnabled (const bool enabled);
+    void setRecordingsPath (const QString& path);
+    void setZoom (const int camera, const int zoom);
+    void changeFPS (const int camera, const int fps);
+    void changeBitrate (const int camera, const int bitrate);
+    void setFlashlightEnabledAll (const bool enabled);
+    void changeResolution (const int camera, const int resolution);
+    void setFlashlightEnabled (const int camera, const bool enabled);
+    void setDeltaFramesEnabled (const int camera, const bool enabled);
+    void setAbbreviatedJpegEnabled (const int camera, const bool enabled);
+    void setNoiseReductionEnabled (const int camera, const bool enabled);
+    void setGrayscaleEnabled (const int camera, const bool enabled);
+    void setAutoGrayscaleEnabled (const int camera, const bool enabled);
+    void setMotionAnalysisBudget (const int camera, const int budget);
+    void setAutoRegulateResolution (const int camera, const bool regulate);
+    void setRegionOfInterest (const int camera, const QRectF& roi);
+    void setCrop (const int camera, const QRectF& crop);
+
+private Q_SLOTS:
+    void removeCamera (const int camera);
+    void connectToCamera (const QHostAddress& ip,
+                          const quint16 port,
+                          const QHostAddress& source);
+    void readInfoPacket (const QHostAddress& address, const QByteArray& data);
+
+private:
+    void setStreamFlag (const int camera, const int flag, const bool enabled);
+    int indexOf (const QHostAddress& ip, const quint16 port);
+    int relayIndexOf (const QHostAddress& source);
+
+private:
+    QImage m_cameraError;
+    QStringList m_groups;
+    QString m_recordingsPath;
+    bool m_saveIncomingMedia;
+    bool m_recordOnMotionOnly;
+    bool m_udpTransport;
+    int m_udpParityGroup;
+    bool m_multicast;
+    QCCTV_Relay* m_relay;
+    bool m_motionAnalysisEnabled;
+    QList<QThread*> m_threads;
+    QList<QCCTV_RemoteCamera*> m_cameras;
+    QList<QHostAddress> m_sources;
+};
+
+#endif
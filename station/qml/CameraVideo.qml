@@ -1,44 +1,58 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-import QtQuick 2.0
-
-Image {
-    property int cameraId: 0
-
-    Connections {
-        target: QCCTVStation
-        onNewCameraImage: {
-            if (camera === cameraId && enabled) {
-                source = ""
-                source = "image://qcctv/" + cameraId
-            }
-        }
-    }
-
-    cache: false
-    smooth: true
-    asynchronous: true
-    fillMode: Image.PreserveAspectCrop
-    source: "image://qcctv/" + cameraId
-}
-
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+import QtQuick 2.0
+
+Image {
+    property int cameraId: 0
+    property bool motion: QCCTVStation.motionDetected (cameraId)
+
+    Connections {
+        target: QCCTVStation
+        onNewCameraImage: {
+            if (camera === cameraId && enabled) {
+                source = ""
+                source = "image://qcctv/" + cameraId
+            }
+        }
+        onMotionDetectedChanged: {
+            if (camera === cameraId)
+                motion = QCCTVStation.motionDetected (cameraId)
+        }
+    }
+
+    Rectangle {
+        border.width: 2
+        anchors.fill: parent
+        color: "transparent"
+        border.color: "#f44336"
+        opacity: motion ? 1 : 0
+        Behavior on opacity { NumberAnimation {} }
+    }
+
+    cache: false
+    smooth: true
+    asynchronous: true
+    fillMode: Image.PreserveAspectCrop
+    source: "image://qcctv/" + cameraId
+}
+
@@ -1,471 +1,813 @@
-/*
- * Copyright (c) 2016 Alex Spataru
- *
- * Permission is hereby granted, free of charge, to any person obtaining a copy
- * of this software and associated documentation files (the "Software"), to deal
- * in the Software without restriction, including without limitation the rights
- * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
- * copies of the Software, and to permit persons to whom the Software is
- * furnished to do so, subject to the following conditions:
- *
- * The above copyright notice and this permission notice shall be included in
- * all copies or substantial portions of the Software.
- *
- * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
- * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
- * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
- * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
- * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
- * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
- * DEALINGS IN THE SOFTWARE
- */
-
-import QtQuick 2.0
-import QtQuick.Layouts 1.0
-import QtQuick.Controls 2.0
-import QtQuick.Controls.Material 2.0
-
-Item {
-    id: cam
-
-    //
-    // Properties
-    //
-    property int fps: 0
-    property int camNumber: 0
-    property int resolution: 0
-    property bool flashOn: false
-    property string cameraName: ""
-    property string cameraStatus: ""
-    property bool autoRegulate: true
-    property bool zoomSupport: false
-    property bool controlsEnabled: true
-    property size buttonSize: Qt.size (36, 36)
-
-    //
-    // Update FPS automatically
-    //
-    onFpsChanged: {
-        fpsSpinbox.value = fps
-        fpsText.text = fps + " FPS"
-    }
-
-    //
-    // Update resolution indicator automatically
-    //
-    onResolutionChanged: resolutions.currentIndex = resolution
-
-    //
-    // Update auto-regulate checkbox automatically
-    //
-    onAutoRegulateChanged: {
-        autoRegulateCheck.checked = autoRegulate
-        QCCTVStation.setAutoRegulateResolution (camNumber, autoRegulate)
-    }
-
-    //
-    // Obtains latest camera data from QCCTV
-    //
-    function reloadData() {
-        fps = QCCTVStation.fps (camNumber)
-        resolution = QCCTVStation.resolution (camNumber)
-        cameraName = QCCTVStation.cameraName (camNumber)
-        zoomSupport = QCCTVStation.supportsZoom (camNumber)
-        flashOn = QCCTVStation.flashlightEnabled (camNumber)
-        cameraStatus = QCCTVStation.statusString (camNumber)
-        autoRegulate = QCCTVStation.autoRegulateResolution (camNumber)
-
-        fpsText.text = fps + " FPS"
-    }
-
-    //
-    // Hides the camera widget
-    //
-    function hideCamera() {
-        opacity = 0
-        enabled = 0
-    }
-
-    //
-    // Shows the camera widge
-    //
-    function showCamera (camera) {
-        opacity = 1
-        enabled = 1
-        camNumber = camera
-
-        reloadData()
-    }
-
-    //
-    // Load initial camera data during creation
-    //
-    Component.onCompleted: reloadData()
-
-    //
-    // React to QCCTV events
-    //
-    Connections {
-        target: QCCTVStation
-
-        onFpsChanged: {
-            if (camera === camNumber && enabled)
-                fps = QCCTVStation.fps (camNumber)
-        }
-
-        onLightStatusChanged: {
-            if (camera === camNumber && enabled)
-                flashOn = QCCTVStation.flashlightEnabled (camNumber)
-        }
-
-        onResolutionChanged: {
-            if (camera === camNumber && enabled)
-                resolution = QCCTVStation.resolution (camNumber)
-        }
-
-        onZoomSupportChanged: {
-            if (camera === camNumber && enabled)
-                zoomSupport = QCCTVStation.supportsZoom (camNumber)
-        }
-
-        onZoomLevelChanged: {
-            if (camera === camNumber && enabled)
-                zoomControl.value = QCCTVStation.zoom (camNumber)
-        }
-
-        onDisconnected: {
-            if (camera === cam.camNumber)
-                hideCamera()
-
-            if (QCCTVStation.cameraCount() === 1)
-                showCamera (0)
-        }
-
-        onCameraNameChanged: {
-            if (camera === camNumber)
-                cameraName = QCCTVStation.cameraName (camNumber)
-        }
-
-        onCameraStatusChanged: {
-            if (camera === camNumber)
-                cameraStatus = QCCTVStation.statusString (camNumber)
-        }
-
-        onAutoRegulateResolutionChanged: {
-            if (camera === camNumber)
-                autoRegulate = QCCTVStation.autoRegulateResolution (camNumber)
-        }
-
-        onCameraCountChanged: fpsDialog.close()
-    }
-
-    Behavior on opacity { NumberAnimation {}}
-
-    //
-    // Camera image
-    //
-    CameraVideo {
-        cameraId: camNumber
-        anchors.fill: parent
-        enabled: cam.enabled
-        fillMode: fillButton.checked ? Image.PreserveAspectFit :
-                                       Image.PreserveAspectCrop
-    }
-
-    //
-    // Toggler mouse area
-    //
-    MouseArea {
-        anchors.fill: parent
-        onClicked: controlsEnabled = !controlsEnabled
-    }
-
-    //
-    // Zoom control
-    //
-    Slider {
-        id: zoomControl
-
-        anchors {
-            right: parent.right
-            margins: app.spacing
-            verticalCenter: parent.verticalCenter
-        }
-
-        to: 100
-        from: 0
-        orientation: Qt.Vertical
-        height: app.height * 0.6
-        opacity: enabled ? 1 : 0
-        enabled: zoomSupport && zoomButton.checked && controlsEnabled
-
-        onVisualPositionChanged: {
-            if (orientation === Qt.Vertical)
-                QCCTVStation.setZoom (camNumber, (1 - visualPosition) * 100)
-            else
-                QCCTVStation.setZoom (camNumber, 1 - visualPosition * 100)
-        }
-
-        Behavior on opacity { NumberAnimation {} }
-    }
-
-    //
-    // Title labels
-    //
-    ColumnLayout {
-        spacing: app.spacing / 2
-
-        anchors {
-            top: parent.top
-            left: parent.left
-            margins: app.spacing
-        }
-
-        Label {
-            text: cameraName
-            background: Rectangle {
-                opacity: 0.65
-                color: app.backgroundColor
-            }
-        }
-
-        Label {
-            text: cameraStatus
-            color: app.disabledForegroundColor
-            background: Rectangle {
-                opacity: 0.65
-                color: app.backgroundColor
-            }
-        }
-
-        Label {
-            id: fpsText
-            color: app.disabledForegroundColor
-            background: Rectangle {
-                opacity: 0.65
-                color: app.backgroundColor
-            }
-        }
-    }
-
-    //
-    // Settings dialog
-    //
-    Popup {
-        id: fpsDialog
-
-        dim: true
-        modal: true
-
-        x: (parent.width - width) / 2
-        y: (parent.height - height) / 2
-
-        Material.theme: Material.Light
-
-        ColumnLayout {
-            spacing: app.spacing
-            anchors.centerIn: parent
-            anchors.margins: app.spacing
-
-            Label {
-                text: qsTr ("Set target FPS") + ":"
-            }
-
-            SpinBox {
-                id: fpsSpinbox
-                Layout.fillWidth: true
-                Layout.minimumWidth: 180
-                to: QCCTVStation.maximumFPS()
-                from: QCCTVStation.minimumFPS()
-                onValueChanged: QCCTVStation.changeFPS (camNumber, value)
-            }
-
-            Label {
-                text: qsTr ("Video Resolution") + ":"
-            }
-
-            ComboBox {
-                id: resolutions
-                Layout.fillWidth: true
-                Layout.minimumWidth: 220
-                model: QCCTVStation.availableResolutions()
-
-                property bool firstIndexChange: true
-
-                onCurrentIndexChanged: {
-                    if (!firstIndexChange)
-                        QCCTVStation.changeResolution (camNumber, currentIndex)
-                    else
-                        firstIndexChange = false
-                }
-            }
-
-            Switch {
-                id: autoRegulateCheck
-                text: qsTr ("Auto-regulate video resolution")
-                onCheckedChanged: autoRegulate = checked
-            }
-
-            Item {
-                Layout.minimumHeight: app.spacing * 2
-            }
-
-            Button {
-                text: qsTr ("Close")
-                Layout.fillWidth: true
-                onClicked: fpsDialog.close()
-            }
-        }
-    }
-
-    //
-    // Camera Controls
-    //
-    RowLayout {
-        spacing: app.spacing
-        opacity: controlsEnabled ? 1 : 0
-
-        Behavior on opacity { NumberAnimation{} }
-
-        anchors {
-            left: parent.left
-            right: parent.right
-            bottom: parent.bottom
-            margins: app.spacing
-        }
-
-        //
-        // Tooltip
-        //
-        ToolTip {
-            id: tooltip
-            timeout: 2000
-        }
-
-        //
-        // Spacer
-        //
-        Item {
-            Layout.fillWidth: true
-        }
-
-        //
-        // Back Button
-        //
-        Button {
-            id: backButton
-
-            contentItem: Image {
-                fillMode: Image.Pad
-                sourceSize: cam.buttonSize
-                source: app.getIcon ("back.svg")
-                verticalAlignment: Image.AlignVCenter
-                horizontalAlignment: Image.AlignHCenter
-            }
-
-            onClicked: hideCamera()
-        }
-
-        //
-        // FPS button
-        //
-        Button {
-            contentItem: Image {
-                fillMode: Image.Pad
-                sourceSize: cam.buttonSize
-                source: app.getIcon ("settings.svg")
-                verticalAlignment: Image.AlignVCenter
-                horizontalAlignment: Image.AlignHCenter
-            }
-
-            onClicked: fpsDialog.open()
-        }
-
-        //
-        // Light button
-        //
-        Button {
-            contentItem: Image {
-                fillMode: Image.Pad
-                sourceSize: cam.buttonSize
-                verticalAlignment: Image.AlignVCenter
-                horizontalAlignment: Image.AlignHCenter
-                source: flashOn ? app.getIcon ("flash-on.svg") :
-                                  app.getIcon ("flash-off.svg")
-            }
-
-            onClicked: {
-                flashOn = !flashOn
-
-                if (QCCTVStation.flashlightAvailable (camNumber))
-                    QCCTVStation.setFlashlightEnabled (camNumber, flashOn)
-
-                else {
-                    flashOn = false
-                    tooltip.text = qsTr ("Flashlight Error")
-                    tooltip.visible = true
-                }
-            }
-        }
-
-        //
-        // Focus button
-        //
-        Button {
-            contentItem: Image {
-                fillMode: Image.Pad
-                sourceSize: cam.buttonSize
-                source: app.getIcon ("focus.svg")
-                verticalAlignment: Image.AlignVCenter
-                horizontalAlignment: Image.AlignHCenter
-            }
-
-            onClicked: {
-                QCCTVStation.focusCamera (camNumber)
-                tooltip.text = qsTr ("Focusing Camera") + "..."
-                tooltip.visible = true
-            }
-        }
-
-        //
-        // Fill/fit button
-        //
-        Button {
-            id: fillButton
-            checkable: true
-            contentItem: Image {
-                fillMode: Image.Pad
-                sourceSize: cam.buttonSize
-                verticalAlignment: Image.AlignVCenter
-                horizontalAlignment: Image.AlignHCenter
-                source: fillButton.checked ? app.getIcon ("fill.svg") :
-                                             app.getIcon ("fit.svg")
-            }
-        }
-
-        //
-        // Zoom button
-        //
-        Button {
-            id: zoomButton
-            checkable: true
-            enabled: zoomSupport
-            visible: zoomSupport
-
-            contentItem: Image {
-                fillMode: Image.Pad
-                sourceSize: cam.buttonSize
-                source: app.getIcon ("zoom.svg")
-                verticalAlignment: Image.AlignVCenter
-                horizontalAlignment: Image.AlignHCenter
-            }
-        }
-
-        //
-        // Spacer
-        //
-        Item {
-            Layout.fillWidth: true
-        }
-    }
-}
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+import QtQuick 2.0
+import QtQuick.Layouts 1.0
+import QtQuick.Controls 2.0
+import QtQuick.Controls.Material 2.0
+
+Item {
+    id: cam
+
+    //
+    // Properties
+    //
+    property int fps: 0
+    property int minFps: 1
+    property int maxFps: 0
+    property int bitrate: 0
+    property int quality: 0
+    property int camNumber: 0
+    property int resolution: 0
+    property bool flashOn: false
+    property string cameraName: ""
+    property string cameraStatus: ""
+    property bool autoRegulate: true
+    property bool deltaFrames: false
+    property bool abbreviatedJpeg: false
+    property bool noiseReduction: false
+    property bool grayscale: false
+    property bool grayscaleEnabled: false
+    property bool autoGrayscale: false
+    property string selectionTarget: ""
+    property rect crop: Qt.rect (0, 0, 0, 0)
+    property rect regionOfInterest: Qt.rect (0, 0, 0, 0)
+    property bool zoomSupport: false
+    property bool controlsEnabled: true
+    property size buttonSize: Qt.size (36, 36)
+
+    //
+    // Update FPS automatically
+    //
+    onFpsChanged: {
+        fpsSpinbox.value = fps
+        updateFpsText()
+    }
+
+    //
+    // Update bitrate and quality indicators automatically
+    //
+    onBitrateChanged: bitrateSpinbox.value = bitrate
+    onQualityChanged: updateFpsText()
+
+    //
+    // Update resolution indicator automatically
+    //
+    onResolutionChanged: resolutions.currentIndex = resolution
+
+    //
+    // Update auto-regulate checkbox automatically
+    //
+    onAutoRegulateChanged: {
+        autoRegulateCheck.checked = autoRegulate
+        QCCTVStation.setAutoRegulateResolution (camNumber, autoRegulate)
+    }
+
+    //
+    // Update delta frames checkbox automatically
+    //
+    onDeltaFramesChanged: {
+        deltaFramesCheck.checked = deltaFrames
+        QCCTVStation.setDeltaFramesEnabled (camNumber, deltaFrames)
+    }
+
+    //
+    // Update abbreviated JPEG checkbox automatically
+    //
+    onAbbreviatedJpegChanged: {
+        abbreviatedJpegCheck.checked = abbreviatedJpeg
+        QCCTVStation.setAbbreviatedJpegEnabled (camNumber, abbreviatedJpeg)
+    }
+
+    //
+    // Update noise reduction checkbox automatically
+    //
+    onNoiseReductionChanged: {
+        noiseReductionCheck.checked = noiseReduction
+        QCCTVStation.setNoiseReductionEnabled (camNumber, noiseReduction)
+    }
+
+    //
+    // Update grayscale checkbox automatically
+    //
+    onGrayscaleEnabledChanged: {
+        grayscaleCheck.checked = grayscaleEnabled
+        QCCTVStation.setGrayscaleEnabled (camNumber, grayscaleEnabled)
+    }
+
+    //
+    // Update automatic grayscale checkbox automatically
+    //
+    onAutoGrayscaleChanged: {
+        autoGrayscaleCheck.checked = autoGrayscale
+        QCCTVStation.setAutoGrayscaleEnabled (camNumber, autoGrayscale)
+    }
+
+    //
+    // Update grayscale indicator automatically
+    //
+    onGrayscaleChanged: updateFpsText()
+
+    //
+    // Obtains latest camera data from QCCTV
+    //
+    function reloadData() {
+        minFps = Math.max (QCCTVStation.minimumFPS (camNumber), 1)
+        maxFps = Math.max (QCCTVStation.maximumFPS (camNumber), QCCTVStation.maximumFPS())
+        fps = QCCTVStation.fps (camNumber)
+        bitrate = QCCTVStation.bitrate (camNumber)
+        quality = QCCTVStation.quality (camNumber)
+        resolution = QCCTVStation.resolution (camNumber)
+        cameraName = QCCTVStation.cameraName (camNumber)
+        zoomSupport = QCCTVStation.supportsZoom (camNumber)
+        flashOn = QCCTVStation.flashlightEnabled (camNumber)
+        cameraStatus = QCCTVStation.statusString (camNumber)
+        autoRegulate = QCCTVStation.autoRegulateResolution (camNumber)
+        deltaFrames = QCCTVStation.deltaFramesEnabled (camNumber)
+        abbreviatedJpeg = QCCTVStation.abbreviatedJpegEnabled (camNumber)
+        noiseReduction = QCCTVStation.noiseReductionEnabled (camNumber)
+        crop = QCCTVStation.crop (camNumber)
+        regionOfInterest = QCCTVStation.regionOfInterest (camNumber)
+        grayscale = QCCTVStation.grayscale (camNumber)
+        grayscaleEnabled = QCCTVStation.grayscaleEnabled (camNumber)
+        autoGrayscale = QCCTVStation.autoGrayscaleEnabled (camNumber)
+
+        updateFpsText()
+    }
+
+    //
+    // Shows the FPS and the JPEG quality of the camera
+    //
+    function updateFpsText() {
+        fpsText.text = fps + " FPS, " + qsTr ("Quality") + " " + quality + "%"
+        if (grayscale)
+            fpsText.text += ", " + qsTr ("Grayscale")
+    }
+
+    //
+    // Hides the camera widget
+    //
+    function hideCamera() {
+        opacity = 0
+        enabled = 0
+        selectionTarget = ""
+    }
+
+    //
+    // Shows the camera widge
+    //
+    function showCamera (camera) {
+        opacity = 1
+        enabled = 1
+        camNumber = camera
+
+        reloadData()
+    }
+
+    //
+    // Load initial camera data during creation
+    //
+    Component.onCompleted: reloadData()
+
+    //
+    // React to QCCTV events
+    //
+    Connections {
+        target: QCCTVStation
+
+        onFpsChanged: {
+            if (camera === camNumber && enabled) {
+                minFps = Math.max (QCCTVStation.minimumFPS (camNumber), 1)
+                maxFps = Math.max (QCCTVStation.maximumFPS (camNumber), QCCTVStation.maximumFPS())
+                fps = QCCTVStation.fps (camNumber)
+            }
+        }
+
+        onBitrateChanged: {
+            if (camera === camNumber && enabled)
+                bitrate = QCCTVStation.bitrate (camNumber)
+        }
+
+        onQualityChanged: {
+            if (camera === camNumber && enabled)
+                quality = QCCTVStation.quality (camNumber)
+        }
+
+        onLightStatusChanged: {
+            if (camera === camNumber && enabled)
+                flashOn = QCCTVStation.flashlightEnabled (camNumber)
+        }
+
+        onResolutionChanged: {
+            if (camera === camNumber && enabled)
+                resolution = QCCTVStation.resolution (camNumber)
+        }
+
+        onZoomSupportChanged: {
+            if (camera === camNumber && enabled)
+                zoomSupport = QCCTVStation.supportsZoom (camNumber)
+        }
+
+        onZoomLevelChanged: {
+            if (camera === camNumber && enabled)
+                zoomControl.value = QCCTVStation.zoom (camNumber)
+        }
+
+        onDisconnected: {
+            if (camera === cam.camNumber)
+                hideCamera()
+
+            if (QCCTVStation.cameraCount() === 1)
+                showCamera (0)
+        }
+
+        onCameraNameChanged: {
+            if (camera === camNumber)
+                cameraName = QCCTVStation.cameraName (camNumber)
+        }
+
+        onCameraStatusChanged: {
+            if (camera === camNumber)
+                cameraStatus = QCCTVStation.statusString (camNumber)
+        }
+
+        onAutoRegulateResolutionChanged: {
+            if (camera === camNumber)
+                autoRegulate = QCCTVStation.autoRegulateResolution (camNumber)
+        }
+
+        onStreamFlagsChanged: {
+            if (camera === camNumber) {
+                deltaFrames = QCCTVStation.deltaFramesEnabled (camNumber)
+                abbreviatedJpeg = QCCTVStation.abbreviatedJpegEnabled (camNumber)
+                noiseReduction = QCCTVStation.noiseReductionEnabled (camNumber)
+                grayscaleEnabled = QCCTVStation.grayscaleEnabled (camNumber)
+                autoGrayscale = QCCTVStation.autoGrayscaleEnabled (camNumber)
+            }
+        }
+
+        onGrayscaleChanged: {
+            if (camera === camNumber)
+                grayscale = QCCTVStation.grayscale (camNumber)
+        }
+
+        onRegionOfInterestChanged: {
+            if (camera === camNumber)
+                regionOfInterest = QCCTVStation.regionOfInterest (camNumber)
+        }
+
+        onCropChanged: {
+            if (camera === camNumber)
+                crop = QCCTVStation.crop (camNumber)
+        }
+
+        onSnapshotReceived: {
+            if (camera === camNumber) {
+                snapshotPreview.source = ""
+                snapshotPreview.source = "image://qcctv/snapshot/" + camNumber
+                snapshotPreview.visible = true
+                snapshotTimer.restart()
+
+                tooltip.text = qsTr ("Snapshot saved to %1").arg (
+                            QCCTVStation.snapshotFile (camNumber))
+                tooltip.visible = true
+            }
+        }
+
+        onCameraCountChanged: fpsDialog.close()
+    }
+
+    Behavior on opacity { NumberAnimation {}}
+
+    //
+    // Camera image
+    //
+    CameraVideo {
+        id: video
+        cameraId: camNumber
+        anchors.fill: parent
+        enabled: cam.enabled
+        fillMode: fillButton.checked ? Image.PreserveAspectFit :
+                                       Image.PreserveAspectCrop
+    }
+
+    //
+    // Toggler mouse area
+    //
+    MouseArea {
+        anchors.fill: parent
+        onClicked: controlsEnabled = !controlsEnabled
+    }
+
+    //
+    // Snapshot preview
+    //
+    Image {
+        id: snapshotPreview
+        cache: false
+        smooth: true
+        visible: false
+        asynchronous: true
+        fillMode: Image.PreserveAspectFit
+        width: parent.width / 4
+        height: parent.height / 4
+
+        anchors {
+            top: parent.top
+            right: parent.right
+            margins: app.spacing
+        }
+
+        Timer {
+            id: snapshotTimer
+            interval: 3000
+            onTriggered: snapshotPreview.visible = false
+        }
+    }
+
+    //
+    // Region of interest indicator
+    //
+    Rectangle {
+        border.width: 2
+        color: "transparent"
+        border.color: "#ffc107"
+        visible: regionOfInterest.width > 0 && crop.width === 0 &&
+                 selectionTarget === ""
+
+        x: (video.width - video.paintedWidth) / 2 +
+           regionOfInterest.x * video.paintedWidth
+        y: (video.height - video.paintedHeight) / 2 +
+           regionOfInterest.y * video.paintedHeight
+        width: regionOfInterest.width * video.paintedWidth
+        height: regionOfInterest.height * video.paintedHeight
+    }
+
+    //
+    // Region of interest and digital zoom selector
+    //
+    MouseArea {
+        anchors.fill: parent
+        enabled: selectionTarget !== ""
+        visible: selectionTarget !== ""
+
+        property point origin: Qt.point (0, 0)
+        property rect selection: Qt.rect (0, 0, 0, 0)
+
+        onPressed: {
+            origin = Qt.point (mouse.x, mouse.y)
+            selection = Qt.rect (mouse.x, mouse.y, 0, 0)
+        }
+
+        onPositionChanged: {
+            selection = Qt.rect (Math.min (origin.x, mouse.x),
+                                 Math.min (origin.y, mouse.y),
+                                 Math.abs (mouse.x - origin.x),
+                                 Math.abs (mouse.y - origin.y))
+        }
+
+        onReleased: {
+            var x = (video.width - video.paintedWidth) / 2
+            var y = (video.height - video.paintedHeight) / 2
+            var roi = Qt.rect ((selection.x - x) / video.paintedWidth,
+                               (selection.y - y) / video.paintedHeight,
+                               selection.width / video.paintedWidth,
+                               selection.height / video.paintedHeight)
+
+            /* Zoom into the current crop */
+            if (selectionTarget === "crop") {
+                if (crop.width > 0)
+                    roi = Qt.rect (crop.x + roi.x * crop.width,
+                                   crop.y + roi.y * crop.height,
+                                   roi.width * crop.width,
+                                   roi.height * crop.height)
+
+                QCCTVStation.setCrop (camNumber, roi)
+            }
+
+            else
+                QCCTVStation.setRegionOfInterest (camNumber, roi)
+
+            selectionTarget = ""
+        }
+
+        Rectangle {
+            border.width: 2
+            color: "transparent"
+            border.color: "#ffc107"
+            x: parent.selection.x
+            y: parent.selection.y
+            width: parent.selection.width
+            height: parent.selection.height
+        }
+    }
+
+    //
+    // Zoom control
+    //
+    Slider {
+        id: zoomControl
+
+        anchors {
+            right: parent.right
+            margins: app.spacing
+            verticalCenter: parent.verticalCenter
+        }
+
+        to: 100
+        from: 0
+        orientation: Qt.Vertical
+        height: app.height * 0.6
+        opacity: enabled ? 1 : 0
+        enabled: zoomSupport && zoomButton.checked && controlsEnabled
+
+        onVisualPositionChanged: {
+            if (orientation === Qt.Vertical)
+                QCCTVStation.setZoom (camNumber, (1 - visualPosition) * 100)
+            else
+                QCCTVStation.setZoom (camNumber, 1 - visualPosition * 100)
+        }
+
+        Behavior on opacity { NumberAnimation {} }
+    }
+
+    //
+    // Title labels
+    //
+    ColumnLayout {
+        spacing: app.spacing / 2
+
+        anchors {
+            top: parent.top
+            left: parent.left
+            margins: app.spacing
+        }
+
+        Label {
+            text: cameraName
+            background: Rectangle {
+                opacity: 0.65
+                color: app.backgroundColor
+            }
+        }
+
+        Label {
+            text: cameraStatus
+            color: app.disabledForegroundColor
+            background: Rectangle {
+                opacity: 0.65
+                color: app.backgroundColor
+            }
+        }
+
+        Label {
+            id: fpsText
+            color: app.disabledForegroundColor
+            background: Rectangle {
+                opacity: 0.65
+                color: app.backgroundColor
+            }
+        }
+    }
+
+    //
+    // Settings dialog
+    //
+    Popup {
+        id: fpsDialog
+
+        dim: true
+        modal: true
+
+        x: (parent.width - width) / 2
+        y: (parent.height - height) / 2
+
+        Material.theme: Material.Light
+
+        ColumnLayout {
+            spacing: app.spacing
+            anchors.centerIn: parent
+            anchors.margins: app.spacing
+
+            Label {
+                text: qsTr ("Set target FPS") + ":"
+            }
+
+            SpinBox {
+                id: fpsSpinbox
+                Layout.fillWidth: true
+                Layout.minimumWidth: 180
+                to: maxFps
+                from: minFps
+                onValueChanged: QCCTVStation.changeFPS (camNumber, value)
+            }
+
+            Label {
+                text: qsTr ("Target bitrate (kbit/s)") + ":"
+            }
+
+            SpinBox {
+                id: bitrateSpinbox
+                from: 0
+                to: 20000
+                stepSize: 250
+                editable: true
+                Layout.fillWidth: true
+                onValueChanged: QCCTVStation.changeBitrate (camNumber, value)
+            }
+
+            Label {
+                text: qsTr ("Video Resolution") + ":"
+            }
+
+            ComboBox {
+                id: resolutions
+                Layout.fillWidth: true
+                Layout.minimumWidth: 220
+                model: QCCTVStation.availableResolutions()
+
+                property bool firstIndexChange: true
+
+                onCurrentIndexChanged: {
+                    if (!firstIndexChange)
+                        QCCTVStation.changeResolution (camNumber, currentIndex)
+                    else
+                        firstIndexChange = false
+                }
+            }
+
+            Switch {
+                id: autoRegulateCheck
+                text: qsTr ("Auto-regulate video resolution")
+                onCheckedChanged: autoRegulate = checked
+            }
+
+            Switch {
+                id: deltaFramesCheck
+                text: qsTr ("Only send changed image blocks")
+                onCheckedChanged: deltaFrames = checked
+            }
+
+            Switch {
+                id: abbreviatedJpegCheck
+                text: qsTr ("Only send JPEG tables when they change")
+                onCheckedChanged: abbreviatedJpeg = checked
+            }
+
+            Switch {
+                id: noiseReductionCheck
+                text: qsTr ("Reduce image noise")
+                onCheckedChanged: noiseReduction = checked
+            }
+
+            Switch {
+                id: grayscaleCheck
+                text: qsTr ("Send grayscale images")
+                onCheckedChanged: grayscaleEnabled = checked
+            }
+
+            Switch {
+                id: autoGrayscaleCheck
+                text: qsTr ("Send grayscale images when there is no color")
+                onCheckedChanged: autoGrayscale = checked
+            }
+
+            Button {
+                text: qsTr ("Select region of interest")
+                Layout.fillWidth: true
+                enabled: crop.width === 0
+                onClicked: {
+                    fpsDialog.close()
+                    selectionTarget = "roi"
+                    tooltip.text = qsTr ("Drag over the image to select the region of interest")
+                    tooltip.visible = true
+                }
+            }
+
+            Button {
+                text: qsTr ("Clear region of interest")
+                Layout.fillWidth: true
+                enabled: regionOfInterest.width > 0
+                onClicked: QCCTVStation.setRegionOfInterest (camNumber,
+                                                             Qt.rect (0, 0, 0, 0))
+            }
+
+            Button {
+                text: qsTr ("Digital zoom")
+                Layout.fillWidth: true
+                onClicked: {
+                    fpsDialog.close()
+                    selectionTarget = "crop"
+                    tooltip.text = qsTr ("Drag over the image to select the region to zoom into")
+                    tooltip.visible = true
+                }
+            }
+
+            Button {
+                text: qsTr ("Reset digital zoom")
+                Layout.fillWidth: true
+                enabled: crop.width > 0
+                onClicked: QCCTVStation.setCrop (camNumber, Qt.rect (0, 0, 0, 0))
+            }
+
+            Item {
+                Layout.minimumHeight: app.spacing * 2
+            }
+
+            Button {
+                text: qsTr ("Close")
+                Layout.fillWidth: true
+                onClicked: fpsDialog.close()
+            }
+        }
+    }
+
+    //
+    // Camera Controls
+    //
+    RowLayout {
+        spacing: app.spacing
+        opacity: controlsEnabled ? 1 : 0
+
+        Behavior on opacity { NumberAnimation{} }
+
+        anchors {
+            left: parent.left
+            right: parent.right
+            bottom: parent.bottom
+            margins: app.spacing
+        }
+
+        //
+        // Tooltip
+        //
+        ToolTip {
+            id: tooltip
+            timeout: 2000
+        }
+
+        //
+        // Spacer
+        //
+        Item {
+            Layout.fillWidth: true
+        }
+
+        //
+        // Back Button
+        //
+        Button {
+            id: backButton
+
+            contentItem: Image {
+                fillMode: Image.Pad
+                sourceSize: cam.buttonSize
+                source: app.getIcon ("back.svg")
+                verticalAlignment: Image.AlignVCenter
+                horizontalAlignment: Image.AlignHCenter
+            }
+
+            onClicked: hideCamera()
+        }
+
+        //
+        // FPS button
+        //
+        Button {
+            contentItem: Image {
+                fillMode: Image.Pad
+                sourceSize: cam.buttonSize
+                source: app.getIcon ("settings.svg")
+                verticalAlignment: Image.AlignVCenter
+                horizontalAlignment: Image.AlignHCenter
+            }
+
+            onClicked: fpsDialog.open()
+        }
+
+        //
+        // Light button
+        //
+        Button {
+            contentItem: Image {
+                fillMode: Image.Pad
+                sourceSize: cam.buttonSize
+                verticalAlignment: Image.AlignVCenter
+                horizontalAlignment: Image.AlignHCenter
+                source: flashOn ? app.getIcon ("flash-on.svg") :
+                                  app.getIcon ("flash-off.svg")
+            }
+
+            onClicked: {
+                flashOn = !flashOn
+
+                if (QCCTVStation.flashlightAvailable (camNumber))
+                    QCCTVStation.setFlashlightEnabled (camNumber, flashOn)
+
+                else {
+                    flashOn = false
+                    tooltip.text = qsTr ("Flashlight Error")
+                    tooltip.visible = true
+                }
+            }
+        }
+
+        //
+        // Focus button
+        //
+        Button {
+            contentItem: Image {
+                fillMode: Image.Pad
+                sourceSize: cam.buttonSize
+                source: app.getIcon ("focus.svg")
+                verticalAlignment: Image.AlignVCenter
+                horizontalAlignment: Image.AlignHCenter
+            }
+
+            onClicked: {
+                QCCTVStation.focusCamera (camNumber)
+                tooltip.text = qsTr ("Focusing Camera") + "..."
+                tooltip.visible = true
+            }
+        }
+
+        //
+        // Snapshot button
+        //
+        Button {
+            contentItem: Image {
+                fillMode: Image.Pad
+                sourceSize: cam.buttonSize
+                source: app.getIcon ("download.svg")
+                verticalAlignment: Image.AlignVCenter
+                horizontalAlignment: Image.AlignHCenter
+            }
+
+            onClicked: {
+                QCCTVStation.requestSnapshot (camNumber)
+                tooltip.text = qsTr ("Requesting Snapshot") + "..."
+                tooltip.visible = true
+            }
+        }
+
+        //
+        // Fill/fit button
+        //
+        Button {
+            id: fillButton
+            checkable: true
+            contentItem: Image {
+                fillMode: Image.Pad
+                sourceSize: cam.buttonSize
+                verticalAlignment: Image.AlignVCenter
+                horizontalAlignment: Image.AlignHCenter
+                source: fillButton.checked ? app.getIcon ("fill.svg") :
+                                             app.getIcon ("fit.svg")
+            }
+        }
+
+        //
+        // Zoom button
+        //
+        Button {
+            id: zoomButton
+            checkable: true
+            enabled: zoomSupport
+            visible: zoomSupport
+
+            contentItem: Image {
+                fillMode: Image.Pad
+                sourceSize: cam.buttonSize
+                source: app.getIcon ("zoom.svg")
+                verticalAlignment: Image.AlignVCenter
+                horizontalAlignment: Image.AlignHCenter
+            }
+        }
+
+        //
+        // Spacer
+        //
+        Item {
+            Layout.fillWidth: true
+        }
+    }
+}
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include <QtTest>
+#include <QUdpSocket>
+#include <QElapsedTimer>
+
+#include "QCCTV.h"
+#include "QCCTV_DatagramStream.h"
+
+/*
+ * Frame lengths used by the tests: a frame with a partial parity group (four
+ * full fragments and a short one) and a frame with a single full parity
+ * group that ends with a short fragment
+ */
+static const int PARTIAL_GROUP_FRAME = 4 * QCCTV_UDP_FRAGMENT_SIZE + 300;
+static const int FULL_GROUP_FRAME    = 3 * QCCTV_UDP_FRAGMENT_SIZE + 500;
+
+/*
+ * Time to wait for datagrams that should (or should not) arrive
+ */
+static const int WAIT_TIME = 100;
+
+/*
+ * State of the pseudo-random generator (fixed seed, so that a failure can
+ * always be reproduced)
+ */
+static quint32 SEED = 0;
+
+/**
+ * Returns a frame with the given \a length filled with pseudo-random bytes
+ */
+static QByteArray random_frame (const int length)
+{
+    QByteArray data (length, 0);
+    for (int i = 0; i < length; ++i) {
+        SEED = SEED * 1664525 + 1013904223;
+        data [i] = (char) (SEED >> 24);
+    }
+
+    return data;
+}
+
+/**
+ * Returns the number of datagrams (data and parity fragments) sent for a
+ * frame with the given \a length
+ */
+static int datagram_count (const int length)
+{
+    int count = (length + QCCTV_UDP_FRAGMENT_SIZE - 1) / QCCTV_UDP_FRAGMENT_SIZE;
+    return count + (count + QCCTV_UDP_PARITY_GROUP - 1) / QCCTV_UDP_PARITY_GROUP;
+}
+
+/**
+ * Returns \c true if the given \a datagram is a parity fragment
+ */
+static bool is_parity (const QByteArray& datagram)
+{
+    return datagram.at (6) != 0;
+}
+
+/**
+ * Returns the index of the given (data or parity) \a datagram
+ */
+static int fragment_index (const QByteArray& datagram)
+{
+    return ((quint8) datagram.at (2) << 8) | (quint8) datagram.at (3);
+}
+
+/**
+ * Returns the given \a datagrams without the data fragments with the given
+ * \a indexes
+ */
+static QList<QByteArray> drop_fragments (const QList<QByteArray>& datagrams,
+                                         const QList<int>& indexes)
+{
+    QList<QByteArray> output;
+    foreach (const QByteArray& datagram, datagrams)
+        if (is_parity (datagram) || !indexes.contains (fragment_index (datagram)))
+            output.append (datagram);
+
+    return output;
+}
+
+/**
+ * \brief Lossy network link between two datagram streams.
+ *
+ * Receives the datagrams of the sender, which the test forwards (in any
+ * order) or drops. The frame IDs are shifted by a fixed offset when the
+ * datagrams are forwarded, so that the receiver sees the 16-bit frame IDs
+ * wrap around after a few frames.
+ */
+class QCCTV_LossyLink
+{
+public:
+    QCCTV_LossyLink()
+    {
+        m_offset = 0;
+        m_destination = 0;
+        m_socket.bind (QHostAddress::LocalHost, 0);
+    }
+
+    quint16 port() const
+    {
+        return m_socket.localPort();
+    }
+
+    void setIdOffset (const quint16 offset)
+    {
+        m_offset = offset;
+    }
+
+    void setDestination (const quint16 port)
+    {
+        m_destination = port;
+    }
+
+    /**
+     * Waits for the given \a count of datagrams from the sender and returns
+     * them (in the order in which they were received)
+     */
+    QList<QByteArray> receive (const int count)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        QList<QByteArray> datagrams;
+        while (datagrams.count() < count && timer.elapsed() < WAIT_TIME * 10) {
+            if (!m_socket.hasPendingDatagrams())
+                m_socket.waitForReadyRead (WAIT_TIME);
+
+            while (m_socket.hasPendingDatagrams()) {
+                QByteArray datagram;
+                datagram.resize (m_socket.pendingDatagramSize());
+                m_socket.readDatagram (datagram.data(), datagram.size());
+                datagrams.append (datagram);
+            }
+        }
+
+        return datagrams;
+    }
+
+    /**
+     * Sends the given \a datagrams to the receiver (with the shifted frame ID)
+     */
+    void forward (const QList<QByteArray>& datagrams)
+    {
+        foreach (QByteArray datagram, datagrams) {
+            quint16 id = (((quint8) datagram.at (0) << 8) |
+                          (quint8) datagram.at (1)) + m_offset;
+            datagram [0] = (char) (id >> 8);
+            datagram [1] = (char) (id & 0xff);
+            m_socket.writeDatagram (datagram, QHostAddress::LocalHost,
+                                    m_destination);
+        }
+    }
+
+private:
+    quint16 m_offset;
+    quint16 m_destination;
+    QUdpSocket m_socket;
+};
+
+/*
+ * Drops and reorders the datagrams sent between two datagram streams on the
+ * loopback interface and checks the frames reported by the receiver
+ */
+class QCCTV_DatagramStreamTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void recoverFragments_data();
+    void recoverFragments();
+    void unrecoverableFragments();
+    void reorderedFragments_data();
+    void reorderedFragments();
+    void retransmittedFrameWrapAround();
+    void reorderedFramesWrapAround();
+    void retransmissionTimeout();
+
+private:
+    void setIdOffset (const quint16 offset);
+    QList<QByteArray> send (const QByteArray& frame);
+    QList<QByteArray> received() const;
+
+private:
+    bool m_answer;
+    quint16 m_offset;
+    QList<quint16> m_missing;
+
+    QCCTV_LossyLink* m_link;
+    QSignalSpy* m_lostSpy;
+    QSignalSpy* m_receivedSpy;
+    QCCTV_DatagramStream* m_sender;
+    QCCTV_DatagramStream* m_receiver;
+};
+
+/**
+ * Creates the sender, the receiver and the link between them. Frames that
+ * the receiver asks for are retransmitted by the test if \c m_answer is set
+ * (the way the session retransmits them through its TCP connection)
+ */
+void QCCTV_DatagramStreamTest::init()
+{
+    SEED = 1;
+    m_offset = 0;
+    m_answer = false;
+    m_missing.clear();
+
+    m_link = new QCCTV_LossyLink;
+    m_sender = new QCCTV_DatagramStream;
+    m_receiver = new QCCTV_DatagramStream;
+
+    QVERIFY (m_receiver->listen());
+    m_link->setDestination (m_receiver->port());
+    m_sender->setDestination (QHostAddress::LocalHost, m_link->port());
+
+    m_lostSpy = new QSignalSpy (m_receiver, SIGNAL (framesLost()));
+    m_receivedSpy = new QSignalSpy (m_receiver, SIGNAL (frameReceived (QByteArray)));
+
+    connect (m_receiver, &QCCTV_DatagramStream::frameMissing, this,
+    [this] (const quint16 id) {
+        m_missing.append (id);
+
+        QByteArray data;
+        if (m_answer && m_sender->sentFrame ((quint16) (id - m_offset), &data))
+            m_receiver->insertFrame (id, data);
+    }, Qt::QueuedConnection);
+}
+
+void QCCTV_DatagramStreamTest::cleanup()
+{
+    delete m_lostSpy;
+    delete m_receivedSpy;
+    delete m_sender;
+    delete m_receiver;
+    delete m_link;
+}
+
+/**
+ * Shifts the frame IDs seen by the receiver by the given \a offset
+ */
+void QCCTV_DatagramStreamTest::setIdOffset (const quint16 offset)
+{
+    m_offset = offset;
+    m_link->setIdOffset (offset);
+}
+
+/**
+ * Sends the given \a frame and returns its datagrams, which are held by the
+ * link until the test forwards them
+ */
+QList<QByteArray> QCCTV_DatagramStreamTest::send (const QByteArray& frame)
+{
+    m_sender->sendFrame (frame);
+    return m_link->receive (datagram_count (frame.size()));
+}
+
+/**
+ * Returns the frames reported by the receiver
+ */
+QList<QByteArray> QCCTV_DatagramStreamTest::received() const
+{
+    QList<QByteArray> frames;
+    for (int i = 0; i < m_receivedSpy->count(); ++i)
+        frames.append (m_receivedSpy->at (i).at (0).toByteArray());
+
+    return frames;
+}
+
+void QCCTV_DatagramStreamTest::recoverFragments_data()
+{
+    QTest::addColumn<int> ("length");
+    QTest::addColumn<int> ("lost");
+
+    QTest::newRow ("first fragment") << PARTIAL_GROUP_FRAME << 0;
+    QTest::newRow ("middle fragment") << PARTIAL_GROUP_FRAME << 2;
+    QTest::newRow ("last of full group") << PARTIAL_GROUP_FRAME << 3;
+    QTest::newRow ("short last fragment") << PARTIAL_GROUP_FRAME << 4;
+    QTest::newRow ("short last fragment of group") << FULL_GROUP_FRAME << 3;
+    QTest::newRow ("single fragment") << 700 << 0;
+}
+
+/**
+ * One lost fragment per group is rebuilt from the parity fragment, the short
+ * last fragment must be trimmed to the length of the frame
+ */
+void QCCTV_DatagramStreamTest::recoverFragments()
+{
+    QFETCH (int, length);
+    QFETCH (int, lost);
+
+    const QByteArray frame = random_frame (length);
+    QList<QByteArray> datagrams = send (frame);
+    QCOMPARE (datagrams.count(), datagram_count (length));
+
+    m_link->forward (drop_fragments (datagrams, QList<int>() << lost));
+
+    QTRY_COMPARE (m_receivedSpy->count(), 1);
+    QCOMPARE (received().first(), frame);
+    QCOMPARE (m_lostSpy->count(), 0);
+}
+
+/**
+ * Two lost fragments of the same group cannot be rebuilt, the frame is
+ * dropped and the loss is reported when the next frame arrives
+ */
+void QCCTV_DatagramStreamTest::unrecoverableFragments()
+{
+    const QByteArray first = random_frame (PARTIAL_GROUP_FRAME);
+    const QByteArray second = random_frame (PARTIAL_GROUP_FRAME);
+    const QByteArray third = random_frame (PARTIAL_GROUP_FRAME);
+
+    m_link->forward (send (first));
+    QTRY_COMPARE (m_receivedSpy->count(), 1);
+
+    m_link->forward (drop_fragments (send (second), QList<int>() << 1 << 2));
+    QTest::qWait (WAIT_TIME);
+    QCOMPARE (m_receivedSpy->count(), 1);
+
+    m_link->forward (send (third));
+    QTRY_COMPARE (m_receivedSpy->count(), 2);
+    QCOMPARE (received(), QList<QByteArray>() << first << third);
+    QCOMPARE (m_lostSpy->count(), 1);
+}
+
+void QCCTV_DatagramStreamTest::reorderedFragments_data()
+{
+    QTest::addColumn<bool> ("loss");
+
+    QTest::newRow ("reversed") << false;
+    QTest::newRow ("reversed with loss") << true;
+}
+
+/**
+ * Fragments (and parity fragments) may arrive in any order
+ */
+void QCCTV_DatagramStreamTest::reorderedFragments()
+{
+    QFETCH (bool, loss);
+
+    const QByteArray frame = random_frame (PARTIAL_GROUP_FRAME);
+    QList<QByteArray> datagrams = send (frame);
+    if (loss)
+        datagrams = drop_fragments (datagrams, QList<int>() << 1 << 4);
+
+    QList<QByteArray> reversed;
+    foreach (const QByteArray& datagram, datagrams)
+        reversed.prepend (datagram);
+
+    m_link->forward (reversed);
+
+    QTRY_COMPARE (m_receivedSpy->count(), 1);
+    QCOMPARE (received().first(), frame);
+    QCOMPARE (m_lostSpy->count(), 0);
+}
+
+/**
+ * The frame lost right before the frame IDs wrap around is retransmitted,
+ * the frames that follow it are held back and delivered in order
+ */
+void QCCTV_DatagramStreamTest::retransmittedFrameWrapAround()
+{
+    m_answer = true;
+    setIdOffset (0xfffd);
+    m_receiver->setRetransmissionsEnabled (true);
+
+    /* Frames 0xfffd, 0xfffe, 0xffff (lost), 0x0000 and 0x0001 */
+    QList<QByteArray> frames;
+    for (int i = 0; i < 5; ++i) {
+        frames.append (random_frame (PARTIAL_GROUP_FRAME));
+        QList<QByteArray> datagrams = send (frames.last());
+        if (i != 2)
+            m_link->forward (datagrams);
+    }
+
+    QTRY_COMPARE (m_receivedSpy->count(), frames.count());
+    QCOMPARE (received(), frames);
+    QCOMPARE (m_missing, QList<quint16>() << 0xffff);
+    QCOMPARE (m_lostSpy->count(), 0);
+}
+
+/**
+ * A frame that arrives after the next frame (across the frame ID wrap
+ * around) is delivered before it, without reporting a loss
+ */
+void QCCTV_DatagramStreamTest::reorderedFramesWrapAround()
+{
+    setIdOffset (0xfffe);
+    m_receiver->setRetransmissionsEnabled (true);
+
+    /* Frames 0xfffe, 0xffff and 0x0000 */
+    QList<QByteArray> frames;
+    QList<QList<QByteArray> > datagrams;
+    for (int i = 0; i < 3; ++i) {
+        frames.append (random_frame (FULL_GROUP_FRAME));
+        datagrams.append (send (frames.last()));
+    }
+
+    m_link->forward (datagrams.at (0));
+    QTRY_COMPARE (m_receivedSpy->count(), 1);
+
+    m_link->forward (datagrams.at (2));
+    QTest::qWait (WAIT_TIME);
+    QCOMPARE (m_receivedSpy->count(), 1);
+
+    m_link->forward (datagrams.at (1));
+    QTRY_COMPARE (m_receivedSpy->count(), frames.count());
+    QCOMPARE (received(), frames);
+    QCOMPARE (m_lostSpy->count(), 0);
+}
+
+/**
+ * If the lost frame is not retransmitted, the held frames are delivered
+ * once the retransmission times out and the loss is reported
+ */
+void QCCTV_DatagramStreamTest::retransmissionTimeout()
+{
+    setIdOffset (0xfffd);
+    m_receiver->setRetransmissionsEnabled (true);
+
+    /* Frames 0xfffd, 0xfffe, 0xffff (lost), 0x0000 and 0x0001 */
+    QList<QByteArray> frames;
+    for (int i = 0; i < 5; ++i) {
+        QByteArray frame = random_frame (FULL_GROUP_FRAME);
+        QList<QByteArray> datagrams = send (frame);
+        if (i != 2) {
+            frames.append (frame);
+            m_link->forward (datagrams);
+        }
+    }
+
+    QTest::qWait (QCCTV_UDP_RETRANSMIT_TIME / 2);
+    QCOMPARE (m_receivedSpy->count(), 2);
+
+    QTRY_COMPARE (m_receivedSpy->count(), frames.count());
+    QCOMPARE (received(), frames);
+    QCOMPARE (m_missing, QList<quint16>() << 0xffff);
+    QCOMPARE (m_lostSpy->count(), 1);
+}
+
+QTEST_GUILESS_MAIN (QCCTV_DatagramStreamTest)
+#include "tst_datagramstream.moc"
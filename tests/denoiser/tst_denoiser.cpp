@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include <QtTest>
+#include <QBuffer>
+
+#include "QCCTV.h"
+#include "QCCTV_Denoiser.h"
+
+/*
+ * Quality of the JPEG images used to measure the bytes per frame
+ */
+static const int JPEG_QUALITY = 80;
+
+/*
+ * Number of frames of the noisy test sequence
+ */
+static const int FRAMES = 30;
+
+/*
+ * State of the pseudo-random generator (fixed seed, so that a failure can
+ * always be reproduced)
+ */
+static quint32 SEED = 0;
+
+/**
+ * Returns the next pseudo-random number (a simple LCG is enough here)
+ */
+static int random_int (const int max)
+{
+    SEED = SEED * 1664525 + 1013904223;
+    return (int) ((SEED >> 8) % (quint32) max);
+}
+
+/**
+ * Returns the sum of three random numbers between -\a noise and \a noise,
+ * which is close enough to the (gaussian) noise of a camera sensor
+ */
+static int random_noise (const int noise)
+{
+    int sum = 0;
+    for (int i = 0; i < 3; ++i)
+        sum += random_int (noise * 2 + 1) - noise;
+
+    return sum / 2;
+}
+
+/**
+ * Returns a random image of the given \a size
+ */
+static QImage random_image (const QSize& size)
+{
+    QImage image (size, QImage::Format_RGB32);
+    for (int y = 0; y < size.height(); ++y) {
+        uchar* line = image.scanLine (y);
+        for (int x = 0; x < size.width() * 4; ++x)
+            line [x] = (uchar) random_int (256);
+    }
+
+    return image;
+}
+
+/**
+ * Returns a copy of the given \a image with random \a noise added to each
+ * byte and a moving block (that changes with the \a frame number)
+ */
+static QImage noisy_frame (const QImage& image, const int noise, const int frame)
+{
+    QImage output = image.copy();
+    for (int y = 0; y < output.height(); ++y) {
+        uchar* line = output.scanLine (y);
+        for (int x = 0; x < output.width() * 4; ++x)
+            line [x] = (uchar) qBound (0, line [x] + random_noise (noise), 255);
+    }
+
+    const int size = output.height() / 4;
+    const int left = (frame * 16) % qMax (output.width() - size, 1);
+    for (int y = 0; y < size; ++y) {
+        QRgb* line = (QRgb*) output.scanLine (output.height() / 2 + y);
+        for (int x = 0; x < size; ++x)
+            line [left + x] = qRgb (255, 255, 255);
+    }
+
+    return output;
+}
+
+/**
+ * Returns a smooth test scene (a gradient with a few flat shapes) of the
+ * given \a size, similar to the static background seen by a camera
+ */
+static QImage test_scene (const QSize& size)
+{
+    QImage image (size, QImage::Format_RGB32);
+    for (int y = 0; y < size.height(); ++y) {
+        QRgb* line = (QRgb*) image.scanLine (y);
+        for (int x = 0; x < size.width(); ++x) {
+            const int v = (x * 160) / size.width() + (y * 64) / size.height();
+            line [x] = qRgb (v, (v + 40) % 256, 255 - v);
+        }
+    }
+
+    for (int i = 0; i < 8; ++i) {
+        const int w = size.width() / 8;
+        const int h = size.height() / 8;
+        const int x0 = random_int (size.width() - w);
+        const int y0 = random_int (size.height() - h);
+        const QRgb color = qRgb (random_int (256), random_int (256),
+                                 random_int (256));
+
+        for (int y = y0; y < y0 + h; ++y) {
+            QRgb* line = (QRgb*) image.scanLine (y);
+            for (int x = x0; x < x0 + w; ++x)
+                line [x] = color;
+        }
+    }
+
+    return image;
+}
+
+/**
+ * Returns the size of the given \a image encoded as a JPEG image
+ */
+static int jpeg_size (const QImage& image)
+{
+    QByteArray bytes;
+    QBuffer buffer (&bytes);
+    image.save (&buffer, "jpg", JPEG_QUALITY);
+    return bytes.size();
+}
+
+/*
+ * Checks that the SIMD kernels of the denoiser give the same output as the
+ * scalar code and measures the bytes per frame saved by the denoiser
+ */
+class QCCTV_DenoiserTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void simdMatchesScalar_data();
+    void simdMatchesScalar();
+
+    void bytesPerFrame_data();
+    void bytesPerFrame();
+
+    void throughput_data();
+    void throughput();
+};
+
+void QCCTV_DenoiserTest::cleanup()
+{
+    QCCTV_SetEnabledSimd (QCCTV_SupportedSimd());
+}
+
+void QCCTV_DenoiserTest::simdMatchesScalar_data()
+{
+    QTest::addColumn<int> ("flags");
+
+    QTest::newRow ("sse2") << (int) QCCTV_SIMD_SSE2;
+    QTest::newRow ("avx2") << (int) QCCTV_SIMD_AVX2;
+    QTest::newRow ("avx2+sse2") << (int) (QCCTV_SIMD_AVX2 | QCCTV_SIMD_SSE2);
+    QTest::newRow ("neon") << (int) QCCTV_SIMD_NEON;
+}
+
+/**
+ * Filters random frames (random sizes, so that every SIMD loop tail is used,
+ * with noise around the pixel threshold) with and without the given SIMD
+ * kernels
+ */
+void QCCTV_DenoiserTest::simdMatchesScalar()
+{
+    QFETCH (int, flags);
+    if ((QCCTV_SupportedSimd() & flags) != flags)
+        QSKIP ("Instruction set not supported by this build or CPU");
+
+    SEED = 3;
+    for (int run = 0; run < 50; ++run) {
+        const QSize size (QCCTV_MOTION_WIDTH + random_int (400),
+                          QCCTV_MOTION_HEIGHT + random_int (200));
+
+        const QImage first = random_image (size);
+        const QImage second = noisy_frame (first, 16, run);
+
+        QCCTV_Denoiser scalar;
+        QCCTV_Denoiser simd;
+        scalar.setTimeBudget (INT_MAX);
+        simd.setTimeBudget (INT_MAX);
+
+        QCCTV_SetEnabledSimd (QCCTV_SIMD_NONE);
+        scalar.process (first);
+        const QImage expected = scalar.process (second);
+
+        QCCTV_SetEnabledSimd (flags);
+        simd.process (first);
+        const QImage actual = simd.process (second);
+
+        QVERIFY2 (actual == expected,
+                  qPrintable (QString ("Run %1 (%2x%3)")
+                              .arg (run)
+                              .arg (size.width())
+                              .arg (size.height())));
+    }
+}
+
+void QCCTV_DenoiserTest::bytesPerFrame_data()
+{
+    QTest::addColumn<int> ("res");
+    QTest::addColumn<int> ("noise");
+
+    QTest::newRow ("CIF, low noise") << (int) QCCTV_CIF << 4;
+    QTest::newRow ("CIF, high noise") << (int) QCCTV_CIF << 10;
+    QTest::newRow ("D1, low noise") << (int) QCCTV_D1 << 4;
+    QTest::newRow ("D1, high noise") << (int) QCCTV_D1 << 10;
+}
+
+/**
+ * Encodes a noisy sequence of a static scene (with a moving block) with and
+ * without noise reduction, the filtered frames must be smaller at the same
+ * JPEG quality
+ */
+void QCCTV_DenoiserTest::bytesPerFrame()
+{
+    QFETCH (int, res);
+    QFETCH (int, noise);
+
+    SEED = 4;
+    const QImage scene = test_scene (QCCTV_GetResolution (res));
+
+    qint64 raw = 0;
+    qint64 filtered = 0;
+    QCCTV_Denoiser denoiser;
+    denoiser.setTimeBudget (INT_MAX);
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        const QImage image = noisy_frame (scene, noise, frame);
+        raw += jpeg_size (image);
+        filtered += jpeg_size (denoiser.process (image));
+    }
+
+    raw /= FRAMES;
+    filtered /= FRAMES;
+    qDebug ("Without noise reduction: %lld bytes/frame, with noise reduction: "
+            "%lld bytes/frame (%.1f%% smaller)", raw, filtered,
+            100.0 * (raw - filtered) / raw);
+
+    QVERIFY (filtered < raw);
+}
+
+void QCCTV_DenoiserTest::throughput_data()
+{
+    QTest::addColumn<int> ("simd");
+
+    QTest::newRow ("D1 scalar") << (int) QCCTV_SIMD_NONE;
+    QTest::newRow ("D1 simd") << QCCTV_SupportedSimd();
+}
+
+/**
+ * Measures the time needed to filter a D1 frame
+ */
+void QCCTV_DenoiserTest::throughput()
+{
+    QFETCH (int, simd);
+
+    SEED = 5;
+    const QImage scene = test_scene (QCCTV_GetResolution (QCCTV_D1));
+    const QImage first = noisy_frame (scene, 4, 0);
+    const QImage second = noisy_frame (scene, 4, 1);
+
+    QCCTV_SetEnabledSimd (simd);
+
+    QCCTV_Denoiser denoiser;
+    denoiser.setTimeBudget (INT_MAX);
+    QBENCHMARK {
+        denoiser.process (first);
+        denoiser.process (second);
+    }
+}
+
+QTEST_GUILESS_MAIN (QCCTV_DenoiserTest)
+#include "tst_denoiser.moc"
@@ -0,0 +1,361 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include <QtTest>
+#include <QThread>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QAtomicInt>
+#include <QGuiApplication>
+
+#include "QCCTV.h"
+#include "QCCTV_Session.h"
+#include "QCCTV_Communications.h"
+
+/*
+ * Frame rate that the pipeline must sustain before high frame rates can be
+ * used by default
+ */
+static const int TARGET_FPS = 60;
+
+/*
+ * Time spent sending frames through the loopback session (milliseconds)
+ */
+static const int DURATION = 3000;
+
+/*
+ * Number of different source frames (the sequence is repeated)
+ */
+static const int SOURCE_FRAMES = 8;
+
+/*
+ * State of the pseudo-random generator (fixed seed, so that a failure can
+ * always be reproduced)
+ */
+static quint32 SEED = 0;
+
+/**
+ * Returns the next pseudo-random number (a simple LCG is enough here)
+ */
+static int random_int (const int max)
+{
+    SEED = SEED * 1664525 + 1013904223;
+    return (int) ((SEED >> 8) % (quint32) max);
+}
+
+/**
+ * Returns a sequence of camera frames with the given \a size: a static
+ * scene with some sensor noise and a block that moves in each frame
+ */
+static QList<QImage> source_frames (const QSize& size)
+{
+    SEED = 1;
+    QList<QImage> frames;
+    for (int i = 0; i < SOURCE_FRAMES; ++i) {
+        QImage image (size, QImage::Format_RGB32);
+        for (int y = 0; y < size.height(); ++y) {
+            QRgb* line = (QRgb*) image.scanLine (y);
+            for (int x = 0; x < size.width(); ++x) {
+                const int v = (x * 160) / size.width() + (y * 64) / size.height();
+                const int n = random_int (9) - 4;
+                line [x] = qRgb (v + n, (v + 40 + n) % 256, 255 - v - n);
+            }
+        }
+
+        const int block = size.height() / 4;
+        const int left = (i * size.width()) / (SOURCE_FRAMES * 2);
+        for (int y = 0; y < block; ++y) {
+            QRgb* line = (QRgb*) image.scanLine (size.height() / 2 + y);
+            for (int x = 0; x < block; ++x)
+                line [left + x] = qRgb (255, 255, 255);
+        }
+
+        frames.append (image);
+    }
+
+    return frames;
+}
+
+/**
+ * \brief Station side of the loopback pipeline.
+ *
+ * Runs in its own thread (as if it was in another host) and decodes the
+ * images received through its session.
+ */
+class QCCTV_PipelineStation : public QObject
+{
+    Q_OBJECT
+
+public:
+    QCCTV_PipelineStation()
+    {
+        m_socket = Q_NULLPTR;
+        QCCTV_InitImage (&m_packet);
+    }
+
+    QAtomicInt frames;
+    QAtomicInt errors;
+
+public Q_SLOTS:
+    void connectToCamera (const int port)
+    {
+        m_socket = new QTcpSocket (this);
+        QCCTV_Session* session = new QCCTV_Session (m_socket, this);
+        connect (session, SIGNAL (imageReceived (QByteArray)),
+                 this,      SLOT (onImageReceived (QByteArray)));
+
+        m_socket->connectToHost (QHostAddress::LocalHost, port);
+    }
+
+private Q_SLOTS:
+    void onImageReceived (const QByteArray& data)
+    {
+        if (QCCTV_ReadImagePacket (&m_packet, data) &&
+            m_packet.image.size() == QCCTV_GetResolution (QCCTV_720p))
+            frames.ref();
+        else
+            errors.ref();
+    }
+
+private:
+    QTcpSocket* m_socket;
+    QCCTV_ImagePacket m_packet;
+};
+
+/*
+ * Checks that the whole pipeline (scaling, encoding, session and decoding)
+ * keeps up with 720p streams at 60 FPS
+ */
+class QCCTV_PipelineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void sustainedFps_data();
+    void sustainedFps();
+
+    void encode_data();
+    void encode();
+    void decode_data();
+    void decode();
+
+private:
+    void addRows();
+    void initStream (QCCTV_InfoPacket* info, QCCTV_ImagePacket* packet,
+                     const int flags);
+};
+
+/**
+ * Adds the source resolutions and stream flags used by the tests
+ */
+void QCCTV_PipelineTest::addRows()
+{
+    QTest::addColumn<QSize> ("source");
+    QTest::addColumn<int> ("flags");
+
+    const int all = QCCTV_STREAM_DELTA_FRAMES |
+                    QCCTV_STREAM_ABBREVIATED |
+                    QCCTV_STREAM_NOISE_REDUCTION;
+
+    QTest::newRow ("720p") << QSize (1280, 720) << (int) QCCTV_STREAM_DEFAULT;
+    QTest::newRow ("1080p to 720p") << QSize (1920, 1080) << (int) QCCTV_STREAM_DEFAULT;
+    QTest::newRow ("720p, all stream flags") << QSize (1280, 720) << all;
+}
+
+/**
+ * Initializes a 720p stream at 60 FPS with the default bitrate and the
+ * given stream \a flags
+ */
+void QCCTV_PipelineTest::initStream (QCCTV_InfoPacket* info,
+                                     QCCTV_ImagePacket* packet,
+                                     const int flags)
+{
+    QCCTV_InitInfo (info);
+    QCCTV_InitImage (packet);
+
+    info->fps = TARGET_FPS;
+    info->maxFps = TARGET_FPS;
+    info->streamFlags = flags;
+    info->resolution = QCCTV_720p;
+    packet->fps = TARGET_FPS;
+}
+
+void QCCTV_PipelineTest::sustainedFps_data()
+{
+    addRows();
+}
+
+/**
+ * Sends frames through a loopback session as fast as the pipeline allows
+ * (a new frame is only queued when the session started sending the last
+ * one) and checks that the station decodes at least 60 frames per second
+ */
+void QCCTV_PipelineTest::sustainedFps()
+{
+    QFETCH (QSize, source);
+    QFETCH (int, flags);
+
+    const QList<QImage> frames = source_frames (source);
+
+    QCCTV_InfoPacket info;
+    QCCTV_ImagePacket packet;
+    initStream (&info, &packet, flags);
+
+    /* Start the station thread */
+    QThread thread;
+    QCCTV_PipelineStation* station = new QCCTV_PipelineStation;
+    station->moveToThread (&thread);
+    connect (&thread, SIGNAL (finished()), station, SLOT (deleteLater()));
+    thread.start();
+
+    /* Connect the station to the camera */
+    QTcpServer server;
+    QVERIFY (server.listen (QHostAddress::LocalHost, 0));
+    QMetaObject::invokeMethod (station, "connectToCamera",
+                               Qt::QueuedConnection,
+                               Q_ARG (int, server.serverPort()));
+
+    const bool connected = server.waitForNewConnection (5000);
+    if (!connected) {
+        thread.quit();
+        thread.wait();
+    }
+
+    QVERIFY (connected);
+
+    QTcpSocket* socket = server.nextPendingConnection();
+    QCCTV_Session session (socket);
+
+    /* Send the frames */
+    int sent = 0;
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.elapsed() < DURATION) {
+        while (session.imagePending())
+            QCoreApplication::processEvents();
+
+        packet.image = frames.at (sent % frames.count());
+        session.sendImage (QCCTV_CreateImagePacket (&packet, &info),
+                           packet.selfContained);
+
+        ++sent;
+        QCoreApplication::processEvents();
+    }
+
+    /* Wait for the station to decode the last frames */
+    QElapsedTimer wait;
+    wait.start();
+    while (station->frames.load() + station->errors.load() < sent &&
+           wait.elapsed() < 5000)
+        QCoreApplication::processEvents();
+
+    const int decoded = station->frames.load();
+    const int errors = station->errors.load();
+    const qreal fps = decoded * 1000.0 / timer.elapsed();
+
+    thread.quit();
+    thread.wait();
+
+    qDebug ("%d frames sent, %d frames decoded, %.1f FPS", sent, decoded, fps);
+    QCOMPARE (errors, 0);
+    QCOMPARE (decoded, sent);
+    QVERIFY2 (fps >= TARGET_FPS,
+              qPrintable (QString ("Only %1 FPS").arg (fps, 0, 'f', 1)));
+}
+
+void QCCTV_PipelineTest::encode_data()
+{
+    addRows();
+}
+
+/**
+ * Measures the time needed by the camera to create an image packet
+ */
+void QCCTV_PipelineTest::encode()
+{
+    QFETCH (QSize, source);
+    QFETCH (int, flags);
+
+    const QList<QImage> frames = source_frames (source);
+
+    QCCTV_InfoPacket info;
+    QCCTV_ImagePacket packet;
+    initStream (&info, &packet, flags);
+
+    int frame = 0;
+    QBENCHMARK {
+        packet.image = frames.at (frame++ % frames.count());
+        QCCTV_CreateImagePacket (&packet, &info);
+    }
+}
+
+void QCCTV_PipelineTest::decode_data()
+{
+    addRows();
+}
+
+/**
+ * Measures the time needed by the station to read the image packets of the
+ * whole source sequence
+ */
+void QCCTV_PipelineTest::decode()
+{
+    QFETCH (QSize, source);
+    QFETCH (int, flags);
+
+    const QList<QImage> frames = source_frames (source);
+
+    QCCTV_InfoPacket info;
+    QCCTV_ImagePacket packet;
+    initStream (&info, &packet, flags);
+
+    /* Encode the sequence (the first frame is a keyframe) */
+    QList<QByteArray> packets;
+    foreach (const QImage& image, frames) {
+        packet.image = image;
+        packets.append (QCCTV_CreateImagePacket (&packet, &info));
+    }
+
+    QCCTV_ImagePacket received;
+    QCCTV_InitImage (&received);
+
+    QBENCHMARK {
+        foreach (const QByteArray& data, packets)
+            QVERIFY (QCCTV_ReadImagePacket (&received, data));
+    }
+}
+
+/**
+ * Status images are drawn on a QPixmap, which needs a GUI application (the
+ * offscreen platform is used unless another one is given)
+ */
+int main (int argc, char** argv)
+{
+    if (qEnvironmentVariableIsEmpty ("QT_QPA_PLATFORM"))
+        qputenv ("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app (argc, argv);
+    QCCTV_PipelineTest test;
+    return QTest::qExec (&test, argc, argv);
+}
+
+#include "tst_pipeline.moc"
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2016 Alex Spataru
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
+ * ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE
+ */
+
+#include <QtTest>
+#include <QBuffer>
+#include <qmath.h>
+
+#include "QCCTV.h"
+#include "QCCTV_Scaler.h"
+
+/*
+ * Quality of the JPEG images used to compare the scaling methods
+ */
+static const int JPEG_QUALITY = 80;
+
+/*
+ * State of the pseudo-random generator (fixed seed, so that a failure can
+ * always be reproduced)
+ */
+static quint32 SEED = 0;
+
+/**
+ * Returns the next pseudo-random number (a simple LCG is enough here)
+ */
+static int random_int (const int max)
+{
+    SEED = SEED * 1664525 + 1013904223;
+    return (int) ((SEED >> 8) % (quint32) max);
+}
+
+/**
+ * Returns a 1080p test image with a zone plate (which has every frequency up
+ * to the Nyquist limit of the image, so it shows any aliasing of the scaler)
+ * and some sensor-like noise
+ */
+static QImage test_image()
+{
+    SEED = 1;
+    const int w = 1920;
+    const int h = 1080;
+    const qreal k = M_PI / 3840;
+
+    QImage image (w, h, QImage::Format_RGB32);
+    for (int y = 0; y < h; ++y) {
+        QRgb* line = (QRgb*) image.scanLine (y);
+        for (int x = 0; x < w; ++x) {
+            const qreal dx = x - w / 2;
+            const qreal dy = y - h / 2;
+            const int value = qRound (127.5 + 127.5 * qCos (k * (dx * dx + dy * dy)));
+
+            int rgb [3];
+            for (int c = 0; c < 3; ++c)
+                rgb [c] = qBound (0, value + random_int (17) - 8, 255);
+
+            line [x] = qRgb (rgb [0], rgb [1], rgb [2]);
+        }
+    }
+
+    return image;
+}
+
+/**
+ * Returns the size of the given \a image encoded as a JPEG image
+ */
+static int jpeg_size (const QImage& image)
+{
+    QByteArray bytes;
+    QBuffer buffer (&bytes);
+    image.save (&buffer, "jpg", JPEG_QUALITY);
+    return bytes.size();
+}
+
+/**
+ * Scales the given \a image to the given \a res with the old method
+ * (nearest-neighbour scaling provided by Qt)
+ */
+static QImage nearest_image (const QImage& image, const int res)
+{
+    return image.scaled (QCCTV_GetResolution (res), Qt::KeepAspectRatio,
+                         Qt::FastTransformation);
+}
+
+/*
+ * Checks that the SIMD kernels of the scaler give the same output as the
+ * scalar code and compares the area scaler with nearest-neighbour scaling
+ */
+class QCCTV_ScalerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void simdMatchesScalar_data();
+    void simdMatchesScalar();
+
+    void jpegSize_data();
+    void jpegSize();
+
+    void throughput_data();
+    void throughput();
+
+private:
+    QImage m_image;
+};
+
+void QCCTV_ScalerTest::initTestCase()
+{
+    m_image = test_image();
+}
+
+void QCCTV_ScalerTest::cleanup()
+{
+    QCCTV_SetEnabledSimd (QCCTV_SupportedSimd());
+}
+
+void QCCTV_ScalerTest::simdMatchesScalar_data()
+{
+    QTest::addColumn<int> ("flags");
+
+    QTest::newRow ("sse2") << (int) QCCTV_SIMD_SSE2;
+    QTest::newRow ("avx2") << (int) QCCTV_SIMD_AVX2;
+    QTest::newRow ("avx2+sse2") << (int) (QCCTV_SIMD_AVX2 | QCCTV_SIMD_SSE2);
+    QTest::newRow ("neon") << (int) QCCTV_SIMD_NEON;
+}
+
+/**
+ * Scales random planes (random sizes, channels, modes and padded strides, so
+ * that every SIMD loop tail is used) with and without the given SIMD kernels
+ */
+void QCCTV_ScalerTest::simdMatchesScalar()
+{
+    QFETCH (int, flags);
+    if ((QCCTV_SupportedSimd() & flags) != flags)
+        QSKIP ("Instruction set not supported by this build or CPU");
+
+    SEED = 2;
+    const int channels [3] = {1, 3, 4};
+    for (int run = 0; run < 300; ++run) {
+        const int ch = channels [run % 3];
+        const int srcWidth = 1 + random_int (700);
+        const int srcHeight = 1 + random_int (300);
+        const int dstWidth = 1 + random_int (srcWidth);
+        const int dstHeight = 1 + random_int (srcHeight);
+        const int srcStride = srcWidth * ch + random_int (5);
+        const int dstStride = dstWidth * ch + random_int (5);
+        const int mode = random_int (2) ? QCCTV_SCALE_BILINEAR : QCCTV_SCALE_AREA;
+
+        QByteArray src (srcStride * srcHeight, 0);
+        for (int i = 0; i < src.size(); ++i)
+            src [i] = (char) random_int (256);
+
+        QByteArray scalar (dstStride * dstHeight, 0);
+        QByteArray simd (dstStride * dstHeight, 0);
+
+        QCCTV_SetEnabledSimd (QCCTV_SIMD_NONE);
+        QCCTV_ScalePlane ((const uchar*) src.constData(), srcWidth, srcHeight,
+                          srcStride, (uchar*) scalar.data(), dstWidth,
+                          dstHeight, dstStride, ch, mode);
+
+        QCCTV_SetEnabledSimd (flags);
+        QCCTV_ScalePlane ((const uchar*) src.constData(), srcWidth, srcHeight,
+                          srcStride, (uchar*) simd.data(), dstWidth,
+                          dstHeight, dstStride, ch, mode);
+
+        for (int y = 0; y < dstHeight; ++y) {
+            const int offset = y * dstStride;
+            const bool equal = memcmp (scalar.constData() + offset,
+                                       simd.constData() + offset,
+                                       dstWidth * ch) == 0;
+
+            QVERIFY2 (equal, qPrintable (QString ("Run %1 (%2x%3 to %4x%5, "
+                                                  "%6 channels), row %7")
+                                         .arg (run)
+                                         .arg (srcWidth).arg (srcHeight)
+                                         .arg (dstWidth).arg (dstHeight)
+                                         .arg (ch).arg (y)));
+        }
+    }
+}
+
+void QCCTV_ScalerTest::jpegSize_data()
+{
+    QTest::addColumn<int> ("res");
+
+    QTest::newRow ("QCIF") << (int) QCCTV_QCIF;
+    QTest::newRow ("CIF") << (int) QCCTV_CIF;
+    QTest::newRow ("D1") << (int) QCCTV_D1;
+    QTest::newRow ("720p") << (int) QCCTV_720p;
+}
+
+/**
+ * Area averaging removes the aliasing (and averages the noise) of the scaled
+ * image, so the JPEG image must be smaller at the same quality
+ */
+void QCCTV_ScalerTest::jpegSize()
+{
+    QFETCH (int, res);
+
+    const int nearest = jpeg_size (nearest_image (m_image, res));
+    const int area = jpeg_size (QCCTV_ScaleImage (m_image, res));
+
+    qDebug ("Nearest: %d bytes, area: %d bytes (%.1f%% smaller)",
+            nearest, area, 100.0 * (nearest - area) / nearest);
+
+    QVERIFY (area < nearest);
+}
+
+void QCCTV_ScalerTest::throughput_data()
+{
+    QTest::addColumn<int> ("res");
+    QTest::addColumn<int> ("simd");
+    QTest::addColumn<bool> ("area");
+    QTest::addColumn<bool> ("encode");
+
+    const int all = QCCTV_SupportedSimd();
+    const int res [3] = {QCCTV_QCIF, QCCTV_D1, QCCTV_720p};
+    const char* names [3] = {"QCIF", "D1", "720p"};
+
+    for (int i = 0; i < 3; ++i) {
+        for (int encode = 0; encode < 2; ++encode) {
+            const char* task = encode ? "scale+encode" : "scale";
+            QTest::newRow (qPrintable (QString ("%1 %2 nearest").arg (names [i]).arg (task)))
+                    << res [i] << all << false << (bool) encode;
+            QTest::newRow (qPrintable (QString ("%1 %2 area scalar").arg (names [i]).arg (task)))
+                    << res [i] << (int) QCCTV_SIMD_NONE << true << (bool) encode;
+            QTest::newRow (qPrintable (QString ("%1 %2 area simd").arg (names [i]).arg (task)))
+                    << res [i] << all << true << (bool) encode;
+        }
+    }
+}
+
+/**
+ * Measures the time needed to scale (and optionally encode) a 1080p frame
+ * with nearest-neighbour scaling and with area averaging
+ */
+void QCCTV_ScalerTest::throughput()
+{
+    QFETCH (int, res);
+    QFETCH (int, simd);
+    QFETCH (bool, area);
+    QFETCH (bool, encode);
+
+    QCCTV_SetEnabledSimd (simd);
+
+    QBENCHMARK {
+        QImage image = area ? QCCTV_ScaleImage (m_image, res) :
+                       nearest_image (m_image, res);
+        if (encode)
+            jpeg_size (image);
+    }
+}
+
+QTEST_GUILESS_MAIN (QCCTV_ScalerTest)
+#include "tst_scaler.moc"